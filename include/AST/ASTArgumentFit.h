@@ -12,6 +12,8 @@
 #include "AST/ASTValueType.h"
 #include "AST/ExprNode.h"
 
+#include <cstdint>
+
 namespace AST
 {
     // how well an argument answers a parameter. declaration order is best to worst, and that
@@ -529,6 +531,41 @@ namespace AST
 
         return ArgumentFit::t_none;
     }
+
+    // **everything argument_fit reads off the expression rather than off its type**, one bit each: that
+    // there is one, its storage class, whether its value is an address, and whether it is a call - which
+    // is the whole of what read_reaches_storage, is_place_expression and can_bind_temporary ask.
+    //
+    // so two arguments of one type and one shape fit every parameter identically, and that is the
+    // promise FunctionRegistry's remembered resolutions are keyed on. an arm that learns to ask the
+    // expression something new has to add its bit here, or a remembered answer will be handed to an
+    // argument it was never true of
+    inline uint8_t argument_shape(const ExprNode *expr)
+    {
+        if (expr == nullptr) {
+            return 0;
+        }
+
+        uint8_t shape = 1u << 0;
+
+        if (is_place_expression(*expr)) {
+            shape |= 1u << 1;
+        }
+
+        if (can_bind_temporary(*expr)) {
+            shape |= 1u << 2;
+        }
+
+        if (value_is_an_address(*expr)) {
+            shape |= 1u << 3;
+        }
+
+        if (is_call_expression(*expr)) {
+            shape |= 1u << 4;
+        }
+
+        return shape;
+    }
 };
 
 #endif
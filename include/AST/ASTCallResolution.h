@@ -4,6 +4,7 @@
 #pragma once
 
 #include "AST/ASTCodeRef.h"
+#include "AST/ASTFunctionMatcher.h"
 #include "AST/ASTNode.h"
 #include "AST/ExprNode.h"
 
@@ -82,6 +83,20 @@ namespace AST
         // the token their caller read
         std::vector<FunctionDeclNode *> candidates_for(const FunctionCallExprNode &call) const;
 
+        // score the candidates against the call's arguments - a template against the parameters it
+        // would be instantiated with - and pick one. AST::match_function is the picking
+        FunctionMatch match_overloads(
+            const FunctionCallExprNode &call,
+            const std::vector<FunctionDeclNode *> &candidates,
+            const std::vector<ValueType> &argument_types);
+
+        // match_overloads, answered from FunctionRegistry's remembered matches where the call is one
+        // whose answer its key determines, and remembered there when it was not yet
+        FunctionMatch remembered_match(
+            const FunctionCallExprNode &call,
+            const std::vector<FunctionDeclNode *> &candidates,
+            const std::vector<ValueType> &argument_types);
+
         // run the overload match and record its answer on the call. `candidates` is passed in
         // because `settle` has just derived the set for its own empty-set test
         Result choose_declaration(
@@ -14,8 +14,8 @@ namespace AST
     //
     // `NodeCollection::of_type` is not a tree walk - it hands back every node ever allocated of that type -
     // so a pass that replaces a statement leaves everything under the old one visible forever. that is not
-    // merely untidy, it is expensive and occasionally wrong: `Monomorphizer::snapshot_calls` mints a generic
-    // instance per call it finds, `TypeLowering::build_function_maps`' second loop declares a symbol *and
+    // merely untidy, it is expensive and occasionally wrong: `Monomorphizer::instantiate_generic_calls` mints
+    // a generic instance per call it finds, `TypeLowering::build_function_maps`' second loop declares a symbol *and
     // queues a linkonce_odr body* per callee it finds, and `Monomorphizer::finalize_calls` will report an
     // unknown name against one. so a discarded `const if` arm still had its `operator []` emitted, and a
     // name it got wrong could still have failed the compile.
@@ -29,9 +29,10 @@ namespace AST
     void forget_subtree(Bundle &bundle, Node &root);
 
     // the collecting half, for a caller that discards more than one subtree before the arena has to be
-    // told. `NodeCollection::forget` is an erase-remove over every bucket of every module, so one call per
-    // subtree is one whole-arena sweep per subtree - and AST::ConstFolding discards one per `const if` and
-    // one per `const(...)`, on every round of the monomorphizer's fixpoint. the same obligation applies
+    // told. `NodeCollection::forget` asks every module's arena about every node it is handed, so one call
+    // per subtree is one pass over the modules per subtree - and AST::ConstFolding discards one per
+    // `const if` and one per `const(...)`, on every round of the monomorphizer's fixpoint. the same
+    // obligation applies
     void collect_subtree(Node &root, std::unordered_set<const Node *> &gone);
 
     // **a round's worth of discards, told to the arena once.**
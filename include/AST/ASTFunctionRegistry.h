@@ -5,9 +5,11 @@
 
 #include "AST/ASTCodeRef.h"
 #include "AST/ASTDeclarationSite.h"
+#include "AST/ASTFunctionMatcher.h"
 #include "AST/ASTValueType.h"
 #include "Token.h"
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -27,6 +29,28 @@ namespace AST
     // whether the field-wise constructor would duplicate one the user wrote
     bool signatures_match(const FunctionDeclNode *candidate, const std::vector<ValueType> &parameter_types);
 
+    // **what a free call's overload match depends on, besides the overload set itself**: the namespace
+    // the set was searched from, and each argument's type and AST::argument_shape. two calls with equal
+    // keys over one set are scored identically, argument by argument, so they resolve identically
+    struct MatchKey
+    {
+        const Namespace *ns = nullptr;
+        std::vector<ValueType> argument_types;
+        std::vector<uint8_t> argument_shapes;
+
+        static MatchKey of(
+            const Namespace &ns,
+            const std::vector<ValueType> &argument_types,
+            const std::vector<ExprNode *> &arguments);
+
+        bool operator==(const MatchKey &other) const = default;
+    };
+
+    struct MatchKeyHash
+    {
+        size_t operator()(const MatchKey &key) const;
+    };
+
     // the single store of function declarations, bundle-wide, keyed by namespace and name to a
     // *set* of overloads rather than to one declaration
     //
@@ -129,6 +153,34 @@ namespace AST
             const FunctionDeclNode *ignore = nullptr
         ) const;
 
+        // **from here on, remember what overload matches answered.** the monomorphizer asks the same
+        // call again every round and every instance of a template asks its body's calls again, so a
+        // free call over `str::from`'s two dozen overloads was scored against every one of them each
+        // time. off until then, because a match also reads what the parse is still declaring - a
+        // type's `#[implicit]` conversions, its conformances - and nothing but a new overload would
+        // tell a remembered answer it had gone stale
+        void remember_matches() {
+            _remembering = true;
+        }
+
+        // the match remembered for `name` under `key`, or null - always null before remember_matches.
+        // a remembered match outlives nothing but the next overload registered under `name`, which
+        // forgets every match that name had
+        const FunctionMatch *recall_match(const std::string &name, const MatchKey &key);
+
+        void remember_match(const std::string &name, MatchKey key, FunctionMatch match);
+
+        // how often recall_match answered and how often it could not, for `--explain time`
+        struct MatchCounts
+        {
+            size_t hits = 0;
+            size_t misses = 0;
+        };
+
+        inline MatchCounts match_counts() const {
+            return _match_counts;
+        }
+
         // every registered declaration, in declaration order
         inline const std::vector<FunctionDeclNode *> &get_all() const {
             return _functions;
@@ -170,6 +222,12 @@ namespace AST
         // FunctionDeclNode::declaration_site_token()'s answer: the name token for anything the user
         // named, its own `constructor` keyword for a constructor
         std::unordered_map<DeclarationSite, FunctionDeclNode *, DeclarationSiteHash> _by_decl_site;
+
+        // by name first, so registering an overload forgets exactly the matches it could change: the
+        // set searched outward from *any* namespace may now stop at the one it was added to
+        bool _remembering = false;
+        std::unordered_map<std::string, std::unordered_map<MatchKey, FunctionMatch, MatchKeyHash>> _matches;
+        MatchCounts _match_counts;
     };
 };
 
@@ -86,6 +86,17 @@ namespace AST
 
         TokenizedFile tokenize(Lexer &lexer, File &file, const TokenFilter &filter = nullptr);
 
+        // `file`'s slice of `tokens`, for tokens something other than tokenize put there - a module read
+        // back from its token store, see Parser::read_module_tokens. **the caller vouches for the
+        // range**: nothing here can tell a slice that is this file's from one that is not
+        TokenizedFile adopt_tokenized_file(File &file, size_t start, size_t end);
+
+        // `file`'s slice of `tokens`, for tokens that were lexed somewhere else and appended from `from`
+        // onwards *unfiltered* - the embedded standard library, see AST::load_embedded_module. Runs `filter`
+        // over the tail first, exactly as tokenize does after its lexer, and throws TokenFilterException the
+        // same way
+        TokenizedFile filter_tokenized_file(File &file, size_t from, const TokenFilter &filter);
+
         bool is_owner_of(const TokenReference &tokenref) const {
             return tokenref.belongs_to(tokens);
         }
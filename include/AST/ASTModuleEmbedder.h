@@ -5,8 +5,41 @@
 
 #include "AST/ASTModule.h"
 
+#include <string_view>
+#include <tuple>
+#include <vector>
+
 namespace AST
 {
+    // writes `module` as a header a binary can carry it in: a byte array holding every file's content and
+    // the tokens the lexer makes of it, and an accessor named after the module - `stdlib_module_blob()`.
+    //
+    // **the tokens before the conditional filter**, not after. The filter answers `#[if: os == ...]` against
+    // the target of the compile that loads the module, and a released binary cross-compiles: tokens filtered
+    // for the machine that generated the header would be the wrong standard library for every other target.
+    // So the lexing is what gets shipped and the filter still runs at load, per invocation, which is cheap -
+    // it erases, it does not lex.
+    //
+    // the content travels too, although nothing lexes it again: a diagnostic that notes a declaration inside
+    // the standard library underlines a line of its source, and a released binary has nowhere else to read it
+    // from.
+    //
+    // **byte-for-byte reproducible** from the same sources, since CI compares a freshly generated header
+    // against the committed one: nothing that varies between two runs - a path on this machine, a pid, a
+    // time - is written into it
     void write_embedded_module(AST::Module &module, const std::string &output_path);
+
+    // fills `module` - which must hold no file and no token yet - from a blob write_embedded_module
+    // generated, running `filter` over each file's tokens as Module::tokenize would. The files, in the order
+    // the three passes walk them.
+    //
+    // the blob's format version is checked against ECO_MODULE_TOKENS_VERSION, and a blob from another
+    // compiler - or one that does not decode - is a std::runtime_error saying to regenerate it. The header
+    // already refuses to compile against a mismatched compiler; this is the same check for a blob that got
+    // here some other way
+    std::vector<std::tuple<File *, TokenizedFile>> load_embedded_module(
+        AST::Module &module,
+        std::string_view blob,
+        const Module::TokenFilter &filter);
 };
 #endif
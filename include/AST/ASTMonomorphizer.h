@@ -26,6 +26,7 @@ namespace AST
 {
     class FunctionDeclNode;
     class FunctionCallExprNode;
+    class VarDeclNode;
 
     // resolves every generic use in the bundle into concrete instances before codegen
     // a generic function call is instantiated by cloning its template with concrete type
@@ -43,8 +44,9 @@ namespace AST
 
         // a human-readable dump of what monomorphization produced: every concrete instance created,
         // every call site rewired to an instance, and every struct instantiation interned. reuses
-        // the same type descriptions as --print-ast so the two can be cross-checked. drives
-        // --print-instances; call after run().
+        // the same type descriptions as --print-ast so the two can be cross-checked - and how many
+        // rounds the fixpoint took, with what each one visited. drives --print instances; call after
+        // run().
         std::string debug_dump_instances() const;
 
     private:
@@ -144,9 +146,57 @@ namespace AST
         FunctionDeclNode *get_or_create_function_instance(FunctionDeclNode *tmpl, const std::vector<ValueType> &args);
 
         // every call in the bundle, snapshotted before anything is instantiated - cloning appends to
-        // the very collections this walks
+        // the very collections this walks. only for the two sweeps that run once: the rounds work from
+        // the worklists below
         std::vector<std::pair<FunctionCallExprNode *, Module *>> snapshot_calls();
 
+        // **the nodes of one kind a step of the fixpoint still owes something**, per module and in the
+        // order the arena made them - the order a sweep over `of_type` visits them in, so a step moved
+        // onto one of these changes which nodes it looks at and never the order it acts on them.
+        //
+        // a node joins when it is allocated, which is how a cloned body's calls reach the next step
+        // without anybody enqueueing them, and leaves once the step can never owe it anything again or
+        // the arena has forgotten it. so a round costs what is still open plus what the last one made,
+        // rather than every call in the bundle - most of which settled in the round they appeared in
+        template <typename T>
+        struct Worklist
+        {
+            struct Lane
+            {
+                Module *module;
+
+                // NodeCollection::size() at the last refresh, so the next one reads only what came after
+                size_t seen = 0;
+
+                std::vector<T *> open;
+            };
+
+            // one per module, in the bundle's order
+            std::vector<Lane> lanes;
+        };
+
+        // calls not yet terminal - what steps A and C visit
+        Worklist<FunctionCallExprNode> _open_calls;
+
+        // declarations whose type is not determined yet - what step B visits
+        Worklist<VarDeclNode> _stale_decls;
+
+        // brings a worklist up to date: admits what was allocated since the last refresh, and drops what
+        // is `done` or forgotten. answers how many nodes it admitted
+        template <typename T, typename Done>
+        size_t refresh(Worklist<T> &list, Done done);
+
+        // what one round of the fixpoint visited, for --print instances: the whole point of the
+        // worklists is that these track what changed and not the size of the program
+        struct RoundWork
+        {
+            size_t calls_admitted = 0;
+            size_t calls_visited = 0;
+            size_t decls_visited = 0;
+        };
+
+        std::vector<RoundWork> _rounds;
+
         // one round's steps, in the order they have to run in - see the comments on each
         bool instantiate_generic_calls(size_t round);
         bool rederive_stale_variable_types();
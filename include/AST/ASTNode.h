@@ -3,14 +3,20 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
 #include <memory>
-#include <typeindex>
 #include <unordered_map>
 #include <unordered_set>
 #include <algorithm>
+#include <cstddef>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
 
+#include "AST/ASTNodeArena.h"
 #include "AST/ASTNodeTypes.h"
 #include "AST/ASTNodeReference.h"
 #include "AST/ASTVisitor.h"
@@ -52,115 +58,152 @@ namespace AST
         return node ? NodeReference(node->get_node_type(), node) : make_void_ref();
     }
 
-    typedef std::vector<std::unique_ptr<Node>> NodeList;
-
-
-    // node collection is just a wrapper around a node list
+    // node collection is a module's nodes: the arena they live in, and the index `of_type` answers from
     class NodeCollection
     {
-        std::unique_ptr<NodeList> nodes = std::make_unique<NodeList>();
+        NodeArena arena;
+
+        // every node ever allocated here, in the order it was. **what teardown walks** - the arena knows
+        // bytes and not nodes - and what `size` counts, so a forgotten node is still in it
+        std::vector<Node *> nodes;
+
+        // one bucket per node kind, at node_type_index of its tag: `of_type<T>` is an array index known at
+        // compile time rather than a hash of a `typeid`. Mutable for the same reason `dirty` is - see forget
+        mutable std::array<std::vector<Node *>, node_type_count> buckets;
 
-        std::unordered_map<std::type_index, std::vector<Node *>> node_map;
+        // which buckets still hold a node `forget` was told about, and every node it was told about. the set
+        // is kept after the sweep has run, because `is_forgotten` answers from it too
+        mutable std::array<bool, node_type_count> dirty {};
+        std::unordered_set<const Node *> forgotten;
+
+        // the erase-remove `forget` put off, for one kind
+        void sweep(size_t kind) const;
     public:
+        NodeCollection() = default;
+
+        NodeCollection(const NodeCollection &) = delete;
+        NodeCollection &operator=(const NodeCollection &) = delete;
+
+        // a moved-from collection holds no node, so the one destructor that runs them is the new owner's.
+        // No move *assignment*: overwriting a collection would have to run the destructors of everything in
+        // it first, and nothing replaces a module's nodes wholesale
+        NodeCollection(NodeCollection &&other) noexcept :
+            arena(std::move(other.arena)),
+            nodes(std::exchange(other.nodes, {})),
+            buckets(std::exchange(other.buckets, {})),
+            dirty(std::exchange(other.dirty, {})),
+            forgotten(std::exchange(other.forgotten, {}))
+        {}
+
+        NodeCollection &operator=(NodeCollection &&) = delete;
+
+        ~NodeCollection();
+
+        // **for a process that is about to exit.** Every collection destroyed after this returns its blocks
+        // without running a single node's destructor: the strings, vectors and types a tree holds go back to
+        // the system with the process rather than one `delete` at a time, which for a large program was a
+        // visible pause between the last line of output and the shell prompt.
+        //
+        // only the driver calls it, and only on the path that returns from `main` next - a compiler that
+        // outlives its bundle would leak every tree it dropped. A no-op under AddressSanitizer, whose leak
+        // check would rightly report every one of them
+        static void skip_teardown();
 
         // emplace back
         template <typename T, typename... Args>
             requires NodeTypeProvider<T>
         inline T &emplace_back(Args&&... args) {
-            auto node = std::make_unique<T>(std::forward<Args>(args)...);
-            auto &node_ref = *node;
-            nodes->push_back(std::move(node));
+            static_assert(alignof(T) <= alignof(std::max_align_t), "a node over-aligned for the arena");
+
+            // the bucket is picked by `T::node_type` and `forget` finds it again by get_node_type(), so the
+            // two must be one answer: a kind that inherited its tag from another would be filed under the
+            // other's bucket and swept from its own. ECO_AST_NODE_TYPE declares both together, and this
+            // catches a class that forgot to
+            static_assert(std::is_same_v<decltype(&T::get_node_type), NodeType (T::*)() const>,
+                "a node kind must declare its own tag with ECO_AST_NODE_TYPE");
+
+            T *node = new (arena.allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            nodes.push_back(node);
 
-            // store a reference to the node in the node map for the type
-            node_map[typeid(T)].push_back(&node_ref);
+            buckets[node_type_index(T::node_type)].push_back(node);
 
-            return node_ref;
+            return *node;
         }
 
+        // every node of kind `T` allocated here and not forgotten, in the order they were
         template <typename T>
             requires NodeTypeProvider<T>
         inline const std::vector<T *> &of_type() const {
-            static const std::vector<T *> empty;
-            auto it = node_map.find(std::type_index(typeid(T)));
-            if (it != node_map.end()) {
-                return reinterpret_cast<const std::vector<T *> &>(it->second);
+            constexpr size_t kind = node_type_index(T::node_type);
+
+            if (dirty[kind]) {
+                sweep(kind);
             }
-            return empty;
+
+            return reinterpret_cast<const std::vector<T *> &>(buckets[kind]);
         }
 
         inline size_t size() const {
-            return nodes->size();
+            return nodes.size();
+        }
+
+        // every node allocated here from position `from` on, where `from` is something `size` answered
+        // earlier - forgotten ones included, since `nodes` never loses one. what lets a caller that has
+        // seen a collection once look at only what was added since, rather than at a whole bucket again
+        inline std::span<Node *const> since(size_t from) const {
+            return std::span<Node *const>(nodes).subspan(from);
         }
 
-        // **stop answering for these nodes.** the unique_ptrs stay in `nodes`, so every pointer anything
-        // still holds stays valid - what changes is only what `of_type` reports.
+        // was this node handed to `forget`. what `of_type` already answers for a bucket, for a caller
+        // holding a node it found some other way
+        inline bool is_forgotten(const Node *node) const {
+            return forgotten.count(node) > 0;
+        }
+
+        // **stop answering for these nodes.** they stay in the arena and in `nodes`, so every pointer
+        // anything still holds stays valid - what changes is only what `of_type` reports.
         //
         // it exists because that answer was wrong for a subtree no scope holds any more, and because the
         // sweeps reading it are the expensive ones. `of_type` is not a tree walk, so a pass that replaces
-        // a statement leaves everything under the old one visible forever: Monomorphizer::snapshot_calls
-        // mints a generic instance per call it finds, TypeLowering::build_function_maps' second loop
+        // a statement leaves everything under the old one visible forever: the monomorphizer's rounds
+        // mint a generic instance per call they find, TypeLowering::build_function_maps' second loop
         // declares a symbol and **queues a linkonce_odr body** per callee it finds, and
         // Monomorphizer::finalize_calls will happily report an unknown name against one. so an arm
         // AST::ConstFolding discarded still had its callees emitted, and could still fail the compile.
         //
         // **order-preserving, and that is load-bearing**: `of_type` order is insertion order, and it decides
-        // the order codegen declares functions in - IR goldens name symbols by position - so this is an
+        // the order codegen declares functions in - IR goldens name symbols by position - so the sweep is an
         // erase-remove and never a swap-and-pop.
         //
         // **the obligation this creates**: forgetting a node the tree still holds makes a live call
         // invisible, which is a missing symbol at link time. so a caller must walk exactly what is going
-        // away, which is why the passes that discard release each subtree they keep *before* collecting
-        // **only the buckets these nodes are actually in.** the sweep is an erase-remove over a bucket
-        // and the arena has one per node kind ever allocated, so touching them all costs a pass over
-        // every node in the program - and both rewriting passes inside the monomorphizer's fixpoint
-        // flush a batch per round, to remove a handful of nodes of five or six kinds.
+        // away, which is why the passes that discard release each subtree they keep *before* collecting.
         //
-        // the *dynamic* type is the key, and it is the same one the node was filed under: emplace_back
-        // requires NodeTypeProvider<T> and constructs a `T`, so every bucket is keyed by a concrete
-        // leaf kind and `typeid(*node)` cannot name a different one. that identity is what keeps this
-        // total - under-collecting here is the silent direction, a live call left visible after its
-        // statement went away
-        static std::unordered_set<std::type_index> kinds_of(const std::unordered_set<const Node *> &gone) {
-            std::unordered_set<std::type_index> kinds;
-
-            for (const Node *node : gone) {
-                if (node != nullptr) {
-                    kinds.insert(std::type_index(typeid(*node)));
-                }
-            }
-
-            return kinds;
-        }
-
+        // **linear in `gone` and not in the arena**: this only notes each node this arena owns and marks its
+        // kind's bucket, and the erase-remove waits for the next `of_type` of that kind. Both rewriting passes
+        // inside the monomorphizer's fixpoint flush a batch per round, to remove a handful of nodes, and a
+        // kind nobody asks for again is never swept at all. Nodes owned by another module's arena are skipped,
+        // so Bundle::forget_nodes can hand every module the whole batch.
+        //
+        // which leaves `of_type` writing through a const collection, so **two threads may not read one
+        // collection while a forget is pending** - a pass that wants to calls `settle` first, as codegen's
+        // lanes do
         void forget(const std::unordered_set<const Node *> &gone) {
-            forget(gone, kinds_of(gone));
-        }
-
-        // the same, for a caller sweeping every module of a bundle: the set of kinds is a property of
-        // `gone` and not of the arena, so deriving it once and handing it down is one `typeid` pass
-        // instead of one per module
-        void forget(
-            const std::unordered_set<const Node *> &gone,
-            const std::unordered_set<std::type_index> &kinds) {
-            if (gone.empty()) {
-                return;
-            }
-
-            for (const auto &kind : kinds) {
-                const auto found = node_map.find(kind);
-
-                if (found == node_map.end()) {
+            for (const Node *node : gone) {
+                if (node == nullptr || !arena.owns(node)) {
                     continue;
                 }
 
-                auto &bucket = found->second;
-
-                bucket.erase(
-                    std::remove_if(bucket.begin(), bucket.end(),
-                        [&gone](Node *node) { return gone.count(node) > 0; }),
-                    bucket.end());
+                if (forgotten.insert(node).second) {
+                    dirty[node_type_index(node->get_node_type())] = true;
+                }
             }
         }
+
+        // **every sweep `forget` put off, now**, so `of_type` writes nothing until the next forget. What a
+        // caller about to read this collection from several threads at once runs first - see
+        // LLVMCompiler::lower_in_lanes
+        void settle() const;
     };
 };
 
@@ -0,0 +1,81 @@
+#ifndef ASTNODEARENA_H
+#define ASTNODEARENA_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace AST
+{
+    // the memory every node of one module lives in: a list of large blocks, handed out front to back.
+    //
+    // **a node is never freed on its own**, which is what makes this cheaper than `new`: a module's nodes
+    // live exactly as long as the module, since NodeCollection::forget only stops answering for a node and
+    // every pointer into the tree stays valid until the bundle goes. So an allocation is a bump of one
+    // pointer, and the whole module is returned in a handful of `free`s rather than one `delete` per node -
+    // of which the monomorphizer's clones alone are hundreds of thousands in a large program.
+    //
+    // raw memory and nothing else. Constructing into it and running destructors is NodeCollection's job,
+    // because only it knows which of the bytes handed out are which node
+    class NodeArena
+    {
+    public:
+        NodeArena() = default;
+
+        NodeArena(const NodeArena &) = delete;
+        NodeArena &operator=(const NodeArena &) = delete;
+
+        // a moved-from arena owns no block and hands out fresh ones, so a module moved into a collection
+        // leaves nothing behind that could be freed twice
+        NodeArena(NodeArena &&other) noexcept;
+        NodeArena &operator=(NodeArena &&other) noexcept;
+
+        // `size` bytes at `align`, valid until the arena is destroyed
+        inline void *allocate(size_t size, size_t align) {
+            uintptr_t at = (reinterpret_cast<uintptr_t>(_cursor) + (align - 1)) & ~(uintptr_t)(align - 1);
+
+            if (_cursor == nullptr || at + size > reinterpret_cast<uintptr_t>(_end)) {
+                return allocate_slow(size, align);
+            }
+
+            _cursor = reinterpret_cast<std::byte *>(at + size);
+            return reinterpret_cast<void *>(at);
+        }
+
+        // is `ptr` inside one of this arena's blocks. A bundle's modules each have an arena and a node
+        // carries no note of which one made it, so this is how NodeCollection::forget tells its own nodes
+        // from the rest of a batch - a binary search over the blocks, which are few
+        bool owns(const void *ptr) const;
+
+        // how many bytes the blocks hold between them, handed out or not
+        size_t reserved_bytes() const {
+            return _reserved;
+        }
+
+    private:
+        // sized so that a block is a few hundred nodes - the largest node kinds are a few hundred bytes - and
+        // small enough that a module holding one file's worth of nodes does not reserve much past it
+        static constexpr size_t k_block_size = 64 * 1024;
+
+        std::vector<std::unique_ptr<std::byte[]>> _blocks;
+
+        // every block's [begin, end), sorted by address rather than in the order they were made - `owns`
+        // searches this and never the blocks themselves
+        std::vector<std::pair<const std::byte *, const std::byte *>> _ranges;
+
+        std::byte *_cursor = nullptr;
+        std::byte *_end = nullptr;
+        size_t _reserved = 0;
+
+        // a new block, or one of its own for an allocation larger than a block
+        void *allocate_slow(size_t size, size_t align);
+
+        std::byte *add_block(size_t size);
+    };
+};
+
+#endif
@@ -4,8 +4,72 @@
 #pragma once
 
 #include <concepts>
+#include <cstddef>
 #include <type_traits>
 
+// every node kind, once. **the one list**: the NodeType enum below is generated from it, and so is the
+// count NodeCollection sizes its per-kind index by - a kind added here is a kind that has a bucket, with
+// nothing else to keep in step
+#define ECO_AST_NODE_TYPES(X) \
+    X(n_void) \
+    X(n_null) \
+    X(n_scope) \
+    X(n_operator) \
+    X(n_literal) \
+    X(n_literal_float) \
+    X(n_literal_int) \
+    X(n_literal_bool) \
+    X(n_literal_string) \
+    X(n_string_interpolation) \
+    X(n_expr_static_property) \
+    X(n_vardecl) \
+    X(n_const_decl) \
+    X(n_var) \
+    X(n_varref) \
+    X(n_assign) \
+    X(n_type) \
+    X(n_type_cast) \
+    X(n_expr_binary) \
+    X(n_expr_unary) \
+    X(n_expr_call) \
+    X(n_expr_addrof) \
+    X(n_expr_deref) \
+    X(n_expr_peel) \
+    X(n_expr_move) \
+    X(n_expr_index) \
+    X(n_expr_array_literal) \
+    X(n_expr_void) \
+    X(n_expr_class_alloc) \
+    X(n_expr_retain) \
+    X(n_expr_strong) \
+    X(n_expr_null_coalesce) \
+    X(n_expr_optional_chain) \
+    X(n_expr_chain_base) \
+    X(n_expr_closure) \
+    X(n_expr_indirect_call) \
+    X(n_expr_function_ref) \
+    X(n_expr_instanceof) \
+    X(n_expr_temp_bind) \
+    X(n_expr_match) \
+    X(n_expr_const_ref) \
+    X(n_expr_const) \
+    X(n_release) \
+    X(n_func_decl) \
+    X(n_func_return) \
+    X(n_if_statement) \
+    X(n_const_if) \
+    X(n_guard) \
+    X(n_while_statement) \
+    X(n_for_statement) \
+    X(n_loop_control) \
+    X(n_foreach) \
+    X(n_namespace_decl) \
+    X(n_use_decl) \
+    X(n_namespace) \
+    X(n_attribute) \
+    X(n_type_decl) \
+    X(n_member_access)
+
 namespace AST
 {
     class Node;
@@ -13,66 +77,21 @@ namespace AST
     // node type enum
     enum class NodeType
     {
-        n_void,
-        n_null,
-        n_scope,
-        n_operator,
-        n_literal,
-        n_literal_float,
-        n_literal_int,
-        n_literal_bool,
-        n_literal_string,
-        n_string_interpolation,
-        n_expr_static_property,
-        n_vardecl,
-        n_const_decl,
-        n_var,
-        n_varref,
-        n_assign,
-        n_type,
-        n_type_cast,
-        n_expr_binary,
-        n_expr_unary,
-        n_expr_call,
-        n_expr_addrof,
-        n_expr_deref,
-        n_expr_peel,
-        n_expr_move,
-        n_expr_index,
-        n_expr_array_literal,
-        n_expr_void,
-        n_expr_class_alloc,
-        n_expr_retain,
-        n_expr_strong,
-        n_expr_null_coalesce,
-        n_expr_optional_chain,
-        n_expr_chain_base,
-        n_expr_closure,
-        n_expr_indirect_call,
-        n_expr_function_ref,
-        n_expr_instanceof,
-        n_expr_temp_bind,
-        n_expr_match,
-        n_expr_const_ref,
-        n_expr_const,
-        n_release,
-        n_func_decl,
-        n_func_return,
-        n_if_statement,
-        n_const_if,
-        n_guard,
-        n_while_statement,
-        n_for_statement,
-        n_loop_control,
-        n_foreach,
-        n_namespace_decl,
-        n_use_decl,
-        n_namespace,
-        n_attribute,
-        n_type_decl,
-        n_member_access,
+#define ECO_AST_NODE_TYPE_ENUMERATOR(kind) kind,
+        ECO_AST_NODE_TYPES(ECO_AST_NODE_TYPE_ENUMERATOR)
+#undef ECO_AST_NODE_TYPE_ENUMERATOR
     };
 
+    // how many kinds there are, as a constant: NodeCollection keeps one bucket per kind in a flat array,
+    // indexed by the kind itself
+#define ECO_AST_NODE_TYPE_COUNT_ONE(kind) + 1
+    constexpr size_t node_type_count = 0 ECO_AST_NODE_TYPES(ECO_AST_NODE_TYPE_COUNT_ONE);
+#undef ECO_AST_NODE_TYPE_COUNT_ONE
+
+    constexpr size_t node_type_index(NodeType type) {
+        return static_cast<size_t>(type);
+    }
+
     template<typename T>
     concept NodeTypeProvider = std::is_base_of_v<Node, T> && requires {
         { T::node_type } -> std::same_as<const NodeType&>;
@@ -340,15 +340,15 @@ namespace AST
         // deliberately NOT idempotent - make_pointer(make_pointer(int32)) is ptr<ptr<int32>>
         static ValueType make_pointer(ValueType pointee, bool nullable) {
             ValueType type(ValueTypeKind::t_pointer, ValueTypePrimitive::t_void);
-            type._pointee = std::make_shared<const ValueType>(std::move(pointee));
+            type._pointee = intern(pointee);
             if (nullable) {
                 type.type_flags |= static_cast<uint8_t>(ValueTypeFlags::t_nullable);
             }
             return type;
         }
 
-        // `weak<Foo>`. the target is held in the same shared_ptr slot a pointee is, for the same reason:
-        // this is a recursive kind, and nothing about it needs interning to compare
+        // `weak<Foo>`. the target is held in the same interned slot a pointee is, for the same reason:
+        // this is a recursive kind with no identity beyond what it names
         //
         // asserts its target is a class or a type parameter - a weak reference over anything else is
         // meaningless, since nothing else is counted. the *diagnostic* for a written `weak<int32>` is the
@@ -357,12 +357,12 @@ namespace AST
             assert((class_type.is_class() || class_type.is_type_param())
                 && "a weak reference is only meaningful over a counted type");
             ValueType type(ValueTypeKind::t_weak, ValueTypePrimitive::t_void);
-            type._pointee = std::make_shared<const ValueType>(std::move(class_type));
+            type._pointee = intern(class_type);
             return type;
         }
 
-        // `function<R(P...)>`. the signature is shared rather than interned, so equality is structural
-        // all the way down - see CallableSignature
+        // `function<R(P...)>`. the signature is interned like a pointee, so two separately written
+        // `function<void(int32)>`s hold the one record - see CallableSignature
         static ValueType make_callable(ValueType return_type, std::vector<ValueType> parameter_types);
         static ValueType make_c_function(ValueType return_type, std::vector<ValueType> parameter_types);
 
@@ -667,14 +667,16 @@ namespace AST
                     return primitive == other.primitive;
 
                 // a pointer is structural: same nullability (already covered by the flag check
-                // above) and the same pointee, all the way down
+                // above) and the same pointee, all the way down. **which is one pointer compare**,
+                // because the pointee is interned - two equal pointees are the one record, so the
+                // walk down happened once, when the record was made
                 //
                 // a weak shares the arm because it shares the representation - one recursive level in
                 // `_pointee` - and structural equality is right for the same reason: `weak<Foo>` carries
                 // no identity beyond the class it names
                 case ValueTypeKind::t_pointer:
                 case ValueTypeKind::t_weak:
-                    return *_pointee == *other._pointee;
+                    return _pointee == other._pointee;
 
                 // for struct, class, interface and enum types, compare the complex type pointers
                 // two named types are equal if they point to the same ComplexType, so an
@@ -685,13 +687,13 @@ namespace AST
                 case ValueTypeKind::t_enum:
                     return _complex_type == other._complex_type;
 
-                // structural, like a pointer: a signature carries no identity of its own, so two
-                // separately written `function<void(int32)>`s are one type. a C function pointer
-                // shares the comparison and not the kind, so `function<void()>` and
+                // structural, like a pointer, and interned like one: a signature carries no identity
+                // of its own, so two separately written `function<void(int32)>`s are one record. a C
+                // function pointer shares the comparison and not the kind, so `function<void()>` and
                 // `extern function<void()>` stay distinct
                 case ValueTypeKind::t_callable:
                 case ValueTypeKind::t_c_function:
-                    return signatures_are_equal(*this, other);
+                    return _signature == other._signature;
 
                 // identity is the declaration itself, mirroring how struct/class compare their
                 // ComplexType. so the T of `struct Box<T>` is not the A of `struct Pair<A, B>`
@@ -715,37 +717,52 @@ namespace AST
         std::string get_type_desciption() const;
 
     private:
-        // operator== is inline and CallableSignature is not complete there, so the comparison is one
-        // hop out of line. keeping operator== in the header is worth the hop: it is on the hot path of
-        // every overload match and every interning lookup
-        static bool signatures_are_equal(const ValueType &a, const ValueType &b);
+        // **the one record of each distinct pointee and signature.** equal in, same address out, and
+        // never freed - a record is a few words, and a program has as many as it has distinct
+        // `ptr<...>` and `function<...>` spellings, which is nowhere near the number of copies of them.
+        //
+        // it is what keeps the recursive kinds as cheap as the flat ones: a ValueType holds a plain
+        // pointer to its level below, so a copy is a copy of a few words with no count to move, and
+        // equality and hashing stop at that pointer rather than walking down to the leaves. the walk
+        // still happens, once per distinct type, inside the lookup that finds the record.
+        //
+        // process-wide and behind a lock rather than on TypeRegistry, because make_pointer and
+        // make_callable are called from everywhere - most of them with no registry in reach - and a
+        // type made against one registry is routinely compared with one made against another
+        static const ValueType *intern(const ValueType &type);
+        static const CallableSignature *intern(CallableSignature signature);
 
         // defaulted so a default-constructed ValueType is a well-defined `unknown`
         // rather than carrying indeterminate kind/primitive
         ValueTypeKind kind = ValueTypeKind::t_unknown;
         ValueTypePrimitive primitive = ValueTypePrimitive::t_void;
         uint8_t type_flags = 0;
-        ComplexType *_complex_type = nullptr;
-
-        // for the t_generic kind: the declaration this type refers to. a pointer rather than an
-        // ordinal, so the parameter's name, constraint and declaration site travel with every
-        // use of it, and so parameters of different owners are distinct types
-        const TypeParamDecl *_type_param = nullptr;
-
-        // for the t_pointer kind: the type one level down. shared rather than interned because
-        // a pointer carries no state beyond its pointee, so structural equality is enough -
-        // unlike ComplexType, which is a mutable, property-carrying object that must be shared
-        // by identity. shared_ptr keeps ValueType cheap to copy, which everything relies on
-        //
-        // also the t_weak kind's target, which is the same shape of question - one recursive level with
-        // no identity of its own. reached through weak_target() rather than pointee(), so a reader
-        // cannot cross from one kind to the other without saying which it meant
-        std::shared_ptr<const ValueType> _pointee = nullptr;
 
-        // for the t_callable and t_c_function kinds: the signature. shared and structurally
-        // compared, for the same reason _pointee is. the *signature* is the same question; the
-        // calling shape is the kind
-        std::shared_ptr<const CallableSignature> _signature = nullptr;
+        // what the kind refers to, and never more than one of them - so one slot, and a ValueType is
+        // the size of two pointers
+        union
+        {
+            // for the named kinds: struct, class, interface and enum
+            ComplexType *_complex_type = nullptr;
+
+            // for the t_generic kind: the declaration this type refers to. a pointer rather than an
+            // ordinal, so the parameter's name, constraint and declaration site travel with every
+            // use of it, and so parameters of different owners are distinct types
+            const TypeParamDecl *_type_param;
+
+            // for the t_pointer kind: the type one level down, interned - see `intern`. unlike
+            // ComplexType, which is a mutable, property-carrying object shared by identity, a pointer
+            // carries no state beyond its pointee, so the record is found by structure.
+            //
+            // also the t_weak kind's target, which is the same shape of question - one recursive level with
+            // no identity of its own. reached through weak_target() rather than pointee(), so a reader
+            // cannot cross from one kind to the other without saying which it meant
+            const ValueType *_pointee;
+
+            // for the t_callable and t_c_function kinds: the signature, interned for the same reason
+            // _pointee is. the *signature* is the same question; the calling shape is the kind
+            const CallableSignature *_signature;
+        };
 
         ValueType(ValueTypeKind kind, ValueTypePrimitive primitive) : kind(kind), primitive(primitive) {}
         ValueType(ValueTypeKind kind, ComplexType *complex_type) :
@@ -757,11 +774,15 @@ namespace AST
             kind(kind), primitive(ValueTypePrimitive::t_void), _type_param(param) {}
     };
 
-    // held by shared_ptr off a ValueType and compared *structurally*, for the reason the pointee is:
-    // it carries no mutable state and no identity of its own, so two independently written
-    // `function<void(int32)>`s have to be one type or a callback could never be passed anywhere. that
-    // is the whole difference from ComplexType, which is shared by pointer identity because it is a
-    // mutable, property-carrying object
+    // what interning the recursive levels buys, held to: a ValueType is copied into every match candidate,
+    // every substitution and every node's result, and with no count to move a copy is a copy of its bytes
+    static_assert(std::is_trivially_copyable_v<ValueType>);
+
+    // interned off a ValueType and found *structurally*, for the reason the pointee is: it carries no
+    // mutable state and no identity of its own, so two independently written `function<void(int32)>`s
+    // have to be one type or a callback could never be passed anywhere. that is the whole difference
+    // from ComplexType, which is shared by pointer identity because it is a mutable, property-carrying
+    // object
     struct CallableSignature
     {
         ValueType return_type;
@@ -773,16 +794,14 @@ namespace AST
     inline ValueType ValueType::make_callable(ValueType return_type, std::vector<ValueType> parameter_types)
     {
         ValueType type(ValueTypeKind::t_callable, ValueTypePrimitive::t_void);
-        type._signature = std::make_shared<const CallableSignature>(
-            CallableSignature { std::move(return_type), std::move(parameter_types) });
+        type._signature = intern(CallableSignature { std::move(return_type), std::move(parameter_types) });
         return type;
     }
 
     inline ValueType ValueType::make_c_function(ValueType return_type, std::vector<ValueType> parameter_types)
     {
         ValueType type(ValueTypeKind::t_c_function, ValueTypePrimitive::t_void);
-        type._signature = std::make_shared<const CallableSignature>(
-            CallableSignature { std::move(return_type), std::move(parameter_types) });
+        type._signature = intern(CallableSignature { std::move(return_type), std::move(parameter_types) });
         return type;
     }
 
@@ -792,18 +811,6 @@ namespace AST
         return *_signature;
     }
 
-    inline bool ValueType::signatures_are_equal(const ValueType &a, const ValueType &b)
-    {
-        // one signature shared by both, which is what a copy of a ValueType produces - and a copy is
-        // how nearly every comparison gets its operands. the structural compare below is recursive over
-        // the return type and every parameter, so short-circuiting it is worth a pointer test
-        if (a._signature == b._signature) {
-            return true;
-        }
-
-        return a.signature() == b.signature();
-    }
-
     class ComplexType
     {
     public:
@@ -1373,21 +1380,13 @@ namespace std
             if (vt.is_primitive()) h ^= static_cast<size_t>(vt.get_primitive_type());
             else if (vt.has_complex_type()) h ^= reinterpret_cast<size_t>(vt.get_complex_type());
             else if (vt.is_type_param()) h ^= reinterpret_cast<size_t>(vt.get_type_param());
-            // mixed rather than xor'd: a bare xor of the pointee hash would make ptr<int32>
-            // collide with int32, since the primitive component is identical
-            else if (vt.is_pointer()) h ^= (*this)(vt.pointee()) + 0x9e3779b9 + (h << 6) + (h >> 2);
-            // the same mix over the class it names. the kind is already in `h`, so `weak<Foo>` and
-            // `ptr<Foo>` do not collide despite hashing one recursive level the same way
-            else if (vt.is_weak()) h ^= (*this)(vt.weak_target()) + 0x9e3779b9 + (h << 6) + (h >> 2);
-            // structural, so the hash has to be too - mixed for the reason above, and over the
-            // return type as well as the parameters, since `function<int32()>` and
-            // `function<void()>` differ only there
-            else if (vt.has_signature()) {
-                h ^= (*this)(vt.signature().return_type) + 0x9e3779b9 + (h << 6) + (h >> 2);
-                for (const auto &param : vt.signature().parameter_types) {
-                    h ^= (*this)(param) + 0x9e3779b9 + (h << 6) + (h >> 2);
-                }
-            }
+            // the interned record, and mixed rather than xor'd: the kind is already in `h`, so
+            // `weak<Foo>` and `ptr<Foo>` do not collide despite naming one record, and a bare xor
+            // would leave the two levels' bits free to cancel
+            else if (vt.is_pointer() || vt.is_weak()) h ^= reinterpret_cast<size_t>(vt._pointee) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            // the same for a signature: equal signatures are the one record, so its address is the
+            // structure, return type and parameters both
+            else if (vt.has_signature()) h ^= reinterpret_cast<size_t>(vt._signature) + 0x9e3779b9 + (h << 6) + (h >> 2);
             return h;
         }
     };
@@ -3,9 +3,11 @@
 
 #pragma once
 
+#include "Compiler/SharedStore.h"
 #include "Parser/ManifestParser.h"
 
 #include <filesystem>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -140,6 +142,42 @@ namespace Compiler
 
         std::filesystem::path scratch_object(const std::string &module_name) const;
 
+        // the machine-wide store behind the per-module ones, when `ECO_CACHE_DIR` names one - see
+        // Compiler::SharedStore. Read once, here, for the reason everything else on this class is
+        const std::optional<SharedStore> &shared_store() const {
+            return _shared_store;
+        }
+
+        // where a linked program is kept under its key, for a later `echoc run` of the same inputs to start
+        // instead of compiling - see Compiler::compute_program_key. In the entry module's own directory, and
+        // **empty for a loose file**, which has no directory of its own to keep anything in
+        std::filesystem::path program_dir() const;
+
+        // where `--optimize thin` keeps the native objects its link-time backends produced, by the LLVM cache's
+        // own key - see Backend::thin_link. Beside the kept programs and empty for the same loose file
+        std::filesystem::path thin_link_cache_dir() const;
+
+        // where this build's file digests are remembered - see Compiler::FileDigests. In the entry module's
+        // own directory, and **empty until echoc has made that directory**: the memo is the one file here no
+        // build needs, so it is never the reason one gets created
+        std::filesystem::path digest_memo() const;
+
+        // where the resolved manifest graph is remembered - see Parser::recall_manifest_graph. The same
+        // directory and the same rule as digest_memo, for the same reason
+        std::filesystem::path manifest_memo() const;
+
+        // where Compiler::link_in_process remembers the link line the clang driver spelled for this machine.
+        // **the user's cache rather than any project's**: the line is a fact about the installed toolchain -
+        // crt files, libc, the dynamic loader - and every project on the machine links against the same one.
+        // Static, since no layout's state goes into it; empty when neither cache variable is set
+        static std::filesystem::path link_plan_dir();
+
+        // where a unit's ODR-shared bodies are kept as objects of their own - see
+        // Backend::keep_shared_definitions. In the module's own directory, so `echoc clean` reaches them with
+        // the object that leans on them, and **empty until echoc has made that directory**: the entry module's
+        // is only ever made by a build that has something else to keep in it
+        std::filesystem::path instance_dir(const Parser::ModuleManifest &manifest) const;
+
         // removes the scratch directory, but **only when it is the temporary one**.
         //
         // A project's scratch lives inside its build directory, where `echoc clean` reaches it and where a
@@ -181,6 +219,8 @@ namespace Compiler
 
         std::filesystem::path _scratch;
         bool _scratch_is_temporary = false;
+
+        std::optional<SharedStore> _shared_store;
     };
 };
 
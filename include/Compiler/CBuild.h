@@ -144,6 +144,17 @@ namespace Compiler
         std::string &out_error
     );
 
+    // every file this module's C build was last seen to read: its sources, and every prerequisite named by
+    // a depfile under `cache_dir`, deduplicated.
+    //
+    // **what the last build read, not what the next one will.** A header first included by an edit is
+    // learned from the depfile that edit's compile writes - the same one-build lag the object key has, and
+    // for the same reason: nothing short of running the preprocessor knows sooner. `--watch` is the reader
+    std::vector<std::filesystem::path> c_build_inputs(
+        const CBuildSpec &spec,
+        const std::filesystem::path &cache_dir
+    );
+
     // links a module's C objects into something dlopen can take, for `echoc run`.
     //
     // `link_words` is the module's own link line as Compiler::partition_link_requirements rendered it: a
@@ -17,7 +17,9 @@ namespace Compiler
         t_run,
         t_build,
         t_test,
-        t_clean
+        t_clean,
+        t_serve,
+        t_cache
     };
 
     // the bits an option's `subcommands` mask carries. a mask rather than a vector because the only
@@ -28,6 +30,8 @@ namespace Compiler
         constexpr unsigned int build = 1u << 1;
         constexpr unsigned int test = 1u << 2;
         constexpr unsigned int clean = 1u << 3;
+        constexpr unsigned int serve = 1u << 4;
+        constexpr unsigned int cache = 1u << 5;
 
         // the shapes that recur. `compiling` is the set that turns source into code, and is what replaced
         // the second `for (auto &command : {...})` registration loop this table exists to delete.
@@ -38,6 +42,11 @@ namespace Compiler
         constexpr unsigned int compiling = run | build | test;
         constexpr unsigned int jitting = run | test;
         constexpr unsigned int all = run | build | test | clean;
+
+        // **`serve` is not in `all`**, which is what `all` means: every command that locates a build. The
+        // server locates nothing - each request it serves brings its own command line - so it takes only
+        // the flags about how echoc itself talks. Nor does `cache`, whose store the environment names
+        constexpr unsigned int reporting = all | serve | cache;
     };
 
     unsigned int bit_of(Subcommand id);
@@ -60,6 +69,8 @@ namespace Compiler
         t_debug_symbols,
         t_no_tbaa,
         t_track_allocations,
+        t_jobs,
+        t_watch,
         t_no_stdlib,
         t_emit_stdlib_header,
         t_target_os,
@@ -94,28 +105,35 @@ namespace Compiler
     };
 
     // what `--explain <what>` names. **`t_prune` is legal on `run` alone**, because only the JIT prunes -
-    // and that is a property of the *value*, not of the option, which is why OptionValue carries a mask
+    // and that is a property of the *value*, not of the option, which is why OptionValue carries a mask.
+    // `t_tiers` is narrower again: only `run` tiers
     enum class ExplainKind
     {
         t_cache,
         t_prune,
         t_memory,
-        t_time
+        t_time,
+        t_tiers
     };
 
-    // how hard, and over what. three answers rather than two flags that are not each other's
+    // how hard, and over what. five answers rather than two flags that are not each other's
     // inverse: `-O` said what is compiled *together* and `--no-optimize` said whether the per-unit
     // pipeline ran, so `-O --no-optimize` was expressible and meant almost nothing.
     //
     // deliberately **not** on Compiler::CompilerOptions. `t_whole` is a fact about how the driver drove
     // the compiler - merge every unit, then O3, and store no object - and not about the program being
     // compiled, so the readers of `no_optimize` would each owe an arm they must never take. The per-unit
-    // half of this answer *is* `no_optimize`, and Compiler::resolve_driver_options sets it from here
+    // half of this answer *is* `no_optimize`, and Compiler::resolve_driver_options sets it from here.
+    // `t_thin` has a per-unit half too - what a unit's artifact *is* - and that one is
+    // CompilerOptions::thin_lto, for the same reason. `t_tiered` has none: its units are `t_module`'s,
+    // objects and keys alike, and what differs is only how the JIT runs the modules it is handed
     enum class OptimizeMode
     {
         t_none,
         t_module,
-        t_whole
+        t_whole,
+        t_thin,
+        t_tiered
     };
 
     // does the option take a word after it, and may it be given more than once
@@ -221,7 +239,7 @@ namespace Compiler
         ExclusionGroup exclusion;
 
         // what the value is called in a usage line - `<manifest>`, `<dir>` - or nullptr for a flag. an
-        // option with a `values` list generates one instead, `<none|module|whole>`, so the two cannot drift
+        // option with a `values` list generates one instead, `<none|module|whole|thin|tiered>`, so the two cannot drift
         const char *metavar;
 
         // what CommandLine::value() answers when the option was not written. "" for almost everything;
@@ -0,0 +1,74 @@
+#ifndef COMPILESERVER_H
+#define COMPILESERVER_H
+
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Compiler
+{
+    // **is `echoc serve` possible on this platform at all.** The server hands a connection's terminal to a
+    // forked child, so it needs both fork and descriptor passing - the same boundary Compiler::TestRunner
+    // draws, for the same reason. false costs nothing but the speed-up: the CLI simply compiles in-process
+    bool compile_server_available();
+
+    // where `echoc serve` listens and where every other invocation looks for it.
+    //
+    // `ECHOC_SERVER_SOCKET` when set, else `$XDG_RUNTIME_DIR/echoc/serve.sock`, else
+    // `/tmp/echoc-<uid>/serve.sock`. **per user and never shared**: whoever can connect to this socket can
+    // run a compile as whoever started the server, so its directory is created private and a peer of any
+    // other uid is refused - see serve_requests
+    std::filesystem::path server_socket_path();
+
+    // **which echoc this is**, as precisely as the platform can say: the version, the executable's path, and
+    // that file's size and modification time. A rebuilt compiler is a different compiler even when its version
+    // string is not - a server forked from the old one would answer with the old one's code, and a program the
+    // old one linked carries the old one's standard library
+    std::string executable_identity();
+
+    // one invocation as the server received it. `environment` is `NAME=value` words, the shape `environ`
+    // holds, so a child can be handed it without a translation that could lose one
+    struct ServedRequest
+    {
+        std::vector<std::string> arguments;
+        std::filesystem::path working_directory;
+        std::vector<std::string> environment;
+    };
+
+    // **hands this invocation to a running server**, or answers nullopt so the caller compiles it here.
+    //
+    // nullopt is every way of there being nobody to ask - no socket, a stale one, `ECHOC_NO_SERVER` set - and
+    // the one way of being refused: a server started from a different `echoc` binary than this one. A
+    // compile answered by a compiler other than the one that was typed is the failure this must never
+    // have, so a server that cannot prove it is the same executable is not used at all.
+    //
+    // otherwise the exit status the served compile ended with. This process's stdin, stdout and stderr are
+    // passed across, so the compile writes to the same terminal, pipe or file it would have written to,
+    // and a program `echoc run` starts reads the same stdin
+    std::optional<int> forward_to_server(int argc, char *argv[]);
+
+    // **the server loop**, which returns only when it cannot go on (1, with `out_error` saying why) or when
+    // SIGINT or SIGTERM asks it to stop (0).
+    //
+    // each request is served by `serve` in a **forked child**, with the client's descriptors on 0, 1 and 2,
+    // its working directory and its environment in place - so a served compile is exactly the process the
+    // client would have been, forked from a server that already had something in memory. What it returns
+    // is the client's exit status. One request at a time: a second client waits in the listen backlog,
+    // because two compiles writing the same build directory at once is a race the CLI never had.
+    //
+    // `after` runs **in the server**, once the client has its answer, with that request's working directory
+    // and environment in place again and restored when it returns. It is where the server prepares for the
+    // next request, and whatever it leaves in memory is what the next child is forked with
+    int serve_requests(
+        const std::filesystem::path &socket,
+        const std::function<int(const ServedRequest &)> &serve,
+        const std::function<void(const ServedRequest &)> &after,
+        std::string &out_error
+    );
+};
+
+#endif
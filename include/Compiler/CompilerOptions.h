@@ -45,6 +45,15 @@ namespace Compiler
         // LLVMCompiler::emit_objects is about to write, so a second reader is a way for the two to disagree
         bool no_optimize = false;
 
+        // **is a unit's artifact summary bitcode rather than an object** - `--optimize thin`, whose per-unit
+        // half this is. prepare_unit_for_emission runs the ThinLTO pre-link pipeline in place of the
+        // baseline one, emit_object writes the module with its summary, and the objects the linker sees are
+        // produced afterwards by Backend::thin_link over every unit at once.
+        //
+        // here and not only on the driver's OptimizeMode for no_optimize's reason: what a unit's stored
+        // artifact is changes what compute_module_keys has to promise about it
+        bool thin_lto = false;
+
         // **does the emitted object carry DWARF**, so a debugger can name a source line, a function and
         // a local.
         //
@@ -14,6 +14,13 @@
 
 namespace Compiler
 {
+    // what `echoc cache` was asked to do. The parser has already refused any other word
+    enum class CacheAction
+    {
+        t_stats,
+        t_prune
+    };
+
     // **the sole answer to "what does this invocation mean".**
     //
     // resolved once, in main, and handed to everything below it. It replaced an argument parser threaded
@@ -58,6 +65,13 @@ namespace Compiler
             return optimize == OptimizeMode::t_whole;
         }
 
+        // how many modules are read and lexed at once, **settled** - `-j` when it was written, one per core
+        // when it was not, and never zero. Not on `options` for `--print`'s reason: the parse it spreads
+        // over threads produces the same tokens in the same order, so a key reacting to it would go cold
+        // for a flag no emitted byte ever saw. Codegen, object emission and `--optimize thin`'s link-time
+        // backends spend the same number, and their objects are the same whichever thread produced them
+        unsigned jobs = 1;
+
         std::vector<std::string> sources;
         std::vector<std::string> modules;
         std::vector<std::string> link;
@@ -99,15 +113,24 @@ namespace Compiler
         bool emit_stdlib_header = false;
         bool silent = false;
 
+        // `build` and `test` only. Not on `options`: rebuilding on a change is a question about how often
+        // the driver runs, and each of those runs is exactly the build it would have been without it
+        bool watch = false;
+
         // `test` only, and it is a *detail level* rather than a second `silent`: what a run reports through
         // is the terminal's answer, and how much of it is reported is this one. Compiler::TestDetail is the
         // vocabulary, settled at the one call site that builds a reporter
         bool verbose = false;
 
-        // `clean` only
+        // `clean` and `cache prune`
         bool dry_run = false;
+
+        // `clean` only
         bool with_stdlib = false;
 
+        // `cache` only
+        CacheAction cache_action = CacheAction::t_stats;
+
         ColorChoice color = ColorChoice::t_auto;
         DiagnosticFormat format = DiagnosticFormat::t_auto;
 
@@ -0,0 +1,103 @@
+#ifndef FILEDIGESTS_H
+#define FILEDIGESTS_H
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string_view>
+
+namespace Compiler
+{
+    // **what a file's bytes hash to**, wherever a cache key folds a file in: a module's manifest and sources,
+    // a C source and every header it reached.
+    //
+    // XXH3, through LLVM's copy of it. The folds around it stay Compiler::fnv1a64 - they hash a few short
+    // strings each - but a file is the one input that can be megabytes, and a byte-at-a-time loop over it
+    // was most of what an all-hit build spent computing its keys
+    uint64_t content_digest(std::string_view bytes);
+
+    // **content digests remembered across builds, and trusted only while the file provably has not moved.**
+    //
+    // a remembered digest is keyed by the file's path and checked against its size, mtime, ctime and inode
+    // - all of them, to the nanosecond - before it is answered, and any difference is a read and a hash. So
+    // a key is still a function of the *content*, exactly as Compiler::read_whole_file insists: a `touch` or
+    // a checkout that rewrites a file with its own bytes costs one hash and changes no key, and an edit is
+    // caught by the stat even on a filesystem whose mtime a tool set back, because nothing but the kernel can
+    // set a ctime.
+    //
+    // **a file changed within `settle` of being hashed is never remembered as settled.** A timestamp has a
+    // granularity - a tick on most filesystems, a second or two on some - and an edit inside the same tick as
+    // the hash, of the same length, is a stat that matches and bytes that do not. Such an entry is hashed
+    // again every time it is asked until it is old enough to trust, which is git's racy-clean rule.
+    //
+    // process-wide for PhaseTimings' reason: the two key computations that ask are in different files and
+    // neither owns the other, and one memo is what lets a header both of them read be stat'd against one
+    // entry. The memo file is the build directory's - see BuildLayout::digest_memo - and losing it costs one
+    // build's worth of hashing and nothing else
+    class FileDigests
+    {
+    public:
+        // the testable constructor: `settle` is how old a change has to be before its digest is trusted
+        explicit FileDigests(std::chrono::nanoseconds settle = std::chrono::seconds(2));
+
+        static FileDigests &instance();
+
+        // where the memo is kept, and what it held. Read at most once per path; empty keeps it in memory only.
+        // Whatever cannot be read is an empty memo rather than an error
+        void attach(const std::filesystem::path &memo);
+
+        // the digest of `path`'s bytes, or nullopt when it cannot be read
+        std::optional<uint64_t> digest_of(const std::filesystem::path &path);
+
+        // writes the memo back, when anything was hashed since it was read. Best effort and never into a
+        // directory that is not there, for the reason an unwritable build directory never fails a build
+        void save();
+
+        // how many answers came from the memo and how many from reading the file, for `--explain time`
+        size_t recalled() const { return _recalled; }
+        size_t hashed() const { return _hashed; }
+
+    private:
+        struct Stamp
+        {
+            uint64_t size = 0;
+            int64_t modified_ns = 0;
+            int64_t changed_ns = 0;
+            uint64_t inode = 0;
+
+            bool operator==(const Stamp &other) const = default;
+        };
+
+        struct Entry
+        {
+            Stamp stamp;
+            uint64_t digest = 0;
+
+            // when the stat above was taken, which is what `settle` is measured against
+            int64_t stamped_ns = 0;
+        };
+
+        static std::optional<Stamp> stamp_of(const std::filesystem::path &path);
+
+        void load(const std::filesystem::path &memo);
+
+        std::chrono::nanoseconds _settle;
+        std::filesystem::path _memo;
+        bool _attached = false;
+        bool _dirty = false;
+
+        std::map<std::filesystem::path, Entry> _entries;
+        size_t _recalled = 0;
+        size_t _hashed = 0;
+
+        // the parse reads sources from worker threads, and nothing about a memo says who may ask it
+        std::mutex _mutex;
+    };
+};
+
+#endif
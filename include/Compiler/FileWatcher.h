@@ -0,0 +1,105 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace Compiler
+{
+    // **blocks until something a build read has changed**, for `--watch`.
+    //
+    // the files are watched through their *directories*, never one by one. An editor that saves by writing
+    // a new file and renaming it over the old one replaces the inode a per-file watch was on, and the
+    // second save would go unnoticed - so a file is a name in a watched directory, and a change is an event
+    // on that name, whatever happened to the inode behind it.
+    //
+    // a directory holds more than sources - a build directory beside a manifest is the obvious one - so an
+    // event counts only when it names a watched file, or when a new file with a source's extension appears:
+    // a `#[sources: "src/*.eco"]` matches a file that did not exist when the list was taken. Anything else,
+    // including everything the build itself writes, is ignored, which is what keeps a build from
+    // triggering the next one.
+    //
+    // inotify where there is one, and a stat comparison every quarter second where there is not - slower
+    // to notice, and the same answer
+    class FileWatcher
+    {
+    public:
+        FileWatcher();
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher &) = delete;
+        FileWatcher &operator=(const FileWatcher &) = delete;
+
+        struct Stamp
+        {
+            bool exists = false;
+            long long size = 0;
+            long long modified = 0;
+
+            bool operator==(const Stamp &other) const = default;
+        };
+
+        // what a set of files looked like at one moment, for the stretch nothing is watching them - see
+        // changed_since
+        struct Snapshot
+        {
+            std::map<std::filesystem::path, Stamp> stamps;
+            std::filesystem::file_time_type taken;
+        };
+
+        // makes `files` the watched set. **a diff against the last set, not a replacement**: a directory
+        // watched before and after keeps its watch, so an event it queued while the caller was busy is
+        // still there for wait_for_change. Relative paths are taken against the working directory now, so a
+        // later chdir does not move them
+        void watch(const std::vector<std::filesystem::path> &files);
+
+        // the files that changed, once something has and has then been quiet for a moment - an editor's
+        // save is several writes, and a build started on the first would read the file half written.
+        // Empty when watching itself failed, which the caller treats as having nothing left to wait for
+        std::vector<std::filesystem::path> wait_for_change();
+
+        // drops whatever has been noticed and not yet asked for, for a caller that found the change some
+        // other way and is about to act on it
+        void forget_pending();
+
+        static Snapshot snapshot(const std::vector<std::filesystem::path> &files);
+
+        // which of `files` moved since `before` was taken: a stamp that differs, or a file it did not
+        // cover that was written after it. The check for the window a watch cannot cover - a file that
+        // only becomes an input once the build that read it is over was never watched while it ran
+        static std::vector<std::filesystem::path> changed_since(
+            const Snapshot &before, const std::vector<std::filesystem::path> &files);
+
+    private:
+        // a file's name within its directory, which is how an event reports it
+        std::map<std::filesystem::path, std::set<std::string>> _names_by_directory;
+
+        // what would count as a new source appearing - see the class comment
+        static bool looks_like_a_source(const std::filesystem::path &name);
+
+        static Stamp stamp_of(const std::filesystem::path &path);
+
+#if defined(__linux__)
+        int _inotify = -1;
+        std::map<int, std::filesystem::path> _directories;
+
+        // one read's worth of events, appended to `changed`
+        void read_events(std::set<std::filesystem::path> &changed);
+#else
+        std::map<std::filesystem::path, Stamp> _stamps;
+        std::map<std::filesystem::path, std::set<std::string>> _listings;
+
+        static std::set<std::string> listing_of(const std::filesystem::path &directory);
+
+        // what moved since the stamps were taken, and the stamps retaken
+        std::set<std::filesystem::path> sweep();
+#endif
+    };
+};
+
+#endif
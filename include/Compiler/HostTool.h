@@ -18,6 +18,11 @@ namespace Compiler
     // clang diagnostic reaches the terminal as clang wrote it rather than through a renderer that would
     // have to pretend it understood it
     bool run_tool(const std::vector<std::string> &argv);
+
+    // the same, for the one kind of tool whose stderr is an answer rather than a diagnostic - `clang -###`,
+    // which prints the commands it would have run and runs none. Its stderr lands in `out_stderr` instead of
+    // on the terminal; stdout is still inherited
+    bool run_tool_captured(const std::vector<std::string> &argv, std::string &out_stderr);
 };
 
 #endif
@@ -0,0 +1,64 @@
+#ifndef INPROCESSLINK_H
+#define INPROCESSLINK_H
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Compiler
+{
+    // what link_in_process made of a link. `refused` is the program's own inputs at fault - an undefined
+    // symbol, a library nothing provides - said on stderr already, and the same answer the driver would
+    // give, so there is nothing to retry. `failed` is a refusal that may be the kept link line's doing: the
+    // caller retries through the clang driver, and calls forget_link_plan once that has linked. `unavailable`
+    // is not a failure at all: this build or this host has no in-process linker to offer, and the caller
+    // links through the driver exactly as it always did
+    enum class InProcessLink
+    {
+        t_linked,
+        t_refused,
+        t_failed,
+        t_unavailable,
+    };
+
+    // **a link without a second process**: what `clang <driver_words> -o output <inputs>` would have done,
+    // done by LLD's ELF linker inside echoc.
+    //
+    // spawning clang to link costs a driver start, a second resolution of the toolchain echoc has already
+    // resolved once, and a linker that writes its output on one thread. LLD as a library writes sections
+    // on every core, and is already in the address space - so a build whose objects all came out of the
+    // cache is a link and nothing else, and the link is the one step left that was not near-instant.
+    //
+    // **the driver is still asked, once.** Which crt files start a program, where libc and the dynamic
+    // loader live, what `-shared` changes - that knowledge is the clang driver's and nobody else's, and
+    // re-deriving it here would be a second toolchain resolution that disagrees with the first on whichever
+    // distribution it was not written on. So `clang -###` spells the linker's argv for placeholder inputs,
+    // and the line is kept under BuildLayout::link_plan_dir, keyed by the clang it came from and the words
+    // asked with. A line whose files have since moved - a compiler upgrade takes its crtbegin with it - is
+    // asked for again rather than trusted.
+    //
+    // `inputs` are objects, archives and linker words (`-L`, `-l`) in link order, placed where the driver
+    // places its own inputs. ELF hosts, and builds configured with ECO_WITH_LLD, only; anywhere else this is
+    // `unavailable`
+    InProcessLink link_in_process(
+        const std::vector<std::string> &driver_words,
+        const std::filesystem::path &output,
+        const std::vector<std::string> &inputs
+    );
+
+    // drops the link line kept for `driver_words`, here and on disk. **Only once the driver has linked what
+    // the line could not**, which is the one proof the line was at fault: forgetting it on any refusal would
+    // ask `clang -###` again on every build of a program with a typo in it
+    void forget_link_plan(const std::vector<std::string> &driver_words);
+
+    // the last command a `clang -###` printed, as an argv: every word of it unquoted the way the driver
+    // quoted it. nullopt when the output held no command at all. Exposed for the tests, which is the one
+    // place an unusual quoting can be pinned down without an unusual toolchain
+    std::optional<std::vector<std::string>> last_driver_command(std::string_view driver_output);
+};
+
+#endif
@@ -6,6 +6,7 @@
 #include "Compiler/LinkRequirement.h"
 #include "Compiler/TargetSubtarget.h"
 
+#include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <optional>
@@ -14,8 +15,14 @@
 
 namespace llvm
 {
-    class ExecutionEngine;
+    class Module;
     class TargetMachine;
+    class raw_pwrite_stream;
+
+    namespace orc
+    {
+        class LLJIT;
+    };
 };
 
 namespace Compiler::LLVM
@@ -24,6 +31,8 @@ namespace Compiler::LLVM
 
     struct CmpUnit;
 
+    class TieredExecution;
+
     // the output stage of the compiler: runs the optimization pipeline, prints the module IR,
     // JIT-executes the main module, and emits a native executable
     class Backend
@@ -68,19 +77,34 @@ namespace Compiler::LLVM
         // combined entry point for either of them to be the odd one out of.
         //
         // `prepare_execution` prunes the module to what its roots reach - see prune_to_entry, so what runs
-        // is smaller than what print_ir printed - then builds the engine and finalizes the objects:
-        // everything up to the moment machine code could be called. It is idempotent, and false with a
-        // message already printed. Nothing may be called before it has returned true, and the module is
-        // gone afterwards - the engine owns it.
+        // is smaller than what print_ir printed - then builds the JIT and hands it every module and object:
+        // everything up to the moment machine code could be called. **What is compiled by then is nothing
+        // but stubs** - a body is compiled the first time it is called, on `jobs` threads when there are
+        // several to compile at once - except for a test run of several tests, which compiles up front for
+        // the reason the implementation gives. It is idempotent, and false with a message already printed.
+        // Nothing may be called before it has returned true, and the modules are gone afterwards - the JIT
+        // owns them.
+        //
+        // **`objects` are loaded rather than compiled**: the per-module objects the cache served and the ones
+        // emit_objects just wrote, exactly the files a `build` would hand its linker. Any unit still holding
+        // a module is compiled by the JIT beside them, the entry module always among them. With objects
+        // in play there is no prune - see prune_to_entry for why it needs the whole program in one module -
+        // and what it would have saved, machine-coding a library per run, is what the objects already save.
         //
         // **every native library this program needs is already open by the time this is called**, and the
-        // driver is what opened them: MCJIT resolves an external out of the running process and nothing
+        // driver is what opened them: the JIT resolves an external out of the running process and nothing
         // else ever puts one there, so a `#[link:]` becomes a
-        // llvm::sys::DynamicLibrary::LoadLibraryPermanently before the engine exists. Deliberately not a
+        // llvm::sys::DynamicLibrary::LoadLibraryPermanently before the JIT exists. Deliberately not a
         // parameter here - the registry it loads into is process-global either way, and refusing over one
         // that will not open needs the requirement's declaring module and the diagnostic renderer, neither
-        // of which the backend has. A missing one is not survivable: MCJIT hangs rather than reporting
-        bool prepare_execution();
+        // of which the backend has. A missing one is not survivable: lazily, it is found missing only when
+        // the function that names it is first called, part way through the program
+        //
+        // **`tiered` is `--optimize tiered`**: every module the JIT compiles goes through TieredExecution on
+        // its way in, so what runs first is the cheap baseline and what runs hot is rebuilt at O3 behind it.
+        // Objects are loaded as they are - they went through the unit pipeline when they were written
+        bool prepare_execution(
+            const std::vector<std::filesystem::path> &objects = {}, unsigned jobs = 1, bool tiered = false);
 
         // calls the entry point.
         //
@@ -95,7 +119,8 @@ namespace Compiler::LLVM
         // JIT'd code, which takes echoc down with them, and that is already the right exit status
         int run_main(const std::vector<std::string> &arguments, const char *const *environment);
 
-        // the address of a finalized definition, or 0 when the engine holds no such symbol.
+        // the address of a definition, or 0 when the JIT holds no such symbol. Under the lazy JIT it is the
+        // address of the stub, which is as callable as the body and compiles it on the first call.
         //
         // **0 is a real answer and a caller must refuse on it**: the prune deletes anything its root set
         // does not reach, so a symbol asked for without being named a root is not there - which is a
@@ -118,6 +143,10 @@ namespace Compiler::LLVM
         // a compile prints is the driver's question, and the driver is the only place that sees the flag
         const std::string &prune_report() const { return _prune_report; }
 
+        // the `[tiers]` section `--explain tiers` asks for, or a line saying the run was not tiered. Waits
+        // for the reoptimizations already asked for, so it is asked after the program has returned
+        std::string tier_report();
+
         // **one unit to one object file, and one link, and that is the whole of emission.** a
         // third entry point sitting beside these two would be exactly the pair of them over the
         // one unit a merge leaves behind, so the driver would branch between two spellings of one
@@ -133,6 +162,58 @@ namespace Compiler::LLVM
         // *not* reference one has no business shipping it
         bool emit_object(CmpUnit &cmp_unit, const std::filesystem::path &object_path);
 
+        // one unit on its way to an object, for emit_units. `instance` is the answer rather than the
+        // question: the instance object keep_shared_definitions left the unit leaning on, or empty
+        struct UnitEmission
+        {
+            CmpUnit *cmp_unit = nullptr;
+            std::filesystem::path object;
+            std::filesystem::path instance_dir;
+            std::filesystem::path instance;
+        };
+
+        // **every unit handed in becomes its object, up to `jobs` of them at once**: prepare_unit_for_emission,
+        // keep_shared_definitions and emit_object per unit, which is all this is with `jobs` at one. A unit's
+        // module is released once its object is written - it is an object from then on, and the JIT must not
+        // be handed it a second time.
+        //
+        // above one, each unit leaves the shared LLVMContext as bitcode that keeps its use-list order, and a
+        // worker reads it into a context of its own and runs the same three steps through a TargetMachine of
+        // its own: nothing in LLVM is safe to share between two threads short of the registry. What the
+        // worker reads back is the module it was written from, down to the order the optimizer walks a
+        // value's users in, so the object is the one the serial path writes - tests/module_cache.cpp compares
+        // the two byte for byte.
+        //
+        // the `[instances]` rows, the counters and the progress row are written here on the calling thread
+        // and in unit order, never by a worker: PhaseTimings and ProgressReporter are one per process and lock
+        // nothing. False with a message already printed, like emit_object
+        bool emit_units(std::vector<UnitEmission> &units, unsigned jobs);
+
+        // **the exception to that rule, and the only one**: a prepared unit's ODR-shared bodies moved into an
+        // object of their own under `instance_dir`, for the unit's object - about to be written to
+        // `object_path` - to be emitted without them. The path of that object, which the link needs beside
+        // the unit's, or empty when the unit keeps its bodies.
+        //
+        // the object is stored under what it holds - see Compiler::LLVM::shared_definitions_digest - so a unit
+        // whose bodies come out the same as a build ago links the one that build stored and generates none of
+        // them: an edit to a module's own code no longer sends every instance it uses back through the
+        // backend with it. Still sound for the rule above, since the unit leans only on an object the link is
+        // handed beside it, and Compiler::write_instance_record is what tells a later build to do the same.
+        //
+        // **nothing is moved unless everything has somewhere to go**: the instance object stored or found,
+        // the record written, only then the unit's bodies dropped. Any failure before that is a unit emitted
+        // whole, as if `instance_dir` were empty - which it is for a thin unit, whose summary is not an
+        // object, and under `-g`, where a body's DWARF belongs to its unit's compile unit
+        std::filesystem::path keep_shared_definitions(
+            CmpUnit &cmp_unit,
+            const std::filesystem::path &object_path,
+            const std::filesystem::path &instance_dir
+        );
+
+        // what keep_shared_definitions moved, reused and kept: the `[instances]` section `--explain cache`
+        // prints. Empty when no unit was asked - thin_link_report's shape
+        const std::string &instance_report() const { return _instance_report; }
+
         // links objects into an executable. Prefers the system linker and falls back to the `clang`
         // driver, which is a ~33ms difference on every build: almost all of `clang -o exe exe.o` is
         // driver startup, and this stage is otherwise a constant floor no amount of caching removes.
@@ -148,7 +229,79 @@ namespace Compiler::LLVM
             const std::vector<Compiler::LinkRequirement> &link
         );
 
+        // **`--optimize thin`'s link-time half**: every unit's summary bitcode in, one native object per unit
+        // out, into `output_dir`, for link_executable to link exactly as it links an ordinary build's.
+        //
+        // the summaries are combined into one index, each unit imports the bodies it calls from the others
+        // and is optimized and code-generated on its own thread - `jobs` of them, the driver's settled `-j`.
+        // A unit whose own bytes and whose imports are both unchanged is served from `cache_dir` instead of
+        // generated, which is the half of the cache a summary alone cannot give. An empty `cache_dir` is a
+        // link with no cache: a loose file has no directory to keep one in.
+        //
+        // **what may be internalized is read off the objects the link will add**: the entry point, and any
+        // symbol a C source or an `object:` file references by name, stay visible; everything else is this
+        // program's alone and the thin link may drop or inline it away. An object it cannot read - an
+        // archive, a format it does not know - makes every symbol visible rather than guessing. A library
+        // given as `lib:` is not read at all, so one that calls back into the program by name is a link
+        // error rather than a program that runs wrongly.
+        //
+        // false with a message already printed, like emit_object
+        bool thin_link(
+            const std::vector<std::filesystem::path> &summaries,
+            const std::vector<Compiler::LinkRequirement> &link,
+            const std::filesystem::path &cache_dir,
+            const std::filesystem::path &output_dir,
+            unsigned jobs,
+            std::vector<std::filesystem::path> &out_objects
+        );
+
+        // what the last thin_link generated and what its cache served: the `[thin link]` section
+        // `--explain cache` prints. Empty until thin_link has run - prune_report's shape, for its reasons
+        const std::string &thin_link_report() const { return _thin_link_report; }
+
     private:
+        // what keep_shared_definitions did with one unit: the instance object it leans on, if any, and the
+        // `[instances]` row and counter that say so - apart, because under emit_units' workers the doing is
+        // a worker's and the saying is the calling thread's
+        struct KeptDefinitions
+        {
+            std::filesystem::path instance;
+            std::string report_row;
+            const char *counter = nullptr;
+        };
+
+        // a TargetMachine for the host, as init_target settles it - the one the backend keeps, and one per
+        // emit_units worker, which cannot share it
+        std::unique_ptr<llvm::TargetMachine> create_target_machine() const;
+
+        // the halves of prepare_unit_for_emission, keep_shared_definitions and emit_object that touch only
+        // the module and the machine they are handed, so a worker holding its own of both can run them
+        void run_unit_pipeline(llvm::Module &module, llvm::TargetMachine &machine) const;
+
+        KeptDefinitions split_off_shared_definitions(
+            llvm::Module &module,
+            const std::string &unit_name,
+            const std::filesystem::path &object_path,
+            const std::filesystem::path &instance_dir,
+            llvm::TargetMachine &machine) const;
+
+        bool write_unit_object(
+            llvm::Module &module, const std::filesystem::path &object_path, llvm::TargetMachine &machine) const;
+
+        // the row and the counter of one kept unit, into _instance_report and PhaseTimings
+        void record_kept(const KeptDefinitions &kept);
+
+        // emit_units above one job - see there
+        bool emit_units_in_parallel(std::vector<UnitEmission> &units, unsigned jobs);
+
+        // the JIT prepare_execution hands everything to: compile-on-first-call when `lazy` and the target has
+        // stubs to do it with, up front otherwise. `compile_threads` of zero compiles on the asking thread
+        bool create_jit(bool lazy, unsigned compile_threads);
+
+        // `_tiering` over the JIT create_jit built, with the two pipelines it runs, installed as the JIT's IR
+        // transform - see TieredExecution
+        void start_tiering();
+
         // **Mach-O only, and only under `-g`.** `ld` leaves the DWARF in the objects and writes only a
         // debug map into the binary, so a debug session depends on those objects still being where they
         // were linked from. dsymutil is what folds them into a self-contained `<exe>.dSYM`. Best effort:
@@ -156,15 +309,26 @@ namespace Compiler::LLVM
         // linker puts the DWARF in the executable itself
         void gen_debug_symbols(const std::string &executable_name);
 
+        // native code for `module` into `dest`, through `machine` - the half of emit_object an instance
+        // object shares with a unit's
+        static bool write_native_object(
+            llvm::Module &module, llvm::raw_pwrite_stream &dest, llvm::TargetMachine &machine);
+
+        // what an instance object depends on that its IR does not say: this compiler, the LLVM behind it, and
+        // the machine `machine` generates for, at the level it generates at. Every machine create_target_machine
+        // builds answers the same
+        uint64_t instance_environment(const llvm::TargetMachine &machine) const;
+
         // drops everything the roots cannot reach, by internalizing the module and running GlobalDCE over
         // what is left. The root set is ECO_ENTRY_SYMBOL_NAME plus set_jit_roots' names, so it is read off
         // the backend rather than passed: what a caller will look up by name is the same list it already
         // stated, and two spellings of it are how one gets deleted and then asked for.
         //
         // **the JIT only, and sound only there** - which is why it is private and prepare_execution is its
-        // one caller. It merges every unit into one module because the JIT can only be handed one, and the
-        // only things ever looked up by name in that module are the entry symbol and those roots - which
-        // makes them the complete root set. A `build` must not do this: its per-module objects are the
+        // one caller, and only when every unit was merged into the one module it is handed. There the only
+        // things ever looked up by name are the entry symbol and those roots - which makes them the
+        // complete root set. A run that loads per-module objects beside it skips this: see
+        // prepare_execution. A `build` must not do this: its per-module objects are the
         // cache contract, and a library's object may not depend on which application consumes it.
         // Reachable only from the JIT, it cannot be asked for anywhere that would be unsound.
         //
@@ -196,12 +360,25 @@ namespace Compiler::LLVM
         // code path through the thing it is meant to describe
         std::string _prune_report;
 
+        // built by thin_link, read by thin_link_report
+        std::string _thin_link_report;
+
+        // built by keep_shared_definitions, read by instance_report
+        std::string _instance_report;
+
         // the roots the prune keeps beside the entry point - see set_jit_roots
         std::vector<std::string> _jit_roots;
 
         // the live JIT, from prepare_execution until this Backend is destroyed. **it owns the main module**
-        // from the moment EngineBuilder takes it, which is why nothing may print or emit IR afterwards
-        llvm::ExecutionEngine *_engine = nullptr;
+        // from the moment prepare_execution hands it over, which is why nothing may print or emit IR afterwards
+        std::unique_ptr<llvm::orc::LLJIT> _jit;
+
+        // whether `_jit` is the lazy one, which is the only one that takes a module through addLazyIRModule
+        bool _jit_is_lazy = false;
+
+        // `--optimize tiered`'s stubs, counters and worker, or null. **after `_jit`**, so it is destroyed
+        // first: its worker compiles into the JIT, and has to be stopped before there is no JIT to compile into
+        std::unique_ptr<TieredExecution> _tiering;
     };
 };
 
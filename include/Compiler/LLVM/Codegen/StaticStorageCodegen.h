@@ -29,8 +29,8 @@ namespace Compiler::LLVM
     //
     // **initialization is lazy and first-use.** every read and every write goes through a call to a
     // self-guarding init function, which runs the initializer once. the alternative was
-    // `llvm.global_ctors`, and it is not merely worse here - `Backend::run_code` never calls
-    // `runStaticConstructorsDestructors`, so `echoc build` would initialize statics and `echoc run`
+    // `llvm.global_ctors`, and it is not merely worse here - the JIT never runs a module's
+    // initializers, so `echoc build` would initialize statics and `echoc run`
     // would silently not. the corpus is overwhelmingly `mode: run`, so that divergence would have been
     // pinned as golden. the consequence to document is that a static nothing ever names is never
     // initialized, so its initializer's side effects never run
@@ -0,0 +1,153 @@
+#ifndef TIEREDEXECUTION_H
+#define TIEREDEXECUTION_H
+
+#pragma once
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/Support/Error.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace llvm
+{
+    class Function;
+    class Module;
+    class TargetMachine;
+
+    namespace orc
+    {
+        class JITDylib;
+        class LLJIT;
+        class MaterializationResponsibility;
+    };
+};
+
+namespace Compiler::LLVM
+{
+    // **`--optimize tiered`: a run that starts on cheap code and pays for good code only where it is spent.**
+    //
+    // every function the JIT is handed is split in two before it goes: a *tier stub* under the function's
+    // own name, which does nothing but jump through a pointer, and the body under `<name>$tier0`, which the
+    // pointer starts at. The body is compiled lazily like any other, through a cheap pipeline - mem2reg and
+    // the obvious - and with a counter bumped on entry and at every loop header. The call that takes the
+    // counter to `threshold` queues the function, and a worker thread builds it again from the untouched IR
+    // at O3, with every other tiered body visible to its inliner, then points the stub at the result.
+    //
+    // **no on-stack replacement**, and that is the one thing this does not do: a frame already running the
+    // baseline body finishes on it. A hot function called again takes the new one, which is what a long
+    // script spends its time doing - a loop at the top level of the entry module is the case it cannot help,
+    // and the entry point is not tiered at all for that reason.
+    //
+    // the stubs are IR rather than ORC's own, because ORC's are private to its compile-on-demand layer and
+    // are written once, when the body behind them is first compiled. A stub here is an ordinary function
+    // any caller reaches by name - so a call from another module, an object or a function pointer all
+    // pick up the swap - and a pointer written once more is all a swap is
+    class TieredExecution
+    {
+    public:
+        // how many calls and loop iterations, counted together, make a function hot
+        static constexpr uint32_t threshold = 1000;
+
+        // `baseline` runs over every partition the JIT compiles, `hot` over each module built for a hot
+        // function, through `machine` - which the worker owns from here on, since nothing in LLVM is safe to
+        // share between two threads. Both are the Backend's to choose, which keeps every pipeline in one file
+        TieredExecution(
+            llvm::orc::LLJIT &jit,
+            std::unique_ptr<llvm::TargetMachine> machine,
+            std::function<void(llvm::Module &)> baseline,
+            std::function<void(llvm::Module &, llvm::TargetMachine &)> hot
+        );
+
+        // stops the worker, dropping whatever it had not started - see finish
+        ~TieredExecution();
+
+        TieredExecution(const TieredExecution &) = delete;
+        TieredExecution &operator=(const TieredExecution &) = delete;
+
+        // **a module on its way into the JIT**, split as above. Every module must pass through here before the
+        // first is added, since the stubs are resolved by name across all of them and the worker reads back
+        // what this kept of each. Module-local globals become external under a name unique to the module:
+        // a hot body is built in a module of its own, and can only reach a static or a literal by name
+        void prepare_module(llvm::Module &module);
+
+        // the JIT's IR transform: the baseline pipeline, then the counters. Installed by the Backend on the
+        // JIT's IRTransformLayer, so it sees each lazily compiled partition rather than whole modules - and
+        // passes the modules it built itself through untouched
+        llvm::Expected<llvm::orc::ThreadSafeModule> transform(
+            llvm::orc::ThreadSafeModule module, llvm::orc::MaterializationResponsibility &responsibility);
+
+        // waits for the worker and stops it. With `drain` everything queued is built first - the report
+        // wants to describe a finished run - and without it only the function in hand, which is what a
+        // program leaving through libc's `exit` gets: LLVM's own statics are about to be destroyed under it
+        void finish(bool drain);
+
+        // the `[tiers]` section `--explain tiers` prints: how many functions were tiered, and which were
+        // reoptimized. Finishes the worker first, so it is asked once the program has returned
+        std::string report();
+
+    private:
+        // one tiered function. `module` indexes `_pristine`; `symbol` is its name in the JIT, after
+        // prepare_module's renaming, and `name` the one codegen gave it, which is what the report says
+        struct Tiered
+        {
+            size_t module = 0;
+            std::string symbol;
+            std::string name;
+        };
+
+        // the IR the worker rebuilds a hot function from, as bitcode, one per prepared module
+        struct Pristine
+        {
+            std::string identifier;
+            std::string bitcode;
+        };
+
+        // what JIT'd code calls when a counter reaches `threshold`. Queues the function once, whichever
+        // thread got there, and returns to the baseline body straight away
+        static void request(TieredExecution *self, uint32_t id);
+
+        void work();
+
+        // the O3 body for `id`, compiled and installed behind its stub
+        llvm::Error reoptimize(uint32_t id);
+
+        // the counters, into a partition's `$tier0` bodies
+        void instrument(llvm::Function &body, uint32_t id) const;
+
+        llvm::orc::LLJIT &_jit;
+        std::unique_ptr<llvm::TargetMachine> _machine;
+        std::function<void(llvm::Module &)> _baseline;
+        std::function<void(llvm::Module &, llvm::TargetMachine &)> _hot;
+
+        // written by prepare_module only, which is over before anything runs - read by every compile thread
+        // and the worker afterwards, so none of the three is locked
+        std::vector<Tiered> _tiered;
+        std::vector<Pristine> _pristine;
+        llvm::StringMap<uint32_t> _ids;
+
+        // where the hot bodies go: a dylib of their own, so the transform can tell them apart, which links
+        // against the main one for everything they call
+        llvm::orc::JITDylib *_hot_dylib = nullptr;
+
+        std::mutex _lock;
+        std::condition_variable _wake;
+        std::deque<uint32_t> _queue;
+        std::vector<bool> _requested;
+        std::vector<std::string> _reoptimized;
+        std::vector<std::string> _failed;
+        bool _closing = false;
+
+        std::thread _worker;
+    };
+};
+
+#endif
@@ -64,6 +64,10 @@ namespace Compiler::LLVM
         std::unique_ptr<llvm::LLVMContext> llvm_context;
         std::unique_ptr<llvm::IRBuilder<>> builder;
 
+        // the contexts of units another compiler lowered and this one adopted - LLVMCompiler::lower_in_lanes.
+        // Declared ahead of `cmp_units` so they are destroyed after every module that lives in them
+        std::vector<std::unique_ptr<llvm::LLVMContext>> lane_contexts;
+
         // what the invocation asked for. read through its predicates rather than compared, so that
         // every check the compiler can skip skips together
         CompilerOptions options;
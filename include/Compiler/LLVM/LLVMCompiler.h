@@ -53,7 +53,14 @@ public:
 
     // `cached_modules` names the modules whose compiled object is being reused, so no code is generated for
     // them at all - see TypeLowering::create_cmp_units for why that is the only place it has to be said
-    void compile_bundle(const AST::Bundle &bundle, const std::set<std::string> &cached_modules = {});
+    //
+    // `jobs` units are lowered at once - the driver's settled `-j`, and 1 for a whole-program compile, whose
+    // units are about to be merged into one context anyway. The units and their IR are the same at any
+    // count; see lower_in_lanes
+    void compile_bundle(
+        const AST::Bundle &bundle,
+        const std::set<std::string> &cached_modules = {},
+        unsigned jobs = 1);
 
     // every ODR-shared symbol defined in more than one unit must be defined *identically*, or the linker
     // keeps an arbitrary one and the program silently gets the wrong body. That is the obligation
@@ -154,9 +161,13 @@ public:
     // needs, since it calls a definition of its own once per test instead of running a program.
     //
     // preparing drops everything the roots cannot reach, so the module that runs is smaller than the one
-    // printIR prints. `arguments` and `environment` are the *program's*, and run_main returns what it
-    // returned - see Backend::prepare_execution and Backend::run_main, which own all of those decisions
-    bool prepare_execution();
+    // printIR prints - when there is one module. `objects` are the ones emit_objects wrote and the cache
+    // served, loaded beside whatever units are still in memory. `arguments` and `environment` are the
+    // *program's*, and run_main returns what it returned - see Backend::prepare_execution and
+    // Backend::run_main, which own all of those decisions. `jobs` is how many bodies may compile at once,
+    // and `tiered` is `--optimize tiered`
+    bool prepare_execution(
+        const std::vector<std::filesystem::path> &objects = {}, unsigned jobs = 1, bool tiered = false);
     int run_main(const std::vector<std::string> &arguments, const char *const *environment);
     uint64_t function_address(const std::string &mangled) const;
 
@@ -173,12 +184,44 @@ public:
     // what that prune dropped, for `--explain-prune`. Empty on any path that has not run one
     const std::string &prune_report() const;
 
+    // what `--optimize tiered` reoptimized, for `--explain tiers` - see Backend::tier_report
+    std::string tier_report();
+
     // one object per unit that still has a module, into `object_for(unit name)`. The objects are appended to
-    // `out_objects` in unit order, so the link command is deterministic
+    // `out_objects` in unit order, so the link command is deterministic.
+    //
+    // an empty path leaves that unit's module where it is. A `build` never answers one - every unit becomes
+    // an object for the linker - but the JIT does, for the entry module and anything with no store to go
+    // to: those are compiled in memory by the JIT, and only what a later run can reuse is written out
+    //
+    // `instances_for(unit name)` is where that unit's ODR-shared bodies may be kept as an object of their own -
+    // see Backend::keep_shared_definitions. An empty path, or no function at all, keeps them in the unit's
+    // object. An instance object a unit leans on is appended right after it, once however many units share it
+    //
+    // `jobs` units are optimized and written at once - the driver's settled `-j`. The objects and their order
+    // are the same at any count; see Backend::emit_units. A unit that became an object no longer has a module
     bool emit_objects(
         const std::function<std::filesystem::path(const std::string &)> &object_for,
+        std::vector<std::filesystem::path> &out_objects,
+        const std::function<std::filesystem::path(const std::string &)> &instances_for = {},
+        unsigned jobs = 1);
+
+    // what emit_objects moved into instance objects and what it found already stored, for `--explain cache`
+    const std::string &instance_report() const;
+
+    // `--optimize thin`: what emit_objects wrote and the cache served are summaries rather than objects, and this
+    // turns them into the objects link_executable is then handed - see Backend::thin_link
+    bool thin_link(
+        const std::vector<std::filesystem::path> &summaries,
+        const std::vector<Compiler::LinkRequirement> &link,
+        const std::filesystem::path &cache_dir,
+        const std::filesystem::path &output_dir,
+        unsigned jobs,
         std::vector<std::filesystem::path> &out_objects);
 
+    // what that link generated and what its cache served, for `--explain cache`
+    const std::string &thin_link_report() const;
+
     // links what emit_objects produced, plus anything a cache supplied
     bool link_executable(
         const std::string &executable_name,
@@ -187,6 +230,20 @@ public:
     );
 
 private:
+    // `main`'s definition, into the entry module's unit: the prologue, the file roots and the epilogue
+    void emit_entry_point(Compiler::LLVM::CmpUnit &main_cmp_unit);
+
+    // compile_bundle with one child compiler per unit, on `jobs` threads, whose units this one then adopts.
+    // False when there are not two units to lower, and nothing was done
+    bool lower_in_lanes(
+        const AST::Bundle &bundle,
+        const std::set<std::string> &cached_modules,
+        unsigned jobs);
+
+    // **this compiler is one of another's lanes**, so a bundle whose entry module it was not asked to lower is
+    // the normal case rather than a broken one
+    bool _lane = false;
+
     Compiler::LLVM::CodegenContext _ctx;
 
     Compiler::LLVM::TypeLowering _types;
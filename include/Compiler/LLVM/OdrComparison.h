@@ -39,8 +39,9 @@ namespace Compiler::LLVM
     //
     // so the rule throughout is: **nothing a module owns may be compared by pointer.** A value is a
     // position, a global is a name or - where the name is module-local and therefore says nothing -
-    // its content. What *is* shared is the `LLVMContext`, so a type, an `AttributeList` and a uniqued
-    // MDNode do compare by identity, and only the first of those needs a fallback beneath it.
+    // its content. What is *usually* shared is the `LLVMContext`, so a type, an attribute and a uniqued
+    // MDNode compare by identity first - but only first: a unit lowered on a lane of its own under `-j`
+    // lives in a context of its own, so every one of the three has a content comparison beneath it.
     //
     // returns nothing when the two are the same definition. Nothing is rendered on that path
     std::optional<OdrDifference> first_odr_difference(const llvm::Function &left, const llvm::Function &right);
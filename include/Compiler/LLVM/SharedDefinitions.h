@@ -0,0 +1,74 @@
+#ifndef SHAREDDEFINITIONS_H
+#define SHAREDDEFINITIONS_H
+
+#pragma once
+
+#include <llvm/IR/Module.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Compiler::LLVM
+{
+    // **the ODR-shared bodies of one unit, moved into a module of their own** - the generic instances, the
+    // synthesized constructors and deinits and the `#[inline]` bodies AST::FunctionEmission::t_odr_shared
+    // copies into every unit that references them.
+    //
+    // an edit to a module's own code makes its object miss, and every one of those bodies went back through
+    // the backend with it: `map<string, array<int32>>`'s seat and grow, `array<T>::reserve`, the hashes -
+    // none of which the edit touched. Moved out, they are an object of their own, stored under what they
+    // are, and a unit that holds the same bodies next time links that object rather than generating them.
+    //
+    // **after the unit's pipeline, not before**, which is what keeps this from costing the program anything:
+    // whatever the pipeline was going to inline has already been inlined, every body that is still here is
+    // one the unit calls, and what moves is optimized IR that only machine code is left to be made of.
+    //
+    // **so only the backend is saved.** The monomorphizer still clones every instance and lowering still
+    // builds its IR on every compile - that IR is the key - and one object holds the unit's whole set, so
+    // two units whose sets overlap keep two objects rather than sharing one per instance.
+    //
+    // what is moved is every `linkonce_odr` definition, and with it every module-local global one of them
+    // reaches - a string literal, a lowered closure - copied rather than moved, since the unit may name them
+    // too. **a unit whose bodies reach state of its own is kept whole**: a copy of a mutable internal would
+    // be a second variable, and `kept_because` names the first one that was found
+    struct SharedDefinitionSplit
+    {
+        // null when nothing was moved - the unit had no shared body, or reached one of its own states
+        std::unique_ptr<llvm::Module> module;
+
+        // how many `linkonce_odr` definitions the unit held, moved or not
+        size_t definitions = 0;
+
+        // a sentence when there were some and they stayed, empty otherwise
+        std::string kept_because;
+    };
+
+    // the split of a prepared unit. `unit` is left exactly as it was - release_shared_definitions is the
+    // half that changes it, and only once the caller has somewhere to keep what was split off
+    SharedDefinitionSplit split_shared_definitions(const llvm::Module &unit);
+
+    // what a split module is stored under: its printed IR, `environment` folded over it.
+    //
+    // **the body itself is the key**, rather than the template and the arguments it was instantiated over,
+    // because in this compiler nothing short of the body can be shown to be complete: an instance's calls
+    // are resolved against whatever the bundle declares, and a call lowering mints - an interpolation's
+    // `str::from`, a user's `operator ==` - names an overload from any module at all. Optimized IR names
+    // each callee it settled on and holds every layout it read, so two units that agree on it agree on the
+    // object.
+    //
+    // the unit-local spellings are taken out first, since they are a fact about what else the unit held and
+    // never about these bodies: a named struct is printed by position rather than as the `array<int32>.2`
+    // the order units were lowered in gave it, and module-local globals arrive unnamed from the split.
+    // `environment` is everything the object depends on that the IR does not say - see
+    // Backend::keep_shared_definitions
+    uint64_t shared_definitions_digest(llvm::Module &shared, uint64_t environment);
+
+    // the other half: every definition `shared` now holds becomes a declaration in `unit`, and the
+    // module-local globals nothing in `unit` names any more are dropped. The unit's object then leans on
+    // the one `shared` is written to for those symbols, which is what Compiler::write_instance_record says
+    void release_shared_definitions(llvm::Module &unit, const llvm::Module &shared);
+};
+
+#endif
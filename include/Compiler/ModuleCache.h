@@ -17,10 +17,18 @@
 #include <utility>
 #include <vector>
 
+namespace AST
+{
+    class Module;
+};
+
 namespace Compiler
 {
     // FNV-1a, 64 bit. Not cryptographic and does not need to be: this answers "are these the same inputs as
-    // last time", where the adversary is an edited source file rather than a person
+    // last time", where the adversary is an edited source file rather than a person.
+    //
+    // **for the folds, never for a file.** A key folds short strings and other digests, where a byte at a time
+    // costs nothing; a file's bytes go through Compiler::content_digest, which takes them a block at a time
     uint64_t fnv1a64(const void *data, size_t length, uint64_t seed);
     uint64_t fnv1a64(const std::string &text, uint64_t seed);
 
@@ -37,9 +45,10 @@ namespace Compiler
     // a checkout, a branch switch or a `touch` all move mtimes without changing what is compiled - and the
     // reverse matters more, since two files can share an mtime and differ.
     //
-    // shared with the C object cache, which hashes a source and every header it reached. Sized up front and
-    // read straight into the string; the ostringstream spelling this replaced copied the bytes a second time
-    // before the hash ever saw them, once per file per build
+    // shared with the C object cache, which hashes a source and every header it reached - both through
+    // Compiler::FileDigests now, which reads a file only when its stat says it may have changed. Sized up
+    // front and read straight into the string; the ostringstream spelling this replaced copied the bytes a
+    // second time before the hash ever saw them, once per file per build
     std::optional<std::string> read_whole_file(const std::filesystem::path &path);
 
     // **which machine an object is being compiled for**, folded into `seed`.
@@ -66,6 +75,11 @@ namespace Compiler
     {
         std::string hex;
         std::vector<std::pair<std::filesystem::path, uint64_t>> inputs;
+
+        // **what this module is on its own**: the environment, its manifest and its sources, before any other
+        // module's key was folded in. What compute_object_keys starts an object key from, so the two keys of
+        // one module can never disagree about the module itself - only about what its neighbours contribute
+        uint64_t local = 0;
     };
 
     // a key per module, by module name. `manifests` must be in dependency order, which is what
@@ -75,8 +89,9 @@ namespace Compiler
     // transitive for free: a key already folds in its own dependencies, so editing a leaf reaches everything
     // above it without a second walk.
     //
-    // conservative on purpose. With no visibility modifiers a module's entire source is its interface, so
-    // any edit to a dependency rebuilds its dependents - even one to a function body nothing else can name
+    // conservative on purpose, and **these are the keys of the token store, not of the object**.
+    // The parse reads them before there is anything to tell a body from a declaration, so a dependency's
+    // every byte counts here - see compute_object_keys for the key an object is stored under
     //
     // `modules_with_tests` names the modules that compiled their `test` blocks, which is the one input here
     // that is genuinely **per module** rather than per build: an invocation compiles the tests of what it
@@ -99,6 +114,67 @@ namespace Compiler
         std::map<std::string, ModuleCacheKey> &out_keys,
         std::string &out_error);
 
+    // **what a module shows every module parsed after it**, as a digest - computed from the parsed module,
+    // so it can tell a body from a declaration where compute_module_keys cannot.
+    //
+    // everything but the bodies of ordinary functions: an AST::FunctionEmission::t_module_local body is
+    // emitted once, in the declaring module's own unit, and a dependent only ever names its symbol. What
+    // is left is the declarations, the type layouts, the constants - and every `#[inline]` and generic
+    // body, which AST::FunctionEmission::t_odr_shared copies into each unit that calls it.
+    //
+    // **positions only where an object can carry them.** A shared body's line numbers and line text go
+    // into every abort it can raise, so those always count; the rest of the interface is folded by
+    // spelling alone, so a body that grew a line does not move everything under it - unless
+    // `with_positions`, which a `-g` build passes because DWARF names the line of every declaration a
+    // dependent's types come from
+    uint64_t module_interface_digest(AST::Module &module, bool with_positions);
+
+    // the key a module's **object** is stored under, per module name. `source_keys` are compute_module_keys'
+    // and `interfaces` holds module_interface_digest for each of `manifests`, in the same dependency order.
+    //
+    // the module's own `local` part, then the interface of every module before it - where the source key
+    // folds their whole keys. That difference is the whole point: an edit to a body in a low-level module
+    // changes that module's object and no dependent's, where the source key rebuilt everything above it.
+    //
+    // every earlier module, not only the declared dependencies, for compute_module_keys' reason: the
+    // collector is shared, so anything parsed earlier can change how this module's calls resolve. Each one
+    // is recorded in `inputs` as well, under interface_input, so explain_miss can name the module whose
+    // interface moved rather than calling it a change to the compiler
+    bool compute_object_keys(
+        const std::vector<const Parser::ModuleManifest *> &manifests,
+        const std::map<std::string, ModuleCacheKey> &source_keys,
+        const std::map<std::string, uint64_t> &interfaces,
+        std::map<std::string, ModuleCacheKey> &out_keys,
+        std::string &out_error);
+
+    // the key a **linked program** is stored under: every one of its modules' source keys, and what the link
+    // added that no module key sees.
+    //
+    // the *source* keys and not the object keys, because this one is asked before anything is parsed - that
+    // is the whole of what it buys, a `run` that finds a program under it parses nothing. A source key is the
+    // conservative one of the two, so a program can only be rebuilt more often for it and never served stale.
+    //
+    // `entry_file` is which file of the entry module is the program, which its module key cannot say.
+    // `linked_files` are what the linker copies into the executable - an `object:` file, a static archive -
+    // and count by content, like a source. `settings` is everything else the driver knows changes the
+    // program and no module key folds: the compiler's own identity, whose standard library is in the
+    // binary, the libraries the link names, and the flags that only change the entry module.
+    //
+    // `inputs` is every module's files followed by the linked ones, so explain_miss names the file that
+    // moved exactly as it does for a module
+    bool compute_program_key(
+        const std::vector<const Parser::ModuleManifest *> &manifests,
+        const std::map<std::string, ModuleCacheKey> &source_keys,
+        const std::filesystem::path &entry_file,
+        const std::vector<std::filesystem::path> &linked_files,
+        const std::vector<std::string> &settings,
+        ModuleCacheKey &out_key,
+        std::string &out_error);
+
+    // how another module's interface is spelled in a key's `inputs`. Not a path anybody can open - a
+    // spelling no source can have, so explain_miss can word it as a module rather than as a file
+    std::filesystem::path interface_input(const std::string &module_name);
+
     // the object for a key. **only the filename is this store's** - which directory it goes in is
     // Compiler::BuildLayout's one question - because the key is what invents the name and nothing else
     // knows how to spell one. The key is *in the filename* rather than only in a sidecar, so two build
@@ -106,11 +182,29 @@ namespace Compiler
     std::filesystem::path module_object_path(
         const Parser::ModuleManifest &manifest, const ModuleCacheKey &key, const BuildLayout &layout);
 
+    // what a `--optimize thin` build keeps in the object's place: the module as summary bitcode, which is an
+    // input to the thin link rather than to the linker. Its own extension so a store holding both modes can
+    // be read at a glance - the key already keeps them apart
+    std::filesystem::path module_summary_path(
+        const Parser::ModuleManifest &manifest, const ModuleCacheKey &key, const BuildLayout &layout);
+
+    // the stored tokens for a key - see Parser::read_module_tokens. Beside the object and named the same
+    // way, so a store holds one of each per key and `echoc clean` reaches both
+    std::filesystem::path module_tokens_path(
+        const Parser::ModuleManifest &manifest, const ModuleCacheKey &key, const BuildLayout &layout);
+
     // the record of what the last build of this module was made of, for explaining a miss. One per module
     // rather than one per key, because the interesting comparison is against whatever was there before
     std::filesystem::path module_inputs_path(
         const Parser::ModuleManifest &manifest, const BuildLayout &layout);
 
+    // the stored program for a key, and the record of what the last one stored was made of - the program
+    // counterparts of module_object_path and module_inputs_path, named by the program rather than by a
+    // module. Both empty when the layout has nowhere to keep a program
+    std::filesystem::path stored_program_path(
+        const std::string &program_name, const ModuleCacheKey &key, const BuildLayout &layout);
+    std::filesystem::path program_inputs_path(const std::string &program_name, const BuildLayout &layout);
+
     // writes the sidecar beside a freshly emitted object
     bool write_inputs_record(const std::filesystem::path &path, const ModuleCacheKey &key);
 
@@ -118,6 +212,33 @@ namespace Compiler
     // missing or agrees. Best-effort: this is a diagnostic, and being unable to explain a miss is not itself
     // an error
     std::string explain_miss(const std::filesystem::path &inputs_path, const ModuleCacheKey &key);
+
+    // where a unit's ODR-shared bodies are kept, as an object of their own, under the digest
+    // Compiler::LLVM::shared_definitions_digest gave them - see Backend::keep_shared_definitions. The
+    // directory is Compiler::BuildLayout::instance_dir's; only the filename is this store's, for
+    // module_object_path's reason
+    std::filesystem::path instance_object_path(const std::filesystem::path &instance_dir, uint64_t digest);
+
+    // **what an object leans on**: the record beside it naming the instance objects it was emitted without
+    // the bodies of. An object with no record is whole, which is every object this compiler wrote before
+    // there were instance objects and every one written since that had nothing to move
+    std::filesystem::path instance_record_path(const std::filesystem::path &object);
+
+    // writes that record, staged and renamed into place - a record cut short would name fewer objects than
+    // the one beside it needs, and that is a link failure rather than a miss
+    bool write_instance_record(
+        const std::filesystem::path &object, const std::vector<std::filesystem::path> &instances);
+
+    // the instance objects `object` needs linked beside it, found in `instance_dir` and each marked used -
+    // empty for a whole object. **nullopt when any of them is not there**, or the record cannot be read:
+    // the object is then a miss like any other, since linking it alone would leave its calls undefined
+    std::optional<std::vector<std::filesystem::path>> claim_instance_objects(
+        const std::filesystem::path &object, const std::filesystem::path &instance_dir);
+
+    // drops the instance objects nothing has used for a week. At most once an hour, and on this store's own
+    // schedule rather than a module's: one dropped too early is an object whose module misses next time,
+    // which is the whole of what it can cost
+    void prune_instance_objects(const std::filesystem::path &instance_dir);
 };
 
 #endif
@@ -6,6 +6,7 @@
 #include <chrono>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 namespace Compiler
@@ -24,6 +25,11 @@ namespace Compiler
     // emission - and threading a collector through all of them would change several signatures for a
     // diagnostic. The alternative was a getenv, which is what ECO_TRACE_MONO does; a flag is better here
     // because the output belongs beside the compile it describes.
+    //
+    // **and one thread's.** Whichever thread first asks for the instance owns it, and every other thread's
+    // phases and counts are dropped rather than locked: a worker's `declare` nested under whatever the main
+    // thread had open would be a tree that describes no one's pipeline. Work fanned out to threads is
+    // timed by the phase its owner holds open around the fan-out - see LLVMCompiler::lower_in_lanes
     class PhaseTimings
     {
     public:
@@ -32,6 +38,10 @@ namespace Compiler
         void enable() { _enabled = true; }
         bool enabled() const { return _enabled; }
 
+        // every row dropped, enabled or not. For `--watch`, whose every build is a process forked from one
+        // that has already timed things - a report is about the build it is printed under, not the session
+        void reset() { _depth = 0; _phases.clear(); }
+
         // accumulates rather than replaces, so a phase entered once per module - parsing is - reports the
         // total rather than whichever module happened to be last. `depth` is how many phases were open when
         // this one was entered, and the report indents by it
@@ -46,7 +56,16 @@ namespace Compiler
         // pipeline runs. Ending is what a phase does *after* everything inside it, so ordering on that put
         // every parent below its own children
         size_t enter(std::string_view phase);
-        void leave() { _depth--; }
+        void leave() {
+            if (owned_here()) {
+                _depth--;
+            }
+        }
+
+        // a count rather than a duration, for the question a time cannot answer on its own - *why* a phase
+        // took what it did. accumulates like record, and takes the row under whichever phase is open, so
+        // a cache's hits sit beneath the phase they saved time in
+        void count(std::string_view counter, size_t n);
 
         // the phases in the order they were first entered, so the report reads as the pipeline does
         std::string report() const;
@@ -57,11 +76,20 @@ namespace Compiler
             std::string name;
             size_t depth = 0;
             double milliseconds = 0.0;
+
+            // a row count() made, which prints `count` and no unit
+            bool is_count = false;
+            size_t count = 0;
         };
 
+        // asked by every entry point, so a worker thread neither records nor moves `_depth`
+        bool owned_here() const { return std::this_thread::get_id() == _owner; }
+
         bool _enabled = false;
         size_t _depth = 0;
         std::vector<Phase> _phases;
+
+        std::thread::id _owner = std::this_thread::get_id();
     };
 
     // times a phase for as long as it is in scope, so an early return cannot lose it
@@ -97,7 +97,7 @@ namespace Compiler
     //
     // **there is no spinner thread**, for three independent reasons. Compiler::run_tool hands fd 2 to a
     // child and blocks while it writes, and there is no lock either side can take because the child is
-    // another process. MCJIT runs the user's program on this thread. And motion carrying no information
+    // another process. The JIT runs the user's program on this thread. And motion carrying no information
     // is decoration. So the frame advances once per redraw and a redraw happens only when this object is
     // told something changed - which also makes the frame index a function of the tick sequence, and the
     // unit test byte-comparable.
@@ -0,0 +1,95 @@
+#ifndef SHAREDSTORE_H
+#define SHAREDSTORE_H
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace Compiler
+{
+    // what `ECO_CACHE_MAX_SIZE` is when it is not set. Big enough for the standard library and a monorepo's
+    // worth of vendored modules in several build modes, and small enough that nobody has to find it
+    constexpr uint64_t k_default_shared_store_capacity = 10ull * 1024 * 1024 * 1024;
+
+    // `10G`, `512M`, `64K` or a plain number of bytes, binary multiples. nullopt for anything else
+    std::optional<uint64_t> parse_byte_size(const std::string &written);
+
+    // the other direction, for a person: `1.4 GiB`, `312 KiB`, `93 bytes`
+    std::string describe_byte_size(uint64_t bytes);
+
+    // **one machine-wide store of module objects, shared by every project that names it** - `ECO_CACHE_DIR`.
+    //
+    // the per-project store BuildLayout places is where a build reads and writes; this one sits behind it.
+    // A module that misses there is looked up here by its object key before it is compiled, and a module
+    // that was compiled is published here after the link - so ten checkouts of one repository, and every CI
+    // workspace pointed at one directory, compile a given library once between them. An object key names
+    // the module's content rather than where it sits on disk, which is what makes that sound: two
+    // checkouts agree on a key exactly when they would have compiled the same object.
+    //
+    // **an object arrives by hard link and leaves by rename**, so nothing is ever written in place where
+    // another process could read it half done: a publish is staged under `tmp/` and renamed into `objects/`,
+    // and a fetch is a link staged beside its destination and renamed over it. Where a link cannot be made -
+    // the store on another filesystem - it is a copy, staged the same way.
+    //
+    // **least recently used goes first.** A fetch or a publish sets the object's mtime to now, and pruning
+    // removes the oldest until the store fits its capacity. Fetches and publishes hold the store's lock
+    // shared and a prune holds it exclusive, so a prune never removes an object between the moment a build
+    // found it and the moment that build linked it.
+    //
+    // and **never a reason for a build to fail**: every answer here is a bool, and false is a miss or an
+    // object not kept - what an unwritable per-project store already is
+    class SharedStore
+    {
+    public:
+        SharedStore(std::filesystem::path root, uint64_t capacity);
+
+        // the store the environment names, or nullopt when `ECO_CACHE_DIR` is unset or empty. An
+        // `ECO_CACHE_MAX_SIZE` that is not a size is the default capacity, with the reason in `out_error`
+        // for whoever is in a position to say it - a build is not
+        static std::optional<SharedStore> from_environment(std::string *out_error = nullptr);
+
+        const std::filesystem::path &root() const { return _root; }
+        uint64_t capacity() const { return _capacity; }
+
+        // the object published as `name`, put in place at `destination`. false when the store has none
+        bool fetch(const std::string &name, const std::filesystem::path &destination) const;
+
+        // keeps the object at `source` as `name`, unless one is already kept - which it is touched instead
+        bool publish(const std::string &name, const std::filesystem::path &source) const;
+
+        struct Usage
+        {
+            size_t objects = 0;
+            uint64_t bytes = 0;
+        };
+
+        Usage usage() const;
+
+        // what a prune removed, or would have under `dry_run`, and what it left
+        struct Pruned
+        {
+            Usage removed;
+            Usage kept;
+        };
+
+        // removes the least recently used objects until what is left fits in `capacity`, and whatever an
+        // interrupted publish left in `tmp/`. Waits for the store's lock
+        Pruned prune(uint64_t capacity, bool dry_run) const;
+
+        // prune() to this store's own capacity, when the last one was long enough ago and nobody else holds
+        // the lock. What a build calls after it published something: a store that is never pruned by hand
+        // still stays inside its cap, and a build never waits on another one's prune
+        void prune_if_due() const;
+
+    private:
+        std::filesystem::path _root;
+        uint64_t _capacity;
+
+        std::filesystem::path object_path(const std::string &name) const;
+    };
+};
+
+#endif
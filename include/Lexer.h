@@ -6,10 +6,12 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <cstring>
 #include <exception>
 
 #include "Token.h"
+#include "LexerScan.h"
 #include "AST/ASTOps.h"
 
 #define MHP_VOCAB_LB '\n'
@@ -62,12 +64,19 @@ struct LexerCursor
 
     void reset();
 
+    // the input from `start` up to the cursor, without copying it. What a token's spelling is handed to
+    // TokenCollection::push as, which copies it once per distinct spelling rather than once per token
+    inline std::string_view since(const std::string::const_iterator start) const {
+        return std::string_view(input.data() + (start - input.begin()), static_cast<size_t>(it - start));
+    }
+
     inline void determine_end_of_line() {
         if (is_eof()) {
             end_of_line_offset = input.size();
         } else {
-            end_of_line_offset = input.find(MHP_VOCAB_LB, it - input.begin());
-            end_of_line_offset = end_of_line_offset > input.size() ? input.size() : end_of_line_offset;
+            const char *from = input.data() + (it - input.begin());
+            const char *to = input.data() + input.size();
+            end_of_line_offset = LexerScan::find_byte(from, to, MHP_VOCAB_LB) - input.data();
         }
     }
 
@@ -92,20 +101,72 @@ struct LexerCursor
         }
     }
 
-    inline void skip_formatting() {
-        while (is_formatting() && !is_eof()) {
-            skip();
+    // **the bulk form of `skip()`**: steps over the next `count` bytes, keeping line and column exactly as
+    // `count` single skips would. One count of the newlines in the run and, when there were any, one walk
+    // back to the last of them - rather than a branch per byte
+    inline void skip_over(size_t count) {
+        const size_t remaining = static_cast<size_t>(input.end() - it);
+        count = count > remaining ? remaining : count;
+
+        if (count == 0) {
+            return;
         }
+
+        const char *from = input.data() + (it - input.begin());
+        const size_t newlines = LexerScan::count_byte(from, from + count, MHP_VOCAB_LB);
+
+        it += count;
+
+        if (newlines == 0) {
+            char_offset += count;
+            return;
+        }
+
+        // the column restarts at 1 on the byte after the last newline, and counts every byte since
+        size_t after_last = 0;
+        while (from[count - 1 - after_last] != MHP_VOCAB_LB) {
+            after_last++;
+        }
+
+        line += newlines;
+        char_offset = 1 + after_last;
+        determine_end_of_line();
+    }
+
+    // the bytes from the cursor to the end of the input, as pointers - what a LexerScan function reads
+    inline const char *scan_begin() const {
+        return input.data() + (it - input.begin());
+    }
+
+    inline const char *scan_end() const {
+        return input.data() + input.size();
+    }
+
+    inline void skip_formatting() {
+        skip_over(LexerScan::formatting_run(scan_begin(), scan_end()));
     }
 
     inline void skip_until(char c) {
-        while (peek() != c && !is_eof()) {
-            skip();
-        }
+        skip_over(static_cast<size_t>(LexerScan::find_byte(scan_begin(), scan_end(), c) - scan_begin()));
+    }
+
+    // up to the first of `a`, `b` or `c` - the string literal's quote or escape, a comment's `*`
+    inline void skip_until_any_of(char a, char b, char c) {
+        skip_over(static_cast<size_t>(LexerScan::find_any_of(scan_begin(), scan_end(), a, b, c) - scan_begin()));
     }
 
+    // the newline is already known - determine_end_of_line found it when this line began - so reaching it
+    // is a jump, and the bytes in between hold no newline to count
     inline void skip_until_nl() {
-        skip_until(MHP_VOCAB_LB);
+        const size_t here = static_cast<size_t>(it - input.begin());
+
+        if (end_of_line_offset < here) {
+            determine_end_of_line();
+        }
+
+        const size_t count = end_of_line_offset - here;
+        it += count;
+        char_offset += count;
     }
 
     inline void advance() {
@@ -0,0 +1,56 @@
+#ifndef LEXERSCAN_H
+#define LEXERSCAN_H
+
+#pragma once
+
+#include <cstddef>
+
+// the lexer's inner loops, the ones that walk a run of bytes looking for where it ends: whitespace between
+// tokens, the body of a string literal, the rest of a comment, the next newline.
+//
+// **each question is asked 16 or 32 bytes at a time** where the CPU can, and one byte at a time where it
+// cannot - and which of the two is decided once per process, by asking the CPU rather than the compiler.
+// A binary built for the x86-64 baseline still scans with AVX2 on a machine that has it, and the same
+// binary does not die with an illegal instruction on one that does not.
+//
+// **every function answers exactly what its scalar loop answers**, for every level. LexerCursor turns these
+// into line and column bookkeeping, and a level that disagreed about where a run ends by one byte would
+// be a diagnostic pointing one column off on some machines and not others. The lexer tests hold every
+// level against the portable one
+namespace LexerScan
+{
+    // ordered, so "at least SSE2" is a comparison
+    enum class Level
+    {
+        t_portable,
+        t_sse2,
+        t_avx2
+    };
+
+    // the best level this CPU runs
+    Level detected_level();
+
+    // the level every scan below uses. `detected_level()` unless somebody lowered it
+    Level active_level();
+
+    // lowers (or restores) the level, clamped to what the CPU runs. **for measuring, never for
+    // correctness**: the lexer benchmark and the level-agreement test are the callers. Not to be called
+    // while a lexer is running on another thread - it is a process-wide switch
+    void use_level(Level level);
+
+    const char *level_name(Level level);
+
+    // how many bytes from `begin` are ' ', '\t' or '\n'
+    size_t formatting_run(const char *begin, const char *end);
+
+    // the first `c` in [begin, end), or `end`
+    const char *find_byte(const char *begin, const char *end, char c);
+
+    // the first byte in [begin, end) that is `a`, `b` or `c`, or `end`. Pass one byte twice to ask for two
+    const char *find_any_of(const char *begin, const char *end, char a, char b, char c);
+
+    // how many `c` are in [begin, end)
+    size_t count_byte(const char *begin, const char *end, char c);
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef MANIFESTMEMO_H
+#define MANIFESTMEMO_H
+
+#pragma once
+
+#include "Compiler/TargetFacts.h"
+#include "Parser/ManifestParser.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace Parser
+{
+    // **a resolved manifest graph, remembered in the build directory and trusted only while everything it was
+    // read from provably has not moved.**
+    //
+    // every invocation used to read every manifest through the parser's first two passes and walk every
+    // directory a `sources` pattern names - a fixed cost that grows with the vendored packages a project
+    // carries, paid again by an `echoc run` that changed one line of one source. What a resolve produced is a
+    // function of three things only: the bytes of each manifest, the names in each directory a pattern walked,
+    // and what this file calls the context - the roots, the target facts a manifest's `#[if:]` reads, and the
+    // package directory a `#[requires:]` resolves against. So the graph is kept beside the stamps of all
+    // three, and a recall checks every one of them before it answers: a manifest's digest through
+    // Compiler::FileDigests, a directory's mtime by a stat. Any difference is a full resolve, never a repair.
+    //
+    // **what is kept is what the build reads after the graph.** A manifest's tool attributes - `epm::` and
+    // the like - are left out, because nothing past the resolve asks for them: `-p manifest` reads every
+    // manifest afresh, as written. A requirement comes back without the span its refusal would have pointed
+    // at, since a graph that resolved has no refusal left to make.
+    //
+    // and **never a reason for a build to fail**, the rule every memo in the build directory follows: a memo
+    // that cannot be read is a full resolve, and one that cannot be written is the next invocation's too
+
+    // what a graph was resolved under, beyond the manifests and directories themselves - see above
+    uint64_t manifest_graph_context(
+        const std::vector<std::filesystem::path> &roots,
+        const Compiler::TargetFacts &facts,
+        const std::filesystem::path &package_dir
+    );
+
+    // the graph kept at `memo` under `context`, into `out`, when every manifest and directory it was read
+    // from is still as it was. False, and `out` untouched, on anything else
+    bool recall_manifest_graph(
+        const std::filesystem::path &memo,
+        uint64_t context,
+        std::vector<ModuleManifest> &out
+    );
+
+    // keeps `graph` at `memo`, stamped with what `witness` saw when it was read.
+    //
+    // **nothing is kept for a graph a stamp cannot vouch for**: one with a pattern the vendored glob answered,
+    // or one with a directory changed within `settle` of its stat - a change in the same tick as the stat
+    // would leave the mtime it compares against unmoved. The next invocation resolves it again, and keeps it
+    // once it has settled.
+    //
+    // nor for one declaring a tool attribute (`#[epm::license:]`), which this never recalls: a tool's value
+    // is an AST::AttributeValue whose meaning still leans on the manifest's tokens, and a graph recalled
+    // without them would hand the next reader a value with its tags gone and nothing saying so
+    void remember_manifest_graph(
+        const std::filesystem::path &memo,
+        uint64_t context,
+        const std::vector<ModuleManifest> &graph,
+        const GraphWitness &witness,
+        std::chrono::nanoseconds settle = std::chrono::seconds(2)
+    );
+};
+
+#endif
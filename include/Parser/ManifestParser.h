@@ -258,6 +258,35 @@ namespace Parser
     // or not this invocation would compile it, or a cycle would be a cycle only on some targets
     ActiveTargets all_targets_active(const ModuleManifest &manifest);
 
+    // what one resolve of the graph read, for Parser::remember_manifest_graph to stamp: every manifest's bytes
+    // and every directory a pattern walked.
+    //
+    // **each is taken at the moment it was read**, not after the resolve is over - a manifest saved, or a file
+    // added, while the graph was being walked has to be a mismatch on the next invocation rather than a stamp
+    // of what is there now beside a graph made of what was there then.
+    //
+    // **a directory's mtime moves exactly when a name in it comes or goes**, which is all an expanded file list
+    // is - so a pattern walked here is re-answered by a stat per directory, and an edit inside a source changes
+    // nothing this records. `complete` goes false on the first pattern that fell through to the vendored glob,
+    // which walks on its own terms and leaves no list of where it looked: a graph holding one is resolved
+    // afresh every time rather than remembered on a guess
+    struct GraphWitness
+    {
+        struct DirectoryStamp
+        {
+            std::filesystem::file_time_type modified;
+
+            // when the stat was taken - a change that shared a tick with it cannot be told apart from none
+            std::filesystem::file_time_type stamped;
+        };
+
+        std::map<std::filesystem::path, uint64_t> manifests;
+        std::map<std::filesystem::path, DirectoryStamp> directories;
+        bool complete = true;
+
+        void stamp_directory(const std::filesystem::path &directory);
+    };
+
     // the throwaway parse of every manifest this invocation reads. the driver owns it so the
     // files and tokens a refusal names still exist when the collector is printed
     struct ManifestScratch
@@ -270,6 +299,9 @@ namespace Parser
         // settles it, once per invocation, from the first user root
         std::filesystem::path package_dir;
 
+        // every manifest and directory this graph was read from - see GraphWitness
+        GraphWitness witness;
+
         explicit ManifestScratch(const Compiler::TargetFacts &facts) : parser(facts) {}
 
         AST::Module &fresh_module()
@@ -294,7 +326,11 @@ namespace Parser
     // anything else falls through to the vendored glob, so the grammar is glob's and only the cost differs:
     // glob::glob builds a std::regex per call, which measured at ~5 ms each in a debug build and made the
     // standard library's three patterns cost nearly twice what lexing all of it does. `--timings` found that.
-    std::vector<std::filesystem::path> expand_source_pattern(const std::filesystem::path &pattern);
+    //
+    // `witness`, when there is one, is told every directory the walk read - see GraphWitness
+    std::vector<std::filesystem::path> expand_source_pattern(
+        const std::filesystem::path &pattern,
+        GraphWitness *witness = nullptr);
 
     // **the sole answer to "what manifest does this path name".** A `-m`, a `#[depends:]` entry and the
     // project discovered in the working directory may each name the manifest file or the directory
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "Parser/ModuleTokens.h"
 #include "Parser/ParserCursor.h"
 #include "Parser/ParserPayload.h"
 #include "Token.h"
@@ -13,8 +14,12 @@
 
 #include <memory>
 #include <exception>
+#include <optional>
 #include <set>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
 
 namespace Parser
 {
@@ -40,6 +45,11 @@ namespace Parser
             std::vector<InputFile> files;
             AST::Module &module;
             AST::Collector &collector;
+
+            // where this module's tokens may be loaded from instead of lexed, and stored to when they are
+            // not. Unset for anything that has no Compiler::ModuleCacheKey - the loose sources on a command
+            // line, the program's own module - and then nothing is read or written
+            std::optional<TokenStore> token_store = std::nullopt;
         };
 
         struct TokenizationException : public std::exception
@@ -59,6 +69,23 @@ namespace Parser
             }
         };
 
+        // one module's files, read and lexed and not yet parsed - in the order the module holds them, which
+        // is the order all three passes walk.
+        //
+        // **what parse_module is split at**, so the half that touches nothing but its own module can run
+        // somewhere else: lexing reads one file and appends to one module's TokenCollection, while every
+        // pass after it writes into the collector the whole bundle shares. `error` is the exception the
+        // lexing half threw, kept rather than raised so that whoever collects it can raise it at the point
+        // the serial path would have - see parse_lexed_module
+        struct LexedModule
+        {
+            std::vector<std::tuple<AST::File *, AST::TokenizedFile>> files;
+            std::exception_ptr error;
+
+            // whether `files` came out of the token store rather than the lexer
+            TokenStoreUse store_use = TokenStoreUse::t_none;
+        };
+
         // when enabled, the parser will dump all symbols to stdout
         // after parsing all files in the module
         bool dump_symbols = false;
@@ -101,12 +128,59 @@ namespace Parser
             AST::Collector &collector,
             Parser::Pass pass = Parser::Pass::t_bodies) const;
 
-        void parse_input(const InputPayload &payload) const;
+        // reads, lexes and parses the payload's files - or, when the payload names a token store holding
+        // one under its key, loads the tokens and parses those. What became of the store is the answer
+        TokenStoreUse parse_input(const InputPayload &payload) const;
         void parse_module(AST::Module &module, AST::Collector &collector) const;
 
+        // fills the empty `module` from a blob AST::write_embedded_module generated and parses it - the
+        // embedded standard library. The blob holds the lexer's tokens, so nothing is lexed here; the
+        // conditional filter still runs, against this parser's facts
+        void parse_embedded_module(AST::Module &module, AST::Collector &collector, std::string_view blob) const;
+
+        // the two halves of parse_input, for a caller running the first half of several modules at once.
+        //
+        // **read_and_lex_input is safe to call concurrently for distinct modules** and is the only member
+        // that is: it touches the payload's module and nothing else - no collector, no ScopedPhase, no
+        // ProgressReporter, all three of which are process-wide and unsynchronised. Never throws; a lexer
+        // or filter refusal is carried on the result instead
+        LexedModule read_and_lex_input(const InputPayload &payload) const;
+
+        // raises `lexed.error` if there is one, exactly as parse_module would have thrown it, and otherwise
+        // runs the three passes. The ticks parse_module draws while lexing are drawn here instead, so the
+        // checklist reads the same whichever thread did the lexing
+        void parse_lexed_module(AST::Module &module, AST::Collector &collector, const LexedModule &lexed) const;
+
     private:
         std::unique_ptr<Lexer> _lexer;
 
+        // adds every file of the payload to its module and gives each one its content
+        void read_input(const InputPayload &payload) const;
+
+        // the conditional filter, as AST::Module::tokenize takes it, for `module`'s facts
+        AST::Module::TokenFilter conditional_filter(const AST::Module &module) const;
+
+        // one file's tokens, with a lexer refusal turned into the exception that names its file
+        AST::TokenizedFile lex_file(AST::Module &module, AST::File &file) const;
+
+        // every file the module holds, lexed in order, with a tick per file
+        std::vector<std::tuple<AST::File *, AST::TokenizedFile>> lex_module(AST::Module &module) const;
+
+        // the two halves of a token store, around whichever lexing path ran. Both touch the payload's
+        // module and the filesystem and nothing else, so both may run on a lexing worker.
+        //
+        // load_tokens is true when `out` was filled from the store, and otherwise leaves the module as it
+        // found it with `out.store_use` saying whether a stored one was refused
+        bool load_tokens(const InputPayload &payload, LexedModule &out) const;
+        void store_tokens(const InputPayload &payload, LexedModule &lexed) const;
+
+        // the three passes over tokens that are already in the module
+        void parse_passes(
+            AST::Module &module,
+            AST::Collector &collector,
+            const std::vector<std::tuple<AST::File *, AST::TokenizedFile>> &file_payloads
+        ) const;
+
         void parse_file_from_disk(
             std::filesystem::path path,
             AST::Module &module,
@@ -0,0 +1,100 @@
+#ifndef MODULETOKENS_H
+#define MODULETOKENS_H
+
+#pragma once
+
+#include "AST/ASTModule.h"
+
+#include <filesystem>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace Parser
+{
+    // a module's lexed tokens on disk: the content of every one of its files, and the tokens the module lexed
+    // out of them once the conditional filter had run. **the whole of what reading and lexing produce, and
+    // nothing any pass wrote** - so loading one puts a module exactly where Parser::ModuleParser would have
+    // put it just before pass 1, and the three passes run over it unchanged.
+    //
+    // **the tokens, not the tree.** The passes do not build a module in isolation: every one of them writes
+    // into the AST::Collector the whole bundle shares - the namespace tree, the function registry, the
+    // operator table - and a body resolves against what earlier modules declared there. A stored tree would
+    // have to store that shared state too, as a delta per module, and reading one back into a collector some
+    // other module already changed is a second semantic pass written by hand. Tokens are the last point at
+    // which a module is its own and nobody else's - so a reused store saves the reading and the lexing, and
+    // every module is still parsed on every compile. Parsed libraries outlive a compile only in a process
+    // that holds them - the compile server and `--watch`, see warm_libraries in main.cpp.
+    //
+    // keyed by Compiler::ModuleCacheKey, which already folds in everything the filter saw - the target facts,
+    // whether the module compiles its tests, the `#[target:]` scopes this program opened - so a key that
+    // matches is a token stream that would lex the same. What the key cannot see is this compiler's own
+    // lexer, and ECO_MODULE_TOKENS_VERSION is written into the file for that
+    typedef std::vector<std::tuple<AST::File *, AST::TokenizedFile>> LexedFiles;
+
+    // what became of one module's token store this invocation, as `--explain cache` reports it
+    enum class TokenStoreUse
+    {
+        // nothing was asked: the module has no key, or it is the program itself
+        t_none,
+
+        // loaded instead of read and lexed
+        t_reused,
+
+        // read and lexed from source, and stored for next time
+        t_stored,
+
+        // read and lexed from source, and the store could not take it
+        t_unwritable,
+
+        // one was stored under this key and did not read back. Read and lexed from source, and stored again
+        t_rejected,
+    };
+
+    // the sentence `--explain cache` prints for a use
+    const char *describe(TokenStoreUse use);
+
+    // where one module's tokens live and what it must have been stored under. **`writable` only gates
+    // the store**: a read-only directory still serves whatever is already in it, the rule the object store
+    // follows for the same reason
+    struct TokenStore
+    {
+        std::filesystem::path path;
+        std::string key;
+        bool writable = false;
+    };
+
+    // writes `module`'s files and tokens, as `files` lexed them, under `key`. **never half a file**: it is
+    // written beside the target and renamed over it, since the standard library's store is shared by every
+    // project on the machine and two builds may finish the same store at once.
+    //
+    // must be called between lexing and pass 1 - the passes mint tokens into the same collection. False when
+    // anything failed, which is never an error for the build: a cache that cannot be written is not kept
+    bool write_module_tokens(
+        const std::filesystem::path &path,
+        const std::string &key,
+        AST::Module &module,
+        const LexedFiles &files);
+
+    enum class TokenStoreRead
+    {
+        t_loaded,
+        t_absent,
+        t_rejected
+    };
+
+    // fills `module` - which must hold no file and no token yet - from the store at `path`, taking each
+    // file's path from `sources` rather than from the store, so a project that moved still hits.
+    //
+    // **all or nothing.** The whole file is decoded and checked before the module is touched: the version,
+    // the key, one file per source with the same name in the same order, and every index in bounds. Anything
+    // else is t_rejected with the module exactly as it was handed in, and the caller parses from source
+    TokenStoreRead read_module_tokens(
+        const std::filesystem::path &path,
+        const std::string &key,
+        const std::vector<std::filesystem::path> &sources,
+        AST::Module &module,
+        LexedFiles &out_files);
+};
+
+#endif
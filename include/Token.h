@@ -4,7 +4,10 @@
 #pragma once
 
 #include <vector>
+#include <deque>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <cassert>
 #include <initializer_list>
 
@@ -120,6 +123,11 @@ public:
     uint32_t line;
     uint32_t char_offset; // if you have a file source file thats 2GB, you're have other problems
 
+    // the token's spelling, as an index into its collection's TokenValueTable. Two tokens of one
+    // collection are spelled alike exactly when these are equal, so a comparison between them never
+    // has to look at a character
+    uint32_t value_id;
+
     // the missing third of a source location. line and column were always here; the file was a
     // slice scan on the module, then a walk over every module in the bundle. a token that names
     // its own file needs neither. incomplete type: this header must not include AST
@@ -130,8 +138,14 @@ public:
     // file so a location can still name a line, and a token another module owns has a file too
     bool minted = false;
 
-    Token(Type type, uint32_t line, uint32_t char_offset, AST::File *file = nullptr, bool minted = false)
-        : type(type), line(line), char_offset(char_offset), file(file), minted(minted) {}
+    Token(
+        Type type,
+        uint32_t line,
+        uint32_t char_offset,
+        uint32_t value_id,
+        AST::File *file = nullptr,
+        bool minted = false
+    ) : type(type), line(line), char_offset(char_offset), value_id(value_id), file(file), minted(minted) {}
 
     inline bool is_a(Type type) const {
         return this->type == type;
@@ -170,40 +184,122 @@ const std::string token_lit_symbol_string(const Token::Type type);
 // an attribute value being refused for no reason a user could see
 bool token_spells_a_word(const std::string &value);
 
+// every distinct spelling one TokenCollection holds, stored once.
+//
+// **this is what a token's text costs now**: a lookup, and an allocation only the first time a spelling is
+// seen. It used to be one std::string per token, which for the embedded standard library is hundreds of
+// thousands of small allocations on every `echoc run` - for `(`, `$this` and `return` over and over.
+//
+// interned strings rather than views into the file's source, because a token's value is not always
+// something the source spells: a minted `closure$N`, a float literal's implicit `0`, an interpolation
+// chunk with its quotes stripped. And `TokenReference::value()` hands out a `const std::string &` that a few
+// hundred call sites hold on to, which a deque keeps valid for as long as the collection lives.
+//
+// **per collection, and so per module, rather than per bundle.** Modules are lexed on separate threads
+// (see Parser::ModuleParser::read_and_lex_input), and a table every module shares would be a lock on the
+// one path that exists to run unlocked. Ids are therefore only comparable within one collection, which is
+// what TokenReference::same_spelling checks before it trusts them
+class TokenValueTable
+{
+public:
+    TokenValueTable() = default;
+
+    // the index is views into `_values`, so a copy rebuilds it over its own strings rather than keeping
+    // views into somebody else's. A move keeps the deque's elements where they are, and the views with them
+    TokenValueTable(const TokenValueTable &other) : _values(other._values) { reindex(); }
+    TokenValueTable(TokenValueTable &&other) = default;
+
+    TokenValueTable &operator=(const TokenValueTable &other) {
+        if (this != &other) {
+            _values = other._values;
+            reindex();
+        }
+        return *this;
+    }
+
+    TokenValueTable &operator=(TokenValueTable &&other) = default;
+
+    uint32_t intern(std::string_view value) {
+        auto found = _ids.find(value);
+
+        if (found != _ids.end()) {
+            return found->second;
+        }
+
+        const uint32_t id = static_cast<uint32_t>(_values.size());
+        const std::string &stored = _values.emplace_back(value);
+        _ids.emplace(std::string_view(stored), id);
+
+        return id;
+    }
+
+    const std::string &operator[](uint32_t id) const {
+        assert(id < _values.size());
+        return _values[id];
+    }
+
+    // how many distinct spellings, not how many tokens
+    size_t size() const {
+        return _values.size();
+    }
+
+    void clear() {
+        _ids.clear();
+        _values.clear();
+    }
+
+private:
+    std::deque<std::string> _values;
+    std::unordered_map<std::string_view, uint32_t> _ids;
+
+    void reindex() {
+        _ids.clear();
+
+        for (size_t i = 0; i < _values.size(); i++) {
+            _ids.emplace(std::string_view(_values[i]), static_cast<uint32_t>(i));
+        }
+    }
+};
+
 class TokenReference;
 struct TokenSlice;
 struct TokenCollection
 {
 
     std::vector<Token> tokens;
-    std::vector<std::string> token_values;
+
+    // what every token in `tokens` is spelled, once per spelling - see TokenValueTable
+    TokenValueTable values;
 
     // stamped onto every `push` that is not minted. Module::tokenize sets this to the file it is
     // about to lex, then clears it; lexer tests leave it null
     AST::File *appending_file = nullptr;
 
-    size_t push(const std::string &value, Token::Type type, size_t line, size_t char_offset) {
-        tokens.emplace_back(type, line, char_offset, appending_file, false);
-        token_values.push_back(value);
+    size_t push(std::string_view value, Token::Type type, size_t line, size_t char_offset) {
+        tokens.emplace_back(type, line, char_offset, values.intern(value), appending_file, false);
         return tokens.size() - 1;
     }
 
     // a token no source file spells, at the position (and file) of an existing one
     size_t push_minted(
-        const std::string &value,
+        std::string_view value,
         Token::Type type,
         uint32_t line,
         uint32_t char_offset,
         AST::File *file
     ) {
-        tokens.emplace_back(type, line, char_offset, file, true);
-        token_values.push_back(value);
+        tokens.emplace_back(type, line, char_offset, values.intern(value), file, true);
         return tokens.size() - 1;
     }
 
+    // the spelling of the token at `index`
+    inline const std::string &value_of(size_t index) const {
+        return values[tokens[index].value_id];
+    }
+
     void clear() {
         tokens.clear();
-        token_values.clear();
+        values.clear();
         appending_file = nullptr;
     }
 
@@ -252,7 +348,23 @@ public:
 
     inline const std::string &value() const {
         assert(is_valid());
-        return tokens.token_values[index];
+        return tokens.value_of(index);
+    }
+
+    // the interned id of this token's spelling - see TokenValueTable
+    inline uint32_t value_id() const {
+        assert(is_valid());
+        return tokens.tokens[index].value_id;
+    }
+
+    // is `other` spelled exactly like this token. An integer compare when both live in one collection,
+    // which is every comparison a parser makes within a module; a string compare otherwise
+    inline bool same_spelling(const TokenReference &other) const {
+        if (&tokens == &other.tokens) {
+            return value_id() == other.value_id();
+        }
+
+        return value() == other.value();
     }
 
     inline const Token &token() const {
@@ -80,6 +80,19 @@
 // mode in the cache with no diagnostic
 #define ECO_MODULE_CACHE_VERSION "58"
 
+// the module token store's format version - see Parser::read_module_tokens. **Bump this by hand whenever
+// the lexer or the conditional filter changes which tokens a source produces**, as well as when the file
+// layout itself changes.
+//
+// a separate knob from the one above because a store holds tokens rather than code: a codegen change leaves
+// every stored token stream exactly as good as it was, and a lexer change leaves every object alone. It is
+// written into the file rather than folded into the key, so a bump invalidates token stores without moving a
+// single object's key.
+//
+// the embedded standard library's blob is versioned by it too - it holds the same lexer's tokens, see
+// AST::write_embedded_module - and stdlib/build/stdlib_embedded.h stops compiling until it is regenerated
+#define ECO_MODULE_TOKENS_VERSION 1
+
 // the same knob for the C object cache, and a separate one because the two caches are separate stores
 // keyed on unrelated inputs: a codegen change moves every Echo object and no C one, and a change to how
 // `#[cc:]` builds a translation unit - a flag added, the language inference changed - moves every C object
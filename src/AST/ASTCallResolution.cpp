@@ -269,6 +269,27 @@ namespace AST
 
             return true;
         }
+
+        // **the namespace a free call's overload set is searched outward from**, or null when the set
+        // comes from somewhere else - a constructed type, a static owner, a shorthand's destination or a
+        // receiver. the arms of CallResolver::candidates_for in the order it asks them, so the one place
+        // that remembers a match by namespace cannot disagree with the one that found the set
+        const Namespace *free_call_namespace(const FunctionCallExprNode &call)
+        {
+            if (!call.constructed_type.is_unknown()) {
+                return nullptr;
+            }
+
+            if (call.static_owner.is_type_param() || call.static_owner.has_complex_type()) {
+                return nullptr;
+            }
+
+            if (call.is_shorthand_static_call()) {
+                return nullptr;
+            }
+
+            return call.lookup_namespace;
+        }
     }
 
     std::vector<FunctionDeclNode *> CallResolver::candidates_for(const FunctionCallExprNode &call) const
@@ -316,8 +337,8 @@ namespace AST
         }
 
         // a free call: the namespace it was written in, searched outward by the registry
-        if (call.lookup_namespace != nullptr) {
-            return _collector.functions.overloads(call.lookup_name(), *call.lookup_namespace);
+        if (const Namespace *ns = free_call_namespace(call)) {
+            return _collector.functions.overloads(call.lookup_name(), *ns);
         }
 
         // a member call. the receiver is argument 0, already addressed by the parser as
@@ -335,17 +356,12 @@ namespace AST
         return find_member_functions(receiver_type.get_complex_type(), call.lookup_name());
     }
 
-    CallResolver::Result CallResolver::choose_declaration(
-        FunctionCallExprNode &call,
+    FunctionMatch CallResolver::match_overloads(
+        const FunctionCallExprNode &call,
         const std::vector<FunctionDeclNode *> &candidates,
-        const CodeRef &at,
-        bool report
+        const std::vector<ValueType> &argument_types
     )
     {
-        const std::string &name = call.token_function_name.value();
-
-        const std::vector<ValueType> argument_types = argument_types_of(call);
-
         // with a single candidate there is nothing to choose between, so it is taken as written and
         // every judgement about it is left to the passes that specialise in one: the monomorphizer
         // reports an unsatisfied constraint by name, the type checker reports which argument is
@@ -400,7 +416,53 @@ namespace AST
             });
         }
 
-        const auto match = match_function(match_candidates, argument_types, call.arguments);
+        return match_function(match_candidates, argument_types, call.arguments);
+    }
+
+    FunctionMatch CallResolver::remembered_match(
+        const FunctionCallExprNode &call,
+        const std::vector<FunctionDeclNode *> &candidates,
+        const std::vector<ValueType> &argument_types
+    )
+    {
+        const Namespace *ns = free_call_namespace(call);
+
+        // **only a free call over a set with nothing generic in it.** a template is scored against what
+        // can_instantiate binds from *this* call - its explicit type arguments included - so the
+        // arguments' types and shapes are not the whole of what its answer depends on. a single
+        // candidate is match_function's short circuit, and cheaper to take again than to look up
+        const bool rememberable = ns != nullptr && candidates.size() > 1
+            && std::none_of(candidates.begin(), candidates.end(),
+                [](const FunctionDeclNode *candidate) { return candidate->is_generic(); });
+
+        if (!rememberable) {
+            return match_overloads(call, candidates, argument_types);
+        }
+
+        MatchKey key = MatchKey::of(*ns, argument_types, call.arguments);
+
+        if (const FunctionMatch *remembered = _collector.functions.recall_match(call.lookup_name(), key)) {
+            return *remembered;
+        }
+
+        FunctionMatch match = match_overloads(call, candidates, argument_types);
+        _collector.functions.remember_match(call.lookup_name(), std::move(key), match);
+
+        return match;
+    }
+
+    CallResolver::Result CallResolver::choose_declaration(
+        FunctionCallExprNode &call,
+        const std::vector<FunctionDeclNode *> &candidates,
+        const CodeRef &at,
+        bool report
+    )
+    {
+        const std::string &name = call.token_function_name.value();
+
+        const std::vector<ValueType> argument_types = argument_types_of(call);
+
+        const FunctionMatch match = remembered_match(call, candidates, argument_types);
 
         switch (match.outcome) {
         case FunctionMatch::Outcome::t_resolved:
@@ -47,11 +47,11 @@ bool ConstFolding::run_round()
         }
     }
 
-    // **once for the round, not once per discard.** Bundle::forget_nodes sweeps every bucket of every
-    // module, and a round folds one subtree away per `const if` and per `const(...)` - which with the
-    // stdlib is several per generic instantiation. nothing between a discard and here reads
+    // **once for the round, not once per discard.** Bundle::forget_nodes visits every module, and a round
+    // folds one subtree away per `const if` and per `const(...)` - which with the stdlib is several per
+    // generic instantiation. nothing between a discard and here reads
     // NodeCollection::of_type: this walk goes through scope children, and the sweeps that do care -
-    // Monomorphizer::snapshot_calls and TypeLowering::build_function_maps - are the next round and
+    // Monomorphizer::refresh and TypeLowering::build_function_maps - are the next step and
     // codegen respectively
     _detached.flush(_bundle);
 
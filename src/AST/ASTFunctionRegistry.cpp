@@ -1,5 +1,6 @@
 #include "AST/ASTFunctionRegistry.h"
 
+#include "AST/ASTArgumentFit.h"
 #include "AST/ASTCollector.h"
 #include "AST/ASTMemberLookup.h"
 #include "AST/ASTNamespace.h"
@@ -118,6 +119,10 @@ void AST::FunctionRegistry::register_function(
     }
 
     _by_name[ns][name].push_back(decl);
+
+    // every match remembered for the name, whichever namespace it was searched from: an overload set
+    // found further out may be hidden by this one now, and one found here has grown
+    _matches.erase(name);
 }
 
 void AST::FunctionRegistry::register_member_function(
@@ -332,6 +337,67 @@ AST::FunctionDeclNode *AST::FunctionRegistry::find_by_signature(
     return nullptr;
 }
 
+AST::MatchKey AST::MatchKey::of(
+    const AST::Namespace &ns,
+    const std::vector<AST::ValueType> &argument_types,
+    const std::vector<AST::ExprNode *> &arguments
+)
+{
+    MatchKey key { .ns = &ns, .argument_types = argument_types, .argument_shapes = {} };
+    key.argument_shapes.reserve(argument_types.size());
+
+    // parallel to the types, and as short as match_function allows `arguments` to be
+    for (size_t i = 0; i < argument_types.size(); i++) {
+        key.argument_shapes.push_back(argument_shape(i < arguments.size() ? arguments[i] : nullptr));
+    }
+
+    return key;
+}
+
+size_t AST::MatchKeyHash::operator()(const AST::MatchKey &key) const
+{
+    // a ValueType hashes in constant time now that its levels are interned, so this is linear in the
+    // arguments and nothing else
+    size_t h = std::hash<const Namespace *>{}(key.ns);
+
+    for (size_t i = 0; i < key.argument_types.size(); i++) {
+        h ^= std::hash<ValueType>{}(key.argument_types[i]) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= static_cast<size_t>(key.argument_shapes[i]) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+
+    return h;
+}
+
+const AST::FunctionMatch *AST::FunctionRegistry::recall_match(const std::string &name, const AST::MatchKey &key)
+{
+    if (!_remembering) {
+        return nullptr;
+    }
+
+    const auto for_name = _matches.find(name);
+
+    if (for_name != _matches.end()) {
+        const auto found = for_name->second.find(key);
+
+        if (found != for_name->second.end()) {
+            _match_counts.hits++;
+            return &found->second;
+        }
+    }
+
+    _match_counts.misses++;
+    return nullptr;
+}
+
+void AST::FunctionRegistry::remember_match(const std::string &name, AST::MatchKey key, AST::FunctionMatch match)
+{
+    if (!_remembering) {
+        return;
+    }
+
+    _matches[name].insert_or_assign(std::move(key), std::move(match));
+}
+
 std::string AST::FunctionRegistry::debug_dump() const
 {
     std::string buffer;
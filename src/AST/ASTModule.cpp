@@ -67,8 +67,25 @@ AST::TokenizedFile AST::Module::tokenize(
         }
     };
 
-    AppendingFile stamp(tokens, &file);
-    lexer.tokenize(tokens, file.content.value());
+    {
+        AppendingFile stamp(tokens, &file);
+        lexer.tokenize(tokens, file.content.value());
+    }
+
+    return filter_tokenized_file(file, startindex, filter);
+}
+
+AST::TokenizedFile AST::Module::filter_tokenized_file(
+    AST::File &file,
+    size_t from,
+    const AST::Module::TokenFilter &filter
+)
+{
+    if (file.module != this) {
+        throw std::runtime_error("Cannot filter tokens for a file that is not in this module");
+    }
+
+    assert(from <= tokens.size());
 
     // **between lexing and the slice**, which is the whole of why the filter is a parameter here rather
     // than something a caller does afterwards: a slice measured first and filtered second would name
@@ -76,16 +93,30 @@ AST::TokenizedFile AST::Module::tokenize(
     if (filter) {
         std::string error;
 
-        if (!filter(tokens, startindex, error)) {
+        if (!filter(tokens, from, error)) {
             throw TokenFilterException(error);
         }
     }
 
-    size_t endindex = tokens.size();
+    _tokenized_files.push_back(TokenizedFile {
+        .file = &file,
+        .token_slice = tokens.slice(from, tokens.size())
+    });
+
+    return _tokenized_files.back();
+}
+
+AST::TokenizedFile AST::Module::adopt_tokenized_file(AST::File &file, size_t start, size_t end)
+{
+    if (file.module != this) {
+        throw std::runtime_error("Cannot adopt tokens for a file that is not in this module");
+    }
+
+    assert(start <= end && end <= tokens.size());
 
     _tokenized_files.push_back(TokenizedFile {
         .file = &file,
-        .token_slice = tokens.slice(startindex, endindex)
+        .token_slice = tokens.slice(start, end)
     });
 
     return _tokenized_files.back();
@@ -3,52 +3,340 @@
 #include <fstream>
 #include <fmt/format.h>
 #include "AST/ASTModule.h"
+#include "Lexer.h"
+#include "eco.h"
+
+namespace
+{
+    // what the blob opens with, ahead of its version
+    constexpr std::string_view k_magic = "ECOEMBED";
+
+    // the smallest a token can be written in: its type and three one-byte varints
+    constexpr size_t k_min_token_record_size = 4;
+
+    // **variable-length integers** rather than the fixed-width records a token store uses. A store is read
+    // from disk once per build; this is compiled into every released binary, and nearly every field
+    // of a token - a column, a line advanced by zero or one, a spelling among a few thousand - fits a byte
+    void put_varint(std::string &out, uint64_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+
+        out.push_back(static_cast<char>(value));
+    }
+
+    void put_bytes(std::string &out, std::string_view bytes)
+    {
+        put_varint(out, bytes.size());
+        out.append(bytes);
+    }
+
+    // a token's line, as how far it moved from the one before. Signed, because nothing promises the lexer
+    // never reports an earlier line, and a promise nobody made is not one to encode
+    uint64_t zigzag(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    // a blob that does not decode. The only way to get one is a header edited by hand or written by a
+    // compiler the version check did not catch, so the sentence says what fixes it
+    [[noreturn]] void refuse(const std::string &what)
+    {
+        throw std::runtime_error(fmt::format(
+            "The embedded module does not decode ({}). Regenerate it with '--emit-stdlib-header'.", what));
+    }
+
+    class BlobReader
+    {
+    public:
+        explicit BlobReader(std::string_view bytes) : _bytes(bytes) {}
+
+        size_t remaining() const { return _bytes.size() - _at; }
+
+        uint8_t u8()
+        {
+            need(1);
+            return static_cast<uint8_t>(_bytes[_at++]);
+        }
+
+        uint32_t u32()
+        {
+            need(4);
+
+            uint32_t value = 0;
+            for (int i = 0; i < 4; i++) {
+                value |= static_cast<uint32_t>(static_cast<uint8_t>(_bytes[_at++])) << (8 * i);
+            }
+
+            return value;
+        }
+
+        uint64_t varint()
+        {
+            uint64_t value = 0;
+
+            for (int shift = 0; shift < 64; shift += 7) {
+                const uint8_t byte = u8();
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+                if ((byte & 0x80) == 0) {
+                    return value;
+                }
+            }
+
+            refuse("an integer runs on");
+        }
+
+        std::string_view raw(size_t length)
+        {
+            need(length);
+
+            std::string_view view = _bytes.substr(_at, length);
+            _at += length;
+
+            return view;
+        }
+
+        std::string_view bytes()
+        {
+            return raw(static_cast<size_t>(varint()));
+        }
+
+    private:
+        std::string_view _bytes;
+        size_t _at = 0;
+
+        void need(uint64_t length) const
+        {
+            if (length > remaining()) {
+                refuse("it ends early");
+            }
+        }
+    };
+
+    std::string encode_module(AST::Module &module)
+    {
+        // lexed here, into a collection of its own, rather than taken from `module.tokens`: by now the module
+        // has been filtered for this machine and the passes have minted tokens into it
+        Lexer lexer;
+        TokenCollection tokens;
+
+        struct Lexed
+        {
+            std::string path;
+            std::string_view content;
+            size_t start;
+            size_t end;
+        };
+
+        std::vector<Lexed> files;
+
+        for (auto &file : module.files()) {
+            // this is not really clean, but it works for now
+            // we can take the "STDLIB_SOURCE_DIR" define to determine the relative path
+            // of the full file path if it begins with it
+            std::string file_path = file.get_path().string();
+            if (file_path.find(STDLIB_SOURCE_DIR) == 0) {
+                file_path = "stdlib:" + file_path.substr(strlen(STDLIB_SOURCE_DIR));
+            }
+
+            if (!file.content.has_value()) {
+                throw std::runtime_error(fmt::format("Cannot embed a file without content: {}", file_path));
+            }
+
+            const size_t start = tokens.size();
+            lexer.tokenize(tokens, file.content.value());
+
+            files.push_back(Lexed { file_path, file.content.value(), start, tokens.size() });
+        }
+
+        std::string out;
+        out.append(k_magic);
+
+        const uint32_t version = ECO_MODULE_TOKENS_VERSION;
+        for (int i = 0; i < 4; i++) {
+            out.push_back(static_cast<char>((version >> (8 * i)) & 0xFF));
+        }
+
+        // the spellings first, so every id a token names below is already known when it is read
+        put_varint(out, tokens.values.size());
+        for (size_t i = 0; i < tokens.values.size(); i++) {
+            put_bytes(out, tokens.values[static_cast<uint32_t>(i)]);
+        }
+
+        // the whole module's count ahead of the files, so the collection is sized once rather than per file
+        put_varint(out, files.size());
+        put_varint(out, tokens.size());
+
+        for (const Lexed &file : files) {
+            put_bytes(out, file.path);
+            put_bytes(out, file.content);
+            put_varint(out, file.end - file.start);
+
+            int64_t line = 0;
+
+            for (size_t i = file.start; i < file.end; i++) {
+                const Token &token = tokens.tokens[i];
+
+                out.push_back(static_cast<char>(token.type));
+                put_varint(out, zigzag(static_cast<int64_t>(token.line) - line));
+                put_varint(out, token.char_offset);
+                put_varint(out, token.value_id);
+
+                line = token.line;
+            }
+        }
+
+        return out;
+    }
+};
 
 void AST::write_embedded_module(AST::Module &module, const std::string &output_path)
 {
+    const std::string blob = encode_module(module);
+
     std::ofstream output(output_path);
     if (!output.is_open()) {
         throw std::runtime_error(fmt::format("Failed to embedding file for writing: {}", output_path));
     }
 
-    output << "#include \"AST/ASTModule.h\"\n\n";
-    output << "#include \"AST/ASTBundle.h\"\n\n";
+    output << "// generated by `echoc run --emit-stdlib-header`, do not edit - see AST::write_embedded_module\n";
+    output << "#include \"eco.h\"\n\n";
+    output << "#include <string_view>\n\n";
+
+    // a header from another lexer is a build error rather than a confused start-up
+    output << fmt::format(
+        "static_assert(ECO_MODULE_TOKENS_VERSION == {}, "
+        "\"stdlib_embedded.h was generated by another version of echoc - regenerate it with '--emit-stdlib-header'\");\n\n",
+        ECO_MODULE_TOKENS_VERSION);
 
     output << "namespace EmbeddedModule\n{\n\n";
 
-    output << fmt::format("void load_{}_module(AST::Bundle &bundle, AST::Module &module)\n", module.name);
+    // decimal and unpadded: the header is compiled into every released binary, and three characters a
+    // byte against "0x2f, "'s six is half the text for the compiler to read
+    output << fmt::format("static const unsigned char {}_blob[] = {{\n", module.name);
+
+    size_t column = 0;
+    for (char byte : blob) {
+        const std::string number = std::to_string(static_cast<unsigned int>(byte) & 0xff);
+
+        if (column + number.size() + 1 > 120) {
+            output << "\n";
+            column = 0;
+        }
+
+        output << number << ",";
+        column += number.size() + 1;
+    }
+
+    output << "\n};\n\n";
+
+    output << fmt::format("inline std::string_view {}_module_blob()\n", module.name);
     output << "{\n";
+    output << fmt::format(
+        "    return std::string_view(reinterpret_cast<const char *>({}_blob), sizeof({}_blob));\n",
+        module.name, module.name);
+    output << "}\n\n";
+
+    output << "}\n";
+
+    output.close();
+}
 
-    int file_index = 0;
-    for (auto &file : module.files()) {
-        file_index++;
-        std::string filevar = fmt::format("file_{}", file_index);
+std::vector<std::tuple<AST::File *, AST::TokenizedFile>> AST::load_embedded_module(
+    AST::Module &module,
+    std::string_view blob,
+    const AST::Module::TokenFilter &filter)
+{
+    assert(module.tokens.size() == 0);
+    assert(module.files().first() == nullptr);
+
+    BlobReader in(blob);
+
+    if (in.raw(k_magic.size()) != k_magic) {
+        refuse("it is not an embedded module");
+    }
+
+    const uint32_t version = in.u32();
+    if (version != ECO_MODULE_TOKENS_VERSION) {
+        throw std::runtime_error(fmt::format(
+            "The embedded module was generated for format {}, and this compiler reads {}. "
+            "Regenerate it with '--emit-stdlib-header'.",
+            version, ECO_MODULE_TOKENS_VERSION));
+    }
+
+    // into the module's own table, which is empty, so it hands the ids out in the order they were written
+    const uint64_t value_count = in.varint();
+
+    for (uint64_t i = 0; i < value_count; i++) {
+        if (module.tokens.values.intern(in.bytes()) != i) {
+            refuse("a spelling is stored twice");
+        }
+    }
+
+    const uint64_t file_count = in.varint();
+    const uint64_t total_tokens = in.varint();
+
+    if (total_tokens > in.remaining() / k_min_token_record_size) {
+        refuse("it claims more tokens than it holds");
+    }
 
-        // this is not really clean, but it works for now
-        // we can take the "STDLIB_SOURCE_DIR" define to determine the relative path
-        // of the full file path if it begins with it
-        std::string file_path = file.get_path().string();
-        if (file_path.find(STDLIB_SOURCE_DIR) == 0) {
-            file_path = "stdlib:" + file_path.substr(strlen(STDLIB_SOURCE_DIR));
+    module.tokens.tokens.reserve(static_cast<size_t>(total_tokens));
+
+    std::vector<std::tuple<AST::File *, AST::TokenizedFile>> files;
+
+    for (uint64_t f = 0; f < file_count; f++) {
+        const std::string_view path = in.bytes();
+        const std::string_view content = in.bytes();
+
+        AST::File &file = module.add_file(std::filesystem::path(std::string(path)));
+        file.set_content(content.data(), content.size());
+
+        const uint64_t token_count = in.varint();
+
+        if (token_count > in.remaining() / k_min_token_record_size) {
+            refuse("a file claims more tokens than the blob holds");
         }
 
-        output << fmt::format("    auto &{} = module.add_file(\"{}\");\n", filevar, file_path);
+        const size_t start = module.tokens.size();
+
+        int64_t line = 0;
+
+        for (uint64_t i = 0; i < token_count; i++) {
+            const uint8_t type = in.u8();
+            line += unzigzag(in.varint());
+            const uint64_t char_offset = in.varint();
+            const uint64_t value_id = in.varint();
 
-        output << fmt::format("    static const unsigned char {}_data[] = {{\n", filevar);
-        output << "        ";
-        auto content = file.content.value_or("");
-        for (size_t i = 0; i < content.size(); ++i) {
-            if (i > 0 && i % 12 == 0) {
-                output << "\n        ";
+            if (type > static_cast<uint8_t>(Token::Type::t_unknown)
+                || line < 0 || line > UINT32_MAX
+                || char_offset > UINT32_MAX
+                || value_id >= value_count) {
+                refuse("a token is out of range");
             }
-            output << "0x" << std::hex << std::setw(2) << std::setfill('0') << (static_cast<unsigned int>(content[i]) & 0xff) << ", ";
+
+            module.tokens.tokens.emplace_back(
+                static_cast<Token::Type>(type),
+                static_cast<uint32_t>(line),
+                static_cast<uint32_t>(char_offset),
+                static_cast<uint32_t>(value_id),
+                &file,
+                false);
         }
-        output << "\n    };\n";
-        output << fmt::format("    {}.set_content(reinterpret_cast<const char*>({}_data), sizeof({}_data));\n", filevar, filevar, filevar);
+
+        files.push_back(std::make_tuple(&file, module.filter_tokenized_file(file, start, filter)));
     }
 
-    output << "}\n";
-    output << "}\n";
+    if (in.remaining() != 0) {
+        refuse("there is more after the last file");
+    }
 
-    output.close();
+    return files;
 }
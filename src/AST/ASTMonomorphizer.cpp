@@ -196,6 +196,64 @@ namespace AST
         return calls;
     }
 
+    template <typename T, typename Done>
+    size_t Monomorphizer::refresh(Worklist<T> &list, Done done)
+    {
+        size_t admitted = 0;
+        size_t index = 0;
+
+        for (auto &module_ptr : _bundle.modules) {
+            if (index == list.lanes.size()) {
+                list.lanes.push_back({ .module = module_ptr.get(), .seen = 0, .open = {} });
+            }
+
+            auto &lane = list.lanes[index++];
+            const NodeCollection &nodes = lane.module->nodes;
+
+            // every kind and not only T's, but only what is new: a clone made since the last refresh,
+            // a call a rewriter minted, a drop the ownership pass inserted
+            for (Node *node : nodes.since(lane.seen)) {
+                if (node->get_node_type() == T::node_type) {
+                    lane.open.push_back(static_cast<T *>(node));
+                    admitted++;
+                }
+            }
+
+            lane.seen = nodes.size();
+
+            // forgotten is what a sweep over `of_type` would not have seen, and done is what it would
+            // have seen and skipped
+            std::erase_if(lane.open, [&](T *node) { return nodes.is_forgotten(node) || done(node); });
+        }
+
+        return admitted;
+    }
+
+    namespace
+    {
+        // **a terminal call owes neither step anything**: step C asks CallResolver::settle, which answers
+        // a terminal state from the node, and step A only rewires a call still naming a template - which
+        // a settled call never does, settle() waiting on exactly that, and a failed one never got a
+        // declaration to name
+        bool call_is_done(const FunctionCallExprNode *call)
+        {
+            return call_is_terminal(call->settlement);
+        }
+
+        // a declaration step B will skip in every round from now on. a determined type is never made
+        // undetermined again, and a type parameter the author wrote is substituted in the clones and
+        // never on the template - see the step for why it is skipped at all
+        bool decl_is_done(const VarDeclNode *decl)
+        {
+            if (!decl->has_type()) {
+                return false;
+            }
+
+            return !is_undetermined_type(decl->type())
+                || (decl->type_node()->type_token.has_value() && contains_type_param(decl->type()));
+        }
+    };
+
     // step A: a call naming a template becomes a call naming a concrete instance
     //
     // only the declaration is rewired here. fitting the arguments to it is step C's, through the one
@@ -206,36 +264,44 @@ namespace AST
     {
         bool progressed = false;
 
-        for (auto &[call, mod] : snapshot_calls()) {
-            if (_processed.count(call) || !call->decl || !call->decl->is_generic()) {
-                continue;
-            }
+        RoundWork &work = _rounds.back();
+        work.calls_admitted += refresh(_open_calls, call_is_done);
 
-            bool is_error = false;
-            auto args = determine_type_args(call, *mod, is_error);
-            if (!args) {
-                // reported errors are final; unresolved template-body calls retry later
-                if (is_error) {
-                    _processed.insert(call);
+        for (auto &lane : _open_calls.lanes) {
+            Module *mod = lane.module;
+            work.calls_visited += lane.open.size();
+
+            for (FunctionCallExprNode *call : lane.open) {
+                if (_processed.count(call) || !call->decl || !call->decl->is_generic()) {
+                    continue;
+                }
+
+                bool is_error = false;
+                auto args = determine_type_args(call, *mod, is_error);
+                if (!args) {
+                    // reported errors are final; unresolved template-body calls retry later
+                    if (is_error) {
+                        _processed.insert(call);
+                    }
+                    continue;
                 }
-                continue;
-            }
 
-            _processed.insert(call);
+                _processed.insert(call);
 
-            if (_trace) {
-                std::string arg_desc;
-                for (size_t i = 0; i < args->size(); i++) {
-                    arg_desc += (i > 0 ? ", " : "") + (*args)[i].get_type_desciption();
+                if (_trace) {
+                    std::string arg_desc;
+                    for (size_t i = 0; i < args->size(); i++) {
+                        arg_desc += (i > 0 ? ", " : "") + (*args)[i].get_type_desciption();
+                    }
+                    std::cout << "[mono] round " << round << ": resolve '" << call->decl->func_name()
+                              << "' with <" << arg_desc << ">" << std::endl;
                 }
-                std::cout << "[mono] round " << round << ": resolve '" << call->decl->func_name()
-                          << "' with <" << arg_desc << ">" << std::endl;
-            }
 
-            FunctionDeclNode *instance = get_or_create_function_instance(call->decl, *args);
-            if (instance) {
-                call->decl = instance;
-                progressed = true;
+                FunctionDeclNode *instance = get_or_create_function_instance(call->decl, *args);
+                if (instance) {
+                    call->decl = instance;
+                    progressed = true;
+                }
             }
         }
 
@@ -252,9 +318,13 @@ namespace AST
     {
         bool progressed = false;
 
-        for (auto &module_ptr : _bundle.modules) {
-            Module &mod = *module_ptr;
-            for (auto *decl : mod.nodes.of_type<VarDeclNode>()) {
+        refresh(_stale_decls, decl_is_done);
+
+        for (auto &lane : _stale_decls.lanes) {
+            Module &mod = *lane.module;
+            _rounds.back().decls_visited += lane.open.size();
+
+            for (auto *decl : lane.open) {
                 if (!decl->has_type() || !decl->init_expr) {
                     continue;
                 }
@@ -385,18 +455,30 @@ namespace AST
         CallResolver resolver(_collector);
         bool progressed = false;
 
-        for (auto &[call, mod] : snapshot_calls()) {
-            // a settled call owes nothing, and a failed one is decided on types no later round can
-            // change - re-deriving its match would re-derive its diagnostic with it
-            if (call_is_terminal(call->settlement)) {
-                continue;
-            }
+        // refreshed again rather than reusing step A's: everything between the two - a clone, a
+        // rewriter's `operator []`, an interpolation's `str::from` - made calls this step has to see
+        RoundWork &work = _rounds.back();
+        work.calls_admitted += refresh(_open_calls, call_is_done);
+
+        for (auto &lane : _open_calls.lanes) {
+            Module *mod = lane.module;
+            work.calls_visited += lane.open.size();
+
+            for (FunctionCallExprNode *call : lane.open) {
+                // a settled call owes nothing, and a failed one is decided on types no later round can
+                // change - re-deriving its match would re-derive its diagnostic with it. the refresh
+                // dropped every call that was terminal then, so this is one a call earlier in the lane
+                // made terminal: a shorthand its enclosing call reported for
+                if (call_is_terminal(call->settlement)) {
+                    continue;
+                }
 
-            const auto result = resolver.settle(
-                *call, mod->nodes, code_ref_for(*mod, call->token_function_name), false);
+                const auto result = resolver.settle(
+                    *call, mod->nodes, code_ref_for(*mod, call->token_function_name), false);
 
-            if (result == CallResolver::Result::t_settled) {
-                progressed = true;
+                if (result == CallResolver::Result::t_settled) {
+                    progressed = true;
+                }
             }
         }
 
@@ -578,6 +660,11 @@ namespace AST
             }
         }
 
+        // every module is parsed, so nothing an overload match reads is still being declared - only
+        // new overloads, and FunctionRegistry forgets a name's matches when it gets one. the rounds
+        // below are what ask the same calls again
+        _collector.functions.remember_matches();
+
         // fixpoint: each round takes every call as far as the types now known allow, and cloning a
         // template exposes its body's calls - with concrete types - for the next round
         //
@@ -602,6 +689,7 @@ namespace AST
                 break;
             }
 
+            _rounds.push_back(RoundWork {});
             progressed |= instantiate_generic_calls(rounds);
 
             // **everything the language asked the compiler to decide, decided before anything else looks
@@ -823,10 +911,30 @@ namespace AST
             return title + "\n" + body;
         };
 
+        // how the fixpoint got there, one line per round and in round order. a visit is one node a
+        // step looked at, so a round that visits about what the round before it made is the worklists
+        // doing their job, and one that visits every call in the bundle is a worklist that stopped
+        // letting go of what it was done with
+        size_t calls_in_bundle = 0;
+        for (auto &module_ptr : _bundle.modules) {
+            calls_in_bundle += module_ptr->nodes.of_type<FunctionCallExprNode>().size();
+        }
+
+        std::vector<std::string> round_lines;
+        for (size_t i = 0; i < _rounds.size(); i++) {
+            const RoundWork &work = _rounds[i];
+            round_lines.push_back("- round " + std::to_string(i + 1) + ": "
+                + std::to_string(work.calls_admitted) + " new calls, "
+                + std::to_string(work.calls_visited) + " call visits, "
+                + std::to_string(work.decls_visited) + " declaration visits");
+        }
+
         std::string result = "Monomorphization instances\n{\n";
         result += DD::tabbify(section("Instances created:", instance_lines), 2);
         result += DD::tabbify(section("Rewired call sites:", call_lines), 2);
         result += DD::tabbify(section("Struct instantiations:", struct_lines), 2);
+        result += DD::tabbify(section("Fixpoint: " + std::to_string(_rounds.size()) + " rounds, "
+            + std::to_string(calls_in_bundle) + " calls in the bundle", round_lines), 2);
         result += "}\n";
         return result;
     }
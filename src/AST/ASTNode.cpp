@@ -1 +1,68 @@
 #include "AST/ASTNode.h"
+
+#include <atomic>
+
+namespace
+{
+    // under AddressSanitizer the leak check runs at exit and would report every node skip_teardown left
+    // alone - so there the switch does nothing, and a Debug build tears down the way it always did
+#if defined(__SANITIZE_ADDRESS__)
+    constexpr bool k_can_skip_teardown = false;
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+    constexpr bool k_can_skip_teardown = false;
+#else
+    constexpr bool k_can_skip_teardown = true;
+#endif
+#else
+    constexpr bool k_can_skip_teardown = true;
+#endif
+
+    std::atomic<bool> &teardown_skipped()
+    {
+        static std::atomic<bool> skipped{ false };
+        return skipped;
+    }
+};
+
+void AST::NodeCollection::skip_teardown()
+{
+    if (k_can_skip_teardown) {
+        teardown_skipped().store(true, std::memory_order_relaxed);
+    }
+}
+
+AST::NodeCollection::~NodeCollection()
+{
+    if (teardown_skipped().load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // the destructors and nothing else - the arena returns the memory after this body. No node owns another
+    // (a child is a raw pointer into the same arena), so the order is the one they were made in and nothing
+    // depends on it
+    for (Node *node : nodes) {
+        node->~Node();
+    }
+}
+
+void AST::NodeCollection::sweep(size_t kind) const
+{
+    auto &bucket = buckets[kind];
+
+    bucket.erase(
+        std::remove_if(bucket.begin(), bucket.end(),
+            [this](Node *node) { return forgotten.count(node) > 0; }),
+        bucket.end());
+
+    dirty[kind] = false;
+}
+
+void AST::NodeCollection::settle() const
+{
+    for (size_t kind = 0; kind < node_type_count; kind++) {
+        if (dirty[kind]) {
+            sweep(kind);
+        }
+    }
+}
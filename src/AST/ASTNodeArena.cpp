@@ -0,0 +1,82 @@
+#include "AST/ASTNodeArena.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+AST::NodeArena::NodeArena(NodeArena &&other) noexcept :
+    _blocks(std::move(other._blocks)),
+    _ranges(std::move(other._ranges)),
+    _cursor(std::exchange(other._cursor, nullptr)),
+    _end(std::exchange(other._end, nullptr)),
+    _reserved(std::exchange(other._reserved, 0))
+{
+    other._blocks.clear();
+    other._ranges.clear();
+}
+
+AST::NodeArena &AST::NodeArena::operator=(NodeArena &&other) noexcept
+{
+    if (this != &other) {
+        _blocks = std::move(other._blocks);
+        _ranges = std::move(other._ranges);
+        _cursor = std::exchange(other._cursor, nullptr);
+        _end = std::exchange(other._end, nullptr);
+        _reserved = std::exchange(other._reserved, 0);
+
+        other._blocks.clear();
+        other._ranges.clear();
+    }
+
+    return *this;
+}
+
+void *AST::NodeArena::allocate_slow(size_t size, size_t align)
+{
+    // `new std::byte[]` is aligned for any fundamental type, which is every node: none asks for more.
+    // Deliberately not make_unique, which would zero every block only for a constructor to overwrite it
+    const size_t needed = size + align;
+
+    if (needed > k_block_size / 4) {
+        // an outsized request gets a block to itself, and the current block stays the one being filled -
+        // starting a fresh one would waste the rest of it for the sake of one allocation
+        std::byte *block = add_block(needed);
+
+        const uintptr_t at = (reinterpret_cast<uintptr_t>(block) + (align - 1)) & ~(uintptr_t)(align - 1);
+        return reinterpret_cast<void *>(at);
+    }
+
+    _cursor = add_block(k_block_size);
+    _end = _cursor + k_block_size;
+
+    return allocate(size, align);
+}
+
+std::byte *AST::NodeArena::add_block(size_t size)
+{
+    std::byte *block = _blocks.emplace_back(new std::byte[size]).get();
+    _reserved += size;
+
+    const std::pair<const std::byte *, const std::byte *> range { block, block + size };
+    _ranges.insert(std::upper_bound(_ranges.begin(), _ranges.end(), range,
+        [](const auto &a, const auto &b) { return std::less<const std::byte *>()(a.first, b.first); }), range);
+
+    return block;
+}
+
+bool AST::NodeArena::owns(const void *ptr) const
+{
+    // std::less and not `<`: the blocks are separate allocations, and only std::less is guaranteed a total
+    // order over pointers into different ones
+    const auto *at = static_cast<const std::byte *>(ptr);
+
+    auto after = std::upper_bound(_ranges.begin(), _ranges.end(), at,
+        [](const std::byte *p, const auto &range) { return std::less<const std::byte *>()(p, range.first); });
+
+    if (after == _ranges.begin()) {
+        return false;
+    }
+
+    return std::less<const std::byte *>()(at, std::prev(after)->second);
+}
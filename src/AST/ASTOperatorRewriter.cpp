@@ -72,7 +72,7 @@ bool OperatorRewriter::run_round()
 
     // **once for the round, not once per discard** - see _detached. nothing between a rewrite and here
     // reads NodeCollection::of_type: this walk goes through scope children, and the sweeps that do care -
-    // Monomorphizer::snapshot_calls and TypeLowering::build_function_maps - are the next round and
+    // Monomorphizer::refresh and TypeLowering::build_function_maps - are the next step and
     // codegen respectively. finalize() calls this, so the flush covers that pass too
     _detached.flush(_bundle);
 
@@ -150,7 +150,7 @@ AST::OperatorRegistry::OperatorRegistry()
 
 void AST::OperatorRegistry::register_predefined_token_op(const Token::Type &type)
 {
-    auto t = Token(type, 0, 0);
+    auto t = Token(type, 0, 0, 0);
     assert(t.is_operator_type() && "Token type is not an operator"); // sanity check
 
     auto op = std::make_unique<PredefinedTokenOperator>(type);
@@ -11,6 +11,8 @@
 #include <fmt/core.h>
 
 #include <cassert>
+#include <mutex>
+#include <unordered_set>
 std::string AST::get_primitive_name(ValueTypePrimitive primitive)
 {
     switch (primitive) {
@@ -1050,8 +1052,9 @@ AST::ValueType AST::substitute_type(const ValueType &type, const TypeSubstitutio
     return type;
 }
 
-// structural, and recursive through every part: this is what makes two independently written
-// `function<void(int32)>`s one type, which is the whole point of the callable kind being structural
+// structural over every part: this is what makes two independently written `function<void(int32)>`s one
+// type, which is the whole point of the callable kind being structural. only ever asked by the interner
+// below - every ValueType compares signatures by record - and each part is one step, being interned too
 bool AST::CallableSignature::operator==(const AST::CallableSignature &other) const
 {
     if (parameter_types.size() != other.parameter_types.size()) {
@@ -1070,3 +1073,55 @@ bool AST::CallableSignature::operator==(const AST::CallableSignature &other) con
 
     return true;
 }
+
+namespace
+{
+    struct CallableSignatureHash
+    {
+        size_t operator()(const AST::CallableSignature &signature) const {
+            const std::hash<AST::ValueType> hash;
+
+            size_t h = hash(signature.return_type);
+            for (const auto &parameter : signature.parameter_types) {
+                h ^= hash(parameter) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            }
+
+            return h;
+        }
+    };
+
+    // both tables behind one lock: a record is looked up far less often than it is copied. **the lock is
+    // load-bearing** - LLVMCompiler::lower_in_lanes lowers units concurrently, and every lane interns the
+    // ValueTypes it builds here
+    struct ValueTypeInterner
+    {
+        std::mutex lock;
+
+        // node-based containers, so an element's address is the record's and never moves
+        std::unordered_set<AST::ValueType> levels;
+        std::unordered_set<AST::CallableSignature, CallableSignatureHash> signatures;
+    };
+
+    // never destroyed: a ValueType in a static outlives any order the tables could be torn down in
+    ValueTypeInterner &interner()
+    {
+        static ValueTypeInterner *tables = new ValueTypeInterner();
+        return *tables;
+    }
+};
+
+const AST::ValueType *AST::ValueType::intern(const ValueType &type)
+{
+    ValueTypeInterner &tables = interner();
+    std::lock_guard<std::mutex> guard(tables.lock);
+
+    return &*tables.levels.insert(type).first;
+}
+
+const AST::CallableSignature *AST::ValueType::intern(CallableSignature signature)
+{
+    ValueTypeInterner &tables = interner();
+    std::lock_guard<std::mutex> guard(tables.lock);
+
+    return &*tables.signatures.insert(std::move(signature)).first;
+}
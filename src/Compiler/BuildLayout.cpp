@@ -231,6 +231,10 @@ Compiler::BuildLayout Compiler::BuildLayout::resolve(
     BuildLayout layout;
     layout._flag_directory = flag_directory;
 
+    // **whatever the project**, a loose file included: the store is the machine's, and which objects may go
+    // in it is decided per module by their keys, not by where the program being built lives
+    layout._shared_store = SharedStore::from_environment();
+
     // **the project's own build directory, when there is a project.** A loose .eco file has no manifest and
     // therefore no place of its own to put an object nothing keeps, and the caller's fallback - a directory
     // under the system's temporary path - is the honest answer rather than littering wherever echoc was run
@@ -324,6 +328,66 @@ std::filesystem::path Compiler::BuildLayout::scratch_object(const std::string &m
     return _scratch / (module_name + ".o");
 }
 
+std::filesystem::path Compiler::BuildLayout::program_dir() const
+{
+    if (_entry_dir.empty()) {
+        return {};
+    }
+
+    return _entry_dir / "programs";
+}
+
+std::filesystem::path Compiler::BuildLayout::thin_link_cache_dir() const
+{
+    if (_entry_dir.empty()) {
+        return {};
+    }
+
+    return _entry_dir / "thinlto";
+}
+
+std::filesystem::path Compiler::BuildLayout::digest_memo() const
+{
+    if (_entry_dir.empty() || !is_echo_build_directory(_entry_dir)) {
+        return {};
+    }
+
+    return _entry_dir / "digests";
+}
+
+std::filesystem::path Compiler::BuildLayout::manifest_memo() const
+{
+    if (_entry_dir.empty() || !is_echo_build_directory(_entry_dir)) {
+        return {};
+    }
+
+    return _entry_dir / "manifests";
+}
+
+std::filesystem::path Compiler::BuildLayout::link_plan_dir()
+{
+    const std::filesystem::path user_root = user_cache_root();
+
+    if (user_root.empty()) {
+        return {};
+    }
+
+    // hyphenated, which an identifier is not - the standard library's own directories sit beside it, named
+    // after its modules
+    return user_root / "link-plans";
+}
+
+std::filesystem::path Compiler::BuildLayout::instance_dir(const Parser::ModuleManifest &manifest) const
+{
+    const std::filesystem::path directory = module_dir(manifest);
+
+    if (!is_echo_build_directory(directory)) {
+        return {};
+    }
+
+    return directory / "instances";
+}
+
 Compiler::BuildDirTrust Compiler::BuildLayout::trust_of(const Parser::ModuleManifest &manifest) const
 {
     // shares module_dir's arm order deliberately, including the compiler-supplied one it skips: that
@@ -3,7 +3,9 @@
 #include "eco.h"
 
 #include "Compiler/BuildLayout.h"
+#include "Compiler/FileDigests.h"
 #include "Compiler/HostTool.h"
+#include "Compiler/InProcessLink.h"
 #include "Compiler/LinkRequirement.h"
 #include "Compiler/ModuleCache.h"
 #include "Compiler/SettledPath.h"
@@ -158,8 +160,8 @@ std::string artifact_stem(uint64_t module_digest, const std::filesystem::path &s
 // compile just produced.
 //
 // a header folds in as its **own standalone digest** rather than as its bytes, which is what lets one answer
-// be kept per header rather than one per (header, seed) pair - fnv1a is a rolling hash, so a digest taken
-// under one seed says nothing under the next
+// be kept per header rather than one per (header, seed) pair - and what lets Compiler::FileDigests remember
+// it across builds, so an unchanged header is a stat rather than a read
 class HeaderDigests
 {
 public:
@@ -193,10 +195,8 @@ public:
         // **a header that has since been deleted still moves the key**, because its absence folds in as a
         // different byte than its contents did. Skipping it silently would make removing an include a
         // no-op for the cache
-        const std::optional<std::string> bytes = Compiler::read_whole_file(header);
-
-        const uint64_t digest = Compiler::fnv1a64(
-            bytes.value_or(std::string("<gone>")), Compiler::k_fnv_offset_basis);
+        const uint64_t digest = Compiler::FileDigests::instance().digest_of(header).value_or(
+            Compiler::content_digest("<gone>"));
 
         _digests.emplace(header, digest);
         return digest;
@@ -486,16 +486,16 @@ bool Compiler::build_c_sources(
         const std::filesystem::path depfile = directory / (stem + ".d");
         const std::filesystem::path sidecar = directory / (stem + ".key");
 
-        // **read once**, and folded into the settings half here so the key can be recomputed against the
+        // **digested once**, and folded into the settings half here so the key can be recomputed against the
         // depfile this build is about to write without touching the file again
-        const std::optional<std::string> source_bytes = read_whole_file(source);
+        const std::optional<uint64_t> source_bytes = FileDigests::instance().digest_of(source);
 
         if (!source_bytes.has_value()) {
             out_error = fmt::format("{}: cannot be read.", source.string());
             return false;
         }
 
-        const uint64_t source_digest = fnv1a64(source_bytes.value(), source_settings);
+        const uint64_t source_digest = fnv1a64(&source_bytes.value(), sizeof(uint64_t), source_settings);
         const std::string key = c_content_key(source, source_digest, depfile, seen);
 
         out.content_digest = fnv1a64(key, out.content_digest);
@@ -593,16 +593,42 @@ bool Compiler::build_c_shared_library(
         return true;
     }
 
-    // through the clang driver rather than the system linker: a shared library's platform flags are
-    // considerably fussier than an executable's, and this path is not the one Backend::link_executable's
-    // fast path exists to speed up - it runs once per module per change, not once per build
-    std::vector<std::string> argv = { "clang", "-shared", "-o", out_library.string() };
+    std::vector<std::string> inputs;
 
     for (const std::filesystem::path &object : objects) {
-        argv.push_back(object.string());
+        inputs.push_back(object.string());
+    }
+
+    inputs.insert(inputs.end(), link_words.begin(), link_words.end());
+
+    // in-process where it can be, and with the platform flags still the driver's: `-shared` is asked of it
+    // like any other driver word, which is what made a library's fussier flags safe to hand to LLD at all
+    const std::vector<std::string> driver_words = { "-shared" };
+    bool retrying = false;
+
+    switch (link_in_process(driver_words, out_library, inputs)) {
+    case InProcessLink::t_linked:
+        return true;
+
+    // the objects' own doing, and already said - the driver would only say it again
+    case InProcessLink::t_refused:
+        out_error = fmt::format(
+            "linking the C sources of module '{}' into a loadable library failed.", spec.module_name);
+        return false;
+
+    case InProcessLink::t_failed:
+        retrying = true;
+        break;
+
+    case InProcessLink::t_unavailable:
+        break;
     }
 
-    argv.insert(argv.end(), link_words.begin(), link_words.end());
+    // through the clang driver rather than the system linker: a shared library's platform flags are
+    // considerably fussier than an executable's, and this path is not the one Backend::link_executable's
+    // `ld` fast path exists to speed up - it runs once per module per change, not once per build
+    std::vector<std::string> argv = { "clang", "-shared", "-o", out_library.string() };
+    argv.insert(argv.end(), inputs.begin(), inputs.end());
 
     if (!run_tool(argv)) {
         out_error = fmt::format(
@@ -610,5 +636,42 @@ bool Compiler::build_c_shared_library(
         return false;
     }
 
+    // see Backend::link_executable: only a link the driver made proves the kept line wrong
+    if (retrying) {
+        forget_link_plan(driver_words);
+    }
+
     return true;
 }
+
+std::vector<std::filesystem::path> Compiler::c_build_inputs(
+    const CBuildSpec &spec,
+    const std::filesystem::path &cache_dir
+)
+{
+    std::vector<std::filesystem::path> inputs(spec.sources.begin(), spec.sources.end());
+    std::set<std::filesystem::path> seen(inputs.begin(), inputs.end());
+
+    if (spec.empty()) {
+        return inputs;
+    }
+
+    // every depfile in the directory rather than the ones this spec's settings would name: one left by a
+    // build under other settings names a header that is still one of this module's, and watching a file
+    // too many costs a rebuild nobody needed where watching one too few costs a stale binary
+    std::error_code ec;
+
+    for (const auto &entry : std::filesystem::directory_iterator(cache_dir, ec)) {
+        if (entry.path().extension() != ".d") {
+            continue;
+        }
+
+        for (const std::filesystem::path &prerequisite : read_depfile(entry.path())) {
+            if (seen.insert(prerequisite).second) {
+                inputs.push_back(prerequisite);
+            }
+        }
+    }
+
+    return inputs;
+}
@@ -446,9 +446,34 @@ bool Compiler::parse_command_line(
     const SubcommandInfo &info = subcommand_info(out.subcommand);
     const unsigned int bit = bit_of(out.subcommand);
 
-    if (!info.takes_sources && !out.sources.empty()) {
+    // **`cache` takes a word rather than sources**, and exactly one - the store it acts on is named by
+    // the environment, so anything past the action would be a second answer to a question it never asks
+    if (out.subcommand == Subcommand::t_cache) {
+        if (out.sources.empty()) {
+            out_error = "'cache' needs one of 'stats' or 'prune'.";
+            return false;
+        }
+
+        if (out.sources.front() != "stats" && out.sources.front() != "prune") {
+            out_error = fmt::format(
+                "'{}' is not something 'cache' does. Write 'stats' or 'prune'.", out.sources.front());
+
+            return false;
+        }
+
+        if (out.sources.size() > 1) {
+            out_error = fmt::format("'cache {}' takes nothing after it.", out.sources.front());
+            return false;
+        }
+    }
+    else if (!info.takes_sources && !out.sources.empty()) {
+        // the reason differs and is worth saying: `clean` never reads source, and `serve` reads only what
+        // the commands it is handed name
         out_error = fmt::format(
-            "'{}' takes no source files. It parses none and runs no pass.", info.name);
+            "'{}' takes no source files. {}", info.name,
+            out.subcommand == Subcommand::t_serve
+                ? "Each command it serves names its own."
+                : "It parses none and runs no pass.");
 
         return false;
     }
@@ -484,8 +484,12 @@ void Compiler::CommandLineHelp::render_category(
     // **the sources entry is part of this category and is drawn by hand**, because a positional has no
     // row in the option table: it has no spelling to look up, no arity and no exclusion, and giving it a
     // row would mean every reader of that table owing an arm for the one entry that is not an option
+    //
+    // and only when the positional *is* sources: `cache` has a positional too, and its action is not what
+    // is built - its paragraphs are drawn under the description, as every positional's are
     const bool has_sources = category == OptionCategory::t_inputs
         && subject != Subcommand::t_none
+        && subcommand_info(subject).takes_sources
         && subcommand_info(subject).positional != nullptr;
 
     bool drawn = false;
@@ -513,7 +517,7 @@ void Compiler::CommandLineHelp::render_category(
     }
 
     // a category with nothing in it is absent rather than an empty heading, which is what keeps
-    // WHAT CLEAN REMOVES off the build page and the whole page honest about what this command takes
+    // WHAT IS REMOVED off the build page and the whole page honest about what this command takes
 }
 
 void Compiler::CommandLineHelp::render_overview() const
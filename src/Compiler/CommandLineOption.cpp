@@ -61,6 +61,32 @@ namespace
         return true;
     }
 
+    // a worker count, so zero is refused along with everything that is not a number: "no workers" is not
+    // a slower build but none at all, and the way to ask for the serial path is `-j 1`
+    bool check_jobs(const std::string &value, std::string &out_error)
+    {
+        const std::string expected = "a job count is a whole number of at least 1";
+
+        if (value.empty() || value.size() > 4) {
+            out_error = expected + (value.empty() ? "." : ", got '" + value + "'.");
+            return false;
+        }
+
+        for (char c : value) {
+            if (c < '0' || c > '9') {
+                out_error = expected + ", got '" + value + "'.";
+                return false;
+            }
+        }
+
+        if (std::stoul(value) == 0) {
+            out_error = expected + ", got '" + value + "'.";
+            return false;
+        }
+
+        return true;
+    }
+
     unsigned int code_of(Compiler::PrintKind kind)
     {
         return static_cast<unsigned int>(kind);
@@ -76,7 +102,7 @@ namespace
         return static_cast<unsigned int>(mode);
     }
 
-    // `<none|module|whole>` for an option that owns its vocabulary, the written metavar otherwise. one
+    // `<none|module|whole|thin|tiered>` for an option that owns its vocabulary, the written metavar otherwise. one
     // place, so a value added to a row shows up in every usage line without a second string being edited
     std::string metavar_of(const Compiler::CommandLineOption &option)
     {
@@ -113,6 +139,10 @@ unsigned int Compiler::bit_of(Subcommand id)
         return accepts::test;
     case Subcommand::t_clean:
         return accepts::clean;
+    case Subcommand::t_serve:
+        return accepts::serve;
+    case Subcommand::t_cache:
+        return accepts::cache;
     case Subcommand::t_none:
         return 0;
     }
@@ -132,7 +162,7 @@ const char *Compiler::category_heading(OptionCategory category)
     case OptionCategory::t_report:
         return "What echoc tells you";
     case OptionCategory::t_removal:
-        return "What clean removes";
+        return "What is removed";
     case OptionCategory::t_general:
         return "General";
     }
@@ -334,7 +364,7 @@ const std::vector<Compiler::CommandLineOption> &Compiler::command_line_options()
             "either less than that or more.\n"
             "It used to be two flags, '-O' and '--no-optimize'. They read like opposites and were not: "
             "one chose what is compiled together, the other whether the pipeline ran at all, so writing "
-            "both was legal and meant almost nothing. It is one option with three values now.",
+            "both was legal and meant almost nothing. It is one option with five values now.",
             {
                 {
                     "none", accepts::compiling, code_of(OptimizeMode::t_none),
@@ -358,6 +388,29 @@ const std::vector<Compiler::CommandLineOption> &Compiler::command_line_options()
                     "The catch: there are no per-module objects left afterwards, so it bypasses the cache and "
                     "every build starts over. If you only need one function to stay inlinable, mark it "
                     "'#[inline]' and keep your fast builds."
+                },
+                {
+                    "thin", accepts::build, code_of(OptimizeMode::t_thin),
+                    "optimize across modules, and keep the cache",
+                    "Optimize each unit for a link-time pass, keep it as bitcode with a summary of what it "
+                    "defines, then let the link import what each unit calls from the others and generate code "
+                    "for every unit at once, one per core. Nearly the inlining 'whole' gets you, without giving "
+                    "up the cache: a library you did not touch is not optimized again, and a unit whose imports "
+                    "did not change is not even code-generated again.\n"
+                    "'build' only. It is a link-time mode, and 'run' and 'test' have no link to do it in."
+                },
+                {
+                    "tiered", accepts::run, code_of(OptimizeMode::t_tiered),
+                    "start cheap, reoptimize what runs hot",
+                    "Start the program on lightly optimized code and rebuild each function at full strength, on a "
+                    "thread of its own, once it has been called or has looped a thousand times. A long-running "
+                    "script gets optimized code where it spends its time without waiting for the whole of it to "
+                    "be optimized first; a short one never pays for the optimizer at all.\n"
+                    "A function picks up its optimized body on its next call, so a loop already running at the "
+                    "top level of your script stays where it is - move it into a function to let it tier. "
+                    "'--explain tiers' lists what was reoptimized.\n"
+                    "'run' only. A build has no second chance to optimize a function, and a test run is over "
+                    "before anything gets hot."
                 }
             },
             nullptr
@@ -416,6 +469,42 @@ const std::vector<Compiler::CommandLineOption> &Compiler::command_line_options()
             "leaks is then the build you actually ship.",
             {}, nullptr
         },
+        {
+            Opt::t_jobs, "jobs", nullptr, 'j',
+            OptionArity::t_value, OptionCategory::t_build,
+            accepts::compiling, 0, ExclusionGroup::t_none,
+            "<n>", "",
+            "how many modules to lex, lower and emit at once",
+            "How many threads read and lex the project's modules, build their IR, and turn them into objects:\n"
+            "  echoc build -j 8 -o app main.eco\n"
+            "The default is one per core. Reading and lexing a module touches that module and nothing "
+            "else, so independent modules are tokenized side by side; the three parse passes that follow "
+            "still run one module at a time in dependency order, because each of them can see everything "
+            "the modules before it declared. Each module's IR is then built by a compiler of its own, side by "
+            "side, and each module that needs an object is optimized and written on a thread of its own.\n"
+            "The output does not depend on it. Every diagnostic, dump and object is byte for byte what "
+            "'-j 1' produces, and '-j 1' is the way to rule the flag out when something looks wrong.",
+            {}, check_jobs
+        },
+        {
+            Opt::t_watch, "watch", nullptr, '\0',
+            OptionArity::t_flag, OptionCategory::t_build,
+            accepts::build | accepts::test, 0, ExclusionGroup::t_none,
+            nullptr, "",
+            "build again whenever a source changes",
+            "Build, then keep watching and build again every time something the build read changes:\n"
+            "  echoc build --watch -o app main.eco\n"
+            "  echoc test --watch\n"
+            "What is watched is what the build actually read: every manifest, every source a manifest's "
+            "'#[sources:]' matched, the files you named, and every header a module's C build included. A "
+            "new file appearing beside them counts too, since a pattern may now match it.\n"
+            "Between builds the libraries stay parsed in memory, and the module cache does the rest, so "
+            "editing one file rebuilds one module. Each build reports on its own and ends with a line "
+            "saying how long it took; add --explain time for where that time went, followed by a 'rebuild' row "
+            "timing the change to the end of the build. A file saved while a build runs starts the next one.\n"
+            "Ctrl-C stops it.",
+            {}, nullptr
+        },
         {
             Opt::t_no_stdlib, "no-stdlib", nullptr, '\0',
             OptionArity::t_flag, OptionCategory::t_build,
@@ -444,6 +533,8 @@ const std::vector<Compiler::CommandLineOption> &Compiler::command_line_options()
             "  echoc build --emit-stdlib-header -o app main.eco\n"
             "Only interesting if you work on echoc itself. The header embeds the bytes rather than a "
             "file list, so regenerate it whenever you edit a stdlib file and not only when you add one.\n"
+            "It carries the sources already lexed, so a released echoc does not lex its standard library "
+            "on every start. A header generated by an echoc whose lexer differs no longer compiles.\n"
             "Rewriting a tracked file is opt-in rather than a side effect of every compile. Refused "
             "beside --no-stdlib, where there would be no standard library to write out.",
             {}, nullptr
@@ -576,7 +667,8 @@ const std::vector<Compiler::CommandLineOption> &Compiler::command_line_options()
                     "instances", accepts::compiling, code_of(PrintKind::t_instances),
                     "generic instances and rewired calls",
                     "Which generic instances were minted, which call sites were rewired to them, and which structs "
-                    "were instantiated. When a generic goes wrong, start here rather than in the IR."
+                    "were instantiated - then how many rounds that took, and what each round visited. When a "
+                    "generic goes wrong, start here rather than in the IR."
                 },
                 {
                     "manifest", accepts::compiling, code_of(PrintKind::t_manifest),
@@ -608,8 +700,11 @@ const std::vector<Compiler::CommandLineOption> &Compiler::command_line_options()
                     "cache", accepts::compiling, code_of(ExplainKind::t_cache),
                     "each module's key, and what changed",
                     "Why a module was rebuilt: its cache key, whether a stored object was found, and on a miss the "
-                    "input that changed. The report to reach for when a build recompiles something you were sure "
-                    "it had cached."
+                    "input that changed - a file, or another module's interface. A hit right after a rebuilt "
+                    "module says the rebuild left its interface unchanged. Under each library module, a "
+                    "'tokens' row says whether its tokens were loaded from the store or read and lexed from "
+                    "source. The report to reach for when a build recompiles something you were sure it had "
+                    "cached."
                 },
                 {
                     "prune", accepts::jitting, code_of(ExplainKind::t_prune),
@@ -629,8 +724,16 @@ const std::vector<Compiler::CommandLineOption> &Compiler::command_line_options()
                 {
                     "time", accepts::compiling, code_of(ExplainKind::t_time),
                     "where the compile spent its time",
-                    "Where the compile spent its time, phase by phase, as a tree. Start here before you optimize "
-                    "anything about your build."
+                    "Where the compile spent its time, phase by phase, as a tree, with the counts that explain "
+                    "a phase beneath it - how many overload matches were recalled rather than scored. Start "
+                    "here before you optimize anything about your build."
+                },
+                {
+                    "tiers", accepts::run, code_of(ExplainKind::t_tiers),
+                    "what '--optimize tiered' reoptimized",
+                    "How many functions '--optimize tiered' put behind a tier stub, and which of them got hot "
+                    "enough to be rebuilt at full strength, printed once your program has returned. 'run' only, "
+                    "since only 'run' tiers; without '--optimize tiered' it says so rather than nothing."
                 }
             },
             nullptr
@@ -638,7 +741,7 @@ const std::vector<Compiler::CommandLineOption> &Compiler::command_line_options()
         {
             Opt::t_diagnostics, "diagnostics", nullptr, '\0',
             OptionArity::t_value, OptionCategory::t_report,
-            accepts::all, 0, ExclusionGroup::t_none,
+            accepts::reporting, 0, ExclusionGroup::t_none,
             "<auto|pretty|ascii|json>", "auto",
             "how a diagnostic is drawn",
             "How an error or a warning is drawn:\n"
@@ -655,7 +758,7 @@ const std::vector<Compiler::CommandLineOption> &Compiler::command_line_options()
         {
             Opt::t_color, "color", "colour", '\0',
             OptionArity::t_value, OptionCategory::t_report,
-            accepts::all, 0, ExclusionGroup::t_none,
+            accepts::reporting, 0, ExclusionGroup::t_none,
             "<auto|always|never>", "auto",
             "colourise diagnostics",
             "Colourise diagnostics:\n"
@@ -670,7 +773,7 @@ const std::vector<Compiler::CommandLineOption> &Compiler::command_line_options()
         {
             Opt::t_silent, "silent", nullptr, '\0',
             OptionArity::t_flag, OptionCategory::t_report,
-            accepts::all, 0, ExclusionGroup::t_none,
+            accepts::reporting, 0, ExclusionGroup::t_none,
             nullptr, "",
             "do not draw the progress checklist",
             "Stop drawing the checklist that rewrites itself as each module and phase finishes:\n"
@@ -734,11 +837,12 @@ const std::vector<Compiler::CommandLineOption> &Compiler::command_line_options()
         {
             Opt::t_dry_run, "dry-run", nullptr, 'n',
             OptionArity::t_flag, OptionCategory::t_removal,
-            accepts::clean, 0, ExclusionGroup::t_none,
+            accepts::clean | accepts::cache, 0, ExclusionGroup::t_none,
             nullptr, "",
             "print what would be removed, remove nothing",
             "Print what would be removed and remove nothing:\n"
             "  echoc clean -n\n"
+            "  echoc cache prune -n\n"
             "A good habit in general, and worth the extra command whenever you have pointed a build "
             "somewhere of your own with --build-dir or '#[build_dir:]'.",
             {}, nullptr
@@ -746,7 +850,7 @@ const std::vector<Compiler::CommandLineOption> &Compiler::command_line_options()
         {
             Opt::t_help, "help", nullptr, 'h',
             OptionArity::t_flag, OptionCategory::t_general,
-            accepts::all, 0, ExclusionGroup::t_none,
+            accepts::reporting, 0, ExclusionGroup::t_none,
             nullptr, "",
             "print this page, or one option in full",
             "Print a page. Which page depends on what you put around it:\n"
@@ -762,7 +866,7 @@ const std::vector<Compiler::CommandLineOption> &Compiler::command_line_options()
         {
             Opt::t_version, "version", nullptr, 'v',
             OptionArity::t_flag, OptionCategory::t_general,
-            accepts::all, 0, ExclusionGroup::t_none,
+            accepts::reporting, 0, ExclusionGroup::t_none,
             nullptr, "",
             "print the version",
             "Print the version this echoc was built as, and exit:\n"
@@ -980,6 +1084,52 @@ const std::vector<Compiler::SubcommandInfo> &Compiler::subcommand_table()
             nullptr,
             nullptr,
             false
+        },
+        {
+            Subcommand::t_serve, "serve", accepts::serve,
+            "keep a compiler warm for the commands after it",
+            "Start a compile server in this terminal and keep it running until Ctrl-C:\n"
+            "  echoc serve\n"
+            "While it runs, every 'run', 'build' and 'test' you type - in any terminal, as the same user - "
+            "is handed to it rather than started from scratch. The server keeps the libraries your last "
+            "command parsed, and the modules whose sources have not changed since are not read again. "
+            "Everything else behaves exactly as before: your command still writes to your terminal, reads "
+            "your stdin and ends with the same exit status.\n"
+            "A server started from a different echoc than the one you typed is never used, so rebuilding "
+            "the compiler cannot leave you talking to the old one. Set ECHOC_NO_SERVER=1 to compile "
+            "without it for one command, and ECHOC_SERVER_SOCKET to choose where it listens.",
+            false,
+            nullptr,
+            nullptr,
+            nullptr,
+            false
+        },
+        {
+            Subcommand::t_cache, "cache", accepts::cache,
+            "inspect or trim the shared object store",
+            "Look at, or make room in, the store of compiled modules that every project on this machine "
+            "shares:\n"
+            "  export ECO_CACHE_DIR=~/.cache/echoc\n"
+            "  echoc cache stats\n"
+            "  echoc cache prune -n\n"
+            "With ECO_CACHE_DIR set, a build that would compile a library module first asks this store "
+            "for it, and a module it did compile is added for the next project that needs it. Two "
+            "checkouts of one repository, or every CI job pointed at one directory, compile each library "
+            "once between them. A build with -g neither reads nor adds to it, because a debug object "
+            "names the directory it was compiled in.\n"
+            "The store holds itself to ECO_CACHE_MAX_SIZE, 10G unless you say otherwise, by removing what "
+            "was used longest ago. Builds do that on their own about once an hour, so this command is "
+            "only ever needed to see what is there or to make room now.",
+            false,
+            "<stats|prune>",
+            "what to do with the store",
+            "'stats' prints where the store is, how many objects it holds and how much of its limit they "
+            "use. It changes nothing.\n"
+            "'prune' removes the objects used longest ago until what is left fits in ECO_CACHE_MAX_SIZE, "
+            "along with anything a build that was interrupted left half-written. It waits for any build "
+            "using the store to finish fetching, and never removes an object one of them is about to "
+            "link. Add -n to see how much it would remove first.",
+            false
         }
     };
 
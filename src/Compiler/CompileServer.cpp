@@ -0,0 +1,854 @@
+#include "Compiler/CompileServer.h"
+
+#include "eco.h"
+
+#include <fmt/core.h>
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ECO_COMPILE_SERVER_POSIX 1
+#else
+#define ECO_COMPILE_SERVER_POSIX 0
+#endif
+
+#if ECO_COMPILE_SERVER_POSIX
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#if defined(__APPLE__)
+#include <mach-o/dyld.h>
+#endif
+
+extern char **environ;
+#endif
+
+namespace
+{
+// the first word of every request. **bumped whenever the framing changes**, so a client and a server from
+// two different protocols refuse each other rather than misreading a length as an argument
+constexpr const char *k_protocol = "echoc-serve/1";
+
+// what a server says back before it forks, one byte each
+constexpr char k_accepted = 'A';
+constexpr char k_refused = 'R';
+
+// a request is an argv and an environment. Anything this large is not one, and is refused rather than
+// allocated
+constexpr uint32_t k_max_request_bytes = 16u << 20;
+
+#if ECO_COMPILE_SERVER_POSIX
+#if defined(MSG_NOSIGNAL)
+constexpr int k_send_flags = MSG_NOSIGNAL;
+#else
+constexpr int k_send_flags = 0;
+#endif
+
+// write and read, retried past an interruption and a short count. false is the other end gone
+bool send_all(int fd, const void *data, size_t size)
+{
+    const char *at = static_cast<const char *>(data);
+
+    while (size > 0) {
+        const ssize_t sent = send(fd, at, size, k_send_flags);
+
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (sent <= 0) {
+            return false;
+        }
+
+        at += sent;
+        size -= static_cast<size_t>(sent);
+    }
+
+    return true;
+}
+
+bool receive_all(int fd, void *data, size_t size)
+{
+    char *at = static_cast<char *>(data);
+
+    while (size > 0) {
+        const ssize_t got = recv(fd, at, size, 0);
+
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (got <= 0) {
+            return false;
+        }
+
+        at += got;
+        size -= static_cast<size_t>(got);
+    }
+
+    return true;
+}
+
+// **length-prefixed words, in host order.** Both ends are the same executable on the same machine - the
+// identity check is what guarantees it - so there is no byte order to agree on
+void put_word(std::string &out, const std::string &word)
+{
+    const uint32_t size = static_cast<uint32_t>(word.size());
+
+    out.append(reinterpret_cast<const char *>(&size), sizeof(size));
+    out.append(word);
+}
+
+bool take_word(const std::string &in, size_t &at, std::string &out)
+{
+    uint32_t size = 0;
+
+    if (in.size() - at < sizeof(size)) {
+        return false;
+    }
+
+    std::memcpy(&size, in.data() + at, sizeof(size));
+    at += sizeof(size);
+
+    if (in.size() - at < size) {
+        return false;
+    }
+
+    out.assign(in, at, size);
+    at += size;
+
+    return true;
+}
+
+bool take_words(const std::string &in, size_t &at, std::vector<std::string> &out)
+{
+    std::string count;
+
+    if (!take_word(in, at, count)) {
+        return false;
+    }
+
+    const unsigned long words = std::strtoul(count.c_str(), nullptr, 10);
+
+    for (unsigned long i = 0; i < words; i++) {
+        if (!take_word(in, at, out.emplace_back())) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void put_words(std::string &out, const std::vector<std::string> &words)
+{
+    put_word(out, std::to_string(words.size()));
+
+    for (const std::string &word : words) {
+        put_word(out, word);
+    }
+}
+
+sockaddr_un address_of(const std::filesystem::path &socket, bool &out_fits)
+{
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+
+    const std::string &spelled = socket.native();
+
+    // sun_path is a fixed hundred-odd bytes, and a truncated path is somebody else's socket
+    out_fits = spelled.size() < sizeof(address.sun_path);
+
+    if (out_fits) {
+        std::memcpy(address.sun_path, spelled.c_str(), spelled.size() + 1);
+    }
+
+    return address;
+}
+
+// the uid at the other end of an accepted connection, or false when the platform will not say - which is
+// treated exactly like a stranger
+bool peer_uid(int connection, uid_t &out)
+{
+#if defined(__linux__)
+    ucred credentials {};
+    socklen_t size = sizeof(credentials);
+
+    if (getsockopt(connection, SOL_SOCKET, SO_PEERCRED, &credentials, &size) != 0) {
+        return false;
+    }
+
+    out = credentials.uid;
+    return true;
+#else
+    gid_t group = 0;
+    return getpeereid(connection, &out, &group) == 0;
+#endif
+}
+
+// **the request, and the three descriptors riding on its first bytes.** The length and the descriptors go
+// in one sendmsg so the server cannot read one without the other
+bool send_request(int connection, const std::string &payload)
+{
+    const uint32_t size = static_cast<uint32_t>(payload.size());
+    const int descriptors[3] = { STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO };
+
+    iovec vector {};
+    vector.iov_base = const_cast<uint32_t *>(&size);
+    vector.iov_len = sizeof(size);
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(descriptors))] = {};
+
+    msghdr message {};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    cmsghdr *header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(descriptors));
+    std::memcpy(CMSG_DATA(header), descriptors, sizeof(descriptors));
+
+    ssize_t sent = -1;
+
+    do {
+        sent = sendmsg(connection, &message, k_send_flags);
+    } while (sent < 0 && errno == EINTR);
+
+    if (sent != static_cast<ssize_t>(sizeof(size))) {
+        return false;
+    }
+
+    return send_all(connection, payload.data(), payload.size());
+}
+
+// the other half of send_request. `out_descriptors` holds whatever arrived, even on a refusal, so the
+// caller closes them either way
+bool receive_request(int connection, std::string &out_payload, std::vector<int> &out_descriptors)
+{
+    uint32_t size = 0;
+
+    iovec vector {};
+    vector.iov_base = &size;
+    vector.iov_len = sizeof(size);
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * 3)] = {};
+
+    msghdr message {};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    ssize_t got = -1;
+
+    do {
+        got = recvmsg(connection, &message, 0);
+    } while (got < 0 && errno == EINTR);
+
+    for (cmsghdr *header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+            const size_t count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            const int *received = reinterpret_cast<const int *>(CMSG_DATA(header));
+
+            out_descriptors.insert(out_descriptors.end(), received, received + count);
+        }
+    }
+
+    if (got != static_cast<ssize_t>(sizeof(size)) || out_descriptors.size() != 3 || size > k_max_request_bytes) {
+        return false;
+    }
+
+    out_payload.resize(size);
+
+    return receive_all(connection, out_payload.data(), out_payload.size());
+}
+
+// **private, or not at all.** The default under /tmp is a directory anybody could have made first, so one
+// that exists is used only if it is this user's and nobody else can enter it
+bool prepare_socket_directory(const std::filesystem::path &directory, std::string &out_error)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+
+    struct stat info {};
+
+    if (lstat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+        out_error = fmt::format("'{}' could not be created as a directory.", directory.string());
+        return false;
+    }
+
+    if (info.st_uid != getuid()) {
+        out_error = fmt::format(
+            "'{}' belongs to another user, so a socket in it would not be private to this one.",
+            directory.string());
+        return false;
+    }
+
+    if ((info.st_mode & 077) != 0 && chmod(directory.c_str(), 0700) != 0) {
+        out_error = fmt::format("'{}' could not be made private to this user.", directory.string());
+        return false;
+    }
+
+    return true;
+}
+
+// the server's own signal state. A stop request is a flag the loop reads between requests and while one
+// is running; SIGCHLD is a byte down a pipe, so the wait for a child and the watch on its client are one poll
+volatile sig_atomic_t s_stop_requested = 0;
+int s_child_pipe[2] = { -1, -1 };
+
+extern "C" void on_stop_signal(int)
+{
+    s_stop_requested = 1;
+}
+
+extern "C" void on_child_signal(int)
+{
+    const int saved = errno;
+    const char byte = 0;
+
+    (void)!write(s_child_pipe[1], &byte, 1);
+    errno = saved;
+}
+
+// installed **without SA_RESTART**, so a blocked poll returns and the loop gets to read the flag
+void install_handler(int signal, void (*handler)(int))
+{
+    struct sigaction action {};
+    action.sa_handler = handler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = 0;
+
+    sigaction(signal, &action, nullptr);
+}
+
+int exit_status_of(int status)
+{
+    if (WIFEXITED(status)) {
+        return WEXITSTATUS(status);
+    }
+
+    // the shell's spelling of a death by signal, which is what the client would have ended with had it
+    // died the same way itself
+    if (WIFSIGNALED(status)) {
+        return 128 + WTERMSIG(status);
+    }
+
+    return 1;
+}
+
+// **the child.** Everything the server holds is inherited, which is the point - and everything about the
+// process the client *was* is put back on top of it: its descriptors, its directory, its environment
+[[noreturn]] void run_child(
+    int listener,
+    int connection,
+    const std::vector<int> &descriptors,
+    const Compiler::ServedRequest &request,
+    const std::function<int(const Compiler::ServedRequest &)> &serve
+)
+{
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    signal(SIGPIPE, SIG_DFL);
+    signal(SIGCHLD, SIG_DFL);
+
+    close(listener);
+    close(connection);
+    close(s_child_pipe[0]);
+    close(s_child_pipe[1]);
+
+    for (int target = 0; target < 3; target++) {
+        dup2(descriptors[target], target);
+    }
+
+    for (int descriptor : descriptors) {
+        if (descriptor > STDERR_FILENO) {
+            close(descriptor);
+        }
+    }
+
+    int status = 1;
+
+    if (chdir(request.working_directory.c_str()) == 0) {
+        // never freed: the process ends with the request
+        auto *environment = new std::vector<char *>();
+
+        for (const std::string &entry : request.environment) {
+            environment->push_back(const_cast<char *>(entry.c_str()));
+        }
+
+        environment->push_back(nullptr);
+        environ = environment->data();
+
+        status = serve(request);
+    }
+    else {
+        std::cerr << fmt::format(
+            "echoc: the compile server could not enter '{}'.", request.working_directory.string())
+                  << std::endl;
+    }
+
+    // `_exit` and never `exit`, for Compiler::run_test_isolated's reason: an atexit handler the server
+    // registered would run here too, in a process that owns none of what it tears down
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+    _exit(status);
+}
+
+// the child, watched until it exits - or until its client hangs up, which is a Ctrl-C at the terminal that
+// typed the command: the child is not in that terminal's process group, so the only news of it is the
+// connection closing. nullopt when the answer no longer has anybody to go to
+std::optional<int> watch_child(pid_t child, int connection)
+{
+    int status = 0;
+
+    while (true) {
+        const pid_t reaped = waitpid(child, &status, WNOHANG);
+
+        if (reaped == child) {
+            return exit_status_of(status);
+        }
+
+        if (reaped < 0 && errno != EINTR) {
+            return std::nullopt;
+        }
+
+        pollfd watched[2] = {};
+        watched[0].fd = s_child_pipe[0];
+        watched[0].events = POLLIN;
+        watched[1].fd = connection;
+        watched[1].events = POLLIN;
+
+        if (poll(watched, 2, -1) < 0 && errno != EINTR) {
+            return std::nullopt;
+        }
+
+        if ((watched[0].revents & POLLIN) != 0) {
+            char drained[64];
+            while (read(s_child_pipe[0], drained, sizeof(drained)) > 0) {
+            }
+        }
+
+        // a client has nothing left to send once its request is in, so the connection becoming readable at
+        // all is the other end closing
+        if ((watched[1].revents & (POLLIN | POLLHUP | POLLERR)) != 0 || s_stop_requested) {
+            break;
+        }
+    }
+
+    kill(child, SIGKILL);
+
+    while (waitpid(child, &status, 0) < 0 && errno == EINTR) {
+    }
+
+    return std::nullopt;
+}
+
+// **binds, taking over a socket nobody is listening on.** A server that was SIGKILLed leaves its socket
+// file behind, and refusing to start because of it would make the stale file the user's problem. One that
+// answers is a live server, and is left alone
+int listen_on(const std::filesystem::path &socket, std::string &out_error)
+{
+    bool fits = false;
+    const sockaddr_un address = address_of(socket, fits);
+
+    if (!fits) {
+        out_error = fmt::format("'{}' is too long a path for a socket on this platform.", socket.string());
+        return -1;
+    }
+
+    const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (listener < 0) {
+        out_error = "echoc could not open a socket to listen on.";
+        return -1;
+    }
+
+    fcntl(listener, F_SETFD, FD_CLOEXEC);
+
+    const auto *bound = reinterpret_cast<const sockaddr *>(&address);
+
+    if (bind(listener, bound, sizeof(address)) != 0 && errno == EADDRINUSE) {
+        const int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        const bool live = probe >= 0 && connect(probe, bound, sizeof(address)) == 0;
+
+        if (probe >= 0) {
+            close(probe);
+        }
+
+        if (live) {
+            close(listener);
+            out_error = fmt::format("A compile server is already listening on '{}'.", socket.string());
+            return -1;
+        }
+
+        unlink(socket.c_str());
+
+        if (bind(listener, bound, sizeof(address)) != 0) {
+            close(listener);
+            out_error = fmt::format("echoc could not listen on '{}'.", socket.string());
+            return -1;
+        }
+    }
+
+    if (listen(listener, 8) != 0) {
+        close(listener);
+        unlink(socket.c_str());
+        out_error = fmt::format("echoc could not listen on '{}'.", socket.string());
+        return -1;
+    }
+
+    return listener;
+}
+
+// one connection, start to finish: refused, or forked, answered and then warmed after
+void serve_connection(
+    int listener,
+    int connection,
+    const std::string &identity,
+    const std::function<int(const Compiler::ServedRequest &)> &serve,
+    const std::function<void(const Compiler::ServedRequest &)> &after
+)
+{
+    std::string payload;
+    std::vector<int> descriptors;
+
+    const auto close_descriptors = [&descriptors] {
+        for (int descriptor : descriptors) {
+            close(descriptor);
+        }
+
+        descriptors.clear();
+    };
+
+    uid_t uid = 0;
+
+    if (!peer_uid(connection, uid) || uid != getuid() || !receive_request(connection, payload, descriptors)) {
+        close_descriptors();
+        return;
+    }
+
+    size_t at = 0;
+    std::string protocol;
+    std::string their_identity;
+    std::string working_directory;
+    Compiler::ServedRequest request;
+
+    const bool complete = take_word(payload, at, protocol)
+        && take_word(payload, at, their_identity)
+        && take_word(payload, at, working_directory)
+        && take_words(payload, at, request.arguments)
+        && take_words(payload, at, request.environment);
+
+    if (!complete || protocol != k_protocol || their_identity != identity || request.arguments.empty()) {
+        send_all(connection, &k_refused, 1);
+        close_descriptors();
+        return;
+    }
+
+    request.working_directory = working_directory;
+
+    // **before the fork**, for the reason Compiler::run_test_isolated gives: whatever this process still
+    // has buffered would be written once by it and once more by the child
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+
+    const pid_t child = fork();
+
+    if (child < 0) {
+        send_all(connection, &k_refused, 1);
+        close_descriptors();
+        return;
+    }
+
+    if (child == 0) {
+        run_child(listener, connection, descriptors, request, serve);
+    }
+
+    close_descriptors();
+
+    // accepted only now, so a client that hears it knows a compile is running on its behalf and must not
+    // start one of its own
+    send_all(connection, &k_accepted, 1);
+
+    const std::optional<int> status = watch_child(child, connection);
+
+    if (!status.has_value()) {
+        return;
+    }
+
+    const int32_t answer = status.value();
+    send_all(connection, &answer, sizeof(answer));
+
+    // the client is answered and gone before the server spends anything on the next request, so the
+    // warming `after` does is never time a person waits for
+    shutdown(connection, SHUT_RDWR);
+
+    std::error_code ec;
+    const std::filesystem::path own_directory = std::filesystem::current_path(ec);
+    char **own_environment = environ;
+
+    std::vector<char *> environment;
+
+    for (std::string &entry : request.environment) {
+        environment.push_back(entry.data());
+    }
+
+    environment.push_back(nullptr);
+
+    if (chdir(request.working_directory.c_str()) == 0) {
+        environ = environment.data();
+        after(request);
+        environ = own_environment;
+    }
+
+    if (!own_directory.empty()) {
+        std::filesystem::current_path(own_directory, ec);
+    }
+}
+#endif
+};
+
+std::string Compiler::executable_identity()
+{
+#if ECO_COMPILE_SERVER_POSIX
+    std::string path;
+
+#if defined(__linux__)
+    std::error_code ec;
+    path = std::filesystem::read_symlink("/proc/self/exe", ec).string();
+#elif defined(__APPLE__)
+    char buffer[4096];
+    uint32_t size = sizeof(buffer);
+
+    if (_NSGetExecutablePath(buffer, &size) == 0) {
+        path = buffer;
+    }
+#endif
+
+    struct stat info {};
+
+    if (path.empty() || stat(path.c_str(), &info) != 0) {
+        return ECO_VERSION_STRING;
+    }
+
+#if defined(__APPLE__)
+    const long long nanoseconds = static_cast<long long>(info.st_mtimespec.tv_nsec);
+#else
+    const long long nanoseconds = static_cast<long long>(info.st_mtim.tv_nsec);
+#endif
+
+    return fmt::format("{}|{}|{}|{}.{}", ECO_VERSION_STRING, path,
+        static_cast<long long>(info.st_size), static_cast<long long>(info.st_mtime), nanoseconds);
+#else
+    return ECO_VERSION_STRING;
+#endif
+}
+
+#if ECO_COMPILE_SERVER_POSIX
+
+bool Compiler::compile_server_available()
+{
+    return true;
+}
+
+std::filesystem::path Compiler::server_socket_path()
+{
+    if (const char *named = std::getenv("ECHOC_SERVER_SOCKET"); named != nullptr && *named != '\0') {
+        return named;
+    }
+
+    if (const char *runtime = std::getenv("XDG_RUNTIME_DIR"); runtime != nullptr && *runtime != '\0') {
+        return std::filesystem::path(runtime) / "echoc" / "serve.sock";
+    }
+
+    return std::filesystem::temp_directory_path()
+        / fmt::format("echoc-{}", static_cast<unsigned long>(getuid())) / "serve.sock";
+}
+
+std::optional<int> Compiler::forward_to_server(int argc, char *argv[])
+{
+    if (const char *opted_out = std::getenv("ECHOC_NO_SERVER"); opted_out != nullptr && *opted_out != '\0') {
+        return std::nullopt;
+    }
+
+    const std::filesystem::path socket = server_socket_path();
+
+    // **a socket, and ours.** Anything else at that path is not a server this user started
+    struct stat info {};
+
+    if (lstat(socket.c_str(), &info) != 0 || !S_ISSOCK(info.st_mode) || info.st_uid != getuid()) {
+        return std::nullopt;
+    }
+
+    bool fits = false;
+    const sockaddr_un address = address_of(socket, fits);
+
+    if (!fits) {
+        return std::nullopt;
+    }
+
+    const int connection = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (connection < 0) {
+        return std::nullopt;
+    }
+
+#if defined(SO_NOSIGPIPE)
+    const int on = 1;
+    setsockopt(connection, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+    if (connect(connection, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+        close(connection);
+        return std::nullopt;
+    }
+
+    std::error_code ec;
+    const std::filesystem::path here = std::filesystem::current_path(ec);
+
+    std::vector<std::string> arguments(argv, argv + argc);
+    std::vector<std::string> environment;
+
+    for (char **entry = environ; entry != nullptr && *entry != nullptr; entry++) {
+        environment.emplace_back(*entry);
+    }
+
+    std::string payload;
+    put_word(payload, k_protocol);
+    put_word(payload, executable_identity());
+    put_word(payload, here.string());
+    put_words(payload, arguments);
+    put_words(payload, environment);
+
+    char answer = 0;
+
+    // every failure up to the server saying yes means nothing ran, so compiling here is still right
+    if (ec || !send_request(connection, payload) || !receive_all(connection, &answer, 1) || answer != k_accepted) {
+        close(connection);
+        return std::nullopt;
+    }
+
+    int32_t status = 1;
+
+    // past this point a compile is running on this invocation's terminal, so running another would write
+    // everything twice. A server gone mid-request is a failed command, said as one
+    if (!receive_all(connection, &status, sizeof(status))) {
+        close(connection);
+        std::cerr << "echoc: the compile server stopped before this command finished." << std::endl;
+        return 1;
+    }
+
+    close(connection);
+
+    return status;
+}
+
+int Compiler::serve_requests(
+    const std::filesystem::path &socket,
+    const std::function<int(const ServedRequest &)> &serve,
+    const std::function<void(const ServedRequest &)> &after,
+    std::string &out_error
+)
+{
+    if (!prepare_socket_directory(socket.parent_path(), out_error)) {
+        return 1;
+    }
+
+    const int listener = listen_on(socket, out_error);
+
+    if (listener < 0) {
+        return 1;
+    }
+
+    if (pipe(s_child_pipe) != 0) {
+        close(listener);
+        unlink(socket.c_str());
+        out_error = "echoc could not open the pipe it watches its compiles through.";
+        return 1;
+    }
+
+    for (int end : s_child_pipe) {
+        fcntl(end, F_SETFL, O_NONBLOCK);
+        fcntl(end, F_SETFD, FD_CLOEXEC);
+    }
+
+    install_handler(SIGINT, on_stop_signal);
+    install_handler(SIGTERM, on_stop_signal);
+    install_handler(SIGCHLD, on_child_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    const std::string identity = executable_identity();
+
+    while (!s_stop_requested) {
+        pollfd waiting {};
+        waiting.fd = listener;
+        waiting.events = POLLIN;
+
+        if (poll(&waiting, 1, -1) <= 0) {
+            continue;
+        }
+
+        const int connection = accept(listener, nullptr, nullptr);
+
+        if (connection < 0) {
+            continue;
+        }
+
+        fcntl(connection, F_SETFD, FD_CLOEXEC);
+        serve_connection(listener, connection, identity, serve, after);
+        close(connection);
+    }
+
+    close(listener);
+    close(s_child_pipe[0]);
+    close(s_child_pipe[1]);
+    unlink(socket.c_str());
+
+    return 0;
+}
+
+#else
+
+bool Compiler::compile_server_available()
+{
+    return false;
+}
+
+std::filesystem::path Compiler::server_socket_path()
+{
+    return {};
+}
+
+std::optional<int> Compiler::forward_to_server(int, char *[])
+{
+    return std::nullopt;
+}
+
+int Compiler::serve_requests(
+    const std::filesystem::path &,
+    const std::function<int(const ServedRequest &)> &,
+    const std::function<void(const ServedRequest &)> &,
+    std::string &out_error
+)
+{
+    out_error = "'echoc serve' needs fork and descriptor passing, and this platform has neither.";
+    return 1;
+}
+
+#endif
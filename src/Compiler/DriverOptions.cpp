@@ -1,7 +1,9 @@
 #include "Compiler/DriverOptions.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <string>
+#include <thread>
 
 namespace
 {
@@ -41,6 +43,14 @@ bool Compiler::resolve_driver_options(
     }
     out.program_arguments = cli.program_arguments;
 
+    // hardware_concurrency may answer zero when it cannot tell, and zero workers is no parse at all
+    if (cli.stated(Opt::t_jobs)) {
+        out.jobs = static_cast<unsigned>(std::stoul(cli.value(Opt::t_jobs)));
+    }
+    else {
+        out.jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
+
     out.target_os = cli.value(Opt::t_target_os);
     out.target_arch = cli.value(Opt::t_target_arch);
     out.build_dir = cli.value(Opt::t_build_dir);
@@ -50,10 +60,19 @@ bool Compiler::resolve_driver_options(
     out.no_stdlib = cli.flag(Opt::t_no_stdlib);
     out.emit_stdlib_header = cli.flag(Opt::t_emit_stdlib_header);
     out.silent = cli.flag(Opt::t_silent);
+    out.watch = cli.flag(Opt::t_watch);
     out.verbose = cli.flag(Opt::t_verbose);
     out.dry_run = cli.flag(Opt::t_dry_run);
     out.with_stdlib = cli.flag(Opt::t_with_stdlib);
 
+    // the word rather than `sources`, which under `cache` holds nothing that is a source
+    if (out.subcommand == Subcommand::t_cache) {
+        out.cache_action = !cli.sources.empty() && cli.sources.front() == "prune"
+            ? CacheAction::t_prune
+            : CacheAction::t_stats;
+        out.sources.clear();
+    }
+
     // the two rendering answers. asked of their own parsers again rather than carried off the parse -
     // they are pure functions, and a stored answer is a second place for two readers to drift
     if (!parse_color_choice(cli.value(Opt::t_color), out.color, out_error)
@@ -115,19 +134,20 @@ bool Compiler::resolve_driver_options(
 
     out.options.no_optimize = out.optimize == OptimizeMode::t_none;
 
-    // **three reasons, kept apart from the cache key's one.** The whole-program pipeline and a single IR
+    // **two reasons, kept apart from the cache key's one.** The whole-program pipeline and a single IR
     // dump can each only look at one module, so both force the merge - but a dump changes no emitted
     // byte, and letting it reach compute_module_keys would make every module's key react to a `--print`.
     //
-    // the JIT is the third and is unconditional: it holds one module in memory and emits no object, so
-    // there is never a per-module artifact for it to store or reuse. It used to be a `true` written at
-    // the one call site, which is the same fact with nowhere to be asked. `test` is the second subcommand
-    // that JITs and answers here for exactly that reason rather than as a second rule
-    out.whole_program = out.subcommand == Subcommand::t_run
-        || out.subcommand == Subcommand::t_test
-        || out.optimize_is_whole_program()
+    // the JIT used to be a third, unconditionally, back when it could only be handed one module. It loads
+    // the per-module objects a `build` links now, so `run` and `test` reuse and store them under exactly
+    // the rule `build` does - see Backend::prepare_execution
+    out.whole_program = out.optimize_is_whole_program()
         || out.prints(PrintKind::t_ir);
 
+    // after the merge decision rather than beside no_optimize, because a dump can undo it: `--print ir`
+    // folds every unit into one module, and one module has nothing to import from anything
+    out.options.thin_lto = out.optimize == OptimizeMode::t_thin && !out.whole_program;
+
     // `--print manifest` is an answer, not a dump. combining it with another `-p` value would
     // then try to compile a graph whose packages may not be on disk
     if (out.prints(PrintKind::t_manifest)) {
@@ -0,0 +1,230 @@
+#include "Compiler/FileDigests.h"
+
+#include "Compiler/ModuleCache.h"
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/Support/xxhash.h>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ECO_FILE_DIGESTS_STAT 1
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+// the first line of a memo. A memo in any other shape is one nothing can be recalled from, which is the same
+// as having none
+constexpr const char *k_memo_header = "echoc-digests 1";
+
+int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+};
+
+uint64_t Compiler::content_digest(std::string_view bytes)
+{
+    return llvm::xxh3_64bits(
+        llvm::ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size()));
+}
+
+Compiler::FileDigests::FileDigests(std::chrono::nanoseconds settle) : _settle(settle)
+{
+}
+
+Compiler::FileDigests &Compiler::FileDigests::instance()
+{
+    static FileDigests digests;
+    return digests;
+}
+
+std::optional<Compiler::FileDigests::Stamp> Compiler::FileDigests::stamp_of(const std::filesystem::path &path)
+{
+#if ECO_FILE_DIGESTS_STAT
+    struct stat info {};
+
+    if (stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+        return std::nullopt;
+    }
+
+#if defined(__APPLE__)
+    const timespec modified = info.st_mtimespec;
+    const timespec changed = info.st_ctimespec;
+#else
+    const timespec modified = info.st_mtim;
+    const timespec changed = info.st_ctim;
+#endif
+
+    Stamp stamp;
+    stamp.size = static_cast<uint64_t>(info.st_size);
+    stamp.modified_ns = static_cast<int64_t>(modified.tv_sec) * 1000000000 + modified.tv_nsec;
+    stamp.changed_ns = static_cast<int64_t>(changed.tv_sec) * 1000000000 + changed.tv_nsec;
+    stamp.inode = static_cast<uint64_t>(info.st_ino);
+
+    return stamp;
+#else
+    // no ctime and no inode to check a remembered digest against, so nothing is remembered: every file is
+    // read and hashed, which is what every build did before there was a memo
+    (void)path;
+    return std::nullopt;
+#endif
+}
+
+void Compiler::FileDigests::attach(const std::filesystem::path &memo)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_attached && memo == _memo) {
+        return;
+    }
+
+    _memo = memo;
+    _attached = true;
+
+    if (!memo.empty()) {
+        load(memo);
+    }
+}
+
+void Compiler::FileDigests::load(const std::filesystem::path &memo)
+{
+    std::ifstream in(memo, std::ios::binary);
+    std::string line;
+
+    if (!in || !std::getline(in, line) || line != k_memo_header) {
+        return;
+    }
+
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+
+        std::string digest;
+        Entry entry;
+
+        if (!(fields >> digest >> entry.stamp.size >> entry.stamp.modified_ns >> entry.stamp.changed_ns
+                >> entry.stamp.inode >> entry.stamped_ns)
+            || fields.get() != ' ') {
+            continue;
+        }
+
+        std::string path;
+        std::getline(fields, path);
+
+        const auto parsed = std::from_chars(digest.data(), digest.data() + digest.size(), entry.digest, 16);
+
+        if (path.empty() || digest.size() != 16 || parsed.ptr != digest.data() + digest.size()) {
+            continue;
+        }
+
+        // what this process already learned is newer than anything on disk
+        _entries.emplace(path, entry);
+    }
+}
+
+std::optional<uint64_t> Compiler::FileDigests::digest_of(const std::filesystem::path &path)
+{
+    const std::optional<Stamp> stamp = stamp_of(path);
+    const int64_t stamped_ns = now_ns();
+
+    if (stamp.has_value()) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto known = _entries.find(path);
+
+        // **settled**: the last change is far enough behind the stat that no edit can have shared its tick
+        if (known != _entries.end() && known->second.stamp == stamp.value()) {
+            const int64_t last_change = std::max(stamp->modified_ns, stamp->changed_ns);
+
+            if (last_change + _settle.count() < known->second.stamped_ns) {
+                _recalled++;
+                return known->second.digest;
+            }
+        }
+    }
+
+    // read and hashed outside the lock, which is the whole of the work a worker thread came here to do
+    const std::optional<std::string> bytes = read_whole_file(path);
+
+    if (!bytes.has_value()) {
+        return std::nullopt;
+    }
+
+    const uint64_t digest = content_digest(bytes.value());
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _hashed++;
+
+    // **the stat from before the read**, so a file written while it was being read is stamped older than its
+    // bytes - and the next stat disagrees and hashes it again, rather than agreeing with the wrong digest
+    if (stamp.has_value()) {
+        _entries[path] = Entry{ stamp.value(), digest, stamped_ns };
+        _dirty = true;
+    }
+
+    return digest;
+}
+
+void Compiler::FileDigests::save()
+{
+#if ECO_FILE_DIGESTS_STAT
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::error_code ec;
+
+    if (!_dirty || _memo.empty() || !std::filesystem::is_directory(_memo.parent_path(), ec)) {
+        return;
+    }
+
+    // beside the memo and renamed over it, so two builds sharing a directory each leave a whole memo behind
+    // rather than one interleaved from both
+    const std::filesystem::path partial = _memo.string() + fmt::format(".{}.partial", getpid());
+
+    {
+        std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+
+        if (!out) {
+            return;
+        }
+
+        out << k_memo_header << "\n";
+
+        for (const auto &[path, entry] : _entries) {
+            const std::string spelled = path.string();
+
+            if (spelled.find('\n') != std::string::npos) {
+                continue;
+            }
+
+            out << to_hex(entry.digest) << " " << entry.stamp.size << " " << entry.stamp.modified_ns << " "
+                << entry.stamp.changed_ns << " " << entry.stamp.inode << " " << entry.stamped_ns << " "
+                << spelled << "\n";
+        }
+
+        if (!out.good()) {
+            out.close();
+            std::filesystem::remove(partial, ec);
+            return;
+        }
+    }
+
+    std::filesystem::rename(partial, _memo, ec);
+
+    if (ec) {
+        std::filesystem::remove(partial, ec);
+        return;
+    }
+
+    _dirty = false;
+#endif
+}
@@ -0,0 +1,343 @@
+#include "Compiler/FileWatcher.h"
+
+#include "Compiler/SettledPath.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <thread>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+// how long a change has to be followed by nothing before it is acted on. Long enough to cover the writes
+// of one save, short enough that nobody waits on it
+constexpr int k_quiet_ms = 60;
+};
+
+bool Compiler::FileWatcher::looks_like_a_source(const std::filesystem::path &name)
+{
+    static const std::set<std::string> extensions = { ".eco", ".c", ".h" };
+
+    return extensions.count(name.extension().string()) != 0;
+}
+
+Compiler::FileWatcher::Stamp Compiler::FileWatcher::stamp_of(const std::filesystem::path &path)
+{
+    std::error_code ec;
+    Stamp stamp;
+
+    const auto size = std::filesystem::file_size(path, ec);
+
+    if (ec) {
+        return stamp;
+    }
+
+    stamp.exists = true;
+    stamp.size = static_cast<long long>(size);
+    stamp.modified = static_cast<long long>(
+        std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+
+    return stamp;
+}
+
+Compiler::FileWatcher::Snapshot Compiler::FileWatcher::snapshot(const std::vector<std::filesystem::path> &files)
+{
+    Snapshot out;
+
+    // **before the stamps**, so a write that lands while they are being taken is after `taken` either way
+    out.taken = std::filesystem::file_time_type::clock::now();
+
+    for (const std::filesystem::path &file : files) {
+        const std::filesystem::path settled = canonical_or_absolute(file);
+        out.stamps.emplace(settled, stamp_of(settled));
+    }
+
+    return out;
+}
+
+std::vector<std::filesystem::path> Compiler::FileWatcher::changed_since(
+    const Snapshot &before,
+    const std::vector<std::filesystem::path> &files
+)
+{
+    std::set<std::filesystem::path> changed;
+
+    for (const std::filesystem::path &file : files) {
+        const std::filesystem::path settled = canonical_or_absolute(file);
+        const Stamp now = stamp_of(settled);
+        const auto stamped = before.stamps.find(settled);
+
+        if (stamped != before.stamps.end()) {
+            if (!(stamped->second == now)) {
+                changed.insert(settled);
+            }
+
+            continue;
+        }
+
+        // not an input when the snapshot was taken, so only its time can say whether it moved since
+        if (now.exists && now.modified >= before.taken.time_since_epoch().count()) {
+            changed.insert(settled);
+        }
+    }
+
+    return std::vector<std::filesystem::path>(changed.begin(), changed.end());
+}
+
+#if defined(__linux__)
+
+Compiler::FileWatcher::FileWatcher()
+{
+    _inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+}
+
+Compiler::FileWatcher::~FileWatcher()
+{
+    if (_inotify >= 0) {
+        close(_inotify);
+    }
+}
+
+void Compiler::FileWatcher::watch(const std::vector<std::filesystem::path> &files)
+{
+    _names_by_directory.clear();
+
+    for (const std::filesystem::path &file : files) {
+        const std::filesystem::path settled = canonical_or_absolute(file);
+        _names_by_directory[settled.parent_path()].insert(settled.filename().string());
+    }
+
+    if (_inotify < 0) {
+        return;
+    }
+
+    // only the directories nobody needs any more lose their watch. Removing one queues an IN_IGNORED for
+    // it, which read_events skips with every other event on a descriptor it no longer knows
+    for (auto at = _directories.begin(); at != _directories.end();) {
+        if (_names_by_directory.count(at->second) == 0) {
+            inotify_rm_watch(_inotify, at->first);
+            at = _directories.erase(at);
+        }
+        else {
+            ++at;
+        }
+    }
+
+    std::set<std::filesystem::path> armed;
+    for (const auto &[descriptor, directory] : _directories) {
+        armed.insert(directory);
+    }
+
+    // the events that can mean a file's bytes are different now: written and closed, replaced by a rename,
+    // created, or removed. IN_MODIFY is left out on purpose - it fires per write, and IN_CLOSE_WRITE is the
+    // one that says the writer is done
+    const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE;
+
+    for (const auto &[directory, names] : _names_by_directory) {
+        if (armed.count(directory) != 0) {
+            continue;
+        }
+
+        const int descriptor = inotify_add_watch(_inotify, directory.c_str(), mask);
+
+        if (descriptor >= 0) {
+            _directories[descriptor] = directory;
+        }
+    }
+}
+
+void Compiler::FileWatcher::forget_pending()
+{
+    if (_inotify < 0) {
+        return;
+    }
+
+    std::set<std::filesystem::path> discarded;
+    read_events(discarded);
+}
+
+void Compiler::FileWatcher::read_events(std::set<std::filesystem::path> &changed)
+{
+    alignas(inotify_event) char buffer[16384];
+
+    while (true) {
+        const ssize_t got = read(_inotify, buffer, sizeof(buffer));
+
+        if (got <= 0) {
+            return;
+        }
+
+        for (ssize_t at = 0; at < got;) {
+            const auto *event = reinterpret_cast<const inotify_event *>(buffer + at);
+            at += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            const auto directory = _directories.find(event->wd);
+
+            if (directory == _directories.end() || event->len == 0) {
+                continue;
+            }
+
+            const std::string name = event->name;
+            const std::set<std::string> &watched = _names_by_directory[directory->second];
+
+            const bool appeared = (event->mask & (IN_CREATE | IN_MOVED_TO)) != 0;
+
+            if (watched.count(name) != 0 || (appeared && looks_like_a_source(name))) {
+                changed.insert(directory->second / name);
+            }
+        }
+    }
+}
+
+std::vector<std::filesystem::path> Compiler::FileWatcher::wait_for_change()
+{
+    if (_inotify < 0 || _directories.empty()) {
+        return {};
+    }
+
+    std::set<std::filesystem::path> changed;
+
+    while (true) {
+        pollfd waiting {};
+        waiting.fd = _inotify;
+        waiting.events = POLLIN;
+
+        // forever until the first change, and then only as long as the quiet period
+        const int ready = poll(&waiting, 1, changed.empty() ? -1 : k_quiet_ms);
+
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+
+        if (ready == 0) {
+            break;
+        }
+
+        read_events(changed);
+    }
+
+    return std::vector<std::filesystem::path>(changed.begin(), changed.end());
+}
+
+#else
+
+Compiler::FileWatcher::FileWatcher() = default;
+Compiler::FileWatcher::~FileWatcher() = default;
+
+std::set<std::string> Compiler::FileWatcher::listing_of(const std::filesystem::path &directory)
+{
+    std::set<std::string> names;
+    std::error_code ec;
+
+    for (const auto &entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (looks_like_a_source(entry.path().filename())) {
+            names.insert(entry.path().filename().string());
+        }
+    }
+
+    return names;
+}
+
+void Compiler::FileWatcher::watch(const std::vector<std::filesystem::path> &files)
+{
+    _names_by_directory.clear();
+
+    for (const std::filesystem::path &file : files) {
+        const std::filesystem::path settled = canonical_or_absolute(file);
+        _names_by_directory[settled.parent_path()].insert(settled.filename().string());
+    }
+
+    // the same diff the inotify side makes, in stamps: a file watched before keeps the stamp it had, so a
+    // write since is still a difference for the next sweep, and only what is new is stamped now
+    std::map<std::filesystem::path, Stamp> stamps;
+    std::map<std::filesystem::path, std::set<std::string>> listings;
+
+    for (const auto &[directory, names] : _names_by_directory) {
+        for (const std::string &name : names) {
+            const std::filesystem::path path = directory / name;
+            const auto before = _stamps.find(path);
+
+            stamps[path] = before != _stamps.end() ? before->second : stamp_of(path);
+        }
+
+        const auto before = _listings.find(directory);
+        listings[directory] = before != _listings.end() ? before->second : listing_of(directory);
+    }
+
+    _stamps = std::move(stamps);
+    _listings = std::move(listings);
+}
+
+void Compiler::FileWatcher::forget_pending()
+{
+    sweep();
+}
+
+std::set<std::filesystem::path> Compiler::FileWatcher::sweep()
+{
+    std::set<std::filesystem::path> changed;
+    std::map<std::filesystem::path, Stamp> stamps;
+    std::map<std::filesystem::path, std::set<std::string>> listings;
+
+    for (const auto &[directory, names] : _names_by_directory) {
+        for (const std::string &name : names) {
+            const std::filesystem::path path = directory / name;
+            const Stamp stamp = stamp_of(path);
+            const auto before = _stamps.find(path);
+
+            if (before != _stamps.end() && (before->second.exists != stamp.exists
+                    || before->second.size != stamp.size || before->second.modified != stamp.modified)) {
+                changed.insert(path);
+            }
+
+            stamps[path] = stamp;
+        }
+
+        listings[directory] = listing_of(directory);
+        const auto before = _listings.find(directory);
+
+        if (before != _listings.end()) {
+            for (const std::string &name : listings[directory]) {
+                if (before->second.count(name) == 0) {
+                    changed.insert(directory / name);
+                }
+            }
+        }
+    }
+
+    _stamps = std::move(stamps);
+    _listings = std::move(listings);
+
+    return changed;
+}
+
+std::vector<std::filesystem::path> Compiler::FileWatcher::wait_for_change()
+{
+    if (_names_by_directory.empty()) {
+        return {};
+    }
+
+    std::set<std::filesystem::path> changed;
+
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(changed.empty() ? 250 : k_quiet_ms));
+
+        const std::set<std::filesystem::path> more = sweep();
+
+        if (more.empty() && !changed.empty()) {
+            break;
+        }
+
+        changed.insert(more.begin(), more.end());
+    }
+
+    return std::vector<std::filesystem::path>(changed.begin(), changed.end());
+}
+
+#endif
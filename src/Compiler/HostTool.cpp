@@ -2,6 +2,8 @@
 
 #include "Compiler/ProgressReporter.h"
 
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/Program.h>
 
 bool Compiler::run_tool(const std::vector<std::string> &argv)
@@ -34,3 +36,40 @@ bool Compiler::run_tool(const std::vector<std::string> &argv)
 
     return llvm::sys::ExecuteAndWait(program.get(), args) == 0;
 }
+
+bool Compiler::run_tool_captured(const std::vector<std::string> &argv, std::string &out_stderr)
+{
+    out_stderr.clear();
+
+    if (argv.empty()) {
+        return false;
+    }
+
+    llvm::ErrorOr<std::string> program = llvm::sys::findProgramByName(argv.front());
+
+    if (!program) {
+        return false;
+    }
+
+    std::vector<llvm::StringRef> args(argv.begin(), argv.end());
+    args.front() = program.get();
+
+    // a file rather than a pipe, because ExecuteAndWait redirects to paths - and a pipe the child can fill
+    // before anyone reads it is a deadlock this function would otherwise have to be written around
+    llvm::SmallString<128> captured;
+
+    if (llvm::sys::fs::createTemporaryFile("echoc-tool", "txt", captured)) {
+        return false;
+    }
+
+    const std::optional<llvm::StringRef> redirects[] = { std::nullopt, std::nullopt, llvm::StringRef(captured) };
+    const bool succeeded = llvm::sys::ExecuteAndWait(program.get(), args, std::nullopt, redirects) == 0;
+
+    if (llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> text = llvm::MemoryBuffer::getFile(captured)) {
+        out_stderr = text.get()->getBuffer().str();
+    }
+
+    llvm::sys::fs::remove(captured);
+
+    return succeeded;
+}
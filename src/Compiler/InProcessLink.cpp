@@ -0,0 +1,493 @@
+#include "Compiler/InProcessLink.h"
+
+#include "eco.h"
+
+#include "Compiler/BuildLayout.h"
+#include "Compiler/HostTool.h"
+#include "Compiler/ModuleCache.h"
+#include "Compiler/PhaseTimings.h"
+#include "Compiler/ProgressReporter.h"
+
+#include <llvm/Support/CrashRecoveryContext.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <mutex>
+
+#include <unistd.h>
+
+// an ELF host, and LLD linked in to link with: the only arrangement this file does anything on. Mach-O keeps
+// Backend::link_executable's `ld` fast path, which already skips the driver, and COFF is not a host echoc has
+#if defined(ECO_HAVE_LLD) && !defined(__APPLE__) && !defined(_WIN32)
+#define ECO_LINKS_IN_PROCESS 1
+#else
+#define ECO_LINKS_IN_PROCESS 0
+#endif
+
+#if ECO_LINKS_IN_PROCESS
+#include <lld/Common/Driver.h>
+
+LLD_HAS_DRIVER(elf)
+
+namespace
+{
+
+// where the driver's line takes the output and the inputs. Spelled so no path or flag can be mistaken for
+// them: the output is handed to the driver as a bare word, and the inputs ride through as a `-Wl,` word,
+// which the driver forwards at exactly the position it would have put an object
+constexpr std::string_view k_output_placeholder = "echoc-link-output.placeholder";
+constexpr std::string_view k_inputs_placeholder = "--echoc-link-inputs-placeholder";
+
+// the first line of a kept plan. A file without it is not one, and is asked for again
+constexpr std::string_view k_plan_header = "# echoc link plan 1";
+
+// a linker argv with the two placeholders still in it, everything after the program name
+using LinkPlan = std::vector<std::string>;
+
+// exactly one of each placeholder, or the line is not one a link can be made from: a driver that dropped
+// the inputs, or repeated them, has done something this file does not understand
+bool is_usable_plan(const LinkPlan &plan)
+{
+    size_t outputs = 0;
+    size_t inputs = 0;
+
+    for (const std::string &word : plan) {
+        outputs += word == k_output_placeholder ? 1 : 0;
+        inputs += word == k_inputs_placeholder ? 1 : 0;
+    }
+
+    return outputs == 1 && inputs == 1;
+}
+
+// **every absolute path the plan names is still there.** The line holds the crt files and the dynamic
+// loader by path, and a compiler upgrade removes the directory they were in - a plan trusted past that
+// fails every link until somebody finds this cache. A handful of stats per link is the price of never
+// being that somebody. `-L` directories are not checked: a missing one is a directory the linker skips
+bool plan_still_holds(const LinkPlan &plan)
+{
+    std::error_code ec;
+
+    for (const std::string &word : plan) {
+        if (!word.empty() && word.front() == '/' && !std::filesystem::exists(word, ec)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// which clang the driver words are asked of, and which line they were asked for: the resolved program and
+// its size and mtime, so an upgrade in place is a new key, then the words and this compiler's version
+std::optional<std::filesystem::path> plan_file(const std::vector<std::string> &driver_words)
+{
+    const std::filesystem::path directory = Compiler::BuildLayout::link_plan_dir();
+
+    if (directory.empty()) {
+        return std::nullopt;
+    }
+
+    llvm::ErrorOr<std::string> clang = llvm::sys::findProgramByName("clang");
+
+    if (!clang) {
+        return std::nullopt;
+    }
+
+    std::error_code ec;
+    const std::filesystem::path resolved = std::filesystem::canonical(clang.get(), ec);
+
+    if (ec) {
+        return std::nullopt;
+    }
+
+    const uint64_t size = std::filesystem::file_size(resolved, ec);
+
+    if (ec) {
+        return std::nullopt;
+    }
+
+    const int64_t modified = std::filesystem::last_write_time(resolved, ec).time_since_epoch().count();
+
+    if (ec) {
+        return std::nullopt;
+    }
+
+    uint64_t key = Compiler::fnv1a64(resolved.string(), Compiler::k_fnv_offset_basis);
+    key = Compiler::fnv1a64(&size, sizeof(size), key);
+    key = Compiler::fnv1a64(&modified, sizeof(modified), key);
+
+    for (const std::string &word : driver_words) {
+        key = Compiler::fnv1a64(word, key);
+    }
+
+    key = Compiler::fnv1a64(std::string(ECO_VERSION_STRING), key);
+
+    return directory / (Compiler::to_hex(key) + ".plan");
+}
+
+std::optional<LinkPlan> recall_plan(const std::filesystem::path &file)
+{
+    std::ifstream in(file, std::ios::binary);
+    std::string line;
+
+    if (!in || !std::getline(in, line) || line != k_plan_header) {
+        return std::nullopt;
+    }
+
+    LinkPlan plan;
+
+    while (std::getline(in, line)) {
+        plan.push_back(line);
+    }
+
+    if (!is_usable_plan(plan) || !plan_still_holds(plan)) {
+        return std::nullopt;
+    }
+
+    return plan;
+}
+
+// best effort, and renamed into place for FileDigests::save's reason: two builds asking at once each leave
+// a whole plan behind. Nothing here can fail a link - the line is already in hand
+void keep_plan(const std::filesystem::path &file, const LinkPlan &plan)
+{
+    if (Compiler::prepare_build_directory(file.parent_path(), Compiler::BuildDirTrust::t_ours)
+        != Compiler::BuildDirState::t_ready) {
+        return;
+    }
+
+    for (const std::string &word : plan) {
+        if (word.find('\n') != std::string::npos) {
+            return;
+        }
+    }
+
+    std::error_code ec;
+    const std::filesystem::path partial = file.string() + fmt::format(".{}.partial", getpid());
+
+    {
+        std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+
+        if (!out) {
+            return;
+        }
+
+        out << k_plan_header << "\n";
+
+        for (const std::string &word : plan) {
+            out << word << "\n";
+        }
+
+        if (!out.good()) {
+            out.close();
+            std::filesystem::remove(partial, ec);
+            return;
+        }
+    }
+
+    std::filesystem::rename(partial, file, ec);
+
+    if (ec) {
+        std::filesystem::remove(partial, ec);
+    }
+}
+
+// the linker line the driver would run for `driver_words`, asked of it with placeholders. LLD by name
+// first, since that is the linker the line is about to be handed to; the system's default after, because
+// a host with LLD linked into echoc need not have `ld.lld` installed - and a GNU line is one LLD reads
+std::optional<LinkPlan> ask_the_driver(const std::vector<std::string> &driver_words)
+{
+    for (const bool naming_lld : { true, false }) {
+        std::vector<std::string> argv = { "clang", "-###" };
+
+        if (naming_lld) {
+            argv.push_back("-fuse-ld=lld");
+        }
+
+        argv.insert(argv.end(), driver_words.begin(), driver_words.end());
+        argv.push_back("-o");
+        argv.push_back(std::string(k_output_placeholder));
+        argv.push_back(fmt::format("-Wl,{}", k_inputs_placeholder));
+
+        std::string output;
+
+        if (!Compiler::run_tool_captured(argv, output)) {
+            continue;
+        }
+
+        std::optional<std::vector<std::string>> command = Compiler::last_driver_command(output);
+
+        if (!command || command->empty()) {
+            continue;
+        }
+
+        LinkPlan plan(command->begin() + 1, command->end());
+
+        // the GNU linker's LTO plugin, which only `-flto` asks for and LLD has no use for. A line naming it
+        // was spelled for a different kind of link than this one
+        bool plugin = false;
+
+        for (const std::string &word : plan) {
+            plugin = plugin || word == "-plugin";
+        }
+
+        if (!plugin && is_usable_plan(plan)) {
+            return plan;
+        }
+    }
+
+    return std::nullopt;
+}
+
+// **whether a refused link is the program's doing**, read off what LLD said: every error it gave is one the
+// driver would give as well - a symbol nobody defines or two objects define, a `-l` nothing answers, or one
+// naming an input this link was handed. Such a link is reported as it is and not tried again, since clang
+// would only say the same thing a second time. Anything else - a crt file it could not open, a flag it did
+// not understand, or no error at all - is the plan's doing until the driver shows otherwise
+bool inputs_are_at_fault(std::string_view diagnostics, const std::vector<std::string> &inputs)
+{
+    constexpr std::string_view k_error = "error: ";
+    bool any = false;
+
+    size_t start = 0;
+
+    while (start < diagnostics.size()) {
+        size_t end = diagnostics.find('\n', start);
+
+        if (end == std::string_view::npos) {
+            end = diagnostics.size();
+        }
+
+        const std::string_view line = diagnostics.substr(start, end - start);
+        start = end + 1;
+
+        const size_t at = line.find(k_error);
+
+        if (at == std::string_view::npos) {
+            continue;
+        }
+
+        const std::string_view message = line.substr(at + k_error.size());
+        any = true;
+
+        const bool program = message.rfind("undefined symbol", 0) == 0
+            || message.rfind("duplicate symbol", 0) == 0
+            || message.rfind("unable to find library", 0) == 0
+            || std::any_of(inputs.begin(), inputs.end(), [&](const std::string &input) {
+                   return message.find(input) != std::string_view::npos;
+               });
+
+        if (!program) {
+            return false;
+        }
+    }
+
+    return any;
+}
+
+// the plans this process has already settled, by the words they were asked with. A build links once, but
+// a run with C modules links one library per module, all asking with the same words
+std::map<std::vector<std::string>, LinkPlan> &settled_plans()
+{
+    static std::map<std::vector<std::string>, LinkPlan> plans;
+    return plans;
+}
+
+// LLD keeps its state in globals - the one linker context, its error count, its output buffers - so one
+// link at a time, whichever thread asks. And once it reports that it cannot run again, which is what a
+// crash it recovered from leaves behind, nothing in this process asks it again
+std::mutex &lld_lock()
+{
+    static std::mutex lock;
+    return lock;
+}
+
+bool lld_is_spent = false;
+
+};
+#endif
+
+void Compiler::forget_link_plan(const std::vector<std::string> &driver_words)
+{
+#if ECO_LINKS_IN_PROCESS
+    std::lock_guard<std::mutex> lock(lld_lock());
+
+    settled_plans().erase(driver_words);
+
+    if (const std::optional<std::filesystem::path> file = plan_file(driver_words)) {
+        std::error_code ec;
+        std::filesystem::remove(file.value(), ec);
+    }
+#else
+    (void)driver_words;
+#endif
+}
+
+std::optional<std::vector<std::string>> Compiler::last_driver_command(std::string_view driver_output)
+{
+    std::optional<std::vector<std::string>> last;
+
+    size_t start = 0;
+
+    while (start < driver_output.size()) {
+        size_t end = driver_output.find('\n', start);
+
+        if (end == std::string_view::npos) {
+            end = driver_output.size();
+        }
+
+        const std::string_view line = driver_output.substr(start, end - start);
+        start = end + 1;
+
+        // a command is the one kind of line the driver opens with a quote, after a space of indent. The rest
+        // - its version, target, thread model, install directory - are prose
+        const size_t first = line.find_first_not_of(' ');
+
+        if (first == std::string_view::npos || line[first] != '"') {
+            continue;
+        }
+
+        // each word quoted, and `"`, `\` and `$` inside one escaped with a backslash - the driver's own
+        // Command::printArg, read backwards
+        std::vector<std::string> words;
+        size_t at = first;
+
+        while (at < line.size()) {
+            if (line[at] == ' ') {
+                at++;
+                continue;
+            }
+
+            std::string word;
+
+            if (line[at] == '"') {
+                at++;
+
+                while (at < line.size() && line[at] != '"') {
+                    if (line[at] == '\\' && at + 1 < line.size()) {
+                        at++;
+                    }
+
+                    word += line[at++];
+                }
+
+                at++;
+            }
+            else {
+                while (at < line.size() && line[at] != ' ') {
+                    word += line[at++];
+                }
+            }
+
+            words.push_back(std::move(word));
+        }
+
+        last = std::move(words);
+    }
+
+    return last;
+}
+
+Compiler::InProcessLink Compiler::link_in_process(
+    const std::vector<std::string> &driver_words,
+    const std::filesystem::path &output,
+    const std::vector<std::string> &inputs
+)
+{
+#if ECO_LINKS_IN_PROCESS
+    std::lock_guard<std::mutex> lock(lld_lock());
+
+    if (lld_is_spent) {
+        return InProcessLink::t_unavailable;
+    }
+
+    auto settled = settled_plans().find(driver_words);
+
+    if (settled == settled_plans().end()) {
+        ScopedPhase phase("link plan");
+
+        const std::optional<std::filesystem::path> file = plan_file(driver_words);
+        std::optional<LinkPlan> plan = file ? recall_plan(file.value()) : std::nullopt;
+
+        if (!plan) {
+            plan = ask_the_driver(driver_words);
+
+            if (!plan || !plan_still_holds(plan.value())) {
+                return InProcessLink::t_unavailable;
+            }
+
+            if (file) {
+                keep_plan(file.value(), plan.value());
+            }
+        }
+
+        settled = settled_plans().emplace(driver_words, std::move(plan.value())).first;
+    }
+
+    // the program name is LLD's flavor, so it is always this one whatever linker the driver named
+    const std::string spelled_output = output.string();
+    std::vector<const char *> args = { "ld.lld" };
+
+    for (const std::string &word : settled->second) {
+        if (word == k_output_placeholder) {
+            args.push_back(spelled_output.c_str());
+        }
+        else if (word == k_inputs_placeholder) {
+            for (const std::string &input : inputs) {
+                args.push_back(input.c_str());
+            }
+        }
+        else {
+            args.push_back(word.c_str());
+        }
+    }
+
+    ScopedPhase phase("lld");
+
+    // what run_tool discharges for a child, owed here for the same reason: LLD's diagnostics are about to
+    // reach the stderr a progress row may be sitting on
+    ProgressReporter::instance().suspend();
+
+    // held back rather than written as LLD goes: a refusal that is the plan's doing is retried through the
+    // driver, and what LLD said about a line the driver is about to replace is nobody's business
+    std::string diagnostics;
+    llvm::raw_string_ostream diagnostics_stream(diagnostics);
+
+    // **on every core**, which is LLD's default and the reason for the whole arrangement: `--threads` is left
+    // unset, so section contents are written and relocated in parallel. The recovery context is what lets
+    // LLD's `fatal` unwind to here instead of leaving the process, and it is enabled only around the link so
+    // a JIT'd program's own crash is nobody's to recover but its own
+    llvm::CrashRecoveryContext::Enable();
+    const lld::Result result =
+        lld::lldMain(args, llvm::outs(), diagnostics_stream, { { lld::Gnu, &lld::elf::link } });
+    llvm::CrashRecoveryContext::Disable();
+
+    diagnostics_stream.flush();
+    llvm::outs().flush();
+
+    lld_is_spent = !result.canRunAgain;
+
+    if (result.retCode != 0 && !inputs_are_at_fault(diagnostics, inputs)) {
+        return InProcessLink::t_failed;
+    }
+
+    // a warning on a link that worked, or the errors of one the program itself refused
+    llvm::errs() << diagnostics;
+    llvm::errs().flush();
+
+    if (result.retCode != 0) {
+        return InProcessLink::t_refused;
+    }
+
+    return InProcessLink::t_linked;
+#else
+    (void)driver_words;
+    (void)output;
+    (void)inputs;
+    return InProcessLink::t_unavailable;
+#endif
+}
@@ -1,15 +1,21 @@
 #include "Compiler/LLVM/Codegen/Backend.h"
 #include "Compiler/LLVM/CompilationUnit.h"
 #include "Compiler/LLVM/CodegenContext.h"
+#include "Compiler/LLVM/SharedDefinitions.h"
+#include "Compiler/LLVM/Codegen/TieredExecution.h"
 #include "Compiler/HostTool.h"
+#include "Compiler/InProcessLink.h"
+#include "Compiler/ModuleCache.h"
 #include "Compiler/PhaseTimings.h"
+#include "Compiler/ProgressReporter.h"
 #include "Compiler/TargetFacts.h"
 #include "Compiler/TargetSubtarget.h"
 
 #include <llvm/ADT/StringSet.h>
-#include <llvm/ExecutionEngine/ExecutionEngine.h>
-#include <llvm/ExecutionEngine/MCJIT.h>
-#include <llvm/ExecutionEngine/GenericValue.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/Object/ObjectFile.h>
 #include <llvm/Support/DynamicLibrary.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Program.h>
@@ -24,17 +30,37 @@
 #include <llvm/Transforms/IPO/Inliner.h>
 #include <llvm/Transforms/IPO/GlobalDCE.h>
 #include <llvm/Transforms/IPO/Internalize.h>
+#include <llvm/Transforms/Scalar/EarlyCSE.h>
+#include <llvm/Transforms/Scalar/SROA.h>
+#include <llvm/Transforms/Scalar/SimplifyCFG.h>
 #include <llvm/Analysis/InlineCost.h>
+#include <llvm/Analysis/ModuleSummaryAnalysis.h>
+#include <llvm/Analysis/ProfileSummaryInfo.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/LTO/LTO.h>
+#include <llvm/Support/CachePruning.h>
+#include <llvm/Support/Caching.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Threading.h>
 
 #include <fmt/core.h>
 
 #include <cstdio>
 #include <cstdlib>
 
+#include <unistd.h>
+
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
+#include <mutex>
 #include <optional>
+#include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace Compiler::LLVM
@@ -45,10 +71,9 @@ Backend::Backend(CodegenContext &ctx) : _ctx(ctx)
 
 Backend::~Backend()
 {
-    // the engine outlives every call into the code it holds, which is why it is not deleted where it was
+    // the JIT outlives every call into the code it holds, which is why it is not released where it was
     // used: a test run calls one definition per forked child and only knows it is done when the last child
     // has been reaped
-    delete _engine;
 }
 
 void Backend::print_ir(bool to_file)
@@ -83,9 +108,99 @@ void Backend::print_unit_ir()
     }
 }
 
-bool Backend::prepare_execution()
+// **a module the JIT owns, in a context the JIT owns.** ORC compiles a module under the lock of the context
+// it was built in, and may do so on a thread of its own, so it takes that context with the module - and the
+// ones codegen built are not the backend's to give: the builder, the debug-info builders and the symbol
+// tables all still point into them, and outlive this Backend. So the module crosses as bitcode, with its
+// use-list order for emit_units' reason, into a context of its own that nothing else references.
+//
+// one context per module rather than one for all of them, which is what lets two modules compile at once
+static llvm::Expected<llvm::orc::ThreadSafeModule> into_jit_context(std::unique_ptr<llvm::Module> module)
+{
+    llvm::SmallVector<char, 0> bitcode;
+    llvm::raw_svector_ostream stream(bitcode);
+    llvm::WriteBitcodeToFile(*module, stream, /*ShouldPreserveUseListOrder=*/true);
+
+    const std::string name = module->getModuleIdentifier();
+    module.reset();
+
+    auto context = std::make_unique<llvm::LLVMContext>();
+
+    llvm::Expected<std::unique_ptr<llvm::Module>> parsed = llvm::parseBitcodeFile(
+        llvm::MemoryBufferRef(llvm::StringRef(bitcode.data(), bitcode.size()), name), *context);
+
+    if (!parsed) {
+        return parsed.takeError();
+    }
+
+    return llvm::orc::ThreadSafeModule(std::move(parsed.get()), std::move(context));
+}
+
+// where a lazy stub jumps when the body behind it could not be compiled. ORC has already reported why by
+// then, through the session's error reporter, and the program cannot continue past a call that has no
+// callee - so this only ends it, with the status a `die` would have
+static void lazy_compile_failed()
+{
+    std::fflush(nullptr);
+    std::_Exit(1);
+}
+
+bool Backend::create_jit(bool lazy, unsigned compile_threads)
+{
+    // **the JIT builds its own target machine, so it has to be told the same thing.** It does not take
+    // `_target_machine` - it builds one per compile thread out of this - and left alone it would select
+    // for an empty CPU string. So `run` optimized the IR for one subtarget and then selected instructions
+    // for another, and `--target-cpu` would have been a flag that quietly did nothing on this path.
+    // The answer is the same call the pipelines above make, which is the whole point of it being a
+    // function rather than state on the machine
+    const Compiler::Subtarget sub = subtarget();
+
+    llvm::orc::JITTargetMachineBuilder machine{ llvm::Triple(_ctx.target_triple) };
+    machine.setCPU(sub.cpu);
+    machine.addFeatures(split_target_features(sub.features));
+
+    // the process's own symbols are searched by default - libc, and every library load_native_libraries
+    // opened, which is the only way a `#[link:]` reaches the program. `compile_threads` of zero compiles
+    // on whichever thread asked, which is the one setting that survives a fork
+    if (lazy) {
+        llvm::Expected<std::unique_ptr<llvm::orc::LLLazyJIT>> created = llvm::orc::LLLazyJITBuilder()
+            .setJITTargetMachineBuilder(machine)
+            .setDataLayout(_ctx.layout())
+            .setNumCompileThreads(compile_threads)
+            .setLazyCompileFailureAddr(llvm::orc::ExecutorAddr::fromPtr(&lazy_compile_failed))
+            .create();
+
+        if (created) {
+            _jit = std::move(created.get());
+            _jit_is_lazy = true;
+            return true;
+        }
+
+        // **a target ORC has no stubs for** is a run that compiles everything up front, as it always did,
+        // rather than one that does not run at all
+        llvm::consumeError(created.takeError());
+    }
+
+    llvm::Expected<std::unique_ptr<llvm::orc::LLJIT>> created = llvm::orc::LLJITBuilder()
+        .setJITTargetMachineBuilder(machine)
+        .setDataLayout(_ctx.layout())
+        .setNumCompileThreads(compile_threads)
+        .create();
+
+    if (!created) {
+        llvm::errs() << "Failed to create the JIT: " << llvm::toString(created.takeError()) << '\n';
+        return false;
+    }
+
+    _jit = std::move(created.get());
+    _jit_is_lazy = false;
+
+    return true;
+}
+
+bool Backend::prepare_execution(const std::vector<std::filesystem::path> &objects, unsigned jobs, bool tiered)
 {
-    if (_engine != nullptr) {
+    if (_jit != nullptr) {
         return true;
     }
 
@@ -96,72 +211,199 @@ bool Backend::prepare_execution()
         throw Compiler::InternalCompilerException("No main module found to run", nullptr);
     }
 
-    // before the EngineBuilder below, which moves the module out - and inside run_code rather than beside
-    // it, because the JIT is the only place the prune is sound. `-t` sees it either way: PhaseTimings is
-    // process-wide precisely so a phase can be claimed by whichever object owns the work
-    {
+    // the units the JIT compiles beside the entry module: a module from no manifest, or one whose store
+    // could not be written
+    std::vector<CmpUnit *> in_memory;
+
+    for (auto &cmp_unit : _ctx.cmp_units) {
+        if (cmp_unit.get() != main_cmp_unit && cmp_unit->llvm_module) {
+            in_memory.push_back(cmp_unit.get());
+        }
+    }
+
+    // before the modules leave for the JIT - and inside run_code rather than beside it, because the JIT is
+    // the only place the prune is sound. `-t` sees it either way: PhaseTimings is process-wide precisely so
+    // a phase can be claimed by whichever object owns the work
+    //
+    // **and only over a whole program.** Internalizing the entry module beside objects that define the same
+    // linkonce_odr globals would give it a private copy of each - a second allocation counter, a second
+    // static - so with objects in play the report says why nothing was pruned rather than saying nothing
+    if (objects.empty() && in_memory.empty()) {
         Compiler::ScopedPhase phase("prune");
         prune_to_entry();
     }
+    else {
+        const size_t separate = objects.size() + in_memory.size();
 
-    // **the JIT builds its own target machine, so it has to be told the same thing.** MCJIT does not
-    // take `_target_machine` - it selects one out of the EngineBuilder - and left alone it defaults to
-    // an empty CPU string. So `run` optimized the IR for one subtarget and then selected instructions
-    // for another, and `--target-cpu` would have been a flag that quietly did nothing on this path.
-    // The answer is the same call the pipelines above make, which is the whole point of it being a
-    // function rather than state on the machine
-    const Compiler::Subtarget sub = subtarget();
-    const std::vector<std::string> attributes = split_target_features(sub.features);
-
-    std::string errorStr;
-    const llvm::TargetOptions opts;
-    _engine = llvm::EngineBuilder(std::move(_ctx.main_cmp_unit()->llvm_module))
-        .setErrorStr(&errorStr)
-        .setEngineKind(llvm::EngineKind::JIT)
-        .setTargetOptions(opts)
-        .setMCPU(sub.cpu)
-        .setMAttrs(attributes)
-        .create();
-
-    _ctx.main_cmp_unit()->llvm_module = nullptr;
+        _prune_report = fmt::format(
+            "[prune]\n  not run: {} module{} loaded beside {}, which a prune cannot see into\n",
+            separate, separate == 1 ? " is" : "s are", ECO_ENTRY_SYMBOL_NAME);
+    }
 
-    if (!_engine) {
-        llvm::errs() << "Failed to create ExecutionEngine: " << errorStr << '\n';
+    // **lazy, so a run pays for the functions it calls and not for the ones it could.** Every definition
+    // becomes a stub that compiles its body the first time it is called, so a program that touches a
+    // twentieth of the standard library compiles a twentieth of it - and a test run asked for one test
+    // compiles what that test calls and nothing its neighbours do.
+    //
+    // **except a test run of several**, which compiles up front. Each test runs in a child forked from this
+    // process, and what a child compiles dies with it: lazily, every test would compile again each helper
+    // it shares with the others. And never on compile threads under a test run, because a fork copies
+    // only the thread that forked and a child waiting on a compile the pool was running waits forever
+    const bool lazy = !_ctx.test_mode || _jit_roots.size() < 2;
+    const unsigned compile_threads = _ctx.test_mode || jobs < 2 ? 0 : jobs;
+
+    if (!create_jit(lazy, compile_threads)) {
         return false;
     }
 
-    _engine->finalizeObject();
+    // **the objects before the modules**: a weak definition the JIT already holds wins over one added after
+    // it, so a linkonce_odr definition the entry module shares with a library resolves to the library's
+    // copy - one definition per symbol, as the linker would have left it
+    {
+        Compiler::ScopedPhase phase("load objects");
+
+        for (const std::filesystem::path &object : objects) {
+            llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> loaded = llvm::MemoryBuffer::getFile(object.string());
+
+            if (!loaded) {
+                llvm::errs() << "Could not load '" << object.string() << "': " << loaded.getError().message() << '\n';
+
+                _jit.reset();
+                return false;
+            }
+
+            if (llvm::Error error = _jit->addObjectFile(std::move(loaded.get()))) {
+                llvm::errs() << "Could not load '" << object.string() << "': "
+                             << llvm::toString(std::move(error)) << '\n';
+
+                _jit.reset();
+                return false;
+            }
+        }
+    }
+
+    if (tiered) {
+        start_tiering();
+    }
+
+    std::vector<CmpUnit *> modules = { main_cmp_unit };
+    modules.insert(modules.end(), in_memory.begin(), in_memory.end());
+
+    // **every module across before the first is added**, because a tiered run splits each one on the way and
+    // the stubs of one are resolved by name from all the others - see TieredExecution::prepare_module
+    std::vector<llvm::Expected<llvm::orc::ThreadSafeModule>> crossed;
+
+    for (CmpUnit *cmp_unit : modules) {
+        crossed.push_back(into_jit_context(std::move(cmp_unit->llvm_module)));
+        cmp_unit->llvm_module = nullptr;
+
+        // tested first, which is also what marks it checked for a module the loop below never reaches
+        if (crossed.back() && _tiering != nullptr) {
+            crossed.back()->withModuleDo([this](llvm::Module &module) { _tiering->prepare_module(module); });
+        }
+    }
+
+    for (size_t i = 0; i < modules.size(); ++i) {
+        CmpUnit *cmp_unit = modules[i];
+        llvm::Expected<llvm::orc::ThreadSafeModule> &module = crossed[i];
+
+        const auto add = [&]() -> llvm::Error {
+            if (!module) {
+                return module.takeError();
+            }
+
+            if (_jit_is_lazy) {
+                return static_cast<llvm::orc::LLLazyJIT &>(*_jit).addLazyIRModule(std::move(module.get()));
+            }
+
+            return _jit->addIRModule(std::move(module.get()));
+        };
+
+        if (llvm::Error added = add()) {
+            llvm::errs() << "Could not hand unit '" << cmp_unit->ast_module->name << "' to the JIT: "
+                         << llvm::toString(std::move(added)) << '\n';
+
+            _tiering.reset();
+            _jit.reset();
+            return false;
+        }
+    }
+
+    // **the entry point, looked up now rather than when it is called**, so a program whose symbols do not
+    // resolve fails here, before it has started, rather than part way through. Under the lazy JIT this
+    // answers a stub and compiles nothing; up front it compiles `main` and everything `main` links against
+    llvm::Expected<llvm::orc::ExecutorAddr> entry = _jit->lookup(ECO_ENTRY_SYMBOL_NAME);
+
+    if (!entry) {
+        llvm::errs() << "Function '" ECO_ENTRY_SYMBOL_NAME "' could not be compiled: "
+                     << llvm::toString(entry.takeError()) << '\n';
+
+        _tiering.reset();
+        _jit.reset();
+        return false;
+    }
 
     return true;
 }
 
 uint64_t Backend::function_address(const std::string &mangled) const
 {
-    if (_engine == nullptr) {
+    if (_jit == nullptr) {
         return 0;
     }
 
-    return _engine->getFunctionAddress(mangled);
+    llvm::Expected<llvm::orc::ExecutorAddr> address = _jit->lookup(mangled);
+
+    // a symbol the prune dropped, which is the caller's to refuse - see the header
+    if (!address) {
+        llvm::consumeError(address.takeError());
+        return 0;
+    }
+
+    return address->getValue();
+}
+
+std::string Backend::tier_report()
+{
+    // a line rather than nothing, for `--explain prune`'s reason: a section that is silently absent reads
+    // the same as a flag that was never honoured
+    if (_tiering == nullptr) {
+        return "[tiers]\n  not tiered: this run did not ask for --optimize tiered\n";
+    }
+
+    return _tiering->report();
 }
 
 int Backend::run_main(const std::vector<std::string> &arguments, const char *const *environment)
 {
-    if (_engine == nullptr) {
+    if (_jit == nullptr) {
         throw Compiler::InternalCompilerException(
-            "run_main was called before prepare_execution built the engine", nullptr);
+            "run_main was called before prepare_execution built the JIT", nullptr);
     }
 
-    auto *func = _engine->FindFunctionNamed(ECO_ENTRY_SYMBOL_NAME);
-    if (!func) {
+    llvm::Expected<llvm::orc::ExecutorAddr> entry = _jit->lookup(ECO_ENTRY_SYMBOL_NAME);
+    if (!entry) {
         llvm::errs() << "Function '" ECO_ENTRY_SYMBOL_NAME "' not found in module.\n";
+        llvm::consumeError(entry.takeError());
         return 1;
     }
 
-    // runFunctionAsMain rather than runFunction with no arguments: it is the one place that knows how to
-    // marshal argc/argv/envp into a call, and the entry point now takes all three. It dispatches on the
-    // parameter count and report_fatal_error()s on a shape it does not recognise, so the agreement with
-    // LLVMCompiler's FunctionType is load-bearing and pinned by tests_eco/env
-    return _engine->runFunctionAsMain(func, arguments, environment);
+    // **called directly, with all three arguments.** The entry point is `int main(int, char **, char **)`
+    // - see LLVMCompiler::emit_entry_point - and the agreement is load-bearing and pinned by tests_eco/env.
+    // `argv` is the C shape: writable strings and a null after the last, which the copies below are
+    std::vector<std::string> argument_storage = arguments;
+    std::vector<char *> argv;
+
+    for (std::string &argument : argument_storage) {
+        argv.push_back(argument.data());
+    }
+
+    argv.push_back(nullptr);
+
+    auto *entry_point = entry->toPtr<int (*)(int, char **, char **)>();
+
+    return entry_point(
+        static_cast<int>(argument_storage.size()), argv.data(), const_cast<char **>(environment));
 }
 
 Compiler::Subtarget Backend::subtarget() const
@@ -190,6 +432,12 @@ void Backend::init_target()
 
     _ctx.target_triple = llvm::sys::getDefaultTargetTriple();
 
+    _target_machine = create_target_machine();
+    _ctx.data_layout = _target_machine->createDataLayout();
+}
+
+std::unique_ptr<llvm::TargetMachine> Backend::create_target_machine() const
+{
     std::string error;
     auto *target = llvm::TargetRegistry::lookupTarget(_ctx.target_triple, error);
     if (!target) {
@@ -219,14 +467,14 @@ void Backend::init_target()
         _ctx.options.no_optimize ? llvm::CodeGenOptLevel::None : llvm::CodeGenOptLevel::Default;
 
     llvm::TargetOptions opt;
-    _target_machine.reset(target->createTargetMachine(
+    std::unique_ptr<llvm::TargetMachine> machine(target->createTargetMachine(
         _ctx.target_triple, sub.cpu, sub.features, opt, llvm::Reloc::PIC_, std::nullopt, opt_level));
-    if (!_target_machine) {
+    if (!machine) {
         throw Compiler::InternalCompilerException(fmt::format(
             "Could not create a target machine for '{}'", _ctx.target_triple));
     }
 
-    _ctx.data_layout = _target_machine->createDataLayout();
+    return machine;
 }
 
 namespace
@@ -349,6 +597,12 @@ bool Backend::emit_object(Compiler::LLVM::CmpUnit &cmp_unit, const std::filesyst
         return false;
     }
 
+    return write_unit_object(*cmp_unit.llvm_module, object_path, *_target_machine);
+}
+
+bool Backend::write_unit_object(
+    llvm::Module &module, const std::filesystem::path &object_path, llvm::TargetMachine &machine) const
+{
     // the directory is the driver's - it prepared one before it decided to emit here at all. Creating one
     // on the way past would be a second answer to where a build artifact goes, in the layer furthest from
     // the question
@@ -361,20 +615,353 @@ bool Backend::emit_object(Compiler::LLVM::CmpUnit &cmp_unit, const std::filesyst
         return false;
     }
 
+    // **a thin unit's artifact is its module, summarized** - what it defines, what it calls and how hot, which
+    // is everything thin_link needs to decide what to import without loading a body. The module hash is
+    // what lets the link's own cache recognise the unit again; without it every backend would run every time
+    if (_ctx.options.thin_lto) {
+        llvm::ProfileSummaryInfo profile(module);
+        const llvm::ModuleSummaryIndex summary = llvm::buildModuleSummaryIndex(module, nullptr, &profile);
+
+        llvm::WriteBitcodeToFile(module, dest, /*ShouldPreserveUseListOrder=*/false, &summary, /*GenerateHash=*/true);
+        dest.flush();
+
+        return true;
+    }
+
+    return write_native_object(module, dest, machine);
+}
+
+bool Backend::write_native_object(llvm::Module &module, llvm::raw_pwrite_stream &dest, llvm::TargetMachine &machine)
+{
     llvm::legacy::PassManager pass;
     auto FileType = llvm::CodeGenFileType::ObjectFile;
 
-    if (_target_machine->addPassesToEmitFile(pass, dest, nullptr, FileType)) {
+    if (machine.addPassesToEmitFile(pass, dest, nullptr, FileType)) {
         llvm::errs() << "TargetMachine can't emit a file of this type";
         return false;
     }
 
-    pass.run(*cmp_unit.llvm_module);
+    pass.run(module);
     dest.flush();
 
     return true;
 }
 
+uint64_t Backend::instance_environment(const llvm::TargetMachine &machine) const
+{
+    uint64_t environment = Compiler::k_fnv_offset_basis;
+    environment = Compiler::fnv1a64(std::string(ECO_MODULE_CACHE_VERSION), environment);
+    environment = Compiler::fnv1a64(std::string(LLVM_VERSION_STRING), environment);
+
+    // read off the machine rather than off the options, because the machine is what generates the code -
+    // a CPU the options only implied is one it names
+    environment = Compiler::fnv1a64(machine.getTargetTriple().str(), environment);
+    environment = Compiler::fnv1a64(machine.getTargetCPU().str(), environment);
+    environment = Compiler::fnv1a64(machine.getTargetFeatureString().str(), environment);
+
+    // init_target's machine level, which `--optimize none` lowers and nothing in the IR records
+    return Compiler::fnv1a64(_ctx.options.no_optimize ? std::string("noopt") : std::string("opt"), environment);
+}
+
+std::filesystem::path Backend::keep_shared_definitions(
+    Compiler::LLVM::CmpUnit &cmp_unit,
+    const std::filesystem::path &object_path,
+    const std::filesystem::path &instance_dir
+)
+{
+    std::error_code ec;
+
+    // whatever an earlier object at this path leaned on, this one is about to say for itself - and a record
+    // outliving the object it described would have a whole object wait on instance objects it never needed
+    std::filesystem::remove(Compiler::instance_record_path(object_path), ec);
+
+    if (!cmp_unit.llvm_module || !_target_machine) {
+        return {};
+    }
+
+    const KeptDefinitions kept = split_off_shared_definitions(
+        *cmp_unit.llvm_module, cmp_unit.ast_module->name, object_path, instance_dir, *_target_machine);
+
+    record_kept(kept);
+
+    return kept.instance;
+}
+
+Backend::KeptDefinitions Backend::split_off_shared_definitions(
+    llvm::Module &module,
+    const std::string &unit_name,
+    const std::filesystem::path &object_path,
+    const std::filesystem::path &instance_dir,
+    llvm::TargetMachine &machine
+) const
+{
+    KeptDefinitions kept;
+    std::error_code ec;
+
+    if (instance_dir.empty() || _ctx.options.thin_lto || _ctx.options.emitting_debug_info()) {
+        return kept;
+    }
+
+    SharedDefinitionSplit split = split_shared_definitions(module);
+
+    // a row per unit that had a shared body at all, first field the unit, so a person greps for the module
+    // they are asking about the way they do under `[cache]`
+    if (!split.module) {
+        if (!split.kept_because.empty()) {
+            kept.report_row = fmt::format("  {}  kept  ({})\n", unit_name, split.kept_because);
+        }
+
+        return kept;
+    }
+
+    const uint64_t digest = shared_definitions_digest(*split.module, instance_environment(machine));
+    const std::filesystem::path instance = Compiler::instance_object_path(instance_dir, digest);
+
+    const bool reused = std::filesystem::is_regular_file(instance, ec);
+
+    if (reused) {
+        std::filesystem::last_write_time(instance, std::filesystem::file_time_type::clock::now(), ec);
+    }
+    else {
+        // the directory is the layout's, beneath a module directory the driver already prepared - made here
+        // because this is the first moment anything needs it, and the name was not invented here
+        std::filesystem::create_directories(instance_dir, ec);
+
+        const std::filesystem::path staged = instance.string() + fmt::format(".{}.partial", getpid());
+
+        bool written = false;
+        {
+            llvm::raw_fd_ostream dest(staged.string(), ec, llvm::sys::fs::OF_None);
+            written = !ec && write_native_object(*split.module, dest, machine);
+        }
+
+        if (written) {
+            std::filesystem::rename(staged, instance, ec);
+        }
+
+        if (!written || ec) {
+            std::filesystem::remove(staged, ec);
+            return kept;
+        }
+
+        Compiler::prune_instance_objects(instance_dir);
+    }
+
+    if (!Compiler::write_instance_record(object_path, { instance })) {
+        return kept;
+    }
+
+    release_shared_definitions(module, *split.module);
+
+    kept.instance = instance;
+    kept.counter = reused ? "instance objects reused" : "instance objects stored";
+    kept.report_row = fmt::format("  {}  {}  {}  {} definition{}\n",
+        unit_name, reused ? "hit" : "stored", Compiler::to_hex(digest),
+        split.definitions, split.definitions == 1 ? "" : "s");
+
+    return kept;
+}
+
+void Backend::record_kept(const KeptDefinitions &kept)
+{
+    if (!kept.report_row.empty()) {
+        if (_instance_report.empty()) {
+            _instance_report = "[instances]\n";
+        }
+
+        _instance_report += kept.report_row;
+    }
+
+    if (kept.counter != nullptr) {
+        Compiler::PhaseTimings::instance().count(kept.counter, 1);
+    }
+}
+
+bool Backend::emit_units(std::vector<UnitEmission> &units, unsigned jobs)
+{
+    if (jobs > 1 && units.size() > 1) {
+        return emit_units_in_parallel(units, jobs);
+    }
+
+    for (size_t i = 0; i < units.size(); i++) {
+        UnitEmission &unit = units[i];
+
+        // **what the unit's module holds by the time it is an object** - the unreferenced shared
+        // definitions dropped, then the baseline pipeline unless the invocation refused it. Its own call
+        // and not inside emit_object because `--print ir-units` has to reach the same answer, and it dumps
+        // rather than emits; the whole-program module arrives already marked optimized
+        prepare_unit_for_emission(*unit.cmp_unit);
+
+        // **after the pipeline and before the writer** - what moves is what the pipeline left, and what the
+        // writer is handed is the unit without it
+        unit.instance = keep_shared_definitions(*unit.cmp_unit, unit.object, unit.instance_dir);
+
+        if (!emit_object(*unit.cmp_unit, unit.object)) {
+            return false;
+        }
+
+        unit.cmp_unit->llvm_module.reset();
+
+        Compiler::ProgressReporter::instance().tick(fmt::format("{}/{} units", i + 1, units.size()));
+    }
+
+    return true;
+}
+
+bool Backend::emit_units_in_parallel(std::vector<UnitEmission> &units, unsigned jobs)
+{
+    if (!_target_machine) {
+        llvm::errs() << "No target resolved - init_target must run before emit_object\n";
+        return false;
+    }
+
+    const size_t workers = std::min<size_t>(jobs, units.size());
+
+    // **built here and not on the workers**: a machine that cannot be built is a throw, and a throw has to
+    // happen on the thread that can still report it
+    std::vector<std::unique_ptr<llvm::TargetMachine>> machines;
+
+    for (size_t i = 0; i < workers; i++) {
+        machines.push_back(create_target_machine());
+    }
+
+    // one slot per unit, at the unit's index, so what the workers produce is read back in unit order
+    // whichever of them finished first
+    struct Slot
+    {
+        llvm::SmallVector<char, 0> bitcode;
+        bool optimized = false;
+        bool emitted = false;
+        KeptDefinitions kept;
+    };
+
+    std::vector<Slot> slots(units.size());
+
+    // what the calling thread has handed out, what the workers have claimed and what they have finished.
+    // Handing out is serial because writing the bitcode reads the shared context, so a worker may start on
+    // the first unit while the rest are still being written
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t ready = 0;
+    size_t claimed = 0;
+    size_t finished = 0;
+
+    const auto work = [&](llvm::TargetMachine &machine) {
+        for (;;) {
+            size_t i = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return claimed < ready || claimed == units.size(); });
+
+                if (claimed == units.size()) {
+                    return;
+                }
+
+                i = claimed++;
+            }
+
+            Slot &slot = slots[i];
+            UnitEmission &unit = units[i];
+            const std::string &unit_name = unit.cmp_unit->ast_module->name;
+
+            // a context per unit rather than per worker: it is freed with the unit, and what one unit
+            // interned cannot make another's object depend on which worker it followed
+            llvm::LLVMContext context;
+
+            llvm::Expected<std::unique_ptr<llvm::Module>> module = llvm::parseBitcodeFile(
+                llvm::MemoryBufferRef(llvm::StringRef(slot.bitcode.data(), slot.bitcode.size()), unit_name),
+                context);
+
+            if (!module) {
+                llvm::errs() << "Could not move unit '" << unit_name << "' to an emission thread: "
+                             << llvm::toString(module.takeError()) << '\n';
+            }
+            else {
+                if (!slot.optimized) {
+                    run_unit_pipeline(**module, machine);
+                }
+
+                slot.kept = split_off_shared_definitions(
+                    **module, unit_name, unit.object, unit.instance_dir, machine);
+
+                slot.emitted = write_unit_object(**module, unit.object, machine);
+            }
+
+            slot.bitcode.clear();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished++;
+            }
+
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+
+    for (size_t i = 0; i < workers; i++) {
+        pool.emplace_back(work, std::ref(*machines[i]));
+    }
+
+    for (size_t i = 0; i < units.size(); i++) {
+        UnitEmission &unit = units[i];
+        std::error_code ec;
+
+        // what keep_shared_definitions clears before it decides anything, cleared here for the worker
+        std::filesystem::remove(Compiler::instance_record_path(unit.object), ec);
+
+        // **the use-list order is what makes the copy the module.** Without it the reader rebuilds each
+        // value's users in whatever order it meets them, and passes that walk users - instcombine's
+        // worklist, GVN - can settle on a different but equally valid answer. With it the worker optimizes
+        // exactly what the serial path would have
+        llvm::raw_svector_ostream stream(slots[i].bitcode);
+        llvm::WriteBitcodeToFile(*unit.cmp_unit->llvm_module, stream, /*ShouldPreserveUseListOrder=*/true);
+
+        slots[i].optimized = unit.cmp_unit->optimized;
+        unit.cmp_unit->optimized = true;
+        unit.cmp_unit->llvm_module.reset();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready++;
+        }
+
+        changed.notify_all();
+    }
+
+    // the progress row is this thread's alone, so it advances as the workers report in rather than from them
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        size_t reported = 0;
+
+        while (reported < units.size()) {
+            changed.wait(lock, [&] { return finished > reported; });
+            reported = finished;
+
+            lock.unlock();
+            Compiler::ProgressReporter::instance().tick(fmt::format("{}/{} units", reported, units.size()));
+            lock.lock();
+        }
+    }
+
+    for (std::thread &worker : pool) {
+        worker.join();
+    }
+
+    bool emitted = true;
+
+    for (size_t i = 0; i < units.size(); i++) {
+        record_kept(slots[i].kept);
+        units[i].instance = slots[i].kept.instance;
+        emitted = emitted && slots[i].emitted;
+    }
+
+    Compiler::PhaseTimings::instance().count("emit threads", workers);
+
+    return emitted;
+}
+
 bool Backend::link_executable(
     const std::string &executable_name,
     const std::vector<std::filesystem::path> &objects,
@@ -386,12 +973,46 @@ bool Backend::link_executable(
         return false;
     }
 
-    // **rendered once, for both spellings below.** An `object:` becomes another object file and everything
+    // **rendered once, for every spelling below.** An `object:` becomes another object file and everything
     // else becomes words after them, and which is which is not a decision either call site repeats
     std::vector<std::filesystem::path> link_objects;
     std::vector<std::string> link_words;
     Compiler::partition_link_requirements(link, link_objects, link_words);
 
+    // **in-process first**, where there is one - see Compiler::link_in_process. The words go where the
+    // driver would have put them, in the order the fallback below spells them
+    std::vector<std::string> inputs;
+
+    for (const std::filesystem::path &object : objects) {
+        inputs.push_back(object.string());
+    }
+
+    for (const std::filesystem::path &object : link_objects) {
+        inputs.push_back(object.string());
+    }
+
+    inputs.insert(inputs.end(), link_words.begin(), link_words.end());
+
+    bool retrying = false;
+
+    switch (Compiler::link_in_process({}, executable_name, inputs)) {
+    case Compiler::InProcessLink::t_linked:
+        gen_debug_symbols(executable_name);
+        return true;
+
+    // the program's own doing, said once already - the driver would only say it again
+    case Compiler::InProcessLink::t_refused:
+        return false;
+
+    case Compiler::InProcessLink::t_failed:
+        llvm::errs() << "Note: the in-process linker failed, retrying through the clang driver\n";
+        retrying = true;
+        break;
+
+    case Compiler::InProcessLink::t_unavailable:
+        break;
+    }
+
     if (const auto command = host_linker_command(executable_name, objects, link_objects, link_words)) {
         if (Compiler::run_tool(command.value())) {
             gen_debug_symbols(executable_name);
@@ -415,11 +1036,260 @@ bool Backend::link_executable(
         return false;
     }
 
+    // the driver linked what the kept line could not, so the line was at fault and the next link asks again
+    if (retrying) {
+        Compiler::forget_link_plan({});
+    }
+
     gen_debug_symbols(executable_name);
 
     return true;
 }
 
+// the symbols `objects` reference without defining, which a thin link must leave visible. False when one of
+// them could not be read, and then nothing it names can be known
+static bool symbols_referenced_by(const std::vector<std::filesystem::path> &objects, std::set<std::string> &out)
+{
+    for (const std::filesystem::path &object : objects) {
+        llvm::Expected<llvm::object::OwningBinary<llvm::object::ObjectFile>> loaded =
+            llvm::object::ObjectFile::createObjectFile(object.string());
+
+        if (!loaded) {
+            llvm::consumeError(loaded.takeError());
+            return false;
+        }
+
+        for (const llvm::object::SymbolRef &symbol : loaded->getBinary()->symbols()) {
+            llvm::Expected<uint32_t> flags = symbol.getFlags();
+            llvm::Expected<llvm::StringRef> name = symbol.getName();
+
+            if (!flags || !name) {
+                llvm::consumeError(flags.takeError());
+                llvm::consumeError(name.takeError());
+                return false;
+            }
+
+            if ((*flags & llvm::object::SymbolRef::SF_Undefined) != 0) {
+                out.insert(name->str());
+            }
+        }
+    }
+
+    return true;
+}
+
+// how many entries the link cache holds, before and after, is how a thin link learns how many of its backends
+// the cache served: the cache reports a hit by not asking for a stream, and there is nothing to count that by
+static size_t thin_cache_entries(const std::filesystem::path &cache_dir)
+{
+    size_t entries = 0;
+    std::error_code ec;
+
+    for (const auto &entry : std::filesystem::directory_iterator(cache_dir, ec)) {
+        if (entry.path().filename().string().rfind("llvmcache-", 0) == 0) {
+            entries++;
+        }
+    }
+
+    return entries;
+}
+
+bool Backend::thin_link(
+    const std::vector<std::filesystem::path> &summaries,
+    const std::vector<Compiler::LinkRequirement> &link,
+    const std::filesystem::path &cache_dir,
+    const std::filesystem::path &output_dir,
+    unsigned jobs,
+    std::vector<std::filesystem::path> &out_objects
+)
+{
+    _thin_link_report.clear();
+
+    if (!_target_machine) {
+        llvm::errs() << "No target resolved - init_target must run before thin_link\n";
+        return false;
+    }
+
+    if (summaries.empty()) {
+        llvm::errs() << "Error: nothing to link\n";
+        return false;
+    }
+
+    // the same rendering link_executable makes of the same requirements, so the objects read here are the
+    // ones the linker will be handed
+    std::vector<std::filesystem::path> link_objects;
+    std::vector<std::string> link_words;
+    Compiler::partition_link_requirements(link, link_objects, link_words);
+
+    std::set<std::string> referenced;
+    const bool every_symbol_visible = !symbols_referenced_by(link_objects, referenced);
+
+    // **the machine init_target built, described rather than shared**: the LTO backends build one per thread,
+    // and each has to select instructions for the subtarget the pre-link pipeline already optimized for
+    const Compiler::Subtarget sub = subtarget();
+
+    llvm::lto::Config config;
+    config.CPU = sub.cpu;
+    config.MAttrs = split_target_features(sub.features);
+    config.Options = _target_machine->Options;
+    config.RelocModel = llvm::Reloc::PIC_;
+    config.DefaultTriple = _ctx.target_triple;
+    config.OptLevel = 3;
+    config.CGOptLevel = llvm::CodeGenOptLevel::Aggressive;
+
+    llvm::lto::LTO lto(
+        std::move(config), llvm::lto::createInProcessThinBackend(llvm::heavyweight_hardware_concurrency(jobs)));
+
+    // read lazily by the link, so they are kept until it has run
+    std::vector<std::unique_ptr<llvm::MemoryBuffer>> buffers;
+
+    // **the first definition of a name is the one that prevails**, which is what the linker would have kept:
+    // a `linkonce_odr` body arrives in every unit that references it, and all of its copies are the same
+    std::set<std::string> defined;
+
+    for (const std::filesystem::path &summary : summaries) {
+        llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer = llvm::MemoryBuffer::getFile(summary.string());
+
+        if (!buffer) {
+            llvm::errs() << "Could not read '" << summary.string() << "': " << buffer.getError().message() << '\n';
+            return false;
+        }
+
+        llvm::Expected<std::unique_ptr<llvm::lto::InputFile>> input =
+            llvm::lto::InputFile::create((*buffer)->getMemBufferRef());
+
+        if (!input) {
+            llvm::errs() << "Could not read '" << summary.string() << "': "
+                         << llvm::toString(input.takeError()) << '\n';
+            return false;
+        }
+
+        const auto symbols = (*input)->symbols();
+        std::vector<llvm::lto::SymbolResolution> resolutions(symbols.size());
+
+        for (size_t i = 0; i < symbols.size(); i++) {
+            const llvm::lto::InputFile::Symbol &symbol = symbols[i];
+
+            if (symbol.isUndefined()) {
+                continue;
+            }
+
+            const std::string name = symbol.getName().str();
+
+            resolutions[i].Prevailing = defined.insert(name).second;
+            resolutions[i].FinalDefinitionInLinkageUnit = true;
+            resolutions[i].VisibleToRegularObj = every_symbol_visible
+                || symbol.isUsed()
+                || symbol.getIRName() == ECO_ENTRY_SYMBOL_NAME
+                || referenced.count(name) > 0;
+        }
+
+        buffers.push_back(std::move(*buffer));
+
+        if (llvm::Error error = lto.add(std::move(*input), resolutions)) {
+            llvm::errs() << "Could not add '" << summary.string() << "' to the thin link: "
+                         << llvm::toString(std::move(error)) << '\n';
+            return false;
+        }
+    }
+
+    // one object per task, by task: the backends finish in whatever order their threads do, and the link
+    // command has to come out the same every time
+    const unsigned tasks = lto.getMaxTasks();
+    std::vector<std::filesystem::path> written(tasks);
+    std::atomic<bool> lost{ false };
+
+    const auto object_for = [&output_dir](unsigned task) {
+        return output_dir / fmt::format("thin-{}.o", task);
+    };
+
+    llvm::AddStreamFn add_stream = [&](unsigned task, const llvm::Twine &)
+        -> llvm::Expected<std::unique_ptr<llvm::CachedFileStream>> {
+        std::error_code ec;
+        auto stream = std::make_unique<llvm::raw_fd_ostream>(object_for(task).string(), ec, llvm::sys::fs::OF_None);
+
+        if (ec) {
+            return llvm::errorCodeToError(ec);
+        }
+
+        written[task] = object_for(task);
+        return std::make_unique<llvm::CachedFileStream>(std::move(stream));
+    };
+
+    // **a cache that cannot be opened is a link without one**, never a failed build - the module store's rule.
+    // Served or freshly generated, a cached object arrives here, and is written out beside the others
+    llvm::FileCache cache;
+    bool cached = false;
+    size_t entries_before = 0;
+
+    if (!cache_dir.empty()) {
+        llvm::Expected<llvm::FileCache> local = llvm::localCache(
+            "ThinLTO", "thin", cache_dir.string(),
+            [&](unsigned task, const llvm::Twine &, std::unique_ptr<llvm::MemoryBuffer> object) {
+                std::error_code ec;
+                llvm::raw_fd_ostream out(object_for(task).string(), ec, llvm::sys::fs::OF_None);
+
+                if (ec) {
+                    lost = true;
+                    return;
+                }
+
+                out << object->getBuffer();
+                written[task] = object_for(task);
+            });
+
+        if (local) {
+            cache = std::move(*local);
+            cached = true;
+            entries_before = thin_cache_entries(cache_dir);
+        }
+        else {
+            llvm::consumeError(local.takeError());
+        }
+    }
+
+    if (llvm::Error error = lto.run(add_stream, cache)) {
+        llvm::errs() << "The thin link failed: " << llvm::toString(std::move(error)) << '\n';
+        return false;
+    }
+
+    if (lost) {
+        llvm::errs() << "Could not write an object the thin link produced into '" << output_dir.string() << "'\n";
+        return false;
+    }
+
+    for (const std::filesystem::path &object : written) {
+        if (!object.empty()) {
+            out_objects.push_back(object);
+        }
+    }
+
+    _thin_link_report = "[thin link]\n";
+
+    if (cached) {
+        // **clamped, never subtracted blind**: the directory can shrink during the link - a concurrent
+        // build's prune, or LLVM's own - and an unsigned difference would wrap to a count nobody generated
+        const size_t entries_after = thin_cache_entries(cache_dir);
+        const size_t grown = entries_after > entries_before ? entries_after - entries_before : 0;
+        const size_t generated = std::min(grown, summaries.size());
+
+        _thin_link_report += fmt::format(
+            "  units  {}  generated  {}  cached  {}\n", summaries.size(), generated, summaries.size() - generated);
+
+        // after the count, and on LLVM's own schedule and limits rather than ours: what it keeps is keyed on
+        // import sets nobody else can name, so nothing but its own policy could say what is stale
+        llvm::CachePruningPolicy policy;
+        policy.Interval = std::chrono::hours(1);
+        llvm::pruneCache(cache_dir.string(), policy);
+    }
+    else {
+        _thin_link_report += fmt::format(
+            "  units  {}  generated  {}  (no link cache: nowhere to keep one)\n", summaries.size(), summaries.size());
+    }
+
+    return true;
+}
+
 void Backend::gen_debug_symbols(const std::string &executable_name)
 {
 #if defined(__APPLE__)
@@ -568,17 +1438,69 @@ void Backend::prepare_unit_for_emission(Compiler::LLVM::CmpUnit &cmp_unit)
     // dependencies' keys - which is what Compiler::compute_module_keys promises and tests/module_cache.cpp
     // pins byte for byte. Whole-program `-O` is still merge-then-O3 and still bypasses the cache; the two
     // are no longer all or nothing, which is the actual change here
+    //
+    // **`--optimize thin` swaps the pipeline and nothing else.** Its unit gets the ThinLTO pre-link pipeline at
+    // O3 - the per-module half of what the thin link finishes, which deliberately leaves the inlining across
+    // modules to the link where the other bodies are visible. Still per unit, so still the same function of
+    // the unit's IR the cache relies on, and the discard still goes first
+    run_unit_pipeline(*cmp_unit.llvm_module, *_target_machine);
+}
+
+void Backend::run_unit_pipeline(llvm::Module &module, llvm::TargetMachine &machine) const
+{
     const bool optimize = !_ctx.options.no_optimize;
+    const bool thin = _ctx.options.thin_lto;
 
-    run_module_passes(*cmp_unit.llvm_module, _target_machine.get(), [optimize](llvm::PassBuilder &passBuilder, llvm::ModulePassManager &modulePM) {
+    run_module_passes(module, &machine, [optimize, thin](llvm::PassBuilder &passBuilder, llvm::ModulePassManager &modulePM) {
         modulePM.addPass(llvm::GlobalDCEPass());
 
-        if (optimize) {
+        if (thin) {
+            modulePM.addPass(passBuilder.buildThinLTOPreLinkDefaultPipeline(llvm::OptimizationLevel::O3));
+        }
+        else if (optimize) {
             modulePM.addPass(passBuilder.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O2));
         }
     });
 }
 
+// **the two tiers' pipelines**, here beside the unit pipeline rather than in TieredExecution, so every pipeline
+// this compiler runs is spelled in one file.
+//
+// the baseline is the floor the `run` path never had: SROA is mem2reg and more, which is most of what
+// StmtCodegen's entry allocas have been waiting for, and EarlyCSE and SimplifyCFG are the cleanup that costs
+// next to nothing. Function passes only and no machine - none of the three consults a cost model, and this
+// runs on whichever compile thread the JIT picked, where the backend's own machine is not safe to touch.
+// The hot pipeline is `--optimize whole`'s O3, through a machine of the worker's own, so the vectorizer
+// sees this target's registers
+void Backend::start_tiering()
+{
+    _tiering = std::make_unique<TieredExecution>(
+        *_jit,
+        create_target_machine(),
+        [](llvm::Module &module) {
+            run_module_passes(module, nullptr, [](llvm::PassBuilder &, llvm::ModulePassManager &modulePM) {
+                llvm::FunctionPassManager functionPM;
+                functionPM.addPass(llvm::SROAPass(llvm::SROAOptions::ModifyCFG));
+                functionPM.addPass(llvm::EarlyCSEPass());
+                functionPM.addPass(llvm::SimplifyCFGPass());
+
+                modulePM.addPass(llvm::createModuleToFunctionPassAdaptor(std::move(functionPM)));
+            });
+        },
+        [](llvm::Module &module, llvm::TargetMachine &machine) {
+            run_module_passes(module, &machine, [](llvm::PassBuilder &passBuilder, llvm::ModulePassManager &modulePM) {
+                modulePM = passBuilder.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O3);
+            });
+        });
+
+    TieredExecution *tiering = _tiering.get();
+
+    _jit->getIRTransformLayer().setTransform(
+        [tiering](llvm::orc::ThreadSafeModule module, llvm::orc::MaterializationResponsibility &responsibility) {
+            return tiering->transform(std::move(module), responsibility);
+        });
+}
+
 // the module's own function definitions, by symbol name.
 //
 // declarations are deliberately not among them: InternalizePass leaves them alone, so they were never
@@ -0,0 +1,537 @@
+#include "Compiler/LLVM/Codegen/TieredExecution.h"
+
+#include "eco.h"
+
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/ExecutionEngine/Orc/Core.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Dominators.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/MDBuilder.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Transforms/Utils/BasicBlockUtils.h>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+namespace
+{
+
+// the dylib the hot bodies are added to, by name, which is how the transform tells them from the baseline
+// ones without reading a pointer the worker writes
+constexpr const char *hot_dylib_name = "<tier 1>";
+
+// the instance a program leaving through libc's `exit` has to stop before LLVM's statics go - see finish
+std::atomic<Compiler::LLVM::TieredExecution *> live_tiering{ nullptr };
+
+void finish_at_exit()
+{
+    if (Compiler::LLVM::TieredExecution *tiering = live_tiering.load()) {
+        tiering->finish(/*drain=*/false);
+    }
+}
+
+// what may stand behind a tier stub. The entry point runs once, so a counter in it can only ever report a
+// body too late to matter; a variadic one cannot be forwarded by a tail call; a naked one has no frame to
+// forward from; and a comdat member takes its symbol with its group, which a rename would break
+bool tierable(const llvm::Function &function)
+{
+    return !function.isDeclaration()
+        && !function.hasAvailableExternallyLinkage()
+        && !function.isIntrinsic()
+        && !function.isVarArg()
+        && !function.hasComdat()
+        && !function.hasFnAttribute(llvm::Attribute::Naked)
+        && function.getName() != ECO_ENTRY_SYMBOL_NAME;
+}
+
+// the body a stub jumps to, by the stub's name
+std::string body_name(llvm::StringRef symbol)
+{
+    return (symbol + "$tier0").str();
+}
+
+}
+
+namespace Compiler::LLVM
+{
+TieredExecution::TieredExecution(
+    llvm::orc::LLJIT &jit,
+    std::unique_ptr<llvm::TargetMachine> machine,
+    std::function<void(llvm::Module &)> baseline,
+    std::function<void(llvm::Module &, llvm::TargetMachine &)> hot
+)
+    : _jit(jit), _machine(std::move(machine)), _baseline(std::move(baseline)), _hot(std::move(hot))
+{
+    // registered once, and after LLVM's own statics were constructed - so it runs before they are destroyed
+    static const bool registered = (std::atexit(&finish_at_exit), true);
+    (void)registered;
+
+    live_tiering.store(this);
+
+    _worker = std::thread([this] { work(); });
+}
+
+TieredExecution::~TieredExecution()
+{
+    finish(/*drain=*/false);
+
+    TieredExecution *self = this;
+    live_tiering.compare_exchange_strong(self, nullptr);
+}
+
+void TieredExecution::prepare_module(llvm::Module &module)
+{
+    llvm::LLVMContext &context = module.getContext();
+    const llvm::DataLayout &layout = module.getDataLayout();
+
+    const size_t index = _pristine.size();
+    const std::string suffix = fmt::format(".m{}", index);
+
+    // **every module-local global made reachable by name**, with the module's index on it so two modules'
+    // `.str` do not become one symbol. The prune internalizes everything but the roots, so on a program of
+    // one module this is nearly every function as well - which is why the report names a function by what
+    // codegen called it rather than by this
+    for (llvm::GlobalValue &global : module.global_values()) {
+        if (!global.hasLocalLinkage()) {
+            continue;
+        }
+
+        global.setName((global.hasName() ? global.getName().str() : std::string("__eco_local")) + suffix);
+        global.setLinkage(llvm::GlobalValue::ExternalLinkage);
+    }
+
+    std::vector<llvm::Function *> bodies;
+
+    for (llvm::Function &function : module.functions()) {
+        if (tierable(function)) {
+            bodies.push_back(&function);
+        }
+    }
+
+    llvm::PointerType *pointer = llvm::PointerType::getUnqual(context);
+    llvm::IntegerType *count = llvm::Type::getInt32Ty(context);
+
+    for (llvm::Function *body : bodies) {
+        const std::string symbol = body->getName().str();
+        const llvm::GlobalValue::LinkageTypes linkage = body->getLinkage();
+
+        body->setName(body_name(symbol));
+
+        llvm::Function *stub = llvm::Function::Create(body->getFunctionType(), linkage, symbol, module);
+        stub->copyAttributesFrom(body);
+
+        // before the slot exists, so its initializer is the one use of the body left
+        body->replaceAllUsesWith(stub);
+
+        // the slot and the counter take the body's linkage, so a `linkonce_odr` body two modules both hold
+        // leaves one of each in the JIT rather than a duplicate definition
+        auto *slot = new llvm::GlobalVariable(module, pointer, /*isConstant=*/false, linkage, body, symbol + "$tier");
+        slot->setAlignment(layout.getPointerABIAlignment(0));
+
+        auto *counter = new llvm::GlobalVariable(
+            module, count, /*isConstant=*/false, linkage, llvm::ConstantInt::get(count, 0), symbol + "$calls");
+        counter->setAlignment(llvm::Align(4));
+
+        // **the stub: load the slot, jump.** A musttail call forwards every argument in place, `sret` and
+        // `byval` ones included, and leaves no frame of its own behind - which is what lets a stub stand
+        // in front of every call the program makes and cost it one load and one indirect jump
+        llvm::IRBuilder<> builder(llvm::BasicBlock::Create(context, "entry", stub));
+
+        llvm::LoadInst *target = builder.CreateAlignedLoad(pointer, slot, layout.getPointerABIAlignment(0));
+        target->setAtomic(llvm::AtomicOrdering::Monotonic);
+
+        std::vector<llvm::Value *> arguments;
+
+        for (llvm::Argument &argument : stub->args()) {
+            arguments.push_back(&argument);
+        }
+
+        llvm::CallInst *call = builder.CreateCall(body->getFunctionType(), target, arguments);
+        call->setCallingConv(body->getCallingConv());
+        call->setAttributes(body->getAttributes());
+        call->setTailCallKind(llvm::CallInst::TCK_MustTail);
+
+        if (call->getType()->isVoidTy()) {
+            builder.CreateRetVoid();
+        }
+        else {
+            builder.CreateRet(call);
+        }
+
+        const std::string name = llvm::StringRef(symbol).ends_with(suffix)
+            ? symbol.substr(0, symbol.size() - suffix.size())
+            : symbol;
+
+        // the first module to hold a shared body speaks for it: the JIT keeps one stub and one counter by
+        // name, and any module's copy of an ODR body is the body
+        if (_ids.try_emplace(body->getName(), static_cast<uint32_t>(_tiered.size())).second) {
+            _tiered.push_back({ index, symbol, name });
+        }
+    }
+
+    // after the split and before any counter, which is exactly the module a hot body is rebuilt from
+    Pristine pristine;
+    pristine.identifier = module.getModuleIdentifier();
+
+    llvm::raw_string_ostream stream(pristine.bitcode);
+    llvm::WriteBitcodeToFile(module, stream);
+    stream.flush();
+
+    _pristine.push_back(std::move(pristine));
+    _requested.resize(_tiered.size(), false);
+}
+
+llvm::Expected<llvm::orc::ThreadSafeModule> TieredExecution::transform(
+    llvm::orc::ThreadSafeModule module, llvm::orc::MaterializationResponsibility &responsibility)
+{
+    if (responsibility.getTargetJITDylib().getName() == hot_dylib_name) {
+        return std::move(module);
+    }
+
+    module.withModuleDo([this](llvm::Module &partition) {
+        _baseline(partition);
+
+        for (llvm::Function &function : partition.functions()) {
+            if (function.isDeclaration()) {
+                continue;
+            }
+
+            const auto found = _ids.find(function.getName());
+
+            if (found != _ids.end()) {
+                instrument(function, found->second);
+            }
+        }
+    });
+
+    return std::move(module);
+}
+
+void TieredExecution::instrument(llvm::Function &body, uint32_t id) const
+{
+    llvm::Module &module = *body.getParent();
+    llvm::LLVMContext &context = module.getContext();
+
+    llvm::IntegerType *count = llvm::Type::getInt32Ty(context);
+    llvm::PointerType *pointer = llvm::PointerType::getUnqual(context);
+    llvm::IntegerType *address = module.getDataLayout().getIntPtrType(context);
+
+    // a declaration in the partition - the definition went with the module's globals - and possibly not even
+    // that, since nothing in the body named it until now
+    llvm::Constant *counter = module.getOrInsertGlobal(_tiered[id].symbol + "$calls", count);
+
+    // **the callback by address rather than by symbol**: this process is the one the code runs in, and an
+    // address baked into the IR needs no mangling and no definition in the JIT for it to resolve against
+    llvm::FunctionType *callback_type =
+        llvm::FunctionType::get(llvm::Type::getVoidTy(context), { pointer, count }, false);
+
+    llvm::Constant *callback = llvm::ConstantExpr::getIntToPtr(
+        llvm::ConstantInt::get(address, reinterpret_cast<uintptr_t>(&TieredExecution::request)), pointer);
+
+    llvm::Constant *self = llvm::ConstantExpr::getIntToPtr(
+        llvm::ConstantInt::get(address, reinterpret_cast<uintptr_t>(this)), pointer);
+
+    llvm::MDNode *unlikely = llvm::MDBuilder(context).createBranchWeights(1, threshold);
+
+    // a load and a store rather than an atomic add: a count lost to a race only makes a function hot a
+    // little later, and a `lock xadd` at every loop header would be the baseline paying for the tiering.
+    // Monotonic rather than plain so the race is defined; on the targets the JIT runs on it is a plain move
+    const auto count_before = [&](llvm::Instruction *before) {
+        llvm::IRBuilder<> builder(before);
+
+        llvm::LoadInst *seen = builder.CreateAlignedLoad(count, counter, llvm::Align(4));
+        seen->setAtomic(llvm::AtomicOrdering::Monotonic);
+
+        llvm::Value *now = builder.CreateAdd(seen, builder.getInt32(1));
+
+        llvm::StoreInst *stored = builder.CreateAlignedStore(now, counter, llvm::Align(4));
+        stored->setAtomic(llvm::AtomicOrdering::Monotonic);
+
+        llvm::Value *hot = builder.CreateICmpEQ(now, builder.getInt32(threshold));
+
+        builder.SetInsertPoint(llvm::SplitBlockAndInsertIfThen(hot, before, /*Unreachable=*/false, unlikely));
+
+        llvm::CallInst *call = builder.CreateCall(callback_type, callback, { self, builder.getInt32(id) });
+        call->addFnAttr(llvm::Attribute::Cold);
+    };
+
+    // **the loop headers, found before anything is split**: a block that dominates one of its own
+    // predecessors is where a back edge lands. An irreducible loop has no such block and goes uncounted,
+    // which costs it nothing but the chance to be hot through its iterations rather than its calls
+    std::vector<llvm::BasicBlock *> headers;
+    {
+        llvm::DominatorTree tree(body);
+
+        for (llvm::BasicBlock &block : body) {
+            for (llvm::BasicBlock *predecessor : llvm::predecessors(&block)) {
+                if (tree.dominates(&block, predecessor)) {
+                    headers.push_back(&block);
+                    break;
+                }
+            }
+        }
+    }
+
+    // before each terminator, which leaves the entry block's allocas where the baseline pipeline's mem2reg
+    // has already been looking for them. A block that is nothing but an exception pad cannot be split
+    count_before(body.getEntryBlock().getTerminator());
+
+    for (llvm::BasicBlock *header : headers) {
+        llvm::Instruction *terminator = header->getTerminator();
+
+        if (!terminator->isEHPad()) {
+            count_before(terminator);
+        }
+    }
+}
+
+void TieredExecution::request(TieredExecution *self, uint32_t id)
+{
+    std::lock_guard<std::mutex> guard(self->_lock);
+
+    if (self->_closing || self->_requested[id]) {
+        return;
+    }
+
+    self->_requested[id] = true;
+    self->_queue.push_back(id);
+    self->_wake.notify_one();
+}
+
+void TieredExecution::work()
+{
+    std::unique_lock<std::mutex> guard(_lock);
+
+    for (;;) {
+        _wake.wait(guard, [this] { return _closing || !_queue.empty(); });
+
+        if (_queue.empty()) {
+            return;
+        }
+
+        const uint32_t id = _queue.front();
+        _queue.pop_front();
+
+        guard.unlock();
+        llvm::Error error = reoptimize(id);
+        guard.lock();
+
+        // a hot body that could not be built is a function that stays on its baseline, which is still a
+        // correct program - so it is reported rather than allowed to end the run
+        if (error) {
+            _failed.push_back(fmt::format("{}: {}", _tiered[id].name, llvm::toString(std::move(error))));
+        }
+        else {
+            _reoptimized.push_back(_tiered[id].name);
+        }
+    }
+}
+
+llvm::Error TieredExecution::reoptimize(uint32_t id)
+{
+    const Tiered &tiered = _tiered[id];
+    const Pristine &pristine = _pristine[tiered.module];
+
+    auto context = std::make_unique<llvm::LLVMContext>();
+
+    llvm::Expected<std::unique_ptr<llvm::Module>> parsed = llvm::parseBitcodeFile(
+        llvm::MemoryBufferRef(pristine.bitcode, pristine.identifier), *context);
+
+    if (!parsed) {
+        return parsed.takeError();
+    }
+
+    std::unique_ptr<llvm::Module> module = std::move(parsed.get());
+
+    llvm::Function *hot = module->getFunction(body_name(tiered.symbol));
+
+    if (hot == nullptr) {
+        return llvm::createStringError(llvm::inconvertibleErrorCode(), "its body is not in the module it came from");
+    }
+
+    // **every other body visible to the inliner and emitted nowhere**, and every stub a declaration: what the
+    // hot body calls and does not inline is reached through the stub as before, so it still follows its own
+    // tier. A direct call to a stub is pointed at the body behind it first - a stub is an indirect jump the
+    // inliner cannot see through, and the bodies are what it is here for
+    for (llvm::Function &function : module->functions()) {
+        if (&function == hot || function.isDeclaration()) {
+            continue;
+        }
+
+        function.setComdat(nullptr);
+
+        if (_ids.count(body_name(function.getName())) != 0) {
+            function.deleteBody();
+        }
+        else {
+            function.setLinkage(llvm::GlobalValue::AvailableExternallyLinkage);
+        }
+    }
+
+    for (llvm::Function &stub : module->functions()) {
+        llvm::Function *body = module->getFunction(body_name(stub.getName()));
+
+        if (body == nullptr || _ids.count(body->getName()) == 0) {
+            continue;
+        }
+
+        for (llvm::Use &use : llvm::make_early_inc_range(stub.uses())) {
+            auto *call = llvm::dyn_cast<llvm::CallBase>(use.getUser());
+
+            if (call != nullptr && call->isCallee(&use)) {
+                use.set(body);
+            }
+        }
+    }
+
+    // a constant is kept for the optimizer to fold, and nothing is defined here that the baseline already
+    // defines: a second `$calls` or a second static would be a second variable
+    for (llvm::GlobalVariable &global : module->globals()) {
+        if (global.isDeclaration() || global.getName().starts_with("llvm.")) {
+            continue;
+        }
+
+        global.setComdat(nullptr);
+
+        if (global.isConstant()) {
+            global.setLinkage(llvm::GlobalValue::AvailableExternallyLinkage);
+        }
+        else {
+            global.setInitializer(nullptr);
+            global.setLinkage(llvm::GlobalValue::ExternalLinkage);
+        }
+    }
+
+    hot->setName(tiered.symbol + "$tier1");
+    hot->setLinkage(llvm::GlobalValue::ExternalLinkage);
+
+    _hot(*module, *_machine);
+
+    // whatever the inliner left is a call again, and through the stub. The pipeline drops the bodies it did
+    // not take, and this is what says so for any it kept
+    for (llvm::Function &function : llvm::make_early_inc_range(module->functions())) {
+        if (function.hasAvailableExternallyLinkage()) {
+            function.deleteBody();
+        }
+
+        if (!function.isDeclaration() || _ids.count(function.getName()) == 0) {
+            continue;
+        }
+
+        const llvm::StringRef symbol = function.getName().drop_back(llvm::StringRef("$tier0").size());
+
+        llvm::FunctionCallee stub = module->getOrInsertFunction(symbol, function.getFunctionType());
+        function.replaceAllUsesWith(stub.getCallee());
+        function.eraseFromParent();
+    }
+
+    if (_hot_dylib == nullptr) {
+        llvm::Expected<llvm::orc::JITDylib &> created = _jit.createJITDylib(hot_dylib_name);
+
+        if (!created) {
+            return created.takeError();
+        }
+
+        // the main dylib first and then whatever it links against - the process, the platform - so a hot
+        // body resolves every name exactly as its baseline did. Every symbol rather than the exported ones:
+        // the promoted locals are the program's own, whichever dylib asks
+        llvm::orc::JITDylib &main = _jit.getMainJITDylib();
+        llvm::orc::JITDylibSearchOrder order = {
+            { &main, llvm::orc::JITDylibLookupFlags::MatchAllSymbols }
+        };
+
+        main.withLinkOrderDo([&](const llvm::orc::JITDylibSearchOrder &linked) {
+            for (const auto &entry : linked) {
+                if (entry.first != &main) {
+                    order.push_back(entry);
+                }
+            }
+        });
+
+        created->setLinkOrder(std::move(order));
+        _hot_dylib = &created.get();
+    }
+
+    if (llvm::Error error = _jit.addIRModule(
+            *_hot_dylib, llvm::orc::ThreadSafeModule(std::move(module), std::move(context)))) {
+        return error;
+    }
+
+    llvm::Expected<llvm::orc::ExecutorAddr> body = _jit.lookup(*_hot_dylib, tiered.symbol + "$tier1");
+
+    if (!body) {
+        return body.takeError();
+    }
+
+    llvm::Expected<llvm::orc::ExecutorAddr> slot = _jit.lookup(tiered.symbol + "$tier");
+
+    if (!slot) {
+        return slot.takeError();
+    }
+
+    // **the swap**, and the whole of it: the next call through the stub lands in the new body. A frame that
+    // is already in the old one finishes there - it is still compiled, and nothing ever frees it
+    std::atomic_ref<void *>(*slot->toPtr<void **>()).store(body->toPtr<void *>(), std::memory_order_release);
+
+    return llvm::Error::success();
+}
+
+void TieredExecution::finish(bool drain)
+{
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+
+        _closing = true;
+
+        if (!drain) {
+            _queue.clear();
+        }
+    }
+
+    _wake.notify_all();
+
+    if (_worker.joinable() && _worker.get_id() != std::this_thread::get_id()) {
+        _worker.join();
+    }
+}
+
+std::string TieredExecution::report()
+{
+    finish(/*drain=*/true);
+
+    std::lock_guard<std::mutex> guard(_lock);
+
+    // sorted for prune_report's reason: the order the worker got to them is the order counters crossed the
+    // threshold, which a second thread in the program is free to change
+    std::vector<std::string> reoptimized = _reoptimized;
+    std::sort(reoptimized.begin(), reoptimized.end());
+
+    std::string report = fmt::format(
+        "[tiers]\n  {} function{} tiered, reoptimized after {} calls or loop iterations: {}\n",
+        _tiered.size(), _tiered.size() == 1 ? "" : "s", threshold, reoptimized.size());
+
+    for (const std::string &name : reoptimized) {
+        report += fmt::format("    {}\n", name);
+    }
+
+    for (const std::string &failure : _failed) {
+        report += fmt::format("  not reoptimized: {}\n", failure);
+    }
+
+    return report;
+}
+};
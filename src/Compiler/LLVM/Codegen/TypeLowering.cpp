@@ -32,6 +32,7 @@
 #include <fmt/core.h>
 
 #include <cassert>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -1022,8 +1023,17 @@ llvm::Constant *TypeLowering::get_or_create_vtable(
         [&]() -> llvm::Constant * {
             // which declaration answers each requirement, in slot order. asked of the one walk that
             // decides it, so the table and every dispatch site agree about which entry a method is
-            const std::vector<AST::FunctionDeclNode *> implementations =
-                AST::interface_implementations(implementor, interface, _ctx.type_registry());
+            //
+            // **under a lock, because the registry is the bundle's and not this compiler's.** Every lane
+            // LLVMCompiler::lower_in_lanes runs reaches the same one, and a lookup that misses interns -
+            // which compile_bundle argues never happens, and which this makes harmless if it ever does
+            std::vector<AST::FunctionDeclNode *> implementations;
+            {
+                static std::mutex registry_mutex;
+                std::lock_guard<std::mutex> lock(registry_mutex);
+
+                implementations = AST::interface_implementations(implementor, interface, _ctx.type_registry());
+            }
 
             if (implementations.empty()) {
                 return nullptr;
@@ -19,8 +19,12 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <optional>
 #include <set>
+#include <thread>
 
 LLVMCompiler::LLVMCompiler(Compiler::CompilerOptions options)
     : _types(_ctx), _lvalues(_ctx), _expr(_ctx), _stmt(_ctx), _struct(_ctx), _classes(_ctx),
@@ -115,8 +119,16 @@ void LLVMCompiler::emit_entry_file_roots(Compiler::LLVM::CmpUnit &main_cmp_unit)
     }
 }
 
-void LLVMCompiler::compile_bundle(const AST::Bundle &bundle, const std::set<std::string> &cached_modules)
+void LLVMCompiler::compile_bundle(
+    const AST::Bundle &bundle,
+    const std::set<std::string> &cached_modules,
+    unsigned jobs)
 {
+    // everything below is the serial path, and it is also exactly what each lane runs for its one unit
+    if (jobs > 1 && lower_in_lanes(bundle, cached_modules, jobs)) {
+        return;
+    }
+
     _ctx.llvm_context = std::make_unique<llvm::LLVMContext>();
 
     // beside the context and not per unit: the leaves have to be the *same* MDNode across units, or
@@ -224,13 +236,52 @@ void LLVMCompiler::compile_bundle(const AST::Bundle &bundle, const std::set<std:
     }
     }
 
-    // search for the main module
+    // search for the main module. **a lane may have none** - it lowers one unit of somebody else's
+    // program, and the entry point is the lane holding the entry module's to build
     Compiler::LLVM::CmpUnit *main_cmp_unit = _ctx.main_cmp_unit();
-    if (!main_cmp_unit) {
+    if (!main_cmp_unit && !_lane) {
         throw Compiler::InternalCompilerException(fmt::format(
             "no entry module '{}' in the bundle", _ctx.entry_module_name), nullptr);
     }
 
+    if (main_cmp_unit) {
+        emit_entry_point(*main_cmp_unit);
+    }
+
+    {
+        // the bodies no module owns, into each unit that named one. After `main`'s epilogue, because the
+        // file roots above are what discover most of them, and before the verifier, because until this
+        // runs those units hold `declare`s nothing defines
+        Compiler::ScopedPhase phase("drain");
+        drain_pending_definitions();
+    }
+
+    // **after the drain and before the ODR check.** The drain is the last thing that can add a body to
+    // any unit, and verify_odr_consistency compares final metadata - everything downstream of here (the
+    // merge, both pipelines, the object writer) is then strictly later, which is why there is one moment
+    // rather than an ordering rule per consumer. A builder left unfinalized leaves temporary MDNodes
+    // behind and the verifier rejects the module with a message that does not name the cause
+    _debug_info.finalize_all();
+
+    {
+        // before the merge, because afterwards there is only one copy left to look at
+        Compiler::ScopedPhase phase("odr check");
+        verify_odr_consistency();
+    }
+
+    // verify the main module before linking
+    std::string error_str;
+    llvm::raw_string_ostream error_stream(error_str);
+    if (main_cmp_unit && llvm::verifyModule(*main_cmp_unit->llvm_module, &error_stream)) {
+        throw Compiler::InternalCompilerException(fmt::format(
+            "LLVM IR verification failed for main module:\n{}", error_str
+        ));
+    }
+
+}
+
+void LLVMCompiler::emit_entry_point(Compiler::LLVM::CmpUnit &main_cmp_unit)
+{
     // `int main(int argc, char **argv, char **envp)` - the three-argument form, always, whether or not
     // this program reads any of them. It is POSIX on both platforms we target and a documented CRT
     // extension on Windows, and it is the *only* way the arguments and the environment reach Echo:
@@ -244,14 +295,14 @@ void LLVMCompiler::compile_bundle(const AST::Bundle &bundle, const std::set<std:
     llvm::Type *opaque_ptr = _ctx.opaque_ptr_type();
     llvm::FunctionType *funcType = llvm::FunctionType::get(
         _ctx.builder->getInt32Ty(), { _ctx.builder->getInt32Ty(), opaque_ptr, opaque_ptr }, false);
-    llvm::Function *function = llvm::Function::Create(funcType, llvm::Function::ExternalLinkage, ECO_ENTRY_SYMBOL_NAME, main_cmp_unit->llvm_module.get());
+    llvm::Function *function = llvm::Function::Create(funcType, llvm::Function::ExternalLinkage, ECO_ENTRY_SYMBOL_NAME, main_cmp_unit.llvm_module.get());
     function->getArg(0)->setName("argc");
     function->getArg(1)->setName("argv");
     function->getArg(2)->setName("envp");
     llvm::BasicBlock *entry = llvm::BasicBlock::Create(*_ctx.llvm_context, "entry", function);
     _ctx.set_insert_point(entry);
 
-    _ctx.current_cmp_unit = main_cmp_unit;
+    _ctx.current_cmp_unit = &main_cmp_unit;
 
     // the entry point is built here with a bare Function::Create rather than through gen_function_decl,
     // so it needs its own subprogram - and its own prologue location, because gen_capture below emits
@@ -265,75 +316,175 @@ void LLVMCompiler::compile_bundle(const AST::Bundle &bundle, const std::set<std:
     _process.gen_capture(function);
 
     {
-    Compiler::ScopedPhase entry_phase("entry point");
+        Compiler::ScopedPhase entry_phase("entry point");
 
-    emit_entry_file_roots(*main_cmp_unit);
+        emit_entry_file_roots(main_cmp_unit);
 
-    // terminate the function, unless the program already stopped itself
-    //
-    // the `[memory]` section goes inside this guard rather than before it, and the terminated case
-    // printing nothing is the point: a `die` at module scope already ran the abort runtime's exit(1),
-    // so there is no post-teardown moment left to report on. this *is* that moment on the other path -
-    // the file-root walk above emitted every module-scope release, which `-ar` shows as the last
-    // statements inside the root scope
-    if (!_ctx.block_is_terminated()) {
-        // the epilogue is the function's own, not the last file-root statement's - and gen_report emits
-        // `printf` calls, which must carry a location like every other call here
-        _debug_info.set_function_scope_location();
-
-        // **before the report, and that ordering is the whole reason teardown is not `atexit`.**
-        // `--track-allocations` is on for every corpus case, so a static torn down after gen_report
-        // would read as a live allocation - and an atexit handler runs after this by construction.
-        // it also runs after `~Backend` has deleted the JIT's engine, which is a call into unmapped
-        // memory rather than merely a wrong number
+        // terminate the function, unless the program already stopped itself
         //
-        // inside the terminated-block guard with everything else here, so `die`, a failed `assert`
-        // and `std::env::exit` skip it - the same thing module-scope releases already do
-        _statics.gen_teardown();
-
-        // **no report on a test run**, because the moment it describes has not happened: the report is what
-        // a program prints as it ends, and what ends here is a prologue that ran no statement of anybody's.
-        // A test that wants the number asks `mem::live_allocations()` inside itself
-        if (!_ctx.test_mode) {
-            _memory.gen_report();
+        // the `[memory]` section goes inside this guard rather than before it, and the terminated case
+        // printing nothing is the point: a `die` at module scope already ran the abort runtime's exit(1),
+        // so there is no post-teardown moment left to report on. this *is* that moment on the other path -
+        // the file-root walk above emitted every module-scope release, which `-ar` shows as the last
+        // statements inside the root scope
+        if (!_ctx.block_is_terminated()) {
+            // the epilogue is the function's own, not the last file-root statement's - and gen_report emits
+            // `printf` calls, which must carry a location like every other call here
+            _debug_info.set_function_scope_location();
+
+            // **before the report, and that ordering is the whole reason teardown is not `atexit`.**
+            // `--track-allocations` is on for every corpus case, so a static torn down after gen_report
+            // would read as a live allocation - and an atexit handler runs after this by construction.
+            // it also runs after `~Backend` has destroyed the JIT, which is a call into unmapped
+            // memory rather than merely a wrong number
+            //
+            // inside the terminated-block guard with everything else here, so `die`, a failed `assert`
+            // and `std::env::exit` skip it - the same thing module-scope releases already do
+            _statics.gen_teardown();
+
+            // **no report on a test run**, because the moment it describes has not happened: the report is what
+            // a program prints as it ends, and what ends here is a prologue that ran no statement of anybody's.
+            // A test that wants the number asks `mem::live_allocations()` inside itself
+            if (!_ctx.test_mode) {
+                _memory.gen_report();
+            }
+
+            _ctx.builder->CreateRet(_ctx.builder->getInt32(0));
+        }
+
+        _debug_info.end_function();
+    }
+}
+
+// **one lane per unit, each a whole compiler of its own**, `jobs` of them lowering at once.
+//
+// a lane is handed the bundle with every other unit marked as cached, which is the same request a build
+// that reused all of them makes - so it creates its one unit, declares what that unit references, emits
+// its bodies and drains what it owes, and nothing of it can tell it is not the only compile running.
+// That is also why the output does not depend on `jobs`: a unit's IR is a function of its own module
+// already, because the per-module cache could not serve it otherwise, and the only thing a shared context
+// added was a `.1` on a struct name two units both minted - which no object carries.
+//
+// **nothing codegen writes is shared between lanes.** Each has its own LLVMContext, builder, symbol tables
+// and ODR queues; what they do share is the bundle, read-only once its collections have been settled below,
+// and the type registry behind interface widening, which TypeLowering locks. A lane's timings are dropped -
+// see PhaseTimings - so `-t` reads this whole fan-out as the one row it is in.
+//
+// the adopted units keep their own contexts, which this compiler then owns beside its own - see
+// CodegenContext::lane_contexts. verify_odr_consistency runs here over all of them, after the lanes,
+// because it is the one question about the units that is not about any one of them.
+//
+// answers false, having done nothing, when there are not two units to lower - one lane is the serial path
+// with a thread in the way
+bool LLVMCompiler::lower_in_lanes(
+    const AST::Bundle &bundle,
+    const std::set<std::string> &cached_modules,
+    unsigned jobs)
+{
+    std::vector<const AST::Module *> lowered;
+
+    for (auto &module : bundle.modules) {
+        if (cached_modules.count(module->name) == 0) {
+            lowered.push_back(module.get());
         }
+    }
 
-        _ctx.builder->CreateRet(_ctx.builder->getInt32(0));
+    if (lowered.size() < 2) {
+        return false;
     }
 
-    _debug_info.end_function();
+    // the emission half wants a target machine, and the lanes each resolve their own
+    _backend.init_target();
+
+    // `of_type` sweeps a forget it put off the first time a kind is asked for, which is a write through a
+    // const collection - so every one of them is swept here, once, before two lanes can ask at once
+    for (auto &module : bundle.modules) {
+        module->nodes.settle();
     }
 
+    // built here and not on the worker, so every lane exists before the first one starts and the only
+    // thing a worker does is the compile
+    std::vector<std::unique_ptr<LLVMCompiler>> lanes;
+    std::vector<std::set<std::string>> skipped(lowered.size(), cached_modules);
+
+    for (size_t i = 0; i < lowered.size(); i++) {
+        auto lane = std::make_unique<LLVMCompiler>(_ctx.options);
+        lane->set_entry(_ctx.entry_module_name, _ctx.entry_file);
+        lane->set_test_mode(_ctx.test_mode);
+        lane->_lane = true;
+
+        for (size_t j = 0; j < lowered.size(); j++) {
+            if (j != i) {
+                skipped[i].insert(lowered[j]->name);
+            }
+        }
+
+        lanes.push_back(std::move(lane));
+    }
+
+    // **the first failure in unit order, not the first to happen.** Which lane throws first is a race; which
+    // unit is earliest is not, so the diagnostic a broken program gets does not change between two runs
+    std::vector<std::exception_ptr> failures(lanes.size());
+    std::atomic<size_t> next = 0;
+
+    auto work = [&] {
+        for (size_t i = next++; i < lanes.size(); i = next++) {
+            try {
+                lanes[i]->compile_bundle(bundle, skipped[i]);
+            } catch (...) {
+                failures[i] = std::current_exception();
+            }
+        }
+    };
+
+    const size_t workers = std::min<size_t>(jobs, lanes.size());
+
     {
-        // the bodies no module owns, into each unit that named one. After `main`'s epilogue, because the
-        // file roots above are what discover most of them, and before the verifier, because until this
-        // runs those units hold `declare`s nothing defines
-        Compiler::ScopedPhase phase("drain");
-        drain_pending_definitions();
+        Compiler::ScopedPhase phase("lanes");
+
+        std::vector<std::thread> pool;
+
+        // the calling thread is one of the workers, as it is for the lexer
+        for (size_t i = 1; i < workers; i++) {
+            pool.emplace_back(work);
+        }
+
+        work();
+
+        for (std::thread &worker : pool) {
+            worker.join();
+        }
     }
 
-    // **after the drain and before the ODR check.** The drain is the last thing that can add a body to
-    // any unit, and verify_odr_consistency compares final metadata - everything downstream of here (the
-    // merge, both pipelines, the object writer) is then strictly later, which is why there is one moment
-    // rather than an ordering rule per consumer. A builder left unfinalized leaves temporary MDNodes
-    // behind and the verifier rejects the module with a message that does not name the cause
-    _debug_info.finalize_all();
+    Compiler::PhaseTimings::instance().count("codegen threads", workers);
+
+    for (const std::exception_ptr &failure : failures) {
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    // in bundle order, which is the order the serial path creates units in and so the order every object,
+    // link line and `--print ir-units` section comes out in. The context moves *before* the lane is
+    // destroyed: its debug-info builder still tracks nodes that live there
+    for (std::unique_ptr<LLVMCompiler> &lane : lanes) {
+        for (std::unique_ptr<Compiler::LLVM::CmpUnit> &cmp_unit : lane->_ctx.cmp_units) {
+            _ctx.cmp_unit_map[cmp_unit->ast_module->name] = cmp_unit.get();
+            _ctx.cmp_units.push_back(std::move(cmp_unit));
+        }
+
+        _ctx.lane_contexts.push_back(std::move(lane->_ctx.llvm_context));
+        _ctx.needs_pthread = _ctx.needs_pthread || lane->_ctx.needs_pthread;
+
+        lane.reset();
+    }
 
     {
-        // before the merge, because afterwards there is only one copy left to look at
         Compiler::ScopedPhase phase("odr check");
         verify_odr_consistency();
     }
 
-    // verify the main module before linking
-    std::string error_str;
-    llvm::raw_string_ostream error_stream(error_str);
-    if (llvm::verifyModule(*main_cmp_unit->llvm_module, &error_stream)) {
-        throw Compiler::InternalCompilerException(fmt::format(
-            "LLVM IR verification failed for main module:\n{}", error_str
-        ));
-    }
-
+    return true;
 }
 
 // folds every unit into the main module, leaving one llvm::Module for the whole program.
@@ -643,32 +794,50 @@ void LLVMCompiler::visitAttribute(AST::AttributeNode &node) {}
 // -- backend forwarders -------------------------------------------------------
 
 // deliberately not "for each unit": a unit whose module was already consumed - by a merge, or because a
-// cache supplied its object - has nothing to emit, and asking is how you find out
+// cache supplied its object - has nothing to emit, and asking is how you find out. Nor is a unit
+// `object_for` has no path for, which is the JIT's way of keeping it in memory - see the header
 bool LLVMCompiler::emit_objects(
     const std::function<std::filesystem::path(const std::string &)> &object_for,
-    std::vector<std::filesystem::path> &out_objects
+    std::vector<std::filesystem::path> &out_objects,
+    const std::function<std::filesystem::path(const std::string &)> &instances_for,
+    unsigned jobs
 )
 {
     Compiler::ScopedPhase phase("emit objects");
 
+    std::vector<Compiler::LLVM::Backend::UnitEmission> units;
+
     for (auto &cmp_unit : _ctx.cmp_units) {
         if (!cmp_unit->llvm_module) {
             continue;
         }
 
-        // **what the unit's module holds by the time it is an object** - the unreferenced shared
-        // definitions dropped, then the baseline pipeline unless the invocation refused it. Here and
-        // not inside emit_object because `--print ir-units` has to reach the same answer, and it dumps
-        // rather than emits; the whole-program module arrives already marked optimized
-        _backend.prepare_unit_for_emission(*cmp_unit);
-
         const std::filesystem::path object_path = object_for(cmp_unit->ast_module->name);
 
-        if (!_backend.emit_object(*cmp_unit, object_path)) {
-            return false;
+        if (object_path.empty()) {
+            continue;
         }
 
-        out_objects.push_back(object_path);
+        units.push_back(Compiler::LLVM::Backend::UnitEmission {
+            .cmp_unit = cmp_unit.get(),
+            .object = object_path,
+            .instance_dir = instances_for ? instances_for(cmp_unit->ast_module->name) : std::filesystem::path(),
+            .instance = {}
+        });
+    }
+
+    if (!_backend.emit_units(units, jobs)) {
+        return false;
+    }
+
+    // in unit order whichever thread wrote which, so the link command is the same at any `-j`
+    for (const Compiler::LLVM::Backend::UnitEmission &unit : units) {
+        out_objects.push_back(unit.object);
+
+        if (!unit.instance.empty()
+            && std::find(out_objects.begin(), out_objects.end(), unit.instance) == out_objects.end()) {
+            out_objects.push_back(unit.instance);
+        }
     }
 
     return true;
@@ -684,10 +853,29 @@ bool LLVMCompiler::link_executable(
     return _backend.link_executable(executable_name, objects, link);
 }
 
+bool LLVMCompiler::thin_link(
+    const std::vector<std::filesystem::path> &summaries,
+    const std::vector<Compiler::LinkRequirement> &link,
+    const std::filesystem::path &cache_dir,
+    const std::filesystem::path &output_dir,
+    unsigned jobs,
+    std::vector<std::filesystem::path> &out_objects
+)
+{
+    Compiler::ScopedPhase phase("thin link");
+    return _backend.thin_link(summaries, link, cache_dir, output_dir, jobs, out_objects);
+}
+
+const std::string &LLVMCompiler::thin_link_report() const { return _backend.thin_link_report(); }
+const std::string &LLVMCompiler::instance_report() const { return _backend.instance_report(); }
+
 void LLVMCompiler::optimize() { _backend.optimize(); }
 void LLVMCompiler::printIR(bool toFile) { _backend.print_ir(toFile); }
 void LLVMCompiler::print_unit_ir() { _backend.print_unit_ir(); }
-bool LLVMCompiler::prepare_execution() { return _backend.prepare_execution(); }
+bool LLVMCompiler::prepare_execution(const std::vector<std::filesystem::path> &objects, unsigned jobs, bool tiered)
+{
+    return _backend.prepare_execution(objects, jobs, tiered);
+}
 int LLVMCompiler::run_main(const std::vector<std::string> &arguments, const char *const *environment)
 {
     return _backend.run_main(arguments, environment);
@@ -701,3 +889,4 @@ void LLVMCompiler::set_jit_roots(std::vector<std::string> roots)
     _backend.set_jit_roots(std::move(roots));
 }
 const std::string &LLVMCompiler::prune_report() const { return _backend.prune_report(); }
+std::string LLVMCompiler::tier_report() { return _backend.tier_report(); }
@@ -226,15 +226,19 @@ bool Comparison::same_attributes(
                 continue;
             }
 
-            if (attribute.isEnumAttribute() || attribute.isIntAttribute()) {
-                if (rs.getAttribute(attribute.getKindAsEnum()) != attribute) {
-                    return false;
-                }
-
-                continue;
+            // **by content and not by identity**, because an attribute is uniqued in *its* context and the
+            // two units may not share one: a unit lowered on a lane of its own - see LLVMCompiler::lower_in_lanes -
+            // minted its `noundef` in a context nobody else's definition lives in. The rendered form names
+            // the kind and the value, which is all an enum, integer or string attribute is
+            const llvm::Attribute other = attribute.isStringAttribute()
+                ? rs.getAttribute(attribute.getKindAsString())
+                : rs.getAttribute(attribute.getKindAsEnum());
+
+            if (!other.isValid()) {
+                return false;
             }
 
-            if (rs.getAttribute(attribute.getKindAsString()) != attribute) {
+            if (other != attribute && other.getAsString() != attribute.getAsString()) {
                 return false;
             }
         }
@@ -600,7 +604,7 @@ bool Comparison::same_debug_fields(const llvm::MDNode *left, const llvm::MDNode
 
 bool Comparison::same_metadata(const llvm::Metadata *left, const llvm::Metadata *right)
 {
-    // uniqued in the shared context, so identical content is one node however many modules reach it.
+    // uniqued in the context, so identical content is one node however many of its modules reach it.
     // that is the answer for every `!tbaa` leaf, for a `DILocation`, for a `DIFile` and for a
     // composite type reached through its ODR identifier - what falls through below is the *distinct*
     // nodes, of which a body carries exactly one kind
@@ -828,7 +832,7 @@ const char *Comparison::compare_operation(const llvm::Instruction &left, const l
         }
 
         // **through same_attributes and not `!=`**, for the reason a signature goes through same_type: an
-        // AttributeList is uniqued in the shared context, but a type-carrying attribute embeds a
+        // AttributeList is uniqued in its context, but a type-carrying attribute embeds a
         // `llvm::Type *` and a named struct is the one thing each unit mints for itself. So the `sret` on
         // an indirect return names this unit's `%string`, the other unit's names its own, and two
         // definitions that are the same definition compare unequal
@@ -0,0 +1,264 @@
+#include "Compiler/LLVM/SharedDefinitions.h"
+#include "Compiler/FileDigests.h"
+#include "Compiler/ModuleCache.h"
+
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/GlobalAlias.h>
+#include <llvm/IR/GlobalIFunc.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Metadata.h>
+#include <llvm/IR/TypeFinder.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/ValueMapper.h>
+
+#include <fmt/core.h>
+
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+// the globals the moved bodies reach, gathered transitively: a module-local one is copied along and walked in
+// turn, anything else stays where it is and is named by a declaration
+class Closure
+{
+public:
+    explicit Closure(llvm::SmallPtrSetImpl<const llvm::GlobalValue *> &moved) : _moved(moved) {}
+
+    // false, with a sentence in `kept_because`, at the first global a copy would change the meaning of
+    bool walk(std::vector<const llvm::GlobalValue *> worklist, std::string &kept_because)
+    {
+        _worklist = std::move(worklist);
+
+        while (!_worklist.empty()) {
+            const llvm::GlobalValue *global = _worklist.back();
+            _worklist.pop_back();
+
+            if (const auto *function = llvm::dyn_cast<llvm::Function>(global)) {
+                if (function->hasPersonalityFn()) {
+                    reach(function->getPersonalityFn());
+                }
+
+                for (const llvm::BasicBlock &block : *function) {
+                    for (const llvm::Instruction &instruction : block) {
+                        for (const llvm::Use &operand : instruction.operands()) {
+                            reach(operand.get());
+                        }
+                    }
+                }
+            }
+            else if (const auto *variable = llvm::dyn_cast<llvm::GlobalVariable>(global)) {
+                if (variable->hasInitializer()) {
+                    reach(variable->getInitializer());
+                }
+            }
+
+            if (!_refusal.empty()) {
+                kept_because = _refusal;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    void reach(const llvm::Value *value)
+    {
+        if (!_refusal.empty()) {
+            return;
+        }
+
+        // an intrinsic's metadata operand can carry a global, and it is as much a use as a call is
+        if (const auto *wrapped = llvm::dyn_cast<llvm::MetadataAsValue>(value)) {
+            if (const auto *inner = llvm::dyn_cast<llvm::ValueAsMetadata>(wrapped->getMetadata())) {
+                reach(inner->getValue());
+            }
+
+            return;
+        }
+
+        if (const auto *global = llvm::dyn_cast<llvm::GlobalValue>(value)) {
+            reach_global(global);
+            return;
+        }
+
+        // a constant expression or an aggregate initializer, which is where a literal's address usually is
+        if (const auto *constant = llvm::dyn_cast<llvm::Constant>(value)) {
+            if (!_constants.insert(constant).second) {
+                return;
+            }
+
+            for (const llvm::Use &operand : constant->operands()) {
+                reach(operand.get());
+            }
+        }
+    }
+
+    void reach_global(const llvm::GlobalValue *global)
+    {
+        if (!global->hasLocalLinkage() || _moved.count(global) > 0) {
+            return;
+        }
+
+        // **the one thing a copy cannot be**: two objects each with their own `internal` variable is two
+        // variables, and whichever body wrote one would leave the other unread
+        if (const auto *variable = llvm::dyn_cast<llvm::GlobalVariable>(global); variable && !variable->isConstant()) {
+            _refusal = fmt::format("'{}' is state its unit owns", global->getName().str());
+            return;
+        }
+
+        if (llvm::isa<llvm::GlobalAlias>(global) || llvm::isa<llvm::GlobalIFunc>(global)) {
+            _refusal = fmt::format("'{}' is an alias, which is not copied", global->getName().str());
+            return;
+        }
+
+        _moved.insert(global);
+        _worklist.push_back(global);
+    }
+
+    llvm::SmallPtrSetImpl<const llvm::GlobalValue *> &_moved;
+    llvm::SmallPtrSet<const llvm::Constant *, 32> _constants;
+    std::vector<const llvm::GlobalValue *> _worklist;
+    std::string _refusal;
+};
+
+};
+
+Compiler::LLVM::SharedDefinitionSplit Compiler::LLVM::split_shared_definitions(const llvm::Module &unit)
+{
+    SharedDefinitionSplit split;
+
+    llvm::SmallPtrSet<const llvm::GlobalValue *, 32> moved;
+    std::vector<const llvm::GlobalValue *> roots;
+
+    for (const llvm::Function &function : unit) {
+        if (!function.isDeclaration() && function.hasLinkOnceODRLinkage()) {
+            moved.insert(&function);
+            roots.push_back(&function);
+        }
+    }
+
+    split.definitions = roots.size();
+
+    if (roots.empty()) {
+        return split;
+    }
+
+    Closure closure(moved);
+
+    if (!closure.walk(std::move(roots), split.kept_because)) {
+        return split;
+    }
+
+    llvm::ValueToValueMapTy map;
+    split.module = llvm::CloneModule(unit, map, [&moved](const llvm::GlobalValue *global) {
+        return moved.count(global) > 0;
+    });
+
+    // CloneModule keeps every global the unit had and turns the ones it did not copy into declarations, so
+    // what is left of the unit is swept out here: the bodies it still holds and the symbols nothing moved
+    // names would otherwise be part of what this module is keyed on
+    for (llvm::Function &function : llvm::make_early_inc_range(*split.module)) {
+        if (function.isDeclaration() && function.use_empty()) {
+            function.eraseFromParent();
+        }
+    }
+
+    for (llvm::GlobalVariable &variable : llvm::make_early_inc_range(split.module->globals())) {
+        if (variable.isDeclaration() && variable.use_empty()) {
+            variable.eraseFromParent();
+        }
+    }
+
+    for (llvm::GlobalAlias &alias : llvm::make_early_inc_range(split.module->aliases())) {
+        if (alias.use_empty()) {
+            alias.eraseFromParent();
+        }
+    }
+
+    // **unnamed, so a copy is what it holds rather than where it came from.** `.str.5` is the fifth literal
+    // the unit happened to lower, and a literal added above it in the unit's own code is not a change to
+    // anything moved here
+    for (llvm::GlobalValue &global : split.module->global_values()) {
+        if (global.hasLocalLinkage()) {
+            global.setName("");
+        }
+    }
+
+    return split;
+}
+
+uint64_t Compiler::LLVM::shared_definitions_digest(llvm::Module &shared, uint64_t environment)
+{
+    // a named struct's name is the context's, shared with every unit, so it is taken off for the print and
+    // put back after it - by position is how an unnamed one prints, and the position is this module's own
+    llvm::TypeFinder structs;
+    structs.run(shared, /*onlyNamed=*/true);
+
+    std::vector<std::pair<llvm::StructType *, std::string>> names;
+    names.reserve(structs.size());
+
+    for (llvm::StructType *type : structs) {
+        names.emplace_back(type, type->getName().str());
+        type->setName("");
+    }
+
+    std::string printed;
+    llvm::raw_string_ostream out(printed);
+    shared.print(out, nullptr);
+    out.flush();
+
+    for (auto &[type, name] : names) {
+        type->setName(name);
+    }
+
+    return Compiler::fnv1a64(Compiler::to_hex(Compiler::content_digest(printed)), environment);
+}
+
+void Compiler::LLVM::release_shared_definitions(llvm::Module &unit, const llvm::Module &shared)
+{
+    for (const llvm::Function &moved : shared) {
+        if (moved.isDeclaration() || moved.hasLocalLinkage()) {
+            continue;
+        }
+
+        llvm::Function *own = unit.getFunction(moved.getName());
+
+        if (own == nullptr || own->isDeclaration()) {
+            continue;
+        }
+
+        // a declaration now, of the symbol the shared object defines. Its metadata goes with the body -
+        // a declaration carrying a body's attachments is one the verifier refuses
+        own->deleteBody();
+        own->clearMetadata();
+    }
+
+    // the copies the moved bodies took with them, dropped here when nothing the unit kept still names them.
+    // Repeated, because a dropped function can be the last user of the literal it held
+    bool dropped = true;
+
+    while (dropped) {
+        dropped = false;
+
+        for (llvm::Function &function : llvm::make_early_inc_range(unit)) {
+            if (function.hasLocalLinkage() && function.use_empty()) {
+                function.eraseFromParent();
+                dropped = true;
+            }
+        }
+
+        for (llvm::GlobalVariable &variable : llvm::make_early_inc_range(unit.globals())) {
+            if (variable.hasLocalLinkage() && variable.use_empty()) {
+                variable.eraseFromParent();
+                dropped = true;
+            }
+        }
+    }
+}
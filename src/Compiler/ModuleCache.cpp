@@ -1,5 +1,10 @@
 #include "Compiler/ModuleCache.h"
 
+#include "AST/ASTFunctionEmission.h"
+#include "AST/ASTModule.h"
+#include "AST/FunctionDeclNode.h"
+#include "AST/TypeDeclNode.h"
+#include "Compiler/FileDigests.h"
 #include "Compiler/TargetSubtarget.h"
 #include "eco.h"
 
@@ -9,10 +14,13 @@
 #include <fmt/core.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <fstream>
 #include <optional>
 
+#include <unistd.h>
+
 namespace
 {
 
@@ -21,6 +29,53 @@ using Compiler::k_fnv_offset_basis;
 
 constexpr uint64_t k_fnv_prime = 1099511628211ULL;
 
+// the first line of an instance record. A record in any other shape names nothing this build can trust, which
+// makes its object a miss rather than a whole one
+constexpr const char *k_instance_record_header = "echoc-instances 1";
+
+// how long an instance object is kept unused, and how often anything looks - the thin link cache's own policy,
+// for the same kind of store: keyed on content nobody else can name, so age is the only thing to go on
+constexpr auto k_instance_expiry = std::chrono::hours(24 * 7);
+constexpr auto k_instance_prune_interval = std::chrono::hours(1);
+
+// what module_interface_digest makes of each token, decided before the walk
+enum class InterfaceToken : uint8_t
+{
+    t_declaration,  // part of the interface, folded by spelling
+    t_positioned,   // part of the interface, and its line and line text can end up in another unit
+    t_body          // inside an ordinary body: the declaring unit's business alone
+};
+
+// the body of the declaration at `from`: its opening brace and the brace that closes it. The first `{` is
+// the body's because a signature can hold neither it nor a `;` - the rule Parser::skip_refused_function
+// leans on. nullopt for a declaration with no body, and when the braces never balance: a range that
+// cannot be found is left in the interface rather than guessed at
+std::optional<std::pair<size_t, size_t>> body_range(const TokenCollection &tokens, size_t from)
+{
+    size_t open = from;
+
+    while (open < tokens.size() && tokens.tokens[open].type != Token::Type::t_open_brace) {
+        if (tokens.tokens[open].type == Token::Type::t_semicolon) {
+            return std::nullopt;
+        }
+
+        open++;
+    }
+
+    size_t depth = 0;
+
+    for (size_t i = open; i < tokens.size(); i++) {
+        if (tokens.tokens[i].type == Token::Type::t_open_brace) {
+            depth++;
+        }
+        else if (tokens.tokens[i].type == Token::Type::t_close_brace && --depth == 0) {
+            return std::make_pair(open, i);
+        }
+    }
+
+    return std::nullopt;
+}
+
 };
 
 std::string Compiler::to_hex(uint64_t value)
@@ -155,6 +210,14 @@ bool Compiler::compute_module_keys(
     environment = fnv1a64(
         options.emitting_debug_info() ? std::string("g") : std::string("nog"), environment);
 
+    // **and whether what is stored is an object at all.** A `--optimize thin` unit is summary bitcode that
+    // went through the pre-link pipeline instead of the baseline one, so it is a different artifact of the
+    // same source. Folded only when set, the way an inactive target scope folds nothing: every key an
+    // ordinary build ever wrote stays exactly where it was
+    if (options.thin_lto) {
+        environment = fnv1a64(std::string("thin"), environment);
+    }
+
     // by canonical manifest path, because that is what `depends` holds
     std::map<std::filesystem::path, uint64_t> digest_by_path;
 
@@ -185,15 +248,14 @@ bool Compiler::compute_module_keys(
 
         // the manifest's own bytes: its source list, its dependencies and its comments are all part of what
         // the module is. Hashing the expanded file list instead would miss a pattern that stopped matching
-        const std::optional<std::string> manifest_bytes = read_whole_file(manifest.path);
-        if (!manifest_bytes.has_value()) {
+        const std::optional<uint64_t> manifest_digest = FileDigests::instance().digest_of(manifest.path);
+        if (!manifest_digest.has_value()) {
             out_error = fmt::format("{}: cannot be read to compute a cache key.", manifest.path.string());
             return false;
         }
 
-        const uint64_t manifest_digest = fnv1a64(manifest_bytes.value(), k_fnv_offset_basis);
-        key.inputs.emplace_back(manifest.path, manifest_digest);
-        hash = fnv1a64(&manifest_digest, sizeof(manifest_digest), hash);
+        key.inputs.emplace_back(manifest.path, manifest_digest.value());
+        hash = fnv1a64(&manifest_digest.value(), sizeof(uint64_t), hash);
 
         // **through the one owner of what this module compiles**, which is also what handed the parser its
         // file list. Two merges of "the manifest's sources plus whichever scopes apply" would be a cache
@@ -213,20 +275,22 @@ bool Compiler::compute_module_keys(
         // `sources` is already sorted by the manifest reader, and a scope's files follow the module's own
         // in written order - so the order here is stable either way
         for (const std::filesystem::path &source : contribution.sources) {
-            const std::optional<std::string> bytes = read_whole_file(source);
-            if (!bytes.has_value()) {
+            const std::optional<uint64_t> digest = FileDigests::instance().digest_of(source);
+            if (!digest.has_value()) {
                 out_error = fmt::format("{}: cannot be read to compute a cache key.", source.string());
                 return false;
             }
 
-            const uint64_t digest = fnv1a64(bytes.value(), k_fnv_offset_basis);
-            key.inputs.emplace_back(source, digest);
+            key.inputs.emplace_back(source, digest.value());
 
             // the path as well as the content: renaming a file changes the module even when no byte of it did
             hash = fnv1a64(source.filename().string(), hash);
-            hash = fnv1a64(&digest, sizeof(digest), hash);
+            hash = fnv1a64(&digest.value(), sizeof(uint64_t), hash);
         }
 
+        // what the object key starts from - see compute_object_keys
+        key.local = hash;
+
         // and every dependency's key. The topological order guarantees they are already computed - if one is
         // missing the graph was not ordered, which is a resolver bug rather than a user error
         for (const std::filesystem::path &dependency : contribution.depends) {
@@ -264,6 +328,219 @@ bool Compiler::compute_module_keys(
     return true;
 }
 
+uint64_t Compiler::module_interface_digest(AST::Module &module, bool with_positions)
+{
+    const TokenCollection &tokens = module.tokens;
+    std::vector<InterfaceToken> kinds(tokens.size(), InterfaceToken::t_declaration);
+
+    const auto mark = [&](const TokenReference &site, InterfaceToken kind) {
+        // a declaration this module did not write - an instance cloned out of another module's template,
+        // a closure's minted name - has no span here to mark
+        if (!module.is_owner_of(site) || site.is_minted()) {
+            return;
+        }
+
+        const auto range = body_range(tokens, site.get_handle());
+        if (!range.has_value()) {
+            return;
+        }
+
+        std::fill(kinds.begin() + range->first, kinds.begin() + range->second + 1, kind);
+    };
+
+    // a type's name, for the abort a body synthesized from its shape is blamed on. Only the name: the rest
+    // of the declaration is spelling, and a method body inside it is carved out below like any other
+    for (const AST::TypeDeclNode *type : module.nodes.of_type<AST::TypeDeclNode>()) {
+        if (type->name_token.has_value() && module.is_owner_of(*type->name_token)) {
+            kinds[type->name_token->get_handle()] = InterfaceToken::t_positioned;
+        }
+    }
+
+    // **the ordinary bodies first and the shared ones second**, so nothing inside a shared body - a
+    // closure, whose own body is module-local - is carved out of what every calling unit gets a copy of
+    for (const bool ordinary : { true, false }) {
+        for (const AST::FunctionDeclNode *function : module.nodes.of_type<AST::FunctionDeclNode>()) {
+            // a synthesized constructor is sited at its struct's name, and nobody wrote its body - the
+            // first brace after that name is the struct's own
+            if (function->body == nullptr || function->is_anonymous() || function->is_implicitly_generated) {
+                continue;
+            }
+
+            const bool module_local =
+                AST::function_emission_kind(function) == AST::FunctionEmission::t_module_local;
+
+            if (module_local == ordinary) {
+                mark(function->declaration_site_token(),
+                    ordinary ? InterfaceToken::t_body : InterfaceToken::t_positioned);
+            }
+        }
+    }
+
+    uint64_t digest = k_fnv_offset_basis;
+
+    const AST::File *file = nullptr;
+    uint32_t positioned_line = 0;
+
+    for (size_t i = 0; i < tokens.size(); i++) {
+        const Token &token = tokens.tokens[i];
+
+        // a minted token is the compiler's own rewrite of something that was written, and what was
+        // written is already here
+        if (token.minted || kinds[i] == InterfaceToken::t_body) {
+            continue;
+        }
+
+        // the name rather than the whole path, as compute_module_keys folds it: a project that moved has
+        // not changed what it declares
+        if (token.file != file) {
+            file = token.file;
+            positioned_line = 0;
+
+            if (file != nullptr) {
+                digest = fnv1a64(file->get_path().filename().string(), digest);
+            }
+        }
+
+        const std::string &spelling = tokens.value_of(i);
+        const uint64_t length = spelling.size();
+        const uint32_t type = static_cast<uint32_t>(token.type);
+
+        digest = fnv1a64(&type, sizeof(type), digest);
+        digest = fnv1a64(&length, sizeof(length), digest);
+        digest = fnv1a64(spelling, digest);
+
+        if (with_positions) {
+            digest = fnv1a64(&token.line, sizeof(token.line), digest);
+            digest = fnv1a64(&token.char_offset, sizeof(token.char_offset), digest);
+        }
+
+        // once per line: the abort codegen embeds the line's number *and* its text, whitespace and
+        // comments included, and the spellings above would miss an edit to either
+        if (kinds[i] == InterfaceToken::t_positioned && token.line != positioned_line) {
+            positioned_line = token.line;
+            digest = fnv1a64(&token.line, sizeof(token.line), digest);
+
+            if (file != nullptr) {
+                digest = fnv1a64(file->get_content_of_line(token.line), digest);
+            }
+        }
+    }
+
+    return digest;
+}
+
+std::filesystem::path Compiler::interface_input(const std::string &module_name)
+{
+    return std::filesystem::path(fmt::format("interface:{}", module_name));
+}
+
+bool Compiler::compute_object_keys(
+    const std::vector<const Parser::ModuleManifest *> &manifests,
+    const std::map<std::string, ModuleCacheKey> &source_keys,
+    const std::map<std::string, uint64_t> &interfaces,
+    std::map<std::string, ModuleCacheKey> &out_keys,
+    std::string &out_error
+)
+{
+    out_keys.clear();
+
+    // every earlier module's interface, in order, and the inputs naming them - see the header
+    uint64_t preceding = k_fnv_offset_basis;
+    std::vector<std::pair<std::filesystem::path, uint64_t>> preceding_inputs;
+
+    for (const Parser::ModuleManifest *entry : manifests) {
+        const Parser::ModuleManifest &manifest = *entry;
+
+        auto source = source_keys.find(manifest.name);
+        auto interface = interfaces.find(manifest.name);
+
+        if (source == source_keys.end() || interface == interfaces.end()) {
+            out_error = fmt::format(
+                "internal: the module '{}' has no source key or no interface to key its object on.",
+                manifest.name);
+            return false;
+        }
+
+        ModuleCacheKey key;
+        key.local = source->second.local;
+        key.inputs = source->second.inputs;
+        key.inputs.insert(key.inputs.end(), preceding_inputs.begin(), preceding_inputs.end());
+
+        // tagged, so an object key can never be spelled like the source key of the same module
+        uint64_t hash = fnv1a64(std::string("object"), key.local);
+        hash = fnv1a64(&preceding, sizeof(preceding), hash);
+
+        key.hex = to_hex(hash);
+
+        // the name as well: two modules with the same declarations are still two namespaces' worth of them
+        const uint64_t shown = fnv1a64(manifest.name, interface->second);
+
+        preceding = fnv1a64(&shown, sizeof(shown), preceding);
+        preceding_inputs.emplace_back(interface_input(manifest.name), interface->second);
+
+        out_keys.emplace(manifest.name, std::move(key));
+    }
+
+    return true;
+}
+
+bool Compiler::compute_program_key(
+    const std::vector<const Parser::ModuleManifest *> &manifests,
+    const std::map<std::string, ModuleCacheKey> &source_keys,
+    const std::filesystem::path &entry_file,
+    const std::vector<std::filesystem::path> &linked_files,
+    const std::vector<std::string> &settings,
+    ModuleCacheKey &out_key,
+    std::string &out_error
+)
+{
+    out_key = ModuleCacheKey{};
+
+    uint64_t hash = k_fnv_offset_basis;
+    hash = fnv1a64(std::string(ECO_MODULE_CACHE_VERSION), hash);
+
+    // in dependency order, which is the order they are linked in - two programs made of the same modules in
+    // another order are two different link lines
+    for (const Parser::ModuleManifest *manifest : manifests) {
+        auto found = source_keys.find(manifest->name);
+        if (found == source_keys.end()) {
+            out_error = fmt::format(
+                "internal: the program was keyed before its module '{}' was.", manifest->name);
+            return false;
+        }
+
+        hash = fnv1a64(manifest->name, hash);
+        hash = fnv1a64(found->second.hex, hash);
+
+        out_key.inputs.insert(out_key.inputs.end(), found->second.inputs.begin(), found->second.inputs.end());
+    }
+
+    hash = fnv1a64(entry_file.string(), hash);
+
+    for (const std::filesystem::path &linked : linked_files) {
+        const std::optional<uint64_t> digest = FileDigests::instance().digest_of(linked);
+        if (!digest.has_value()) {
+            out_error = fmt::format("{}: cannot be read to compute a cache key.", linked.string());
+            return false;
+        }
+
+        out_key.inputs.emplace_back(linked, digest.value());
+
+        hash = fnv1a64(linked.string(), hash);
+        hash = fnv1a64(&digest.value(), sizeof(uint64_t), hash);
+    }
+
+    // each one with its terminating NUL, so `a` then `bc` and `ab` then `c` are two keys
+    for (const std::string &setting : settings) {
+        hash = fnv1a64(setting.data(), setting.size() + 1, hash);
+    }
+
+    out_key.local = hash;
+    out_key.hex = to_hex(hash);
+
+    return true;
+}
+
 std::filesystem::path Compiler::module_object_path(
     const Parser::ModuleManifest &manifest,
     const ModuleCacheKey &key,
@@ -273,6 +550,24 @@ std::filesystem::path Compiler::module_object_path(
     return layout.module_dir(manifest) / fmt::format("{}-{}.o", manifest.name, key.hex);
 }
 
+std::filesystem::path Compiler::module_summary_path(
+    const Parser::ModuleManifest &manifest,
+    const ModuleCacheKey &key,
+    const BuildLayout &layout
+)
+{
+    return layout.module_dir(manifest) / fmt::format("{}-{}.bc", manifest.name, key.hex);
+}
+
+std::filesystem::path Compiler::module_tokens_path(
+    const Parser::ModuleManifest &manifest,
+    const ModuleCacheKey &key,
+    const BuildLayout &layout
+)
+{
+    return layout.module_dir(manifest) / fmt::format("{}-{}.ecot", manifest.name, key.hex);
+}
+
 std::filesystem::path Compiler::module_inputs_path(
     const Parser::ModuleManifest &manifest,
     const BuildLayout &layout
@@ -281,6 +576,22 @@ std::filesystem::path Compiler::module_inputs_path(
     return layout.module_dir(manifest) / fmt::format("{}.inputs", manifest.name);
 }
 
+std::filesystem::path Compiler::stored_program_path(
+    const std::string &program_name,
+    const ModuleCacheKey &key,
+    const BuildLayout &layout
+)
+{
+    const std::filesystem::path directory = layout.program_dir();
+    return directory.empty() ? directory : directory / fmt::format("{}-{}", program_name, key.hex);
+}
+
+std::filesystem::path Compiler::program_inputs_path(const std::string &program_name, const BuildLayout &layout)
+{
+    const std::filesystem::path directory = layout.program_dir();
+    return directory.empty() ? directory : directory / fmt::format("{}.inputs", program_name);
+}
+
 bool Compiler::write_inputs_record(const std::filesystem::path &path, const ModuleCacheKey &key)
 {
     // the directory is the caller's - it prepared one before it decided to emit here at all, and creating
@@ -320,15 +631,26 @@ std::string Compiler::explain_miss(const std::filesystem::path &inputs_path, con
         recorded.emplace(line.substr(space + 1), line.substr(0, space));
     }
 
+    // another module's interface is not a file, so it is named as the module it is
+    const auto describe = [](const std::string &input) {
+        const std::string prefix = interface_input("").string();
+
+        if (input.compare(0, prefix.size(), prefix) == 0) {
+            return fmt::format("the interface of '{}'", input.substr(prefix.size()));
+        }
+
+        return fmt::format("'{}'", std::filesystem::path(input).filename().string());
+    };
+
     for (const auto &[input, digest] : key.inputs) {
         auto found = recorded.find(input.string());
 
         if (found == recorded.end()) {
-            return fmt::format("'{}' is new", input.filename().string());
+            return fmt::format("{} is new", describe(input.string()));
         }
 
         if (found->second != to_hex(digest)) {
-            return fmt::format("'{}' changed", input.filename().string());
+            return fmt::format("{} changed", describe(input.string()));
         }
     }
 
@@ -341,9 +663,145 @@ std::string Compiler::explain_miss(const std::filesystem::path &inputs_path, con
             });
 
         if (!still_present) {
-            return fmt::format("'{}' is gone", std::filesystem::path(recorded_path).filename().string());
+            return fmt::format("{} is gone", describe(recorded_path));
         }
     }
 
     return "the compiler, target or build mode changed";
 }
+
+std::filesystem::path Compiler::instance_object_path(const std::filesystem::path &instance_dir, uint64_t digest)
+{
+    return instance_dir / fmt::format("shared-{}.o", to_hex(digest));
+}
+
+std::filesystem::path Compiler::instance_record_path(const std::filesystem::path &object)
+{
+    return object.string() + ".instances";
+}
+
+bool Compiler::write_instance_record(
+    const std::filesystem::path &object,
+    const std::vector<std::filesystem::path> &instances
+)
+{
+    const std::filesystem::path record = instance_record_path(object);
+    const std::filesystem::path partial = record.string() + fmt::format(".{}.partial", getpid());
+    std::error_code ec;
+
+    {
+        std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+
+        if (!out) {
+            return false;
+        }
+
+        // by filename alone: the directory is whichever one the reading build's layout names, which is what
+        // lets a library's object be served to a second program that keeps its own instance objects
+        out << k_instance_record_header << "\n";
+
+        for (const std::filesystem::path &instance : instances) {
+            out << instance.filename().string() << "\n";
+        }
+
+        if (!out.good()) {
+            out.close();
+            std::filesystem::remove(partial, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(partial, record, ec);
+
+    if (ec) {
+        std::filesystem::remove(partial, ec);
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<std::vector<std::filesystem::path>> Compiler::claim_instance_objects(
+    const std::filesystem::path &object,
+    const std::filesystem::path &instance_dir
+)
+{
+    std::vector<std::filesystem::path> instances;
+    std::error_code ec;
+
+    const std::filesystem::path record = instance_record_path(object);
+
+    if (!std::filesystem::exists(record, ec)) {
+        return instances;
+    }
+
+    std::ifstream in(record, std::ios::binary);
+    std::string line;
+
+    if (!in || !std::getline(in, line) || line != k_instance_record_header || instance_dir.empty()) {
+        return std::nullopt;
+    }
+
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        const std::filesystem::path instance = instance_dir / line;
+
+        if (!std::filesystem::is_regular_file(instance, ec)) {
+            return std::nullopt;
+        }
+
+        instances.push_back(instance);
+    }
+
+    // marked once every one of them is known to be there, so a claim that fails leaves nothing looking used
+    for (const std::filesystem::path &instance : instances) {
+        std::filesystem::last_write_time(instance, std::filesystem::file_time_type::clock::now(), ec);
+    }
+
+    return instances;
+}
+
+void Compiler::prune_instance_objects(const std::filesystem::path &instance_dir)
+{
+    if (instance_dir.empty()) {
+        return;
+    }
+
+    const std::filesystem::path stamp = instance_dir / "pruned";
+    const auto now = std::filesystem::file_time_type::clock::now();
+    std::error_code ec;
+
+    const std::filesystem::file_time_type last = std::filesystem::last_write_time(stamp, ec);
+
+    if (!ec && now - last < k_instance_prune_interval) {
+        return;
+    }
+
+    std::ofstream(stamp, std::ios::app);
+    std::filesystem::last_write_time(stamp, now, ec);
+
+    for (const auto &entry : std::filesystem::directory_iterator(instance_dir, ec)) {
+        std::error_code entry_ec;
+
+        // an object, or one a build was interrupted writing - which nothing will ever finish, and which is
+        // given the hour a running build could still need it for
+        const bool object = entry.path().extension() == ".o";
+        const bool staged = entry.path().extension() == ".partial";
+
+        if ((!object && !staged) || !entry.is_regular_file(entry_ec)) {
+            continue;
+        }
+
+        const std::filesystem::file_time_type used = entry.last_write_time(entry_ec);
+        const auto expiry = object
+            ? std::chrono::duration_cast<std::filesystem::file_time_type::duration>(k_instance_expiry)
+            : std::chrono::duration_cast<std::filesystem::file_time_type::duration>(k_instance_prune_interval);
+
+        if (!entry_ec && now - used > expiry) {
+            std::filesystem::remove(entry.path(), entry_ec);
+        }
+    }
+}
@@ -24,10 +24,14 @@ auto find_phase(Phases &phases, std::string_view name)
 
 size_t Compiler::PhaseTimings::enter(std::string_view phase)
 {
+    if (!owned_here()) {
+        return 0;
+    }
+
     const size_t depth = _depth++;
 
     if (_enabled && find_phase(_phases, phase) == _phases.end()) {
-        _phases.push_back(Phase{ std::string(phase), depth, 0.0 });
+        _phases.push_back(Phase{ std::string(phase), depth, 0.0, false, 0 });
     }
 
     return depth;
@@ -35,20 +39,36 @@ size_t Compiler::PhaseTimings::enter(std::string_view phase)
 
 void Compiler::PhaseTimings::record(std::string_view phase, size_t depth, double milliseconds)
 {
-    if (!_enabled) {
+    if (!_enabled || !owned_here()) {
         return;
     }
 
     auto found = find_phase(_phases, phase);
 
     if (found == _phases.end()) {
-        _phases.push_back(Phase{ std::string(phase), depth, milliseconds });
+        _phases.push_back(Phase{ std::string(phase), depth, milliseconds, false, 0 });
         return;
     }
 
     found->milliseconds += milliseconds;
 }
 
+void Compiler::PhaseTimings::count(std::string_view counter, size_t n)
+{
+    if (!_enabled || !owned_here()) {
+        return;
+    }
+
+    auto found = find_phase(_phases, counter);
+
+    if (found == _phases.end()) {
+        _phases.push_back(Phase{ std::string(counter), _depth, 0.0, true, n });
+        return;
+    }
+
+    found->count += n;
+}
+
 std::string Compiler::PhaseTimings::report() const
 {
     if (_phases.empty()) {
@@ -68,6 +88,12 @@ std::string Compiler::PhaseTimings::report() const
     // the interesting cases
     for (const Phase &phase : _phases) {
         const std::string indented = std::string(phase.depth * 2, ' ') + phase.name;
+
+        if (phase.is_count) {
+            out += fmt::format("  {:<{}}  {:>8}\n", indented, width, phase.count);
+            continue;
+        }
+
         out += fmt::format("  {:<{}}  {:>8.2f} ms\n", indented, width, phase.milliseconds);
     }
 
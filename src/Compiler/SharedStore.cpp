@@ -0,0 +1,408 @@
+#include "Compiler/SharedStore.h"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ECO_SHARED_STORE_POSIX 1
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+// how long after one automatic prune the next may run. Pruning lists the whole store, which is the one cost
+// here that grows with it, and a store a little over its cap for an hour has cost nobody anything
+constexpr auto k_prune_interval = std::chrono::hours(1);
+
+// how old a staged file has to be before a prune takes it for an interrupted publish rather than a running one
+constexpr auto k_abandoned_after = std::chrono::hours(1);
+
+// the store's lock, held for as long as this is in scope. **shared for a fetch or a publish and exclusive for
+// a prune** - see the class comment. Without flock there is no lock, and the renames alone still keep every
+// object whole; what is lost is only the guarantee that a prune cannot race a fetch
+class StoreLock
+{
+public:
+    StoreLock(const std::filesystem::path &root, bool exclusive, bool wait)
+    {
+#if ECO_SHARED_STORE_POSIX
+        _fd = open((root / "lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+        if (_fd < 0) {
+            return;
+        }
+
+        const int operation = (exclusive ? LOCK_EX : LOCK_SH) | (wait ? 0 : LOCK_NB);
+
+        if (flock(_fd, operation) == 0) {
+            _held = true;
+        }
+#else
+        (void)root;
+        (void)exclusive;
+        (void)wait;
+        _held = true;
+#endif
+    }
+
+    ~StoreLock()
+    {
+#if ECO_SHARED_STORE_POSIX
+        if (_fd >= 0) {
+            close(_fd);
+        }
+#endif
+    }
+
+    StoreLock(const StoreLock &) = delete;
+    StoreLock &operator=(const StoreLock &) = delete;
+
+    bool held() const { return _held; }
+
+private:
+    int _fd = -1;
+    bool _held = false;
+};
+
+// a name nothing else staging into the same directory can be using
+std::string staging_suffix()
+{
+    static std::atomic<unsigned> counter{ 0 };
+
+#if ECO_SHARED_STORE_POSIX
+    const long long process = static_cast<long long>(getpid());
+#else
+    const long long process = static_cast<long long>(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+
+    return fmt::format(".{}.{}.partial", process, counter++);
+}
+
+// `from` in place at `to`, by a hard link where one can be made and a copy where it cannot, staged beside `to`
+// and renamed over it
+bool place(const std::filesystem::path &from, const std::filesystem::path &to)
+{
+    const std::filesystem::path staged = to.string() + staging_suffix();
+    std::error_code ec;
+
+    std::filesystem::create_hard_link(from, staged, ec);
+
+    if (ec) {
+        ec.clear();
+        std::filesystem::copy_file(from, staged, std::filesystem::copy_options::overwrite_existing, ec);
+    }
+
+    if (!ec) {
+        std::filesystem::rename(staged, to, ec);
+    }
+
+    if (ec) {
+        std::error_code ignored;
+        std::filesystem::remove(staged, ignored);
+        return false;
+    }
+
+    return true;
+}
+
+// marks an object used, which is the whole of the bookkeeping least-recently-used needs
+void touch(const std::filesystem::path &path)
+{
+    std::error_code ec;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+}
+
+struct StoredObject
+{
+    std::filesystem::path path;
+    std::filesystem::file_time_type used;
+    uint64_t bytes = 0;
+};
+
+std::vector<StoredObject> list_objects(const std::filesystem::path &directory)
+{
+    std::vector<StoredObject> objects;
+    std::error_code ec;
+
+    for (const auto &entry : std::filesystem::directory_iterator(directory, ec)) {
+        std::error_code entry_ec;
+
+        if (!entry.is_regular_file(entry_ec)) {
+            continue;
+        }
+
+        const uint64_t bytes = entry.file_size(entry_ec);
+        const std::filesystem::file_time_type used = entry.last_write_time(entry_ec);
+
+        if (!entry_ec) {
+            objects.push_back(StoredObject{ entry.path(), used, bytes });
+        }
+    }
+
+    return objects;
+}
+
+};
+
+std::optional<uint64_t> Compiler::parse_byte_size(const std::string &written)
+{
+    size_t digits = 0;
+
+    while (digits < written.size() && std::isdigit(static_cast<unsigned char>(written[digits]))) {
+        digits++;
+    }
+
+    if (digits == 0 || digits > 15) {
+        return std::nullopt;
+    }
+
+    const uint64_t number = std::stoull(written.substr(0, digits));
+    std::string unit = written.substr(digits);
+
+    // `G`, `GB`, `GiB` and `g` all mean the binary one - nobody sizing a cache means the decimal one on purpose
+    if (!unit.empty() && (unit.back() == 'B' || unit.back() == 'b')) {
+        unit.pop_back();
+
+        if (!unit.empty() && unit.back() == 'i') {
+            unit.pop_back();
+        }
+    }
+
+    if (unit.empty()) {
+        return number;
+    }
+
+    static const std::string scales = "KMGT";
+    const size_t scale = unit.size() == 1
+        ? scales.find(static_cast<char>(std::toupper(static_cast<unsigned char>(unit[0]))))
+        : std::string::npos;
+
+    const unsigned shift = 10 * (static_cast<unsigned>(scale) + 1);
+
+    if (scale == std::string::npos || number > (UINT64_MAX >> shift)) {
+        return std::nullopt;
+    }
+
+    return number << shift;
+}
+
+std::string Compiler::describe_byte_size(uint64_t bytes)
+{
+    static const char *const units[] = { "KiB", "MiB", "GiB", "TiB" };
+
+    if (bytes < 1024) {
+        return fmt::format("{} byte{}", bytes, bytes == 1 ? "" : "s");
+    }
+
+    double scaled = static_cast<double>(bytes) / 1024.0;
+    size_t unit = 0;
+
+    while (scaled >= 1024.0 && unit + 1 < std::size(units)) {
+        scaled /= 1024.0;
+        unit++;
+    }
+
+    return scaled < 10.0
+        ? fmt::format("{:.1f} {}", scaled, units[unit])
+        : fmt::format("{:.0f} {}", scaled, units[unit]);
+}
+
+Compiler::SharedStore::SharedStore(std::filesystem::path root, uint64_t capacity) :
+    _root(std::move(root)), _capacity(capacity)
+{
+}
+
+std::optional<Compiler::SharedStore> Compiler::SharedStore::from_environment(std::string *out_error)
+{
+    const char *root = std::getenv("ECO_CACHE_DIR");
+
+    if (root == nullptr || *root == '\0') {
+        return std::nullopt;
+    }
+
+    uint64_t capacity = k_default_shared_store_capacity;
+
+    if (const char *written = std::getenv("ECO_CACHE_MAX_SIZE"); written != nullptr && *written != '\0') {
+        if (const std::optional<uint64_t> parsed = parse_byte_size(written)) {
+            capacity = parsed.value();
+        }
+        else if (out_error != nullptr) {
+            *out_error = fmt::format(
+                "ECO_CACHE_MAX_SIZE='{}' is not a size - write one like '10G' or '512M'. The store is "
+                "being held to {} instead.", written, describe_byte_size(capacity));
+        }
+    }
+
+    // absolute now, so a build that changes directory later still means the same store
+    std::error_code ec;
+    std::filesystem::path absolute = std::filesystem::absolute(root, ec);
+
+    return SharedStore(ec ? std::filesystem::path(root) : absolute, capacity);
+}
+
+std::filesystem::path Compiler::SharedStore::object_path(const std::string &name) const
+{
+    return _root / "objects" / name;
+}
+
+bool Compiler::SharedStore::fetch(const std::string &name, const std::filesystem::path &destination) const
+{
+    const std::filesystem::path object = object_path(name);
+    std::error_code ec;
+
+    if (!std::filesystem::is_regular_file(object, ec)) {
+        return false;
+    }
+
+    const StoreLock lock(_root, /*exclusive=*/false, /*wait=*/true);
+
+    if (!lock.held() || !place(object, destination)) {
+        return false;
+    }
+
+    touch(object);
+    return true;
+}
+
+bool Compiler::SharedStore::publish(const std::string &name, const std::filesystem::path &source) const
+{
+    std::error_code ec;
+    std::filesystem::create_directories(_root / "objects", ec);
+    std::filesystem::create_directories(_root / "tmp", ec);
+
+    if (ec) {
+        return false;
+    }
+
+    const StoreLock lock(_root, /*exclusive=*/false, /*wait=*/true);
+
+    if (!lock.held()) {
+        return false;
+    }
+
+    const std::filesystem::path object = object_path(name);
+
+    // another project got here first, with the same bytes - the key says so
+    if (std::filesystem::is_regular_file(object, ec)) {
+        touch(object);
+        return true;
+    }
+
+    // staged in `tmp/` rather than beside the object, so a listing of `objects/` never holds a partial one
+    const std::filesystem::path staged = _root / "tmp" / name;
+
+    if (!place(source, staged)) {
+        return false;
+    }
+
+    std::filesystem::rename(staged, object, ec);
+
+    if (ec) {
+        std::filesystem::remove(staged, ec);
+        return false;
+    }
+
+    touch(object);
+    return true;
+}
+
+Compiler::SharedStore::Usage Compiler::SharedStore::usage() const
+{
+    Usage usage;
+
+    for (const StoredObject &object : list_objects(_root / "objects")) {
+        usage.objects++;
+        usage.bytes += object.bytes;
+    }
+
+    return usage;
+}
+
+Compiler::SharedStore::Pruned Compiler::SharedStore::prune(uint64_t capacity, bool dry_run) const
+{
+    Pruned pruned;
+
+    const StoreLock lock(_root, /*exclusive=*/true, /*wait=*/true);
+
+    std::vector<StoredObject> objects = list_objects(_root / "objects");
+
+    // oldest use first, and the name after that so two objects touched in one tick go in a stable order
+    std::sort(objects.begin(), objects.end(), [](const StoredObject &a, const StoredObject &b) {
+        return a.used != b.used ? a.used < b.used : a.path < b.path;
+    });
+
+    uint64_t total = 0;
+
+    for (const StoredObject &object : objects) {
+        total += object.bytes;
+    }
+
+    for (const StoredObject &object : objects) {
+        std::error_code ec;
+
+        if (total > capacity && (dry_run || std::filesystem::remove(object.path, ec))) {
+            total -= object.bytes;
+            pruned.removed.objects++;
+            pruned.removed.bytes += object.bytes;
+            continue;
+        }
+
+        pruned.kept.objects++;
+        pruned.kept.bytes += object.bytes;
+    }
+
+    if (!dry_run) {
+        const auto abandoned = std::filesystem::file_time_type::clock::now() - k_abandoned_after;
+
+        for (const StoredObject &staged : list_objects(_root / "tmp")) {
+            if (staged.used < abandoned) {
+                std::error_code ec;
+                std::filesystem::remove(staged.path, ec);
+            }
+        }
+
+        std::ofstream(_root / "pruned", std::ios::app);
+        touch(_root / "pruned");
+    }
+
+    return pruned;
+}
+
+void Compiler::SharedStore::prune_if_due() const
+{
+    const std::filesystem::path stamp = _root / "pruned";
+    std::error_code ec;
+
+    const std::filesystem::file_time_type last = std::filesystem::last_write_time(stamp, ec);
+
+    if (!ec && std::filesystem::file_time_type::clock::now() - last < k_prune_interval) {
+        return;
+    }
+
+    // the stamp first, so the builds that finish in the next second do not all line up behind this one
+    std::ofstream(stamp, std::ios::app);
+    touch(stamp);
+
+    // a prune somebody else is already running is this one done for them
+    {
+        const StoreLock probe(_root, /*exclusive=*/true, /*wait=*/false);
+
+        if (!probe.held()) {
+            return;
+        }
+    }
+
+    prune(_capacity, /*dry_run=*/false);
+}
@@ -346,7 +346,7 @@ bool LexerFunction::CharToken::parse(TokenCollection &tokens, LexerCursor &curso
         return false;
     }
 
-    tokens.push(std::string(1, lit), type, cursor.line, cursor.char_offset);
+    tokens.push(std::string_view(&lit, 1), type, cursor.line, cursor.char_offset);
     cursor.skip();
     return true;
 }
@@ -479,24 +479,31 @@ bool LexerFunction::StringLiteral::holds_a_hole(const LexerCursor &cursor, char
 {
     // from the opening quote, under the same escape rule the verbatim scan uses - so `"a\"{$x}"`
     // finds the hole and `"a" . "b"` does not go looking past the first literal's end
-    auto it = cursor.current() + 1;
-    const auto end = cursor.end();
+    //
+    // only the three bytes that can change the answer are looked at one by one; the runs between them are
+    // skipped by LexerScan, which for an ordinary literal is the whole of it in one or two steps
+    const char *it = cursor.scan_begin() + 1;
+    const char *end = cursor.scan_end();
+
+    while (true) {
+        it = LexerScan::find_any_of(it, end, quote, '\\', '{');
+
+        if (it == end || *it == quote) {
+            return false;
+        }
 
-    while (it != end && *it != quote) {
         if (*it == '\\') {
             it++;
             if (it == end) {
-                break;
+                return false;
             }
         }
-        else if (*it == '{' && (it + 1) != end && *(it + 1) == '$') {
+        else if ((it + 1) != end && *(it + 1) == '$') {
             return true;
         }
 
         it++;
     }
-
-    return false;
 }
 
 void LexerFunction::StringLiteral::lex_verbatim(TokenCollection &tokens, LexerCursor &cursor, char quote) const
@@ -508,6 +515,9 @@ void LexerFunction::StringLiteral::lex_verbatim(TokenCollection &tokens, LexerCu
     cursor.skip();
 
     while (true) {
+        // straight to the next byte that ends the literal or escapes one, newlines and all
+        cursor.skip_until_any_of(quote, '\\', quote);
+
         if (cursor.is_eof()) {
             const auto sample = cursor.get_code_sample(start, 20);
             throw Lexer::UnterminatedStringException(sample, string_start_line, string_start_offset);
@@ -518,14 +528,12 @@ void LexerFunction::StringLiteral::lex_verbatim(TokenCollection &tokens, LexerCu
             break;
         }
 
-        if (cursor.peek() == '\\') {
-            cursor.skip();
-        }
-
+        // the backslash, and whatever it escapes
+        cursor.skip();
         cursor.skip();
     }
 
-    tokens.push(std::string(start, cursor.current()), Token::Type::t_string_literal, string_start_line, string_start_offset);
+    tokens.push(cursor.since(start), Token::Type::t_string_literal, string_start_line, string_start_offset);
 }
 
 void LexerFunction::StringLiteral::lex_hole(TokenCollection &tokens, LexerCursor &cursor) const
@@ -629,6 +637,14 @@ bool LexerFunction::StringLiteral::parse(TokenCollection &tokens, LexerCursor &c
     size_t chunk_offset = string_start_offset;
 
     while (true) {
+        // the plain text up to the next byte that could mean something, taken as one run
+        const char *run = cursor.scan_begin();
+        const size_t plain = static_cast<size_t>(
+            LexerScan::find_any_of(run, cursor.scan_end(), quote, '{', '\\') - run);
+
+        chunk.append(run, plain);
+        cursor.skip_over(plain);
+
         if (cursor.is_eof()) {
             const auto sample = cursor.get_code_sample(start, 20);
             throw Lexer::UnterminatedStringException(sample, string_start_line, string_start_offset);
@@ -694,7 +710,7 @@ bool LexerFunction::VariableName::parse(TokenCollection &tokens, LexerCursor &cu
         cursor.skip();
     }
 
-    tokens.push(std::string(start, cursor.current()), Token::Type::t_varname, cursor.line, start_col);
+    tokens.push(cursor.since(start), Token::Type::t_varname, cursor.line, start_col);
     return true;
 }
 
@@ -812,7 +828,14 @@ bool LexerFunction::MultiLineComment::parse(TokenCollection &tokens, LexerCursor
 
     cursor.skip(2);
 
-    while (!cursor.is_eof()) {
+    // from one `*` to the next, so the body of the comment is crossed a run at a time
+    while (true) {
+        cursor.skip_until('*');
+
+        if (cursor.is_eof()) {
+            break;
+        }
+
         if (cursor.begins_with("*/")) {
             cursor.skip(2);
             return true;
@@ -852,6 +875,6 @@ bool LexerFunction::Identifier::parse(TokenCollection &tokens, LexerCursor &curs
         return false;
     }
 
-    tokens.push(std::string(start, cursor.current()), Token::Type::t_identifier, start_line, start_offset);
+    tokens.push(cursor.since(start), Token::Type::t_identifier, start_line, start_offset);
     return true;
 }
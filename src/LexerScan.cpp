@@ -0,0 +1,303 @@
+#include "LexerScan.h"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ECO_LEXER_SCAN_X86 1
+#else
+#define ECO_LEXER_SCAN_X86 0
+#endif
+
+namespace
+{
+    inline bool is_formatting(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n';
+    }
+
+    // --- portable ---
+    // ------------------------------------------------------------------------
+    // the reference every other level is held against, and what every level falls back to for the tail
+    // of a range shorter than one vector
+
+    size_t formatting_run_portable(const char *begin, const char *end)
+    {
+        const char *p = begin;
+
+        while (p != end && is_formatting(*p)) {
+            p++;
+        }
+
+        return static_cast<size_t>(p - begin);
+    }
+
+    const char *find_any_of_portable(const char *begin, const char *end, char a, char b, char c)
+    {
+        for (const char *p = begin; p != end; p++) {
+            if (*p == a || *p == b || *p == c) {
+                return p;
+            }
+        }
+
+        return end;
+    }
+
+    size_t count_byte_portable(const char *begin, const char *end, char c)
+    {
+        size_t count = 0;
+
+        for (const char *p = begin; p != end; p++) {
+            count += *p == c;
+        }
+
+        return count;
+    }
+
+#if ECO_LEXER_SCAN_X86
+
+    // --- SSE2 ---
+    // ------------------------------------------------------------------------
+    // the x86-64 baseline, so there is nothing to detect: a 64-bit build always has it
+
+    __attribute__((target("sse2")))
+    inline unsigned formatting_mask_16(const char *p)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+            _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+
+        return static_cast<unsigned>(_mm_movemask_epi8(hit));
+    }
+
+    __attribute__((target("sse2")))
+    size_t formatting_run_sse2(const char *begin, const char *end)
+    {
+        const char *p = begin;
+
+        for (; end - p >= 16; p += 16) {
+            const unsigned miss = ~formatting_mask_16(p) & 0xFFFFu;
+
+            if (miss != 0) {
+                return static_cast<size_t>(p - begin) + __builtin_ctz(miss);
+            }
+        }
+
+        return static_cast<size_t>(p - begin) + formatting_run_portable(p, end);
+    }
+
+    __attribute__((target("sse2")))
+    const char *find_any_of_sse2(const char *begin, const char *end, char a, char b, char c)
+    {
+        const __m128i va = _mm_set1_epi8(a);
+        const __m128i vb = _mm_set1_epi8(b);
+        const __m128i vc = _mm_set1_epi8(c);
+
+        const char *p = begin;
+
+        for (; end - p >= 16; p += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            const __m128i hit = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)), _mm_cmpeq_epi8(v, vc));
+            const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+
+            if (mask != 0) {
+                return p + __builtin_ctz(mask);
+            }
+        }
+
+        return find_any_of_portable(p, end, a, b, c);
+    }
+
+    __attribute__((target("sse2")))
+    size_t count_byte_sse2(const char *begin, const char *end, char c)
+    {
+        const __m128i vc = _mm_set1_epi8(c);
+
+        const char *p = begin;
+        size_t count = 0;
+
+        for (; end - p >= 16; p += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            count += __builtin_popcount(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, vc))));
+        }
+
+        return count + count_byte_portable(p, end, c);
+    }
+
+    // --- AVX2 ---
+    // ------------------------------------------------------------------------
+    // the same three loops twice as wide. compiled for AVX2 per function rather than per file, so the
+    // rest of the compiler keeps whatever baseline it was built for
+
+    __attribute__((target("avx2")))
+    size_t formatting_run_avx2(const char *begin, const char *end)
+    {
+        const __m256i space = _mm256_set1_epi8(' ');
+        const __m256i tab = _mm256_set1_epi8('\t');
+        const __m256i newline = _mm256_set1_epi8('\n');
+
+        const char *p = begin;
+
+        for (; end - p >= 32; p += 32) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            const __m256i hit = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab)),
+                _mm256_cmpeq_epi8(v, newline));
+            const unsigned miss = ~static_cast<unsigned>(_mm256_movemask_epi8(hit));
+
+            if (miss != 0) {
+                return static_cast<size_t>(p - begin) + __builtin_ctz(miss);
+            }
+        }
+
+        return static_cast<size_t>(p - begin) + formatting_run_sse2(p, end);
+    }
+
+    __attribute__((target("avx2")))
+    const char *find_any_of_avx2(const char *begin, const char *end, char a, char b, char c)
+    {
+        const __m256i va = _mm256_set1_epi8(a);
+        const __m256i vb = _mm256_set1_epi8(b);
+        const __m256i vc = _mm256_set1_epi8(c);
+
+        const char *p = begin;
+
+        for (; end - p >= 32; p += 32) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            const __m256i hit = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, va), _mm256_cmpeq_epi8(v, vb)),
+                _mm256_cmpeq_epi8(v, vc));
+            const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+
+            if (mask != 0) {
+                return p + __builtin_ctz(mask);
+            }
+        }
+
+        return find_any_of_sse2(p, end, a, b, c);
+    }
+
+    __attribute__((target("avx2")))
+    size_t count_byte_avx2(const char *begin, const char *end, char c)
+    {
+        const __m256i vc = _mm256_set1_epi8(c);
+
+        const char *p = begin;
+        size_t count = 0;
+
+        for (; end - p >= 32; p += 32) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            count += __builtin_popcount(
+                static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, vc))));
+        }
+
+        return count + count_byte_sse2(p, end, c);
+    }
+
+#endif
+
+    LexerScan::Level detect()
+    {
+#if ECO_LEXER_SCAN_X86
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx2")) {
+            return LexerScan::Level::t_avx2;
+        }
+
+        if (__builtin_cpu_supports("sse2")) {
+            return LexerScan::Level::t_sse2;
+        }
+#endif
+
+        return LexerScan::Level::t_portable;
+    }
+
+    // **an atomic and not a table of function pointers**, so lowering the level for a benchmark is one
+    // store and a scan in flight on another thread reads one level or the other, never half of each.
+    // A relaxed load and a switch is noise beside a 16-byte compare
+    std::atomic<LexerScan::Level> &active()
+    {
+        static std::atomic<LexerScan::Level> level{ LexerScan::detected_level() };
+        return level;
+    }
+};
+
+LexerScan::Level LexerScan::detected_level()
+{
+    static const Level detected = detect();
+    return detected;
+}
+
+LexerScan::Level LexerScan::active_level()
+{
+    return active().load(std::memory_order_relaxed);
+}
+
+void LexerScan::use_level(Level level)
+{
+    active().store(level < detected_level() ? level : detected_level(), std::memory_order_relaxed);
+}
+
+const char *LexerScan::level_name(Level level)
+{
+    switch (level) {
+    case Level::t_portable:
+        return "portable";
+    case Level::t_sse2:
+        return "sse2";
+    case Level::t_avx2:
+        return "avx2";
+    }
+
+    return "";
+}
+
+size_t LexerScan::formatting_run(const char *begin, const char *end)
+{
+    switch (active_level()) {
+#if ECO_LEXER_SCAN_X86
+    case Level::t_avx2:
+        return formatting_run_avx2(begin, end);
+    case Level::t_sse2:
+        return formatting_run_sse2(begin, end);
+#endif
+    default:
+        return formatting_run_portable(begin, end);
+    }
+}
+
+const char *LexerScan::find_byte(const char *begin, const char *end, char c)
+{
+    return find_any_of(begin, end, c, c, c);
+}
+
+const char *LexerScan::find_any_of(const char *begin, const char *end, char a, char b, char c)
+{
+    switch (active_level()) {
+#if ECO_LEXER_SCAN_X86
+    case Level::t_avx2:
+        return find_any_of_avx2(begin, end, a, b, c);
+    case Level::t_sse2:
+        return find_any_of_sse2(begin, end, a, b, c);
+#endif
+    default:
+        return find_any_of_portable(begin, end, a, b, c);
+    }
+}
+
+size_t LexerScan::count_byte(const char *begin, const char *end, char c)
+{
+    switch (active_level()) {
+#if ECO_LEXER_SCAN_X86
+    case Level::t_avx2:
+        return count_byte_avx2(begin, end, c);
+    case Level::t_sse2:
+        return count_byte_sse2(begin, end, c);
+#endif
+    default:
+        return count_byte_portable(begin, end, c);
+    }
+}
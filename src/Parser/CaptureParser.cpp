@@ -254,7 +254,7 @@ bool Parser::parse_capture_list(
         cursor.skip();
 
         for (const AST::ClosureExprNode::Capture &already : captures) {
-            if (already.name.value() == name_token.value()) {
+            if (already.name.same_spelling(name_token)) {
                 payload.collector.collect_issue<AST::Issue::GenericError>(
                     payload.context.code_ref(name_token),
                     fmt::format("'{}' is already in this capture list", name_token.value()));
@@ -48,7 +48,7 @@ namespace
             return "";
         }
 
-        return tokens.token_values[index + 2];
+        return tokens.value_of(index + 2);
     }
 
     // the index one past the token closing the balanced `open ... close` group that starts at `index`, or
@@ -319,10 +319,10 @@ namespace
                 }
 
                 return fail(fmt::format(
-                    "'{}' is not a name a condition can test", tokens.token_values[cursor]));
+                    "'{}' is not a name a condition can test", tokens.value_of(cursor)));
             }
 
-            const std::string name = tokens.token_values[cursor];
+            const std::string name = tokens.value_of(cursor);
             cursor++;
 
             if (!TargetFacts::is_axis(name)) {
@@ -357,7 +357,7 @@ namespace
                 return fail(fmt::format("'{}' is compared against a bare name, not a literal", name));
             }
 
-            const std::string value = tokens.token_values[cursor];
+            const std::string value = tokens.value_of(cursor);
             cursor++;
 
             // **both halves of an axis test are checked**, by the type that owns the vocabulary:
@@ -401,7 +401,7 @@ namespace
         // answer is not the one written
         if (!evaluator.at_end()) {
             out_error = locate(directive.line, fmt::format(
-                "unexpected '{}' after the condition", tokens.token_values[evaluator.cursor]));
+                "unexpected '{}' after the condition", tokens.value_of(evaluator.cursor)));
             return false;
         }
 
@@ -503,7 +503,6 @@ bool Parser::filter_conditional_tokens(
                 for (size_t at = index; at < next; at++) {
                     if (write != at) {
                         tokens.tokens[write] = tokens.tokens[at];
-                        tokens.token_values[write] = std::move(tokens.token_values[at]);
                     }
 
                     write++;
@@ -589,9 +588,10 @@ bool Parser::filter_conditional_tokens(
 
     // `erase` rather than `resize`: Token has no default constructor, so a resize that could grow does not
     // compile - and this only ever shrinks, which is what makes erase-to-the-end the honest spelling
+    //
+    // the value table is left alone: a token carries its spelling's id, so moving the token moved the
+    // spelling with it, and a spelling only dropped tokens used costs a few bytes until the module goes
     tokens.tokens.erase(tokens.tokens.begin() + static_cast<std::ptrdiff_t>(write), tokens.tokens.end());
-    tokens.token_values.erase(
-        tokens.token_values.begin() + static_cast<std::ptrdiff_t>(write), tokens.token_values.end());
 
     return true;
 }
@@ -0,0 +1,525 @@
+#include "Parser/ManifestMemo.h"
+
+#include "Compiler/FileDigests.h"
+#include "Compiler/ModuleCache.h"
+#include "Compiler/SettledPath.h"
+
+#include "eco.h"
+
+#include <fmt/core.h>
+
+#include <charconv>
+#include <fstream>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+// the first line of a memo. A memo in any other shape is one nothing can be recalled from, which is the same
+// as having none
+constexpr std::string_view k_memo_header = "echoc-manifests 1";
+
+// **one record per line, every field length-prefixed**: `<tag> <n>:<bytes> <n>:<bytes>...`. A path may hold a
+// space and a define may hold anything, so a field is measured rather than delimited, and the reader never has
+// to guess where one ends
+void put(std::string &out, std::string_view tag, std::initializer_list<std::string_view> fields)
+{
+    out += tag;
+
+    for (std::string_view field : fields) {
+        out += fmt::format(" {}:", field.size());
+        out += field;
+    }
+
+    out += '\n';
+}
+
+struct Record
+{
+    std::string_view tag;
+    std::vector<std::string_view> fields;
+};
+
+// the next record off the front of `rest`. False on the first byte that is not the shape `put` writes
+bool next_record(std::string_view &rest, Record &out)
+{
+    const size_t tag_end = rest.find_first_of(" \n");
+
+    if (tag_end == std::string_view::npos || tag_end == 0) {
+        return false;
+    }
+
+    out.tag = rest.substr(0, tag_end);
+    out.fields.clear();
+    rest.remove_prefix(tag_end);
+
+    while (!rest.empty() && rest.front() == ' ') {
+        rest.remove_prefix(1);
+
+        size_t length = 0;
+        const auto parsed = std::from_chars(rest.data(), rest.data() + rest.size(), length);
+
+        if (parsed.ec != std::errc() || parsed.ptr == rest.data() + rest.size() || *parsed.ptr != ':') {
+            return false;
+        }
+
+        rest.remove_prefix(static_cast<size_t>(parsed.ptr - rest.data()) + 1);
+
+        if (length > rest.size()) {
+            return false;
+        }
+
+        out.fields.push_back(rest.substr(0, length));
+        rest.remove_prefix(length);
+    }
+
+    if (rest.empty() || rest.front() != '\n') {
+        return false;
+    }
+
+    rest.remove_prefix(1);
+    return true;
+}
+
+template <typename Number>
+bool read_number(std::string_view text, Number &out, int base = 10)
+{
+    const auto parsed = std::from_chars(text.data(), text.data() + text.size(), out, base);
+    return parsed.ec == std::errc() && parsed.ptr == text.data() + text.size();
+}
+
+template <typename Enum>
+std::string enum_field(Enum value)
+{
+    return std::to_string(static_cast<int>(value));
+}
+
+template <typename Enum>
+bool read_enum(std::string_view text, Enum &out)
+{
+    int value = 0;
+
+    if (!read_number(text, value)) {
+        return false;
+    }
+
+    out = static_cast<Enum>(value);
+    return true;
+}
+
+std::string time_field(std::filesystem::file_time_type time)
+{
+    return std::to_string(time.time_since_epoch().count());
+}
+
+// **the part a manifest and a target's scope share** - the same seven members under the same names, which is
+// the split every scoped attribute already makes in the reader. One template over both owners keeps the writer
+// and the reader below at one arm per field rather than two
+template <typename Scope>
+void put_scope(std::string &out, const Scope &scope)
+{
+    for (const std::filesystem::path &source : scope.sources) {
+        put(out, "source", { source.string() });
+    }
+
+    for (const std::filesystem::path &depend : scope.depends) {
+        put(out, "depend", { depend.string() });
+    }
+
+    for (const std::string &written : scope.sources_as_written) {
+        put(out, "source_written", { written });
+    }
+
+    for (const std::string &written : scope.depends_as_written) {
+        put(out, "depend_written", { written });
+    }
+
+    for (const Parser::ModuleRequirement &requirement : scope.requirements) {
+        put(out, "requirement", {
+            requirement.name, requirement.version, enum_field(requirement.source_kind), requirement.source,
+            requirement.rev });
+    }
+
+    for (const Compiler::LinkRequirement &requirement : scope.link) {
+        put(out, "link", {
+            enum_field(requirement.scheme), enum_field(requirement.linkage), enum_field(requirement.runtime),
+            requirement.value, requirement.declared_by, requirement.file.has_value() ? "1" : "0",
+            requirement.file.value_or("") });
+    }
+
+    put(out, "cc_module", { scope.cc.module_name });
+
+    for (const std::string &pattern : scope.cc.source_patterns) {
+        put(out, "cc_pattern", { pattern });
+    }
+
+    for (const std::filesystem::path &source : scope.cc.sources) {
+        put(out, "cc_source", { source.string() });
+    }
+
+    for (const std::filesystem::path &include : scope.cc.includes) {
+        put(out, "cc_include", { include.string() });
+    }
+
+    for (const std::string &define : scope.cc.defines) {
+        put(out, "cc_define", { define });
+    }
+
+    for (const std::string &flag : scope.cc.flags) {
+        put(out, "cc_flag", { flag });
+    }
+}
+
+// one record into whichever scope is open. False for a tag this is not the reader of, or a field count that is
+// not the one `put_scope` writes
+template <typename Scope>
+bool read_scope_record(const Record &record, Scope &scope)
+{
+    const std::vector<std::string_view> &f = record.fields;
+    const auto one = [&f](auto &into) {
+        if (f.size() != 1) {
+            return false;
+        }
+
+        into.emplace_back(f[0]);
+        return true;
+    };
+
+    if (record.tag == "source") {
+        return one(scope.sources);
+    }
+
+    if (record.tag == "depend") {
+        return one(scope.depends);
+    }
+
+    if (record.tag == "source_written") {
+        return one(scope.sources_as_written);
+    }
+
+    if (record.tag == "depend_written") {
+        return one(scope.depends_as_written);
+    }
+
+    if (record.tag == "requirement") {
+        Parser::ModuleRequirement requirement;
+
+        if (f.size() != 5 || !read_enum(f[2], requirement.source_kind)) {
+            return false;
+        }
+
+        requirement.name = f[0];
+        requirement.version = f[1];
+        requirement.source = f[3];
+        requirement.rev = f[4];
+        scope.requirements.push_back(std::move(requirement));
+        return true;
+    }
+
+    if (record.tag == "link") {
+        Compiler::LinkRequirement requirement;
+
+        if (f.size() != 7 || !read_enum(f[0], requirement.scheme) || !read_enum(f[1], requirement.linkage)
+            || !read_enum(f[2], requirement.runtime)) {
+            return false;
+        }
+
+        requirement.value = f[3];
+        requirement.declared_by = f[4];
+
+        if (f[5] == "1") {
+            requirement.file = std::string(f[6]);
+        }
+
+        scope.link.push_back(std::move(requirement));
+        return true;
+    }
+
+    if (record.tag == "cc_module" && f.size() == 1) {
+        scope.cc.module_name = f[0];
+        return true;
+    }
+
+    if (record.tag == "cc_pattern") {
+        return one(scope.cc.source_patterns);
+    }
+
+    if (record.tag == "cc_source") {
+        return one(scope.cc.sources);
+    }
+
+    if (record.tag == "cc_include") {
+        return one(scope.cc.includes);
+    }
+
+    if (record.tag == "cc_define") {
+        return one(scope.cc.defines);
+    }
+
+    if (record.tag == "cc_flag") {
+        return one(scope.cc.flags);
+    }
+
+    return false;
+}
+
+// what a recall compares a directory's stamp against: its mtime now, or the earliest time there is for one that
+// is not there - which is how GraphWitness stamped it
+std::filesystem::file_time_type modified_now(const std::filesystem::path &directory)
+{
+    std::error_code ec;
+    const std::filesystem::file_time_type modified = std::filesystem::last_write_time(directory, ec);
+
+    return ec ? std::filesystem::file_time_type::min() : modified;
+}
+
+};
+
+uint64_t Parser::manifest_graph_context(
+    const std::vector<std::filesystem::path> &roots,
+    const Compiler::TargetFacts &facts,
+    const std::filesystem::path &package_dir
+)
+{
+    // the reader's own version as well as the memo's shape: what a manifest *means* is this compiler's to
+    // decide, and a graph one echoc settled is not one the next is bound by
+    uint64_t context = Compiler::fnv1a64(std::string(k_memo_header), 0);
+    context = Compiler::fnv1a64(std::string(ECO_VERSION_STRING), context);
+    context = Compiler::fnv1a64(std::string(ECO_MODULE_CACHE_VERSION), context);
+
+    // in order, because the order is part of what a graph means - see resolve_module_graph - and settled to
+    // the path a manifest records as its own, so `-m lib` and `-m lib/module.eco` are one context
+    for (const std::filesystem::path &root : roots) {
+        const std::optional<std::filesystem::path> resolved = Parser::manifest_at(root);
+        const std::filesystem::path settled =
+            resolved.has_value() ? Compiler::canonical_or_absolute(resolved.value()) : root;
+
+        context = Compiler::fnv1a64("root=" + settled.string(), context);
+    }
+
+    context = Compiler::fnv1a64(facts.cache_signature(), context);
+    context = Compiler::fnv1a64("packages=" + package_dir.string(), context);
+
+    return context;
+}
+
+bool Parser::recall_manifest_graph(
+    const std::filesystem::path &memo,
+    uint64_t context,
+    std::vector<ModuleManifest> &out
+)
+{
+    if (memo.empty()) {
+        return false;
+    }
+
+    const std::optional<std::string> bytes = Compiler::read_whole_file(memo);
+
+    if (!bytes.has_value()) {
+        return false;
+    }
+
+    std::string_view rest = bytes.value();
+
+    if (rest.substr(0, k_memo_header.size()) != k_memo_header
+        || rest.substr(k_memo_header.size(), 1) != "\n") {
+        return false;
+    }
+
+    rest.remove_prefix(k_memo_header.size() + 1);
+
+    std::vector<ModuleManifest> graph;
+    ModuleTarget *target = nullptr;
+    bool context_matched = false;
+    bool ended = false;
+
+    Record record;
+
+    while (!ended && next_record(rest, record)) {
+        const std::vector<std::string_view> &f = record.fields;
+
+        if (record.tag == "context") {
+            uint64_t kept = 0;
+            context_matched = f.size() == 1 && read_number(f[0], kept, 16) && kept == context;
+
+            if (!context_matched) {
+                return false;
+            }
+        }
+        else if (record.tag == "manifest") {
+            uint64_t digest = 0;
+
+            if (f.size() != 6 || !read_number(f[1], digest, 16)) {
+                return false;
+            }
+
+            ModuleManifest manifest;
+            manifest.path = f[0];
+
+            // **the check, not a step before it**: the bytes are the only thing that says what this manifest
+            // declares, and Compiler::FileDigests answers for an untouched one with a stat
+            if (Compiler::FileDigests::instance().digest_of(manifest.path) != digest) {
+                return false;
+            }
+
+            manifest.directory = f[2];
+            manifest.name = f[3];
+            manifest.version = f[4];
+            manifest.build_dir = f[5];
+
+            graph.push_back(std::move(manifest));
+            target = nullptr;
+        }
+        else if (record.tag == "target" && !graph.empty()) {
+            ModuleTarget settled;
+
+            if (f.size() != 4 || !read_enum(f[1], settled.kind)) {
+                return false;
+            }
+
+            settled.name = f[0];
+            settled.has_scope = f[2] == "1";
+            settled.entry = f[3];
+
+            graph.back().targets.push_back(std::move(settled));
+            target = &graph.back().targets.back();
+        }
+        else if (record.tag == "group" && target != nullptr && f.size() == 1) {
+            target->groups.emplace_back(f[0]);
+        }
+        else if (record.tag == "file" && target != nullptr && f.size() == 1) {
+            target->files.emplace_back(f[0]);
+        }
+        else if (record.tag == "directory") {
+            int64_t modified = 0;
+
+            if (f.size() != 2 || !read_number(f[1], modified)) {
+                return false;
+            }
+
+            const std::filesystem::file_time_type kept{ std::filesystem::file_time_type::duration(modified) };
+
+            if (modified_now(std::filesystem::path(f[0])) != kept) {
+                return false;
+            }
+        }
+        else if (record.tag == "end") {
+            ended = true;
+        }
+        else if (graph.empty()
+            || !(target != nullptr ? read_scope_record(record, *target) : read_scope_record(record, graph.back()))) {
+            return false;
+        }
+    }
+
+    // **the end record is what says the rest was written**, so a memo cut short by a full disk is a miss rather
+    // than a graph missing its last modules
+    if (!ended || !context_matched || !rest.empty()) {
+        return false;
+    }
+
+    out = std::move(graph);
+    return true;
+}
+
+void Parser::remember_manifest_graph(
+    const std::filesystem::path &memo,
+    uint64_t context,
+    const std::vector<ModuleManifest> &graph,
+    const GraphWitness &witness,
+    std::chrono::nanoseconds settle
+)
+{
+    std::error_code ec;
+
+    if (memo.empty() || !witness.complete || !std::filesystem::is_directory(memo.parent_path(), ec)) {
+        return;
+    }
+
+    for (const auto &[directory, stamp] : witness.directories) {
+        if (!(stamp.modified + settle < stamp.stamped)) {
+            return;
+        }
+    }
+
+    std::string out;
+    out += k_memo_header;
+    out += '\n';
+
+    put(out, "context", { Compiler::to_hex(context) });
+
+    for (const ModuleManifest &manifest : graph) {
+        const auto digest = witness.manifests.find(manifest.path);
+
+        // a manifest this resolve did not read is one nothing here can vouch for, and tool attributes are
+        // what it does not write - see the header
+        if (digest == witness.manifests.end() || !manifest.tools.empty()) {
+            return;
+        }
+
+        put(out, "manifest", {
+            manifest.path.string(), Compiler::to_hex(digest->second), manifest.directory.string(), manifest.name,
+            manifest.version, manifest.build_dir.string() });
+
+        put_scope(out, manifest);
+
+        for (const ModuleTarget &target : manifest.targets) {
+            put(out, "target", {
+                target.name, enum_field(target.kind), target.has_scope ? "1" : "0", target.entry.string() });
+
+            for (const std::string &group : target.groups) {
+                put(out, "group", { group });
+            }
+
+            for (const std::filesystem::path &file : target.files) {
+                put(out, "file", { file.string() });
+            }
+
+            put_scope(out, target);
+        }
+    }
+
+    for (const auto &[directory, stamp] : witness.directories) {
+        put(out, "directory", { directory.string(), time_field(stamp.modified) });
+    }
+
+    put(out, "end", {});
+
+#if defined(__unix__) || defined(__APPLE__)
+    const long long process = static_cast<long long>(getpid());
+#else
+    const long long process = 0;
+#endif
+
+    // beside the memo and renamed over it, so two builds sharing a directory each leave a whole memo behind
+    // rather than one interleaved from both
+    const std::filesystem::path partial = memo.string() + fmt::format(".{}.partial", process);
+
+    {
+        std::ofstream file(partial, std::ios::binary | std::ios::trunc);
+
+        if (!file) {
+            return;
+        }
+
+        file << out;
+
+        if (!file.good()) {
+            file.close();
+            std::filesystem::remove(partial, ec);
+            return;
+        }
+    }
+
+    std::filesystem::rename(partial, memo, ec);
+
+    if (ec) {
+        std::filesystem::remove(partial, ec);
+    }
+}
@@ -1,6 +1,7 @@
 #include "Parser/ManifestParser.h"
 
 #include "Compiler/BuildLayout.h"
+#include "Compiler/FileDigests.h"
 #include "Compiler/LinkRequirement.h"
 #include "Compiler/PhaseTimings.h"
 #include "Compiler/SettledPath.h"
@@ -71,8 +72,12 @@ bool has_wildcard(std::string_view text)
 //
 // a leading dot is not matched, which is what glob does with `*` too - a dotfile beside the sources is not
 // one of them
+//
+// every directory it read goes into `witness`, when there is one - the walk's root and, under `**`, each one
+// below it, dot-directories included, because the iterator descends into those whether or not it keeps a file
+// from one
 std::optional<std::vector<std::filesystem::path>> expand_directory_pattern(
-    const std::filesystem::path &absolute_pattern, bool recursive)
+    const std::filesystem::path &absolute_pattern, bool recursive, Parser::GraphWitness *witness)
 {
     std::filesystem::path parent = absolute_pattern.parent_path();
     const std::string leaf = absolute_pattern.filename().string();
@@ -96,6 +101,12 @@ std::optional<std::vector<std::filesystem::path>> expand_directory_pattern(
 
     const std::string extension = (leaf == "*") ? std::string() : leaf.substr(1);
 
+    // the root is stamped even when it is not there, so the module that matched nothing yesterday is read
+    // again on the day it appears
+    if (witness != nullptr) {
+        witness->stamp_directory(parent);
+    }
+
     std::error_code ec;
     if (!std::filesystem::is_directory(parent, ec)) {
         return std::vector<std::filesystem::path>{};
@@ -106,6 +117,12 @@ std::optional<std::vector<std::filesystem::path>> expand_directory_pattern(
     const auto consider = [&](const std::filesystem::directory_entry &entry) {
         const std::string name = entry.path().filename().string();
 
+        std::error_code entry_ec;
+
+        if (witness != nullptr && recursive && entry.is_directory(entry_ec)) {
+            witness->stamp_directory(entry.path());
+        }
+
         if (name.empty() || name[0] == '.') {
             return;
         }
@@ -153,16 +170,37 @@ std::optional<std::filesystem::path> Parser::manifest_at(const std::filesystem::
         ? std::optional<std::filesystem::path>(target) : std::nullopt;
 }
 
-std::vector<std::filesystem::path> Parser::expand_source_pattern(const std::filesystem::path &pattern)
+void Parser::GraphWitness::stamp_directory(const std::filesystem::path &directory)
+{
+    const std::filesystem::file_time_type stamped = std::filesystem::file_time_type::clock::now();
+
+    std::error_code ec;
+    const std::filesystem::file_time_type modified = std::filesystem::last_write_time(directory, ec);
+
+    // the first stamp is the one taken before anything in the directory was read, so a second pattern over
+    // the same directory does not move it later. One that is not there stamps as the earliest time there is,
+    // which is what it will stat as until somebody creates it
+    directories.emplace(
+        directory, DirectoryStamp{ ec ? std::filesystem::file_time_type::min() : modified, stamped });
+}
+
+std::vector<std::filesystem::path> Parser::expand_source_pattern(
+    const std::filesystem::path &pattern,
+    Parser::GraphWitness *witness
+)
 {
     const std::string spelled = pattern.string();
     const bool recursive = spelled.find("**") != std::string::npos;
 
     if (std::optional<std::vector<std::filesystem::path>> walked =
-            expand_directory_pattern(pattern, recursive)) {
+            expand_directory_pattern(pattern, recursive, witness)) {
         return std::move(walked.value());
     }
 
+    if (witness != nullptr) {
+        witness->complete = false;
+    }
+
     return recursive ? glob::rglob(spelled) : glob::glob(spelled);
 }
 
@@ -174,6 +212,10 @@ struct ManifestReport
     AST::Collector &collector;
     AST::Module &module;
     AST::File *file;
+
+    // where the patterns this manifest expands say which directories they read. Carried here because the
+    // report is already threaded through every arm that expands one
+    Parser::GraphWitness *witness = nullptr;
 };
 
 template <typename Issue>
@@ -740,7 +782,8 @@ bool expand_manifest_patterns(
     for (const std::string &pattern : patterns) {
         size_t kept = 0;
 
-        for (const std::filesystem::path &match : Parser::expand_source_pattern(out.directory / pattern)) {
+        for (const std::filesystem::path &match :
+                Parser::expand_source_pattern(out.directory / pattern, into.witness)) {
             if (!std::filesystem::is_regular_file(match, ec)) {
                 continue;
             }
@@ -1046,7 +1089,7 @@ bool read_manifest_with(
 {
     AST::Module &module = scratch.fresh_module();
     AST::File &file = module.add_file(path);
-    const ManifestReport into{ scratch.bundle.collector, module, &file };
+    const ManifestReport into{ scratch.bundle.collector, module, &file, &scratch.witness };
 
     std::error_code ec;
     if (!std::filesystem::is_regular_file(path, ec)) {
@@ -1070,6 +1113,12 @@ bool read_manifest_with(
         return false;
     }
 
+    // the bytes this graph was made of, digested as Compiler::FileDigests digests a file - so recalling it
+    // later is a stat against that memo rather than a second reading of every manifest
+    if (read == Parser::ManifestRead::t_full && file.content.has_value()) {
+        scratch.witness.manifests[out.path] = Compiler::content_digest(file.content.value());
+    }
+
     Parser::ModuleParser &parser = scratch.parser;
 
     AST::TokenizedFile tokenized = parser.make_tokenized_file(module, file);
@@ -9,6 +9,7 @@
 #include "Parser/SymbolParser.h"
 
 #include "AST/ASTImport.h"
+#include "AST/ASTModuleEmbedder.h"
 
 #include <iostream>
 #include <fstream>
@@ -85,23 +86,38 @@ void Parser::ModuleParser::parse_file_from_mem(std::filesystem::path path, const
     // file.root = &Parser::parse_scope(payload);
 }
 
+AST::Module::TokenFilter Parser::ModuleParser::conditional_filter(const AST::Module &module) const
+{
+    return [facts = facts_for(module)](TokenCollection &tokens, size_t from, std::string &out_error) {
+        return Parser::filter_conditional_tokens(tokens, from, facts, out_error);
+    };
+}
+
 AST::TokenizedFile Parser::ModuleParser::make_tokenized_file(AST::Module &module, AST::File &file) const
 {
     // the conditional filter is handed *in* rather than called by Module::tokenize, so that AST knows only
     // that something may shorten the range before the slice is taken - see AST::Module::TokenFilter
-    const Compiler::TargetFacts facts = facts_for(module);
+    return module.tokenize(*_lexer.get(), file, conditional_filter(module));
+}
 
-    return module.tokenize(*_lexer.get(), file,
-        [&facts](TokenCollection &tokens, size_t from, std::string &out_error) {
-            return Parser::filter_conditional_tokens(tokens, from, facts, out_error);
-        });
+AST::TokenizedFile Parser::ModuleParser::lex_file(AST::Module &module, AST::File &file) const
+{
+#if ECO_DONT_CATCH_EXCEPTIONS
+    return make_tokenized_file(module, file);
+#else
+    try {
+        return make_tokenized_file(module, file);
+    }
+    catch (const Lexer::TokenException &e) {
+        throw TokenizationException(e, &file);
+    }
+#endif
 }
 
-void Parser::ModuleParser::parse_module(AST::Module &module, AST::Collector &collector) const
+std::vector<std::tuple<AST::File *, AST::TokenizedFile>> Parser::ModuleParser::lex_module(AST::Module &module) const
 {
-    // build all parser payloads
     std::vector<std::tuple<AST::File *, AST::TokenizedFile>> file_payloads;
-    {
+
     Compiler::ScopedPhase phase("lex");
     for (auto &file : module.files()) {
         // **the one loop that visits each file exactly once**, which is why "which file are we on" is
@@ -110,21 +126,91 @@ void Parser::ModuleParser::parse_module(AST::Module &module, AST::Collector &col
         // process-wide reporter from the parser exactly as the ScopedPhase above it does
         Compiler::ProgressReporter::instance().tick(file.get_path().filename().string());
 
-#if ECO_DONT_CATCH_EXCEPTIONS
-        auto tfile = make_tokenized_file(module, file);
-        file_payloads.push_back(std::make_tuple(&file, tfile));
-#else
-        try {
-            auto tfile = make_tokenized_file(module, file);
-            file_payloads.push_back(std::make_tuple(&file, tfile));
-        }
-        catch (const Lexer::TokenException &e) {
-            throw TokenizationException(e, &file);
+        file_payloads.push_back(std::make_tuple(&file, lex_file(module, file)));
+    }
+
+    return file_payloads;
+}
+
+void Parser::ModuleParser::parse_module(AST::Module &module, AST::Collector &collector) const
+{
+    parse_passes(module, collector, lex_module(module));
+}
+
+void Parser::ModuleParser::parse_embedded_module(
+    AST::Module &module,
+    AST::Collector &collector,
+    std::string_view blob
+) const
+{
+    std::vector<std::tuple<AST::File *, AST::TokenizedFile>> file_payloads;
+
+    {
+        Compiler::ScopedPhase phase("load embedded");
+        file_payloads = AST::load_embedded_module(module, blob, conditional_filter(module));
+    }
+
+    parse_passes(module, collector, file_payloads);
+}
+
+bool Parser::ModuleParser::load_tokens(const InputPayload &payload, LexedModule &out) const
+{
+    if (!payload.token_store.has_value()) {
+        return false;
+    }
+
+    std::vector<std::filesystem::path> sources;
+    sources.reserve(payload.files.size());
+
+    // **an in-memory file is never loaded from a store**: its content is whatever the caller handed in,
+    // which no key on disk was computed from
+    for (const InputFile &input : payload.files) {
+        if (input.content.has_value()) {
+            return false;
         }
-#endif
+
+        sources.push_back(input.path);
     }
+
+    switch (read_module_tokens(
+            payload.token_store->path, payload.token_store->key, sources, payload.module, out.files)) {
+    case TokenStoreRead::t_loaded:
+        out.store_use = TokenStoreUse::t_reused;
+        return true;
+    case TokenStoreRead::t_rejected:
+        out.store_use = TokenStoreUse::t_rejected;
+        return false;
+    case TokenStoreRead::t_absent:
+        break;
     }
 
+    return false;
+}
+
+void Parser::ModuleParser::store_tokens(const InputPayload &payload, LexedModule &lexed) const
+{
+    if (!payload.token_store.has_value()) {
+        return;
+    }
+
+    const TokenStore &store = *payload.token_store;
+
+    const bool stored = store.writable
+        && write_module_tokens(store.path, store.key, payload.module, lexed.files);
+
+    // a refused store that could be written again still says it was refused - that is the surprising
+    // half, and the one somebody reading `--explain cache` would want to know about
+    if (lexed.store_use != TokenStoreUse::t_rejected) {
+        lexed.store_use = stored ? TokenStoreUse::t_stored : TokenStoreUse::t_unwritable;
+    }
+}
+
+void Parser::ModuleParser::parse_passes(
+    AST::Module &module,
+    AST::Collector &collector,
+    const std::vector<std::tuple<AST::File *, AST::TokenizedFile>> &file_payloads
+) const
+{
     // three passes over the same tokens, each one only naming what the next one needs
     //
     // the split exists because a declaration can name anything the module declares, in any file and
@@ -175,20 +261,90 @@ void Parser::ModuleParser::parse_module(AST::Module &module, AST::Collector &col
     }
 }
 
-void Parser::ModuleParser::parse_input(const InputPayload &payload) const
+void Parser::ModuleParser::read_input(const InputPayload &payload) const
 {
+    for (const auto &input_file : payload.files) {
+        if (input_file.content.has_value()) {
+            parse_file_from_mem(input_file.path, input_file.content.value(), payload.module, payload.collector);
+        } else {
+            parse_file_from_disk(input_file.path, payload.module, payload.collector);
+        }
+    }
+}
+
+Parser::TokenStoreUse Parser::ModuleParser::parse_input(const InputPayload &payload) const
+{
+    LexedModule lexed;
+
+    if (payload.token_store.has_value()) {
+        bool loaded = false;
+
+        {
+            Compiler::ScopedPhase phase("load tokens");
+            loaded = load_tokens(payload, lexed);
+        }
+
+        if (loaded) {
+            parse_lexed_module(payload.module, payload.collector, lexed);
+            return lexed.store_use;
+        }
+    }
+
     {
         Compiler::ScopedPhase read_phase("read sources");
+        read_input(payload);
+    }
+
+    lexed.files = lex_module(payload.module);
+
+    // **between the lexer and pass 1**, which is the only moment the module's tokens are all the lexer's:
+    // every pass after this mints into the same collection
+    store_tokens(payload, lexed);
+
+    parse_passes(payload.module, payload.collector, lexed.files);
+
+    return lexed.store_use;
+}
+
+Parser::ModuleParser::LexedModule Parser::ModuleParser::read_and_lex_input(const InputPayload &payload) const
+{
+    LexedModule lexed;
+
+    // everything, not only the two exceptions handle_parse renders: this runs on a worker, where anything
+    // escaping would terminate the process rather than reach whoever is waiting for the module
+    try {
+        if (load_tokens(payload, lexed)) {
+            return lexed;
+        }
+
+        read_input(payload);
 
-        for (const auto &input_file : payload.files) {
-            if (input_file.content.has_value()) {
-                parse_file_from_mem(input_file.path, input_file.content.value(), payload.module, payload.collector);
-            } else {
-                parse_file_from_disk(input_file.path, payload.module, payload.collector);
-            }
+        for (auto &file : payload.module.files()) {
+            lexed.files.push_back(std::make_tuple(&file, lex_file(payload.module, file)));
         }
+
+        store_tokens(payload, lexed);
+    }
+    catch (...) {
+        lexed.error = std::current_exception();
     }
 
+    return lexed;
+}
+
+void Parser::ModuleParser::parse_lexed_module(
+    AST::Module &module,
+    AST::Collector &collector,
+    const LexedModule &lexed
+) const
+{
+    if (lexed.error) {
+        std::rethrow_exception(lexed.error);
+    }
+
+    for (const auto &[file, tfile] : lexed.files) {
+        Compiler::ProgressReporter::instance().tick(file->get_path().filename().string());
+    }
 
-    parse_module(payload.module, payload.collector);
+    parse_passes(module, collector, lexed.files);
 }
@@ -0,0 +1,378 @@
+#include "Parser/ModuleTokens.h"
+
+#include "Compiler/ModuleCache.h"
+#include "eco.h"
+
+#include <unistd.h>
+
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+    // what the file opens with. The version follows it, so a file from another format reads as rejected
+    // rather than as a truncated one
+    constexpr std::string_view k_magic = "ECOTOKNS";
+
+    // type, minted, line, column, spelling, file
+    constexpr size_t k_token_record_size = 1 + 1 + 4 + 4 + 4 + 4;
+
+    // **little-endian whatever the host is**, written a byte at a time. A token store is never carried to
+    // another machine - the key folds in the triple - but a store that is only valid because of where it
+    // happens to be read is one assumption more than this needs
+    void put_u32(std::string &out, uint32_t value)
+    {
+        for (int i = 0; i < 4; i++) {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    void put_u64(std::string &out, uint64_t value)
+    {
+        for (int i = 0; i < 8; i++) {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    void put_bytes(std::string &out, std::string_view bytes)
+    {
+        put_u64(out, bytes.size());
+        out.append(bytes);
+    }
+
+    // the other direction, bounds-checked on every read. **one failed read fails every read after it**, so
+    // a decoder can run to the end and ask once rather than checking each field
+    class TokenStoreReader
+    {
+    public:
+        explicit TokenStoreReader(std::string_view bytes) : _bytes(bytes) {}
+
+        bool ok() const { return _ok; }
+        bool at_end() const { return _at == _bytes.size(); }
+
+        uint8_t u8()
+        {
+            if (!has(1)) {
+                return 0;
+            }
+
+            return static_cast<uint8_t>(_bytes[_at++]);
+        }
+
+        uint32_t u32()
+        {
+            if (!has(4)) {
+                return 0;
+            }
+
+            uint32_t value = 0;
+            for (int i = 0; i < 4; i++) {
+                value |= static_cast<uint32_t>(static_cast<uint8_t>(_bytes[_at++])) << (8 * i);
+            }
+
+            return value;
+        }
+
+        uint64_t u64()
+        {
+            if (!has(8)) {
+                return 0;
+            }
+
+            uint64_t value = 0;
+            for (int i = 0; i < 8; i++) {
+                value |= static_cast<uint64_t>(static_cast<uint8_t>(_bytes[_at++])) << (8 * i);
+            }
+
+            return value;
+        }
+
+        std::string_view raw(size_t length)
+        {
+            if (!has(length)) {
+                return {};
+            }
+
+            std::string_view view = _bytes.substr(_at, length);
+            _at += length;
+
+            return view;
+        }
+
+        std::string_view bytes()
+        {
+            const uint64_t length = u64();
+            return raw(static_cast<size_t>(length));
+        }
+
+    private:
+        std::string_view _bytes;
+        size_t _at = 0;
+        bool _ok = true;
+
+        bool has(uint64_t length)
+        {
+            if (!_ok || length > _bytes.size() - _at) {
+                _ok = false;
+            }
+
+            return _ok;
+        }
+    };
+
+    // one file as the store holds it, before the module has anything in it
+    struct StoredFile
+    {
+        std::string_view name;
+        std::string_view content;
+        uint64_t start = 0;
+        uint64_t end = 0;
+    };
+};
+
+const char *Parser::describe(TokenStoreUse use)
+{
+    switch (use) {
+    case TokenStoreUse::t_none:
+        return "not stored";
+    case TokenStoreUse::t_reused:
+        return "reused";
+    case TokenStoreUse::t_stored:
+        return "read from source, stored for next time";
+    case TokenStoreUse::t_unwritable:
+        return "read from source (its cache directory is not writable)";
+    case TokenStoreUse::t_rejected:
+        return "read from source (the stored one did not read back), stored again";
+    }
+
+    return "";
+}
+
+bool Parser::write_module_tokens(
+    const std::filesystem::path &path,
+    const std::string &key,
+    AST::Module &module,
+    const LexedFiles &files)
+{
+    const TokenCollection &tokens = module.tokens;
+
+    std::string out;
+    out.reserve(tokens.size() * k_token_record_size + 4096);
+
+    out.append(k_magic);
+    put_u32(out, ECO_MODULE_TOKENS_VERSION);
+    put_bytes(out, key);
+
+    // a token names its file by position in this list, 0 being none
+    std::unordered_map<const AST::File *, uint32_t> file_numbers;
+
+    put_u32(out, static_cast<uint32_t>(files.size()));
+
+    for (const auto &[file, tfile] : files) {
+        if (!file->content.has_value()) {
+            return false;
+        }
+
+        file_numbers.emplace(file, static_cast<uint32_t>(file_numbers.size() + 1));
+
+        put_bytes(out, file->get_path().filename().string());
+        put_bytes(out, file->content.value());
+        put_u64(out, tfile.token_slice.start_index);
+        put_u64(out, tfile.token_slice.end_index);
+    }
+
+    put_u32(out, static_cast<uint32_t>(tokens.values.size()));
+
+    for (size_t i = 0; i < tokens.values.size(); i++) {
+        put_bytes(out, tokens.values[static_cast<uint32_t>(i)]);
+    }
+
+    put_u64(out, tokens.size());
+
+    for (const Token &token : tokens.tokens) {
+        uint32_t file_number = 0;
+
+        if (token.file != nullptr) {
+            auto found = file_numbers.find(token.file);
+
+            // a file this module does not hold cannot be written down, and guessing would be a token
+            // pointing at the wrong source after a reload
+            if (found == file_numbers.end()) {
+                return false;
+            }
+
+            file_number = found->second;
+        }
+
+        out.push_back(static_cast<char>(token.type));
+        out.push_back(static_cast<char>(token.minted ? 1 : 0));
+        put_u32(out, token.line);
+        put_u32(out, token.char_offset);
+        put_u32(out, token.value_id);
+        put_u32(out, file_number);
+    }
+
+    std::filesystem::path partial = path;
+    partial += ".partial-" + std::to_string(getpid());
+
+    {
+        std::ofstream stream(partial, std::ios::binary | std::ios::trunc);
+        if (!stream) {
+            return false;
+        }
+
+        stream.write(out.data(), static_cast<std::streamsize>(out.size()));
+
+        if (!stream.good()) {
+            stream.close();
+
+            std::error_code ec;
+            std::filesystem::remove(partial, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(partial, path, ec);
+
+    if (ec) {
+        std::filesystem::remove(partial, ec);
+        return false;
+    }
+
+    return true;
+}
+
+Parser::TokenStoreRead Parser::read_module_tokens(
+    const std::filesystem::path &path,
+    const std::string &key,
+    const std::vector<std::filesystem::path> &sources,
+    AST::Module &module,
+    LexedFiles &out_files)
+{
+    assert(module.tokens.size() == 0);
+    assert(module.files().first() == nullptr);
+
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(path, ec)) {
+        return TokenStoreRead::t_absent;
+    }
+
+    const std::optional<std::string> stored = Compiler::read_whole_file(path);
+    if (!stored.has_value()) {
+        return TokenStoreRead::t_rejected;
+    }
+
+    TokenStoreReader in(stored.value());
+
+    if (in.raw(k_magic.size()) != k_magic
+        || in.u32() != ECO_MODULE_TOKENS_VERSION
+        || in.bytes() != key) {
+        return TokenStoreRead::t_rejected;
+    }
+
+    // one per source, named alike and in the same order. The key already says the content agrees; this is
+    // what catches a store written by something that disagrees with this reader about the file list
+    const uint32_t file_count = in.u32();
+
+    if (!in.ok() || file_count != sources.size()) {
+        return TokenStoreRead::t_rejected;
+    }
+
+    std::vector<StoredFile> files(file_count);
+
+    for (size_t i = 0; i < files.size(); i++) {
+        files[i].name = in.bytes();
+        files[i].content = in.bytes();
+        files[i].start = in.u64();
+        files[i].end = in.u64();
+
+        if (!in.ok() || files[i].name != sources[i].filename().string()) {
+            return TokenStoreRead::t_rejected;
+        }
+    }
+
+    // **into a collection of our own first**, so a store that fails halfway leaves the module untouched.
+    // A fresh table hands out ids in the order it is asked, which is the order they were written in - so a
+    // spelling that comes back with another id is a duplicate, which no table ever wrote
+    TokenCollection tokens;
+
+    const uint32_t value_count = in.u32();
+
+    for (uint32_t i = 0; i < value_count && in.ok(); i++) {
+        if (tokens.values.intern(in.bytes()) != i) {
+            return TokenStoreRead::t_rejected;
+        }
+    }
+
+    const uint64_t token_count = in.u64();
+
+    // a count the rest of the file could not possibly hold is refused before it is reserved
+    if (!in.ok() || token_count > stored->size() / k_token_record_size) {
+        return TokenStoreRead::t_rejected;
+    }
+
+    tokens.tokens.reserve(static_cast<size_t>(token_count));
+
+    std::vector<uint32_t> file_numbers;
+    file_numbers.reserve(static_cast<size_t>(token_count));
+
+    for (uint64_t i = 0; i < token_count; i++) {
+        const uint8_t type = in.u8();
+        const uint8_t minted = in.u8();
+        const uint32_t line = in.u32();
+        const uint32_t char_offset = in.u32();
+        const uint32_t value_id = in.u32();
+        const uint32_t file_number = in.u32();
+
+        if (!in.ok()
+            || type > static_cast<uint8_t>(Token::Type::t_unknown)
+            || minted > 1
+            || value_id >= value_count
+            || file_number > files.size()) {
+            return TokenStoreRead::t_rejected;
+        }
+
+        tokens.tokens.emplace_back(
+            static_cast<Token::Type>(type), line, char_offset, value_id, nullptr, minted == 1);
+        file_numbers.push_back(file_number);
+    }
+
+    if (!in.at_end()) {
+        return TokenStoreRead::t_rejected;
+    }
+
+    for (const StoredFile &file : files) {
+        if (file.start > file.end || file.end > token_count) {
+            return TokenStoreRead::t_rejected;
+        }
+    }
+
+    // everything checked. From here on nothing can refuse, so the module is filled in one go
+    module.tokens = std::move(tokens);
+
+    std::vector<AST::File *> module_files;
+    module_files.reserve(files.size());
+
+    for (size_t i = 0; i < files.size(); i++) {
+        AST::File &file = module.add_file(sources[i]);
+        file.set_content(files[i].content.data(), files[i].content.size());
+        module_files.push_back(&file);
+    }
+
+    for (size_t i = 0; i < file_numbers.size(); i++) {
+        if (file_numbers[i] != 0) {
+            module.tokens.tokens[i].file = module_files[file_numbers[i] - 1];
+        }
+    }
+
+    for (size_t i = 0; i < files.size(); i++) {
+        out_files.push_back(std::make_tuple(
+            module_files[i],
+            module.adopt_tokenized_file(
+                *module_files[i], static_cast<size_t>(files[i].start), static_cast<size_t>(files[i].end))));
+    }
+
+    return TokenStoreRead::t_loaded;
+}
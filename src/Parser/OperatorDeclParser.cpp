@@ -65,7 +65,7 @@ namespace
             default:
                 // every arithmetic, bitwise and comparison token. the parentheses are in there too,
                 // but is_structural_token has already stopped the run on those
-                return Token(type, 0, 0).is_operator_type();
+                return Token(type, 0, 0, 0).is_operator_type();
         }
     }
 
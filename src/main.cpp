@@ -20,6 +20,7 @@
 #include "AST/ASTTypeChecker.h"
 #include "AST/ASTMangler.h"
 #include "AST/FunctionDeclNode.h"
+#include "Parser/ManifestMemo.h"
 #include "Parser/ManifestParser.h"
 #include "Parser/ModuleParser.h"
 #include "Compiler/BuildLayout.h"
@@ -27,13 +28,17 @@
 #include "Compiler/CommandLine.h"
 #include "Compiler/CommandLineHelp.h"
 #include "Compiler/CommandLineOption.h"
+#include "Compiler/CompileServer.h"
 #include "Compiler/DriverOptions.h"
+#include "Compiler/FileDigests.h"
+#include "Compiler/FileWatcher.h"
 #include "Compiler/CompilerException.h"
 #include "Compiler/LinkRequirement.h"
 #include "Compiler/ModuleCache.h"
 #include "Compiler/PhaseTimings.h"
 #include "Compiler/ProgressReporter.h"
 #include "Compiler/SettledPath.h"
+#include "Compiler/SharedStore.h"
 #include "Compiler/TargetSubtarget.h"
 #include "Compiler/TestReporter.h"
 #include "Compiler/TestRunner.h"
@@ -47,12 +52,21 @@
 #include "stdlib_embedded.h"
 #endif
 
+#include <sys/wait.h>
 #include <unistd.h>
 
+// the environment a served compile was handed - see main_serve
+extern char **environ;
+
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <functional>
 #include <map>
 #include <set>
 #include <chrono>
+#include <thread>
 
 // the files an argument names, expanding wildcards. `missing` counts the paths that were named
 // literally and are not there - a caller has to refuse those rather than compile what is left, since
@@ -96,10 +110,10 @@ std::vector<std::filesystem::path> get_file_list_from_args(
     return files;
 }
 
-int handle_parse(
-    const AST::DiagnosticRenderer &diagnostics,
-    Parser::ModuleParser &parser,
-    Parser::ModuleParser::InputPayload &input)
+// the two refusals a parse can end in, rendered. One wrapper around whichever half of the parse is being run,
+// so the serial path and the parallel one cannot come to disagree about what either failure reads as
+template <typename ParseFn>
+static int guard_parse(const AST::DiagnosticRenderer &diagnostics, ParseFn &&parse)
 {
     // **caught whatever ECO_DONT_CATCH_EXCEPTIONS says**, unlike the tokenization error inside. That macro
     // exists to let a *compiler bug* crash with a stack trace, and a malformed `#[if: ...]` is not one - it
@@ -109,7 +123,7 @@ int handle_parse(
     // other thing Parser::filter_conditional_tokens decides: a test block is a region compiled under one
     // condition, and the filter has to read its header to know where the region it is dropping ends
     try {
-        parser.parse_input(input);
+        parse();
     }
     catch (AST::Module::TokenFilterException &e) {
         diagnostics.render_untyped("Conditional Compilation Failed", e.what());
@@ -125,9 +139,17 @@ int handle_parse(
     return 0;
 }
 
+int handle_parse(
+    const AST::DiagnosticRenderer &diagnostics,
+    Parser::ModuleParser &parser,
+    Parser::ModuleParser::InputPayload &input)
+{
+    return guard_parse(diagnostics, [&parser, &input] { parser.parse_input(input); });
+}
+
 // the standard library, when it is embedded in the binary rather than read from disk. This is the one
 // module that cannot come from a manifest, because there is no file list to read - the sources *are* the
-// bytes the generated header carries
+// bytes the generated header carries, together with the tokens they lexed to when it was generated
 //
 // leaving the standard library out is leaving one module out, nothing more - nothing downstream
 // looks a module up by that name, codegen only ever asks for ECO_MAIN_MODULE_NAME, and the core
@@ -141,8 +163,8 @@ static void parse_embedded_stdlib_module(AST::Bundle &bundle, Parser::ModulePars
     AST::module_handle_t stdlib_handle = bundle.modules.add_module("stdlib");
     auto &stdlib = bundle.modules.get_module(stdlib_handle);
 
-    EmbeddedModule::load_stdlib_module(bundle, stdlib);
-    parser.parse_module(stdlib, bundle.collector);
+    // already lexed when the header was generated - what is left is the filter and the three passes
+    parser.parse_embedded_module(stdlib, bundle.collector, EmbeddedModule::stdlib_module_blob());
 }
 #endif
 
@@ -192,6 +214,30 @@ static bool resolve_target_facts(
     return true;
 }
 
+// where the graph rooted at `root` is remembered, which is a question about a manifest nobody has read yet: the
+// build directory is the entry module's, and a `#[build_dir:]` or the module's name under `--build-dir` decide
+// where that is. So the root alone is read as written - its attributes and nothing they name, the read `-p
+// manifest` makes - into a scratch of its own, and anything it would refuse is simply no memo: the full
+// resolve after it reports the refusal once, in its own words.
+//
+// **only for a project with one root**, which is the only shape with an entry module and so with a directory
+// of its own to keep anything in - the rule BuildLayout::digest_memo already follows
+static std::filesystem::path manifest_memo_for(
+    const std::filesystem::path &root,
+    const std::filesystem::path &build_dir_flag,
+    const Compiler::TargetFacts &facts
+)
+{
+    Parser::ManifestScratch probe(facts);
+    Parser::ModuleManifest written;
+
+    if (!Parser::read_module_manifest(root, probe, written, Parser::ManifestRead::t_written)) {
+        return {};
+    }
+
+    return Compiler::BuildLayout::resolve(build_dir_flag, &written, {}).manifest_memo();
+}
+
 // the manifests this invocation builds, in the order the modules have to be parsed: every `-m` the user
 // gave, plus the standard library's own, which is an ordinary manifest module like any other
 //
@@ -201,6 +247,10 @@ static bool resolve_target_facts(
 // **the flags arrive as parameters rather than being read off a parser.** `echoc clean` resolves the same
 // graph and registers none of them, and a function that reaches into a command line for `source` cannot be
 // called by a subcommand that has no such argument
+//
+// the graph a resolve produced is remembered in the project's build directory and recalled while nothing it
+// was read from has moved - see Parser::recall_manifest_graph - so an unchanged project is a stat per
+// manifest and per globbed directory rather than a parse of every manifest and a walk of every source tree
 static bool resolve_manifests(
     const std::vector<std::string> &named_roots,
     bool with_stdlib,
@@ -208,6 +258,7 @@ static bool resolve_manifests(
     const AST::DiagnosticRenderer &diagnostics,
     const Compiler::TargetFacts &facts,
     const std::filesystem::path &package_dir_override,
+    const std::filesystem::path &build_dir_flag,
     std::vector<Parser::ModuleManifest> &out,
     std::vector<std::filesystem::path> &out_roots
 )
@@ -269,11 +320,24 @@ static bool resolve_manifests(
         scratch.package_dir = Parser::resolve_package_dir({}, package_dir_override);
     }
 
+    const std::filesystem::path memo = out_roots.size() == 1
+        ? manifest_memo_for(out_roots.front(), build_dir_flag, facts)
+        : std::filesystem::path();
+    const uint64_t context = Parser::manifest_graph_context(roots, facts, scratch.package_dir);
+
+    if (Parser::recall_manifest_graph(memo, context, out)) {
+        Compiler::PhaseTimings::instance().count("manifests recalled", out.size());
+        return true;
+    }
+
     if (!Parser::resolve_module_graph(roots, scratch, out)) {
         scratch.bundle.collector.print_issues(diagnostics);
         return false;
     }
 
+    Compiler::PhaseTimings::instance().count("manifests read", out.size());
+    Parser::remember_manifest_graph(memo, context, out, scratch.witness);
+
     return true;
 }
 
@@ -291,42 +355,121 @@ static bool manifest_is_a_root(
     return std::find(roots.begin(), roots.end(), manifest.path) != roots.end();
 }
 
+// every manifest module read and lexed up front, `jobs` at a time, one Parser::ModuleParser::LexedModule per
+// entry of `inputs` and at the same index.
+//
+// **modules and not files are the unit of work**, because a module's files append to one TokenCollection
+// and a slice is measured off its tail - two files of one module lexed at once would interleave their
+// tokens. Modules share nothing until the parse passes, which is what makes them safe to hand out.
+//
+// a plain counter rather than a queue: every module is known before the first worker starts and none is
+// added later, so claiming the next one is a fetch_add and there is nothing else to coordinate
+static std::vector<Parser::ModuleParser::LexedModule> read_and_lex_modules(
+    const Parser::ModuleParser &parser,
+    const std::vector<Parser::ModuleParser::InputPayload> &inputs,
+    unsigned jobs
+)
+{
+    std::vector<Parser::ModuleParser::LexedModule> lexed(inputs.size());
+    std::atomic<size_t> next = 0;
+
+    auto work = [&] {
+        for (size_t i = next++; i < inputs.size(); i = next++) {
+            lexed[i] = parser.read_and_lex_input(inputs[i]);
+        }
+    };
+
+    const size_t workers = std::min<size_t>(jobs, inputs.size());
+    std::vector<std::thread> pool;
+
+    // the calling thread is one of the workers, so `-j 2` is two threads lexing and not three alive
+    for (size_t i = 1; i < workers; i++) {
+        pool.emplace_back(work);
+    }
+
+    work();
+
+    for (std::thread &worker : pool) {
+        worker.join();
+    }
+
+    return lexed;
+}
+
 // one AST::Module per manifest, parsed completely before the next one starts - which is what the
 // topological order above exists for
+//
+// **with `jobs` above one, only the reading and lexing moves.** Each pass writes into the collector the
+// whole bundle shares, and a module's pass 1 has to see every type its dependencies declared, so the passes
+// stay here on this thread in exactly the serial order. What changes is that every module's tokens already
+// exist when its turn comes. The modules are added to the bundle up front and in that same order, so every
+// handle is the one the serial path hands out, and a lexer refusal is raised when its module's turn comes
+// rather than when a worker met it - the modules before it still parse and anything after it is never
+// reported, so the output is byte for byte what `-j 1` prints
+//
+// a module with an entry in `token_stores` loads its tokens from the store when there are some under its key,
+// and stores them when there are not - on the worker that lexed it, under `jobs` above one. What became of each
+// is written into `out_uses` for `--explain cache`
 static int parse_manifest_modules(
     const AST::DiagnosticRenderer &diagnostics,
     const std::vector<const Parser::ModuleManifest *> &manifests,
     const std::vector<std::filesystem::path> &roots,
     const Parser::ActiveTargets &active_targets,
+    unsigned jobs,
+    const std::map<std::string, Parser::TokenStore> &token_stores,
     AST::Bundle &bundle,
-    Parser::ModuleParser &parser
+    Parser::ModuleParser &parser,
+    std::map<std::string, Parser::TokenStoreUse> &out_uses
 )
 {
-    for (const Parser::ModuleManifest *entry : manifests) {
-        const Parser::ModuleManifest &manifest = *entry;
+    const bool lex_ahead = jobs > 1 && manifests.size() > 1;
 
-        Compiler::ProgressStep step(
-            Compiler::ProgressReporter::instance(), Compiler::ProgressPhase::t_parse, manifest.name);
+    std::vector<Parser::ModuleParser::InputPayload> inputs;
+    std::vector<Parser::ModuleContribution> contributions;
+
+    inputs.reserve(manifests.size());
+    contributions.reserve(manifests.size());
 
-        AST::module_handle_t handle = bundle.modules.add_module(manifest.name);
-        auto &module = bundle.modules.get_module(handle);
+    for (const Parser::ModuleManifest *entry : manifests) {
+        AST::module_handle_t handle = bundle.modules.add_module(entry->name);
 
         auto input = Parser::ModuleParser::InputPayload {
             .files = {},
-            .module = module,
+            .module = bundle.modules.get_module(handle),
             .collector = bundle.collector
         };
 
         // **through the one owner, never off `manifest.sources`.** What this module compiles is a question
         // about the program being built, and the module cache asks the very same function - two merges
         // here would be a cache handing one program the object built for another
-        const Parser::ModuleContribution contribution =
-            Parser::module_contribution_for(manifest, active_targets);
+        contributions.push_back(Parser::module_contribution_for(*entry, active_targets));
 
-        for (const auto &source : contribution.sources) {
+        for (const auto &source : contributions.back().sources) {
             input.files.push_back(Parser::ModuleParser::InputFile(source));
         }
 
+        auto store = token_stores.find(entry->name);
+        if (store != token_stores.end()) {
+            input.token_store = store->second;
+        }
+
+        inputs.push_back(std::move(input));
+    }
+
+    std::vector<Parser::ModuleParser::LexedModule> lexed;
+
+    if (lex_ahead) {
+        Compiler::ScopedPhase phase("read and lex, parallel");
+        lexed = read_and_lex_modules(parser, inputs, jobs);
+    }
+
+    for (size_t i = 0; i < manifests.size(); i++) {
+        const Parser::ModuleManifest &manifest = *manifests[i];
+        const Parser::ModuleContribution &contribution = contributions[i];
+
+        Compiler::ProgressStep step(
+            Compiler::ProgressReporter::instance(), Compiler::ProgressPhase::t_parse, manifest.name);
+
         step.summary(fmt::format(
             "{} file{}",
             contribution.sources.size(), contribution.sources.size() == 1 ? "" : "s"));
@@ -339,10 +482,22 @@ static int parse_manifest_modules(
             step.detail(contribution.sources);
         }
 
-        if (handle_parse(diagnostics, parser, input)) {
+        Parser::ModuleParser::InputPayload &input = inputs[i];
+        Parser::TokenStoreUse use = Parser::TokenStoreUse::t_none;
+
+        const int failed = lex_ahead
+            ? guard_parse(diagnostics, [&] {
+                parser.parse_lexed_module(input.module, input.collector, lexed[i]);
+                use = lexed[i].store_use;
+            })
+            : guard_parse(diagnostics, [&] { use = parser.parse_input(input); });
+
+        if (failed) {
             return 1;
         }
 
+        out_uses[manifest.name] = use;
+
         step.finish(true);
     }
 
@@ -505,6 +660,15 @@ static void collect_shared_top_level_code(const Parser::ModuleManifest &manifest
     }
 }
 
+// how much of a bundle was already parsed when a front end was handed it: the embedded standard library,
+// and the first `manifests` of the modules it compiles. **Nothing, outside a compile server** - see
+// adopt_warm_bundle
+struct ParsedAhead
+{
+    bool stdlib = false;
+    size_t manifests = 0;
+};
+
 // builds the bundle both `run` and `build` compile: the stdlib module, the manifest modules, then the
 // main module with the user's sources. one function rather than two copies, because the copies had
 // already drifted - `build` never created a stdlib module at all, so any program calling `mem::` or
@@ -518,12 +682,15 @@ static int build_bundle(
     const Invocation &invocation,
     const Program &program,
     const std::vector<const Parser::ModuleManifest *> &manifests,
+    const std::map<std::string, Parser::TokenStore> &token_stores,
+    const ParsedAhead &ahead,
     AST::Bundle &bundle,
-    Parser::ModuleParser &parser
+    Parser::ModuleParser &parser,
+    std::map<std::string, Parser::TokenStoreUse> &out_token_uses
 )
 {
 #if ECO_USE_EMBEDDED_STDLIB
-    if (!driver.no_stdlib) {
+    if (!driver.no_stdlib && !ahead.stdlib) {
         parse_embedded_stdlib_module(bundle, parser);
     }
 #endif
@@ -533,8 +700,14 @@ static int build_bundle(
     // the same one-way rule that holds between two manifests, for the same reason
     const std::vector<std::filesystem::path> &source_files = invocation.sources;
 
+    // **after whatever is already in the bundle**, which is a prefix of this same list by construction - see
+    // adopt_warm_bundle - so what is parsed here is exactly the tail the serial order would have reached next
+    const std::vector<const Parser::ModuleManifest *> still_to_parse(
+        manifests.begin() + static_cast<std::ptrdiff_t>(ahead.manifests), manifests.end());
+
     if (parse_manifest_modules(
-            diagnostics, manifests, invocation.roots, program.active_targets, bundle, parser) != 0) {
+            diagnostics, still_to_parse, invocation.roots, program.active_targets, driver.jobs, token_stores,
+            bundle, parser, out_token_uses) != 0) {
         return 1;
     }
 
@@ -657,6 +830,12 @@ static int run_semantic_passes(
     AST::Monomorphizer monomorphizer(bundle);
     monomorphizer.run();
 
+    // under `semantic passes`, whose time they are. the misses are every free call over an overload set
+    // the fixpoint scored at all, so the two together say how much asking again the registry absorbed
+    const AST::FunctionRegistry::MatchCounts matches = bundle.collector.functions.match_counts();
+    Compiler::PhaseTimings::instance().count("overload matches recalled", matches.hits);
+    Compiler::PhaseTimings::instance().count("overload matches scored", matches.misses);
+
     if (driver.prints(Compiler::PrintKind::t_instances)) {
         // **the one dump written while a progress row is live.** Every other one in this file sits
         // between steps, which is the measure of whether the steps are placed right - so this is the
@@ -720,6 +899,12 @@ struct ModulePlan
     // no compilation unit is created for these, and their stored object is linked instead
     std::set<std::string> cached;
 
+    // the part of `cached` the shared store served, for `--explain cache` to say so
+    std::set<std::string> shared;
+
+    // whether this build reads and feeds the shared store at all - see plan_module_artifacts
+    bool sharing = false;
+
     // the objects already on disk, in module order
     std::vector<std::filesystem::path> reused;
 
@@ -729,6 +914,11 @@ struct ModulePlan
     // one map rather than one per artifact: the two paths are decided together and are always both present or
     // both absent, so two containers would only offer a way for them to disagree
     std::map<std::string, ModuleArtifact> emit_to;
+
+    // where each compiled unit's ODR-shared bodies may be kept as an object of their own, by module name - see
+    // Backend::keep_shared_definitions. The entry module is among them, being the unit edited most. Empty on a
+    // build that feeds the shared store: what another project fetches has to link on its own
+    std::map<std::string, std::filesystem::path> instance_dirs;
 };
 
 // decides, per manifest module, whether its object can be reused.
@@ -736,18 +926,35 @@ struct ModulePlan
 // **and prepares the store while it is there**, which is the one thing it writes: a marker is what makes a
 // directory removable, and preparing on the miss path alone leaves a fully-cached project's directory
 // unmarked - see the call below. So this is where a build provisions, not only where it plans
+//
+// **a miss here is asked of the shared store next**, when there is one, and an object it has is linked into
+// this module's own store and counted a hit. Not under `-g`: a debug object names the absolute path of every
+// source it was compiled from, so one built in another checkout would point a debugger at that checkout
 static ModulePlan plan_module_artifacts(
     const Compiler::BuildLayout &layout,
     const std::vector<const Parser::ModuleManifest *> &manifests,
     const std::map<std::string, Compiler::ModuleCacheKey> &keys,
-    const std::string &entry_module
+    const std::string &entry_module,
+    const Compiler::CompilerOptions &options
 )
 {
     ModulePlan plan;
+    plan.sharing = layout.shared_store().has_value() && !options.emitting_debug_info();
+
+    // the instance store of a module whose own store is ready - which for the entry module, whose directory
+    // this plan does not prepare, is the layout's marker check alone
+    const auto keep_instances = [&](const Parser::ModuleManifest &manifest) {
+        const std::filesystem::path directory = layout.instance_dir(manifest);
+
+        if (!plan.sharing && !directory.empty()) {
+            plan.instance_dirs[manifest.name] = directory;
+        }
+    };
 
     for (const Parser::ModuleManifest *entry : manifests) {
         const Parser::ModuleManifest &manifest = *entry;
         if (manifest.name == entry_module) {
+            keep_instances(manifest);
             continue;
         }
 
@@ -756,7 +963,11 @@ static ModulePlan plan_module_artifacts(
             continue;
         }
 
-        const std::filesystem::path object = Compiler::module_object_path(manifest, found->second, layout);
+        // a thin build keeps summary bitcode where an object would go, and is otherwise this same plan: a key, a
+        // file under it, a hit when the file is there
+        const std::filesystem::path object = options.thin_lto
+            ? Compiler::module_summary_path(manifest, found->second, layout)
+            : Compiler::module_object_path(manifest, found->second, layout);
 
         // **before the hit, so a store in use always carries its marker**, not only one that was written to
         // today. Preparing on the miss path alone leaves a fully-cached project's directory unmarked and
@@ -765,11 +976,22 @@ static ModulePlan plan_module_artifacts(
 
         // deliberately not gated on that: a read-only store still serves what is already in it, and a build
         // that refused to reuse an object it can see would be slower for no reason at all
+        // **and only with every instance object it leans on** - see Compiler::claim_instance_objects. One
+        // that is gone makes the object a miss, compiled again over the top of it like any other
         std::error_code ec;
         if (std::filesystem::is_regular_file(object, ec)) {
-            plan.cached.insert(manifest.name);
-            plan.reused.push_back(object);
-            continue;
+            if (const auto instances = Compiler::claim_instance_objects(object, layout.instance_dir(manifest))) {
+                plan.cached.insert(manifest.name);
+                plan.reused.push_back(object);
+
+                for (const std::filesystem::path &instance : instances.value()) {
+                    if (std::find(plan.reused.begin(), plan.reused.end(), instance) == plan.reused.end()) {
+                        plan.reused.push_back(instance);
+                    }
+                }
+
+                continue;
+            }
         }
 
         // **an unwritable store is not an error.** A read-only library directory, a toolchain installed
@@ -779,23 +1001,79 @@ static ModulePlan plan_module_artifacts(
             continue;
         }
 
+        // a published object is always a whole one, so a record left beside this path by an earlier build
+        // describes something that is no longer there
+        if (plan.sharing && layout.shared_store()->fetch(object.filename().string(), object)) {
+            std::filesystem::remove(Compiler::instance_record_path(object), ec);
+
+            plan.cached.insert(manifest.name);
+            plan.shared.insert(manifest.name);
+            plan.reused.push_back(object);
+            continue;
+        }
+
         plan.emit_to[manifest.name] = ModuleArtifact{
             object, Compiler::module_inputs_path(manifest, layout) };
+
+        keep_instances(manifest);
     }
 
     return plan;
 }
 
+// where each manifest module's tokens are loaded from and stored to - see Parser::read_module_tokens.
+//
+// **every subcommand, whole-program or not.** A token store is what comes out of the lexer, which runs the
+// same way whatever is done with the tree afterwards - so `run`, which keeps no object, keeps these. The
+// program's own module is left out for the object store's reason and a sharper one: it is the module being
+// edited, so every build would store its tokens under a key the next edit retires.
+//
+// prepares each store as plan_module_artifacts does, and for the same reason: a directory in use carries
+// its marker, so `echoc clean` can remove what a `run` left in it
+static std::map<std::string, Parser::TokenStore> plan_token_stores(
+    const Compiler::BuildLayout &layout,
+    const std::vector<const Parser::ModuleManifest *> &manifests,
+    const std::map<std::string, Compiler::ModuleCacheKey> &keys,
+    const std::string &entry_module
+)
+{
+    std::map<std::string, Parser::TokenStore> stores;
+
+    for (const Parser::ModuleManifest *entry : manifests) {
+        const Parser::ModuleManifest &manifest = *entry;
+        if (manifest.name == entry_module) {
+            continue;
+        }
+
+        auto found = keys.find(manifest.name);
+        if (found == keys.end()) {
+            continue;
+        }
+
+        stores.emplace(manifest.name, Parser::TokenStore{
+            Compiler::module_tokens_path(manifest, found->second, layout),
+            found->second.hex,
+            layout.prepare_module_dir(manifest) == Compiler::BuildDirState::t_ready
+        });
+    }
+
+    return stores;
+}
+
 // **the whole-program path.** An optimized or dumped build folds every unit into one module first, because both
 // the O3 pipeline and the IR dump can only look at one - and that is exactly what a per-module object cache
 // cannot have. So the two are mutually exclusive by construction rather than by a warning: `-O` and `-p` get
 // whole-program optimization and no cache, everything else gets the cache.
-// the cache key of every manifest module. Computed whenever anything downstream reads one - the plan, or
-// `--explain-cache` - and skipped entirely otherwise, because a key costs a read of every source in the
-// build and a whole-program build reuses nothing
+// the cache key of every manifest module. **before the parse**, because the token store is keyed on it
+// and is read in place of lexing - so every invocation pays for a key now, and the read of every source it
+// costs is one the lexer no longer makes for a module whose tokens are reused
+//
+// the file digests those reads produce are remembered in the build directory - see Compiler::FileDigests - so
+// a source nothing has touched since is a stat rather than a read
 static bool compute_cache_keys(
     const Compiler::DriverOptions &driver,
     const AST::DiagnosticRenderer &diagnostics,
+    const Compiler::BuildLayout &layout,
     const std::vector<const Parser::ModuleManifest *> &manifests,
     const Compiler::CompilerOptions &options,
     const Compiler::TargetFacts &facts,
@@ -806,6 +1084,12 @@ static bool compute_cache_keys(
 {
     Compiler::ScopedPhase phase("cache keys");
 
+    Compiler::FileDigests &digests = Compiler::FileDigests::instance();
+    digests.attach(layout.digest_memo());
+
+    const size_t recalled = digests.recalled();
+    const size_t hashed = digests.hashed();
+
     std::string error;
     if (!Compiler::compute_module_keys(
             manifests, options, facts, test_modules, active_targets,
@@ -814,6 +1098,46 @@ static bool compute_cache_keys(
         return false;
     }
 
+    Compiler::PhaseTimings::instance().count("file digests recalled", digests.recalled() - recalled);
+    Compiler::PhaseTimings::instance().count("file digests hashed", digests.hashed() - hashed);
+
+    digests.save();
+
+    return true;
+}
+
+// the key each manifest module's object is stored under - see Compiler::compute_object_keys.
+//
+// **after the parse**, because telling a function's body from its declaration takes a parsed module, and
+// before the semantic passes, which mint declarations nobody wrote into every module they touch
+static bool compute_object_cache_keys(
+    const AST::DiagnosticRenderer &diagnostics,
+    AST::Bundle &bundle,
+    const std::vector<const Parser::ModuleManifest *> &manifests,
+    const Compiler::CompilerOptions &options,
+    const std::map<std::string, Compiler::ModuleCacheKey> &source_keys,
+    std::map<std::string, Compiler::ModuleCacheKey> &out_keys
+)
+{
+    Compiler::ScopedPhase phase("object keys");
+
+    std::map<std::string, uint64_t> interfaces;
+
+    for (const Parser::ModuleManifest *manifest : manifests) {
+        AST::Module *module = bundle.modules.find_module_ptr(manifest->name);
+
+        if (module != nullptr) {
+            interfaces.emplace(manifest->name,
+                Compiler::module_interface_digest(*module, options.emitting_debug_info()));
+        }
+    }
+
+    std::string error;
+    if (!Compiler::compute_object_keys(manifests, source_keys, interfaces, out_keys, error)) {
+        diagnostics.render_untyped("Module Cache Error", error);
+        return false;
+    }
+
     return true;
 }
 
@@ -822,10 +1146,15 @@ static bool compute_cache_keys(
 // **it reports the plan rather than re-deriving it from the filesystem.** Asking again would be a second
 // answer to a question the plan already owns, and the two could disagree - which is exactly the bug this
 // diagnostic exists to help find
+//
+// **each module's token store gets a row of its own under it**, first field `tokens`, rather than a word on
+// the module's line: that line is what a person greps for "hit" and "miss" on, and the object and the
+// tokens are two stores that can each answer either way
 static void report_cache_plan(
     const Compiler::DriverOptions &driver,
     const std::vector<const Parser::ModuleManifest *> &manifests,
     const std::map<std::string, Compiler::ModuleCacheKey> &keys,
+    const std::map<std::string, Parser::TokenStoreUse> &token_uses,
     const ModulePlan &plan,
     const std::string &entry_module_name,
     bool bypassed
@@ -837,6 +1166,9 @@ static void report_cache_plan(
 
     std::cout << "[cache]" << std::endl;
 
+    // the first module recompiled into its store, for the hits after it
+    std::string rebuilt;
+
     if (bypassed) {
         std::cout << "  bypassed: an optimized or dumped build is whole-program, so no module object is "
                      "reusable" << std::endl;
@@ -854,8 +1186,34 @@ static void report_cache_plan(
 
         std::cout << "  " << manifest.name << "  " << key.hex << "  ";
 
+        auto stored = token_uses.find(manifest.name);
+        const Parser::TokenStoreUse use =
+            stored == token_uses.end() ? Parser::TokenStoreUse::t_none : stored->second;
+
+        const auto tokens_row = [use]() {
+            if (use != Parser::TokenStoreUse::t_none) {
+                std::cout << "    tokens  " << Parser::describe(use) << std::endl;
+            }
+        };
+
         if (plan.cached.count(manifest.name) > 0) {
-            std::cout << "hit" << std::endl;
+            std::cout << "hit";
+
+            // named because it is the one hit this project's own store could not have produced, and the
+            // one to suspect first if a shared object ever turns out to be wrong
+            if (plan.shared.count(manifest.name) > 0) {
+                std::cout << "  (from the shared store)";
+            }
+
+            // **the hit an object key exists to produce**, and the one that looks wrong without a word: a
+            // module below this one was rebuilt, and only its bodies had changed. Named, so it reads as the
+            // cache working rather than as a stale object
+            if (!rebuilt.empty()) {
+                std::cout << "  (interface unchanged: '" << rebuilt << "' was rebuilt)";
+            }
+
+            std::cout << std::endl;
+            tokens_row();
             continue;
         }
 
@@ -874,6 +1232,8 @@ static void report_cache_plan(
             else {
                 std::cout << "  (its cache directory is not writable)" << std::endl;
             }
+
+            tokens_row();
             continue;
         }
 
@@ -882,17 +1242,46 @@ static void report_cache_plan(
             std::cout << "  (" << why << ")";
         }
 
+        if (rebuilt.empty()) {
+            rebuilt = manifest.name;
+        }
+
         std::cout << std::endl;
+        tokens_row();
     }
 }
 
 
+// where each unit's ODR-shared bodies may be kept, for LLVMCompiler::emit_objects - the plan's instance_dirs,
+// and nowhere for a unit the plan has none for.
+//
+// **nowhere at all under `--print ir-units`**: what that prints is promised to be what each object holds,
+// and an object that leans on another holds less
+static std::function<std::filesystem::path(const std::string &)> instances_for(
+    const Compiler::DriverOptions &driver, const ModulePlan &plan)
+{
+    if (driver.prints(Compiler::PrintKind::t_ir_units)) {
+        return {};
+    }
+
+    return [&plan](const std::string &module_name) -> std::filesystem::path {
+        auto found = plan.instance_dirs.find(module_name);
+        return found != plan.instance_dirs.end() ? found->second : std::filesystem::path();
+    };
+}
+
 // emits every module that was not reused, then links the reused objects together with them.
 //
 // the module's object goes straight into the cache rather than being emitted elsewhere and copied: an object in
 // the store is by definition one this compiler just produced for that exact key, and a copy step is one more
 // thing that can half-succeed.
+//
+// **`--optimize thin` puts one step between the two**: what was emitted and reused is summary bitcode, and the
+// thin link turns all of it into the objects the linker is handed, in scratch - they are a function of every
+// unit's summary at once, so no one module's store could hold them. Its own cache beside the kept programs is
+// what spares an unchanged unit its codegen
 static bool emit_and_link_modules(
+    const Compiler::DriverOptions &driver,
     LLVMCompiler &compiler,
     const Compiler::BuildLayout &layout,
     const std::string &output,
@@ -900,6 +1289,8 @@ static bool emit_and_link_modules(
     const std::vector<Compiler::LinkRequirement> &link
 )
 {
+    const bool thin = driver.options.thin_lto;
+
     std::vector<std::filesystem::path> objects = plan.reused;
 
     // a module with nowhere to be stored - the entry module, or anything not from a manifest - gets a
@@ -912,13 +1303,25 @@ static bool emit_and_link_modules(
             return found->second.object;
         }
 
-        return layout.scratch_object(module_name);
+        return thin
+            ? layout.scratch_object(module_name).replace_extension(".bc")
+            : layout.scratch_object(module_name);
     };
 
-    if (!compiler.emit_objects(object_for, objects)) {
+    if (!compiler.emit_objects(object_for, objects, instances_for(driver, plan), driver.jobs)) {
         return false;
     }
 
+    if (thin) {
+        std::vector<std::filesystem::path> summaries = std::move(objects);
+        objects.clear();
+
+        if (!compiler.thin_link(
+                summaries, link, layout.thin_link_cache_dir(), layout.scratch_dir(), driver.jobs, objects)) {
+            return false;
+        }
+    }
+
     return compiler.link_executable(output, objects, link);
 }
 
@@ -926,11 +1329,17 @@ static bool emit_and_link_modules(
 //
 // best effort: a store that cannot be written is a cache that will miss next time, which is slow rather than
 // wrong. Refusing the build over it would make an unwritable directory fatal to compiling
+//
+// **and each of those objects is published to the shared store**, under the same name, for every other project
+// on this machine. The same rule applies: only what was emitted, only once the link has proved it whole
 static void store_module_records(
+    const Compiler::BuildLayout &layout,
     const ModulePlan &plan,
     const std::map<std::string, Compiler::ModuleCacheKey> &keys
 )
 {
+    bool published = false;
+
     for (const auto &[module_name, artifact] : plan.emit_to) {
         auto found = keys.find(module_name);
         if (found == keys.end()) {
@@ -938,6 +1347,14 @@ static void store_module_records(
         }
 
         Compiler::write_inputs_record(artifact.record, found->second);
+
+        if (plan.sharing) {
+            published |= layout.shared_store()->publish(artifact.object.filename().string(), artifact.object);
+        }
+    }
+
+    if (published) {
+        layout.shared_store()->prune_if_due();
     }
 }
 
@@ -947,7 +1364,7 @@ static void store_module_records(
 // and a second spelling would let them drift. the status is part of the rule, not the caller's - a
 // module whose codegen threw part way through a function is neither runnable nor linkable, and
 // printing the diagnostic and then carrying on would report success on a failed compile: the
-// exit code would say 0 while MCJIT ran over a half-built module, or the emit path would write
+// exit code would say 0 while the JIT ran over a half-built module, or the emit path would write
 // objects for one that may be null or only partly linked. the e2e corpus' `expect:` asserts it
 static int report_compiler_exception(
     const AST::DiagnosticRenderer &diagnostics,
@@ -984,9 +1401,22 @@ struct FrontEnd
 
     Compiler::CompilerOptions options;
 
-    // empty unless something downstream reads one - see needs_cache_keys
+    // the program's AST. **owned here rather than by the subcommand**, because which bundle it is is decided
+    // inside run_front_end - a compile server may already hold one with this program's libraries parsed -
+    // and an AST::Bundle cannot be moved once anything points into it
+    std::unique_ptr<AST::Bundle> bundle;
+
+    // one per manifest module, computed before the parse - see compute_cache_keys
     std::map<std::string, Compiler::ModuleCacheKey> cache_keys;
 
+    // what each manifest module's *object* is stored under, computed after the parse - see
+    // compute_object_cache_keys. The token store keeps `cache_keys`; everything about objects reads these
+    std::map<std::string, Compiler::ModuleCacheKey> object_keys;
+
+    // what each manifest module's token store did this time, for `--explain cache`. A module absent
+    // here had no store to ask
+    std::map<std::string, Parser::TokenStoreUse> token_uses;
+
     // **the modules this program compiles, in dependency order** - which is not every module the project
     // has: a dependency reached only through some other target's `#[target: ...] { #[depends:] }` is not
     // one of them. Filled once, in run_front_end.
@@ -1096,13 +1526,6 @@ static std::filesystem::path fallback_scratch_dir()
     return std::filesystem::temp_directory_path() / "echoc" / std::to_string(getpid());
 }
 
-// keying a module reads every one of its sources, so it is not free. Only two things ever look at a key: the
-// plan, which a whole-program build does not have, and `--explain-cache`
-static bool needs_cache_keys(const Compiler::DriverOptions &driver)
-{
-    return !driver.whole_program || driver.explains(Compiler::ExplainKind::t_cache);
-}
-
 // what a refusal quotes back when it has to name a set, joined the one way.
 //
 // four refusals here name one - the targets a `--target` could have meant, the programs a `run` was handed
@@ -1471,7 +1894,8 @@ static bool resolve_invocation(
                 driver.modules,
                 !driver.no_stdlib,
                 driver.sources.empty(),
-                diagnostics, out.target_facts, driver.package_dir, out.manifests, out.roots)) {
+                diagnostics, out.target_facts, driver.package_dir, driver.build_dir,
+                out.manifests, out.roots)) {
             return false;
         }
     }
@@ -1492,19 +1916,100 @@ static bool resolve_invocation(
     return resolve_programs(driver, diagnostics, out);
 }
 
+// what a compile server parsed after answering its last request, or a watcher before forking its next build,
+// for that one to start from - see warm_libraries. **Only ever filled in one of those two**, so every other
+// invocation reads it as empty and starts from nothing, as it always did
+struct WarmBundle
+{
+    std::unique_ptr<AST::Bundle> bundle;
+
+    // the embedded standard library's facts when `bundle` holds it, empty when it does not
+    std::string stdlib_signature;
+
+    // the manifest modules in `bundle`, in the order they were parsed, with the source key each was parsed
+    // under
+    std::vector<std::pair<std::string, std::string>> modules;
+
+    // what their token stores did, for `--explain cache` - the request adopting them did not ask
+    std::map<std::string, Parser::TokenStoreUse> token_uses;
+};
+
+static WarmBundle s_warm_bundle;
+
+#if ECO_USE_EMBEDDED_STDLIB
+// everything the embedded standard library's parse depends on. It has no source key - its tokens are in
+// this executable, which the server's identity check already pins - so what is left is what its `#[if:]`s
+// and `test` blocks are filtered by
+static std::string embedded_stdlib_signature(const FrontEnd &front)
+{
+    return Compiler::TargetFacts::for_module(front.target_facts(), "stdlib", front.test_modules())
+        .cache_signature();
+}
+#endif
+
+// **the warm bundle, when it holds exactly what this program would have parsed first - and an empty one
+// otherwise.** Exactly: every module in it has to be this program's module at the same position, under the
+// same source key. A source key folds everything a module's parse depends on, the keys of its dependencies
+// included, so a prefix that matches is the bundle the serial parse would have built by that point - and a
+// module that changed, or a flag that moved a key, is one mismatch and a parse from scratch. There is no
+// partial adoption: a module cannot be taken back out of a bundle.
+//
+// taken whichever way it goes, so a second program of the same invocation never sees what the first may
+// already have mutated
+static std::unique_ptr<AST::Bundle> adopt_warm_bundle(
+    const Compiler::DriverOptions &driver,
+    FrontEnd &front,
+    ParsedAhead &out
+)
+{
+    WarmBundle warm = std::move(s_warm_bundle);
+    s_warm_bundle = WarmBundle();
+
+    if (warm.bundle == nullptr || warm.modules.size() > front.compiled.size()) {
+        return std::make_unique<AST::Bundle>();
+    }
+
+#if ECO_USE_EMBEDDED_STDLIB
+    const std::string wanted_stdlib = driver.no_stdlib ? std::string() : embedded_stdlib_signature(front);
+#else
+    (void)driver;
+    const std::string wanted_stdlib;
+#endif
+
+    if (warm.stdlib_signature != wanted_stdlib) {
+        return std::make_unique<AST::Bundle>();
+    }
+
+    for (size_t i = 0; i < warm.modules.size(); i++) {
+        const std::string &name = front.compiled[i]->name;
+        const auto key = front.cache_keys.find(name);
+
+        if (name != warm.modules[i].first || key == front.cache_keys.end()
+            || key->second.hex != warm.modules[i].second) {
+            return std::make_unique<AST::Bundle>();
+        }
+    }
+
+    out.stdlib = !wanted_stdlib.empty();
+    out.manifests = warm.modules.size();
+    front.token_uses = std::move(warm.token_uses);
+
+    return std::move(warm.bundle);
+}
+
 // the front end for **one program**: parse the whole bundle, then run the semantic passes over it.
 //
 // what it is handed rather than deriving is exactly what a second program would derive identically - the
 // platform, the module graph, the layout - and what it settles is what differs between two of them, which
 // today is nothing but the entry file. That it *could* therefore run once for every target is true and is
-// not this: `compile_bundle` builds the LLVMContext its units live in, so proving it re-entrant over one
-// AST::Bundle is a separate piece of work with its own way of going quietly wrong
+// not this: `compile_bundle` builds the LLVMContext its units live in, and while its lanes already run it
+// concurrently over one AST::Bundle, they do so for one entry and one set of options - a second program is
+// a separate piece of work with its own way of going quietly wrong
 static bool run_front_end(
     const Compiler::DriverOptions &driver,
     const AST::DiagnosticRenderer &diagnostics,
     const Invocation &invocation,
     const Program &program,
-    AST::Bundle &bundle,
     FrontEnd &out
 )
 {
@@ -1517,17 +2022,41 @@ static bool run_front_end(
     // platform it is reading for. Neither subcommand touches it once the front end is done
     Parser::ModuleParser parser(out.target_facts(), out.test_modules());
 
+    // **settled before anything is parsed.** AST::TypeChecker reads it - it refuses
+    // `mem::live_allocations()` when nothing is counting - so it has to exist by the semantic
+    // passes, and the keys below fold it
+    out.options = driver.options;
+
+    // **before the parse**, because what the parse may skip is decided by them - see plan_token_stores.
+    // Already there when `run` keyed its program first, from these same manifests and options
+    if (out.cache_keys.empty() && !compute_cache_keys(
+            driver, diagnostics, out.layout(), out.manifests(), out.options, out.target_facts(),
+            out.test_modules(), program.active_targets, out.cache_keys)) {
+        return false;
+    }
+
+    const std::map<std::string, Parser::TokenStore> token_stores =
+        plan_token_stores(out.layout(), out.manifests(), out.cache_keys, out.entry_module());
+
+    // after the keys, which are what a warm bundle is matched by
+    ParsedAhead ahead;
+    out.bundle = adopt_warm_bundle(driver, out, ahead);
+
+    AST::Bundle &bundle = *out.bundle;
+
     {
         Compiler::ScopedPhase phase("parse");
-        if (build_bundle(driver, diagnostics, invocation, program, out.compiled, bundle, parser) != 0) {
+        if (build_bundle(
+                driver, diagnostics, invocation, program, out.compiled, token_stores, ahead, bundle, parser,
+                out.token_uses) != 0) {
             return false;
         }
     }
 
-    // **settled before anything is parsed.** AST::TypeChecker reads it - it refuses
-    // `mem::live_allocations()` when nothing is counting - so it has to exist by the semantic
-    // passes, and that is the whole of what it owes
-    out.options = driver.options;
+    if (!compute_object_cache_keys(
+            diagnostics, bundle, out.manifests(), out.options, out.cache_keys, out.object_keys)) {
+        return false;
+    }
 
     {
         Compiler::ScopedPhase phase("semantic passes");
@@ -1536,13 +2065,6 @@ static bool run_front_end(
         }
     }
 
-    if (needs_cache_keys(driver)
-        && !compute_cache_keys(
-            driver, diagnostics, out.manifests(), out.options, out.target_facts(), out.test_modules(),
-            program.active_targets, out.cache_keys)) {
-        return false;
-    }
-
     return true;
 }
 
@@ -1785,6 +2307,10 @@ static bool build_c_modules(
         step.finish(true);
     }
 
+    // every header the C keys above read, remembered for the next build beside the sources compute_cache_keys
+    // already saved
+    Compiler::FileDigests::instance().save();
+
     if (explaining && !explain.empty()) {
         std::cout << "[cc cache]" << std::endl;
         for (const std::string &line : explain) {
@@ -1817,10 +2343,11 @@ static void report_unloadable_library(
 
 // resolves every requirement to a file and opens it, before the JIT exists.
 //
-// **a failure is fatal, and that is the whole of what this function is for.** MCJIT resolves an external
+// **a failure is fatal, and that is the whole of what this function is for.** The JIT resolves an external
 // out of the running process and nothing else ever puts one there - so a declared library that will not
 // open is a program whose symbols cannot resolve, and carrying on past a warning does not degrade to a
-// useful error: it hangs inside the engine with the note scrolled off the top.
+// useful error: it fails inside the JIT, lazily and part way through the run, with the note scrolled off
+// the top.
 //
 // **a requirement with no runtime spelling is reported too.** An `object:` cannot be opened at all, and
 // dropping it silently leaves the same hang with nothing said about the declaration that was never applied
@@ -1854,7 +2381,7 @@ static bool load_native_libraries(
         std::string reason;
 
         // LoadLibraryPermanently puts the symbols into the process's own search list, which is the only
-        // list MCJIT's resolver consults - so this has to happen before the engine finalizes, and being
+        // list the JIT's resolver consults - so this has to happen before the JIT resolves anything, and being
         // ahead of prepare_execution entirely is the version of that ordering nobody can get wrong
         if (llvm::sys::DynamicLibrary::LoadLibraryPermanently(library.path.string().c_str(), &reason)) {
             report_unloadable_library(diagnostics, library, reason);
@@ -1893,15 +2420,46 @@ std::string program_name(const Compiler::DriverOptions &driver, const Program &p
     return program.entry_module;
 }
 
-// the whole-program optimizer, run iff `-O` asked for it - the same answer for both subcommands.
-//
-// read off the flag rather than off the resolved options. making this unconditional on `build`
-// would make `-O` a switch it accepted and silently ignored, and leave no way at all to see
-// what codegen emitted for a release build, since `-p` only ever showed the optimizer's output
-static void optimize_if_asked(const Compiler::DriverOptions &driver, LLVMCompiler &compiler)
+// **a reused module gets a row and a rebuilt one does not.** Work that did not happen is the surprising half;
+// which input changed for the ones that did is `--explain-cache`'s question, and answering it twice would put
+// explain_miss's reasoning in two places
+static void report_reused_modules(const FrontEnd &front, const ModulePlan &plan)
 {
-    if (!driver.optimize_is_whole_program()) {
-        return;
+    for (const Parser::ModuleManifest *manifest_ptr : front.manifests()) {
+        const Parser::ModuleManifest &manifest = *manifest_ptr;
+
+        if (plan.cached.count(manifest.name) > 0) {
+            Compiler::ProgressReporter::instance().row(
+                Compiler::ProgressPhase::t_cached, manifest.name, "reused",
+                Compiler::ProgressState::t_skipped);
+        }
+    }
+}
+
+// how many units codegen lowers at once - see LLVMCompiler::lower_in_lanes.
+//
+// **one whenever the units are about to become one**, because a whole-program build merges them into a
+// single context and lanes would only be paying for the move. And one under `--print ir-units`: a lane mints
+// each type in a context of its own, so a struct the serial path prints as `%string.1` prints as `%string`,
+// and `-j` promises a dump that does not move with it
+static unsigned codegen_jobs(const Compiler::DriverOptions &driver)
+{
+    if (driver.whole_program || driver.prints(Compiler::PrintKind::t_ir_units)) {
+        return 1;
+    }
+
+    return driver.jobs;
+}
+
+// the whole-program optimizer, run iff `-O` asked for it - the same answer for both subcommands.
+//
+// read off the flag rather than off the resolved options. making this unconditional on `build`
+// would make `-O` a switch it accepted and silently ignored, and leave no way at all to see
+// what codegen emitted for a release build, since `-p` only ever showed the optimizer's output
+static void optimize_if_asked(const Compiler::DriverOptions &driver, LLVMCompiler &compiler)
+{
+    if (!driver.optimize_is_whole_program()) {
+        return;
     }
 
     Compiler::ScopedPhase phase("optimize");
@@ -1912,6 +2470,13 @@ static void optimize_if_asked(const Compiler::DriverOptions &driver, LLVMCompile
     step.finish(true);
 }
 
+// what prepare_jit settled for the engine: the plan it emitted against, and every object it is to load
+struct JitArtifacts
+{
+    ModulePlan plan;
+    std::vector<std::filesystem::path> objects;
+};
+
 // **everything between a parsed bundle and a JIT that can be asked for an address**, shared by the two
 // subcommands that run one: the cache plan, the link requirements, the C modules, the native libraries the
 // JIT must have open before it resolves a symbol, then codegen and the whole-program optimizer.
@@ -1920,21 +2485,35 @@ static void optimize_if_asked(const Compiler::DriverOptions &driver, LLVMCompile
 // runs the program, the other calls one definition at a time - so this is one function rather than the two
 // copies it was, which is what keeps a change to the JIT path from having to be remembered twice.
 //
-// nullopt is success; anything else is the exit status the subcommand owes its caller
+// nullopt is success; anything else is the exit status the subcommand owes its caller.
+//
+// **the object cache is `build`'s, plan and all.** A library module whose object is stored is loaded rather
+// than compiled, one that missed is emitted into its store the way `build` would emit it and loaded from
+// there, and only the entry module - and anything with no store to go to - is compiled by the engine itself.
+// So an unchanged project's `run` is mostly mapping objects in, and a `run` after a `build --debug` of the
+// same project compiles nothing but the program. `--optimize whole` and `--print ir` still merge everything
+// into one module, for the reason they do on a `build`, and report the cache as bypassed
 static std::optional<int> prepare_jit(
     const Compiler::DriverOptions &driver,
     const AST::DiagnosticRenderer &diagnostics,
     FrontEnd &front,
     AST::Bundle &bundle,
     bool test_mode,
-    LLVMCompiler &compiler
+    LLVMCompiler &compiler,
+    JitArtifacts &out
 )
 {
-    // the JIT is handed one module, so every unit is merged and there are no per-module objects to store or
-    // load - the plan is reported as bypassed rather than not reported at all
+    const bool whole_program = driver.whole_program;
+    const std::string &entry_module = front.entry_module();
+
+    out.plan = whole_program
+        ? ModulePlan{}
+        : plan_module_artifacts(front.layout(), front.manifests(), front.object_keys, entry_module, front.options);
+
     report_cache_plan(
-        driver, front.manifests(), front.cache_keys, ModulePlan{}, front.entry_module(),
-        /*bypassed=*/true);
+        driver, front.manifests(), front.object_keys, front.token_uses, out.plan, entry_module, whole_program);
+
+    report_reused_modules(front, out.plan);
 
     // **before codegen**, because a C source that does not compile is a build that is going to fail either
     // way, and finding out after the whole Echo program has been lowered wastes the wait. It also puts the
@@ -1969,10 +2548,12 @@ static std::optional<int> prepare_jit(
         Compiler::ProgressStep step(
             Compiler::ProgressReporter::instance(), Compiler::ProgressPhase::t_codegen);
 
-        compiler.compile_bundle(bundle);
+        compiler.compile_bundle(bundle, out.plan.cached, codegen_jobs(driver));
+
+        if (whole_program) {
+            compiler.link_into_main();
+        }
 
-        // the JIT can only be handed one module, so both of these paths always merge
-        compiler.link_into_main();
         step.finish(true);
     } catch (Compiler::ASTCompilerException &e) {
         return report_compiler_exception(diagnostics, e);
@@ -1992,9 +2573,287 @@ static std::optional<int> prepare_jit(
         compiler.printIR(false);
     }
 
+    // **into the store and not into memory**, so the object a later run or build is served is the one this
+    // run loaded. An empty path keeps a unit in memory for the engine: the entry module, whose object
+    // nothing would reuse, and a module whose store could not be written
+    out.objects = out.plan.reused;
+
+    const auto object_for = [&](const std::string &module_name) -> std::filesystem::path {
+        auto found = out.plan.emit_to.find(module_name);
+        return found != out.plan.emit_to.end() ? found->second.object : std::filesystem::path();
+    };
+
+    if (!whole_program
+        && !compiler.emit_objects(object_for, out.objects, instances_for(driver, out.plan), driver.jobs)) {
+        diagnostics.render_untyped("Cannot Run This Program",
+            "a module's object could not be written to its build directory.");
+        return 1;
+    }
+
+    if (driver.explains(Compiler::ExplainKind::t_cache)) {
+        std::cout << compiler.instance_report();
+    }
+
     return std::nullopt;
 }
 
+// builds the JIT over what prepare_jit left, then keeps what it emitted.
+//
+// the records are written here rather than after the program for the reason `build` writes them after the
+// link: a JIT that found the entry point has taken every object it was handed, which is as near the proof a
+// link would have been as a lazy one gets - and a program that ends in `exit` never comes back to a line
+// after run_main
+static bool start_jit(
+    const Compiler::DriverOptions &driver,
+    const FrontEnd &front,
+    LLVMCompiler &compiler,
+    const JitArtifacts &jit
+)
+{
+    if (!compiler.prepare_execution(
+            jit.objects, driver.jobs, driver.optimize == Compiler::OptimizeMode::t_tiered)) {
+        return false;
+    }
+
+    if (!driver.whole_program) {
+        store_module_records(front.layout(), jit.plan, front.object_keys);
+    }
+
+    return true;
+}
+
+// what the program store has to say about one program: the key its linked executable is kept under, or why it
+// cannot be kept at all
+struct ProgramCacheEntry
+{
+    // the program as the store names it - its target's name, or its entry module's when no target declared it
+    std::string name;
+
+    Compiler::ModuleCacheKey key;
+
+    // where the executable for `key` is kept, and the record of the last one that was. Both empty when
+    // `refused` is not
+    std::filesystem::path stored;
+    std::filesystem::path record;
+
+    // a sentence for `--explain cache`, and the reason a build keeps nothing and a run looks for nothing
+    std::string refused;
+};
+
+// **the key this program's executable is stored under**, computed from what is known before the parse - see
+// Compiler::compute_program_key. `front` needs the invocation, the program and its modules and nothing the
+// parse fills in; the source keys are computed here when nobody has yet, and run_front_end keeps them.
+//
+// two programs are never kept, and both are decided before anything is hashed:
+//
+// - **a loose file**, which has no build directory of its own - its artifacts go to a temporary one that is
+//   gone when the command is
+// - **a program with C sources**, whose headers only its C build discovers, by preprocessing. A key that
+//   could not see a header would serve the program built against the old one
+//
+// false only when something was rendered - a link requirement that does not resolve, which the compile
+// this stands in front of would have refused in the same words
+static bool key_program(
+    const Compiler::DriverOptions &driver,
+    const AST::DiagnosticRenderer &diagnostics,
+    FrontEnd &front,
+    ProgramCacheEntry &out
+)
+{
+    const Compiler::BuildLayout &layout = front.layout();
+
+    out.name = front.program->name.empty() ? front.entry_module() : front.program->name;
+
+    if (layout.program_dir().empty()) {
+        out.refused = "a loose file has no build directory to keep a program in";
+        return true;
+    }
+
+    for (const Parser::ModuleManifest *manifest : front.manifests()) {
+        if (!front.contribution(*manifest).cc.empty()) {
+            out.refused = fmt::format(
+                "module '{}' compiles C sources, whose headers only its C build can see", manifest->name);
+            return true;
+        }
+    }
+
+    if (front.cache_keys.empty() && !compute_cache_keys(
+            driver, diagnostics, layout, front.manifests(), front.options, front.target_facts(),
+            front.test_modules(), front.program->active_targets, front.cache_keys)) {
+        return false;
+    }
+
+    std::vector<Compiler::LinkRequirement> link;
+
+    if (!collect_link_requirements(driver, diagnostics, front, link)) {
+        return false;
+    }
+
+    // what the linker copies in counts by content, and what it only names counts by the name - the same
+    // trust a `build` places in a system library, which is found again by whatever runs the program
+    std::vector<std::filesystem::path> linked_files;
+    std::vector<std::string> settings;
+    Compiler::partition_link_requirements(link, linked_files, settings);
+
+    settings.push_back(Compiler::executable_identity());
+    settings.push_back(driver.no_stdlib ? "no-stdlib" : "stdlib");
+    settings.push_back(front.options.reporting_allocations() ? "report" : "noreport");
+    settings.push_back(front.options.no_tbaa ? "notbaa" : "tbaa");
+
+    std::string error;
+
+    if (!Compiler::compute_program_key(
+            front.manifests(), front.cache_keys, front.entry_file(), linked_files, settings, out.key, error)) {
+        // a cache that cannot key a program keeps nothing, which is not a reason to refuse the compile
+        out.refused = error;
+        return true;
+    }
+
+    Compiler::FileDigests::instance().save();
+
+    out.stored = Compiler::stored_program_path(out.name, out.key, layout);
+    out.record = Compiler::program_inputs_path(out.name, layout);
+
+    return true;
+}
+
+// keeps the executable a build just linked under its key, and drops whichever this program kept before.
+//
+// **a copy and never a link**, unlike the shared store: `output` is the user's file, and whatever they or the
+// next build do to it in place must not reach the one a later run starts. Staged beside the stored one and
+// renamed over it, so a run never starts half an executable. Best-effort throughout - a program that is not
+// kept costs the next run a compile, exactly what it cost before there was anything to keep
+static void store_program(const ProgramCacheEntry &entry, const std::filesystem::path &output)
+{
+    if (!entry.refused.empty()) {
+        return;
+    }
+
+    const std::filesystem::path directory = entry.stored.parent_path();
+    std::error_code ec;
+
+    std::filesystem::create_directories(directory, ec);
+
+    const std::filesystem::path staged = entry.stored.string() + fmt::format(".{}.partial", getpid());
+
+    if (ec
+        || !std::filesystem::copy_file(output, staged, std::filesystem::copy_options::overwrite_existing, ec)) {
+        std::filesystem::remove(staged, ec);
+        return;
+    }
+
+    std::filesystem::rename(staged, entry.stored, ec);
+
+    if (ec) {
+        std::filesystem::remove(staged, ec);
+        return;
+    }
+
+    // **one kept program per name.** An edit makes a new key and the old executable is never asked for
+    // again, so keeping it is only disk. Matched on the whole `<name>-<key>` shape, so a program called
+    // `app` leaves `app-cli`'s alone
+    const std::string prefix = entry.name + "-";
+
+    for (const auto &kept : std::filesystem::directory_iterator(directory, ec)) {
+        const std::string file = kept.path().filename().string();
+
+        const bool is_ours = file.size() == prefix.size() + entry.key.hex.size()
+            && file.compare(0, prefix.size(), prefix) == 0
+            && file.find_first_not_of("0123456789abcdef", prefix.size()) == std::string::npos;
+
+        if (is_ours && kept.path() != entry.stored) {
+            std::error_code ignored;
+            std::filesystem::remove(kept.path(), ignored);
+        }
+    }
+
+    Compiler::write_inputs_record(entry.record, entry.key);
+}
+
+// **starts the executable a build kept for exactly these inputs, in place of compiling them** - and returns
+// only when there is none, or it could not be started.
+//
+// asked before the parse, which is the whole of what it is for: an unchanged project's `run` after a `build`
+// of the same mode hashes its sources and replaces this process with the program, which is what the JIT path
+// ends in anyway and the milliseconds of a stat rather than the seconds of a compile. The program is handed
+// the argv and the environment the JIT would have handed it, `argv[0]` included, and its exit status is
+// `echoc run`'s because it *is* this process.
+//
+// not asked when the invocation wants to see the compile - a dump, a prune report, a tier report or `-t` -
+// since starting a stored program would answer none of them. `--optimize tiered` alone is still served: the
+// stored program is the same program, already optimized everywhere, and tiering is only a way to get there
+static void start_stored_program(
+    const Compiler::DriverOptions &driver,
+    const Program &program,
+    const ProgramCacheEntry &entry,
+    const char *const *environment
+)
+{
+    const bool explaining = driver.explains(Compiler::ExplainKind::t_cache);
+
+    std::error_code ec;
+    const bool stored = entry.refused.empty() && std::filesystem::is_regular_file(entry.stored, ec);
+
+    if (explaining) {
+        std::cout << "[program cache]" << std::endl;
+        std::cout << "  program  " << entry.name << "  ";
+
+        if (!entry.refused.empty()) {
+            std::cout << "miss  (" << entry.refused << ")" << std::endl;
+        }
+        else if (stored) {
+            std::cout << entry.key.hex << "  hit" << std::endl;
+        }
+        else {
+            // the record is the last kept program's inputs, so a reason from it is what changed since - and
+            // no reason is either no build at all yet, or one that agrees and was since removed
+            std::string why = Compiler::explain_miss(entry.record, entry.key);
+
+            if (why.empty()) {
+                std::error_code record_ec;
+                why = std::filesystem::exists(entry.record, record_ec)
+                    ? "the kept program was removed"
+                    : "no 'echoc build' in this mode has kept one";
+            }
+
+            std::cout << entry.key.hex << "  miss  (" << why << ")" << std::endl;
+        }
+    }
+
+    if (!stored) {
+        return;
+    }
+
+    // **a row and not the closing line**, which is the compile's: should the program not start, the compile
+    // below is what this run becomes, and it closes the checklist the way it always has
+    Compiler::ProgressReporter::instance().row(
+        Compiler::ProgressPhase::t_cached, entry.name, "kept program", Compiler::ProgressState::t_skipped);
+    Compiler::ProgressReporter::instance().suspend();
+
+    const std::string path = entry.stored.string();
+    std::vector<std::string> words = { program_name(driver, program) };
+    words.insert(words.end(), driver.program_arguments.begin(), driver.program_arguments.end());
+
+    std::vector<char *> argv;
+
+    for (std::string &word : words) {
+        argv.push_back(word.data());
+    }
+
+    argv.push_back(nullptr);
+
+    // whatever this process buffered is the compiler's, and has to be out before the program's begins
+    std::cout.flush();
+    std::cerr.flush();
+    fflush(nullptr);
+
+    execve(path.c_str(), argv.data(),
+        const_cast<char *const *>(environment != nullptr ? environment : environ));
+
+    // **still here, so it did not start** - removed under us, or on a filesystem that will not execute.
+    // Compiling is what `run` did before there was a store, and it is never wrong
+}
+
 int main_run(
     const Compiler::DriverOptions &driver,
     const AST::DiagnosticRenderer &diagnostics,
@@ -2002,7 +2861,7 @@ int main_run(
 {
     // **said rather than ignored, and said before anything else.** `-g` is declared on both subcommands so
     // that resolve_options stays one reader of one flag set, but only `build` writes an object a debugger
-    // can open - the JIT keeps its module in memory and MCJIT registers nothing a debugger reads. A flag
+    // can open - the JIT keeps its module in memory and registers nothing a debugger reads. A flag
     // that silently does nothing is the worse failure here: the metadata really is emitted, so nothing
     // downstream is wrong, and the person is left concluding the feature is broken.
     //
@@ -2013,7 +2872,7 @@ int main_run(
     if (driver.options.emitting_debug_info()) {
         diagnostics.render_untyped(
             "Debug Info Ignored",
-            "'-g' produces no artifact a debugger can open on 'run': the JIT emits no object file. "
+            "'-g' produces no artifact a debugger can open on 'run': the program is compiled in memory. "
             "Use 'echoc build -g' and open the resulting executable instead.",
             AST::IssueSeverity::Warning);
     }
@@ -2022,11 +2881,6 @@ int main_run(
     // Deliberately not Compiler::PhaseTimings, which measures nothing unless `-t` asked it to
     const auto started = std::chrono::steady_clock::now();
 
-    auto bundle = AST::Bundle();
-
-    // `run` reuses nothing: the JIT is handed one module, so every unit is merged and there are no per-module
-    // objects to store or load. Feeding it stored objects instead would mean handing the JIT one per cached
-    // module beside main's, which is a question about duplicate weak symbols rather than about caching
     Invocation invocation;
     if (!resolve_invocation(driver, diagnostics, invocation)) {
         return 1;
@@ -2036,16 +2890,44 @@ int main_run(
     const Program &program = invocation.programs.front();
 
     FrontEnd front;
-    if (!run_front_end(driver, diagnostics, invocation, program, bundle, front)) {
+
+    // **before the parse**, which is the point - see start_stored_program. A program it starts never comes
+    // back here; one it does not leaves `front` holding the source keys, and run_front_end keeps them
+    const bool shows_the_compile =
+        driver.prints(Compiler::PrintKind::t_ast) || driver.prints(Compiler::PrintKind::t_ast_resolved)
+        || driver.prints(Compiler::PrintKind::t_ir) || driver.prints(Compiler::PrintKind::t_ir_units)
+        || driver.prints(Compiler::PrintKind::t_symbols) || driver.prints(Compiler::PrintKind::t_instances)
+        || driver.explains(Compiler::ExplainKind::t_prune) || driver.explains(Compiler::ExplainKind::t_time)
+        || driver.explains(Compiler::ExplainKind::t_tiers);
+
+    if (!shows_the_compile) {
+        front.invocation = &invocation;
+        front.program = &program;
+        front.compiled = compiled_manifests(invocation, program);
+        front.options = driver.options;
+
+        ProgramCacheEntry kept;
+
+        if (!key_program(driver, diagnostics, front, kept)) {
+            return 1;
+        }
+
+        start_stored_program(driver, program, kept, environment);
+    }
+
+    if (!run_front_end(driver, diagnostics, invocation, program, front)) {
         return 1;
     }
 
+    AST::Bundle &bundle = *front.bundle;
+
     const std::string &entry_module = front.entry_module();
 
     LLVMCompiler compiler(front.options);
+    JitArtifacts jit;
 
     if (const std::optional<int> failed = prepare_jit(
-            driver, diagnostics, front, bundle, /*test_mode=*/false, compiler)) {
+            driver, diagnostics, front, bundle, /*test_mode=*/false, compiler, jit)) {
         return failed.value();
     }
 
@@ -2061,14 +2943,14 @@ int main_run(
     // **the checklist ends here, and `jit` gets no row.** The compile is over the moment the program
     // starts: a row completing after the program's own output would put the compiler's summary inside
     // the program's conversation, which is the thing "stdout under run belongs to the program" exists to
-    // prevent. The cost is that a slow finalizeObject shows nothing, and it is the right trade
+    // prevent. The cost is that a slow JIT compile shows nothing, and it is the right trade
     Compiler::ProgressReporter::instance().close(
         fmt::format("compiled '{}'", entry_module), Compiler::progress_elapsed_ms(started));
 
     int status = 0;
     {
         Compiler::ScopedPhase phase("jit");
-        status = compiler.prepare_execution() ? compiler.run_main(argv, environment) : 1;
+        status = start_jit(driver, front, compiler, jit) ? compiler.run_main(argv, environment) : 1;
     }
 
     // after the program, because the prune happened inside the run - the same position `[timings]` takes,
@@ -2077,6 +2959,11 @@ int main_run(
         std::cout << compiler.prune_report();
     }
 
+    // after the program for the same reason, and because what got hot is only known once it has run
+    if (driver.explains(Compiler::ExplainKind::t_tiers)) {
+        std::cout << compiler.tier_report();
+    }
+
     std::cout << Compiler::PhaseTimings::instance().report();
 
     // after the program, because a C module's loadable library lives there and was open for the whole of it
@@ -2176,8 +3063,6 @@ int main_test(
 
     const auto started = std::chrono::steady_clock::now();
 
-    auto bundle = AST::Bundle();
-
     Invocation invocation;
     if (!resolve_invocation(driver, diagnostics, invocation)) {
         return 1;
@@ -2188,10 +3073,12 @@ int main_test(
     const Program &program = invocation.programs.front();
 
     FrontEnd front;
-    if (!run_front_end(driver, diagnostics, invocation, program, bundle, front)) {
+    if (!run_front_end(driver, diagnostics, invocation, program, front)) {
         return 1;
     }
 
+    AST::Bundle &bundle = *front.bundle;
+
     Compiler::TestSelection selection;
     if (!resolve_test_selection(driver, diagnostics, invocation, selection)) {
         return 1;
@@ -2223,9 +3110,10 @@ int main_test(
     }
 
     LLVMCompiler compiler(front.options);
+    JitArtifacts jit;
 
     if (const std::optional<int> failed = prepare_jit(
-            driver, diagnostics, front, bundle, /*test_mode=*/true, compiler)) {
+            driver, diagnostics, front, bundle, /*test_mode=*/true, compiler, jit)) {
         return failed.value();
     }
 
@@ -2240,7 +3128,7 @@ int main_test(
 
     compiler.set_jit_roots(std::move(roots));
 
-    if (!compiler.prepare_execution()) {
+    if (!start_jit(driver, front, compiler, jit)) {
         return 1;
     }
 
@@ -2312,37 +3200,27 @@ static int build_one_program(
     const Program &program
 )
 {
-    auto bundle = AST::Bundle();
-
     const bool whole_program = driver.whole_program;
 
     FrontEnd front;
-    if (!run_front_end(driver, diagnostics, invocation, program, bundle, front)) {
+    if (!run_front_end(driver, diagnostics, invocation, program, front)) {
         return 1;
     }
 
+    AST::Bundle &bundle = *front.bundle;
+
     const Compiler::CompilerOptions options = front.options;
     const std::string &entry_module = front.entry_module();
 
     // an optimized or dumped build reuses nothing and stores nothing - see wants_whole_program_module
     const ModulePlan plan = whole_program
         ? ModulePlan{}
-        : plan_module_artifacts(front.layout(), front.manifests(), front.cache_keys, entry_module);
+        : plan_module_artifacts(front.layout(), front.manifests(), front.object_keys, entry_module, options);
 
-    report_cache_plan(driver, front.manifests(), front.cache_keys, plan, entry_module, whole_program);
+    report_cache_plan(
+        driver, front.manifests(), front.object_keys, front.token_uses, plan, entry_module, whole_program);
 
-    // **a reused module gets a row and a rebuilt one does not.** Work that did not happen is the
-    // surprising half; which input changed for the ones that did is `--explain-cache`'s question, and
-    // answering it twice would put explain_miss's reasoning in two places
-    for (const Parser::ModuleManifest *manifest_ptr : front.manifests()) {
-        const Parser::ModuleManifest &manifest = *manifest_ptr;
-
-        if (plan.cached.count(manifest.name) > 0) {
-            Compiler::ProgressReporter::instance().row(
-                Compiler::ProgressPhase::t_cached, manifest.name, "reused",
-                Compiler::ProgressState::t_skipped);
-        }
-    }
+    report_reused_modules(front, plan);
 
     const std::string output = program.output.string();
 
@@ -2383,7 +3261,7 @@ static int build_one_program(
         Compiler::ProgressStep step(
             Compiler::ProgressReporter::instance(), Compiler::ProgressPhase::t_codegen);
 
-        compiler.compile_bundle(bundle, plan.cached);
+        compiler.compile_bundle(bundle, plan.cached, codegen_jobs(driver));
 
         if (whole_program) {
             compiler.link_into_main();
@@ -2436,7 +3314,7 @@ static int build_one_program(
         // was handed.
         // The tool that failed has already said what it could, and what it could not say is which
         // manifest asked for each requirement
-        const bool linked = emit_and_link_modules(compiler, front.layout(), output, plan, link);
+        const bool linked = emit_and_link_modules(driver, compiler, front.layout(), output, plan, link);
 
         // closed before the failure is reported rather than by the destructor after it, so the row sits
         // above the sentence that explains it - the order every other step reaches deliberately
@@ -2448,12 +3326,30 @@ static int build_one_program(
         }
     }
 
+    // under `[cache]` because it is the rest of that answer: the module rows say which summaries were reused,
+    // and only the link knows which units that spared codegen. Empty on any build that is not thin
+    if (driver.explains(Compiler::ExplainKind::t_cache)) {
+        std::cout << compiler.thin_link_report();
+        std::cout << compiler.instance_report();
+    }
+
     // only now, and only for what was actually emitted: a record written before the object exists would
     // describe a build that may still have failed
     if (!whole_program) {
-        store_module_records(plan, front.cache_keys);
+        store_module_records(front.layout(), plan, front.object_keys);
+    }
+
+    // and the executable itself, for a later `run` of these same inputs to start instead of compiling them -
+    // see start_stored_program. Whole-program builds too: the key folds `-O`, so only a run asking for the
+    // same is ever started on one
+    ProgramCacheEntry kept;
+
+    if (!key_program(driver, diagnostics, front, kept)) {
+        return 1;
     }
 
+    store_program(kept, output);
+
     // **after the link succeeded, and only then.** A failed build is one somebody is about to look at, and
     // the objects it got as far as producing are part of what there is to look at
     front.layout().discard_temporary_scratch();
@@ -2483,6 +3379,13 @@ int main_build(const Compiler::DriverOptions &driver, const AST::DiagnosticRende
             std::cout << "[target " << program.name << "]" << std::endl;
         }
 
+        // only the last program's bundle is dropped on the way out of the process. One before it is
+        // dropped while the next is still to be parsed, and kept until exit it would be memory a
+        // many-target build holds for nothing - see NodeCollection::skip_teardown
+        if (&program == &invocation.programs.back()) {
+            AST::NodeCollection::skip_teardown();
+        }
+
         if (build_one_program(driver, diagnostics, invocation, program) != 0) {
             // **the first failure stops the build.** run_semantic_passes renders one summary per program
             // and `--diagnostics json` promises diagnostics then *one* of them - and an error in code the
@@ -2548,7 +3451,7 @@ int main_clean(const Compiler::DriverOptions &driver, const AST::DiagnosticRende
             driver.modules,
             /*with_stdlib=*/true,
             /*allow_project_discovery=*/true,
-            diagnostics, facts, driver.package_dir, manifests, roots)) {
+            diagnostics, facts, driver.package_dir, driver.build_dir, manifests, roots)) {
         return 1;
     }
 
@@ -2647,6 +3550,61 @@ int main_clean(const Compiler::DriverOptions &driver, const AST::DiagnosticRende
     return refused ? 1 : 0;
 }
 
+// reports on, or trims, the store `ECO_CACHE_DIR` names - see Compiler::SharedStore.
+//
+// **no store is not an error.** Sharing is off until somebody turns it on, and a command that exits non-zero
+// on a machine that simply never did would make a CI step that prunes "just in case" a failure
+static int main_cache(const Compiler::DriverOptions &driver, const AST::DiagnosticRenderer &diagnostics)
+{
+    std::string size_error;
+    const std::optional<Compiler::SharedStore> store = Compiler::SharedStore::from_environment(&size_error);
+
+    if (!store.has_value()) {
+        std::cerr << "No shared store: ECO_CACHE_DIR is not set, so every project keeps its own objects."
+                  << std::endl;
+        return 0;
+    }
+
+    // a build holds the store to the default without a word, because it is in no position to say one; this
+    // command is the one place the mistake can be pointed out
+    if (!size_error.empty()) {
+        diagnostics.render_untyped("Unreadable Cache Size", size_error, AST::IssueSeverity::Warning);
+    }
+
+    const std::string shown = store->root().string();
+
+    if (driver.cache_action == Compiler::CacheAction::t_stats) {
+        const Compiler::SharedStore::Usage usage = store->usage();
+
+        std::cout << "[cache store]" << std::endl
+                  << "  " << shown << std::endl
+                  << fmt::format("  {} object{}, {} of {}",
+                         usage.objects, usage.objects == 1 ? "" : "s",
+                         Compiler::describe_byte_size(usage.bytes),
+                         Compiler::describe_byte_size(store->capacity()))
+                  << std::endl;
+
+        return 0;
+    }
+
+    const Compiler::SharedStore::Pruned pruned = store->prune(store->capacity(), driver.dry_run);
+
+    std::cout << "[cache prune]" << std::endl
+              << "  " << shown << std::endl
+              << fmt::format("  {} {} object{}, {}",
+                     driver.dry_run ? "would remove" : "removed",
+                     pruned.removed.objects, pruned.removed.objects == 1 ? "" : "s",
+                     Compiler::describe_byte_size(pruned.removed.bytes))
+              << std::endl
+              << fmt::format("  kept {} object{}, {} of {}",
+                     pruned.kept.objects, pruned.kept.objects == 1 ? "" : "s",
+                     Compiler::describe_byte_size(pruned.kept.bytes),
+                     Compiler::describe_byte_size(store->capacity()))
+              << std::endl;
+
+    return 0;
+}
+
 // `envp` is taken rather than reached for, and that is the whole reason `std::env` needs no platform
 // conditionals: the environment block arrives as a parameter on every platform we target, whereas the
 // `environ` symbol it would otherwise have to read is spelled `_NSGetEnviron()` on Darwin and is not
@@ -2706,7 +3664,448 @@ static int main_print_manifest(
     return 0;
 }
 
+static int run_command(int argc, char *argv[], char *envp[]);
+
+static int run_subcommand(
+    const Compiler::DriverOptions &driver,
+    const AST::DiagnosticRenderer &diagnostics,
+    const Compiler::TerminalCapabilities &capabilities,
+    char *envp[]
+);
+
+// **parses the first program's libraries into s_warm_bundle**, so a process forked after this returns starts
+// holding them - see adopt_warm_bundle.
+//
+// the program's own front end, up to and excluding its entry module, because the next compile is most often
+// this one again with the entry module edited. Everything it finds wrong is dropped unsaid - the compile it
+// mirrors already said it - and a bundle with a critical issue in it is not kept: a child adopting it would
+// report the issue as its own without having parsed anything.
+//
+// **a bundle already warm for exactly these libraries is kept as it is.** The process holding it only ever
+// forks the compiles that adopt it, so its own copy is the one the parse left - and a server answering the
+// same command again would otherwise spend each gap between requests parsing what it already holds, with
+// the next request queued behind that parse. Exactly is adopt_warm_bundle's word: the same modules in the
+// same order under the same source keys, and the same standard library
+static void warm_libraries(
+    const Compiler::DriverOptions &driver,
+    const AST::DiagnosticRenderer &diagnostics,
+    const Invocation &invocation
+)
+{
+    if (invocation.programs.empty()) {
+        s_warm_bundle = WarmBundle();
+        return;
+    }
+
+    const Program &program = invocation.programs.front();
+
+    FrontEnd front;
+    front.invocation = &invocation;
+    front.program = &program;
+    front.compiled = compiled_manifests(invocation, program);
+    front.options = driver.options;
+
+    if (!compute_cache_keys(
+            driver, diagnostics, front.layout(), front.manifests(), front.options, front.target_facts(),
+            front.test_modules(), program.active_targets, front.cache_keys)) {
+        s_warm_bundle = WarmBundle();
+        return;
+    }
+
+    std::vector<const Parser::ModuleManifest *> libraries;
+    std::vector<std::pair<std::string, std::string>> wanted_modules;
+
+    for (const Parser::ModuleManifest *manifest : front.compiled) {
+        if (manifest->name == front.entry_module()) {
+            break;
+        }
+
+        libraries.push_back(manifest);
+        wanted_modules.emplace_back(manifest->name, front.cache_keys.at(manifest->name).hex);
+    }
+
+#if ECO_USE_EMBEDDED_STDLIB
+    const std::string wanted_stdlib = driver.no_stdlib ? std::string() : embedded_stdlib_signature(front);
+#else
+    const std::string wanted_stdlib;
+#endif
+
+    if (s_warm_bundle.bundle != nullptr && s_warm_bundle.modules == wanted_modules
+        && s_warm_bundle.stdlib_signature == wanted_stdlib) {
+        return;
+    }
+
+    s_warm_bundle = WarmBundle();
+
+    const std::map<std::string, Parser::TokenStore> token_stores =
+        plan_token_stores(front.layout(), front.manifests(), front.cache_keys, front.entry_module());
+
+    Parser::ModuleParser parser(front.target_facts(), front.test_modules());
+
+    WarmBundle warm;
+    warm.bundle = std::make_unique<AST::Bundle>();
+
+#if ECO_USE_EMBEDDED_STDLIB
+    if (!driver.no_stdlib) {
+        if (guard_parse(diagnostics, [&] { parse_embedded_stdlib_module(*warm.bundle, parser); })) {
+            return;
+        }
+
+        warm.stdlib_signature = wanted_stdlib;
+    }
+#endif
+
+    if (parse_manifest_modules(
+            diagnostics, libraries, invocation.roots, program.active_targets, driver.jobs, token_stores,
+            *warm.bundle, parser, warm.token_uses) != 0
+        || warm.bundle->collector.has_critical_issues()) {
+        return;
+    }
+
+    warm.modules = std::move(wanted_modules);
+    s_warm_bundle = std::move(warm);
+}
+
+// **what a compile server does once a request is answered**: warm_libraries for that request, in the server,
+// so the next request's child is forked already holding them. A request that is not a compile leaves the
+// bundle as it is, for the next one that is - adopt_warm_bundle checks it against whoever adopts it
+static void warm_for_next_request(const Compiler::ServedRequest &request)
+{
+    std::vector<std::string> words = request.arguments;
+    std::vector<char *> argv;
+
+    for (std::string &word : words) {
+        argv.push_back(word.data());
+    }
+
+    Compiler::CommandLine cli;
+    Compiler::DriverOptions driver;
+    std::string error;
+
+    if (!Compiler::parse_command_line(static_cast<int>(argv.size()), argv.data(), cli, error)
+        || cli.wants_help || cli.wants_version
+        || !Compiler::resolve_driver_options(cli, driver, error)
+        || (Compiler::bit_of(driver.subcommand) & Compiler::accepts::compiling) == 0
+        || driver.prints(Compiler::PrintKind::t_manifest)) {
+        return;
+    }
+
+    std::ostream discarded(nullptr);
+    const AST::DiagnosticRenderer diagnostics(
+        discarded, driver.format, Compiler::TerminalCapabilities::resolve(driver.color, driver.format));
+
+    // **a warm-up that fails leaves the server cold, never down.** Whatever threw here threw for the
+    // request too, which reported it
+    try {
+        Invocation invocation;
+        if (resolve_invocation(driver, diagnostics, invocation)) {
+            warm_libraries(driver, diagnostics, invocation);
+        }
+    }
+    catch (...) {
+        s_warm_bundle = WarmBundle();
+    }
+}
+
+// `echoc serve`: the server loop, and what each request is served with - see Compiler::serve_requests.
+//
+// each child runs run_command itself, so a served invocation is the command line it would have been,
+// refused, answered and reported in the same words. What the server adds is only what the child is forked
+// with: the native target already registered, and the libraries the last request parsed
+static int main_serve(const Compiler::DriverOptions &driver, const AST::DiagnosticRenderer &diagnostics)
+{
+    if (!Compiler::compile_server_available()) {
+        diagnostics.render_untyped("No Compile Server",
+            "'echoc serve' hands each command's terminal to a process of its own, and this platform has no "
+            "fork. Every other subcommand is unaffected.");
+        return 1;
+    }
+
+    // **before the first fork**, so no child ever pays for it. Registration is process-wide and idempotent,
+    // which is what makes doing it once here the same as every child doing it for itself
+    Compiler::ensure_native_target_registered();
+
+    const std::filesystem::path socket = Compiler::server_socket_path();
+
+    if (!driver.silent) {
+        std::cerr << "echoc " ECO_VERSION_STRING " is serving on '" << socket.string()
+                  << "'. Ctrl-C stops it." << std::endl;
+    }
+
+    const auto serve = [](const Compiler::ServedRequest &request) {
+        std::vector<std::string> words = request.arguments;
+        std::vector<char *> argv;
+
+        for (std::string &word : words) {
+            argv.push_back(word.data());
+        }
+
+        argv.push_back(nullptr);
+
+        return run_command(static_cast<int>(words.size()), argv.data(), environ);
+    };
+
+    std::string error;
+    const int status = Compiler::serve_requests(socket, serve, warm_for_next_request, error);
+
+    if (status != 0) {
+        diagnostics.render_untyped("No Compile Server", error);
+    }
+
+    return status;
+}
+
+// **every file the last build read**, for `--watch` to wait on: the loose sources, every manifest, each
+// compiled module's sources, and what each module's C build last read - headers included, which is why it
+// is the depfiles that are asked and not the manifest.
+//
+// the first program's view of it. A second program of the same invocation differs only in its entry file,
+// and its entry file is a source of its own module like any other
+static std::vector<std::filesystem::path> watched_inputs(const Invocation &invocation)
+{
+    std::vector<std::filesystem::path> out = invocation.sources;
+
+    for (const Parser::ModuleManifest &manifest : invocation.manifests) {
+        out.push_back(manifest.path);
+    }
+
+    for (const Program &program : invocation.programs) {
+        for (const Parser::ModuleManifest *manifest : compiled_manifests(invocation, program)) {
+            const Parser::ModuleContribution contribution =
+                Parser::module_contribution_for(*manifest, program.active_targets);
+
+            out.insert(out.end(), contribution.sources.begin(), contribution.sources.end());
+
+            if (!contribution.cc.empty()) {
+                const std::vector<std::filesystem::path> c_inputs =
+                    Compiler::c_build_inputs(contribution.cc, invocation.layout.module_cc_dir(*manifest));
+
+                out.insert(out.end(), c_inputs.begin(), c_inputs.end());
+            }
+        }
+    }
+
+    return out;
+}
+
+// what is left to watch when the invocation does not resolve - most often a manifest that no longer parses.
+// The files it was asked about by name, which are the ones an edit is most likely to be fixing
+static std::vector<std::filesystem::path> named_inputs(const Compiler::DriverOptions &driver)
+{
+    std::vector<std::filesystem::path> out(driver.sources.begin(), driver.sources.end());
+
+    for (const std::string &module : driver.modules) {
+        out.push_back(Parser::manifest_at(module).value_or(module));
+    }
+
+    if (driver.sources.empty() && driver.modules.empty()) {
+        if (const std::optional<std::filesystem::path> manifest = discover_project_manifest()) {
+            out.push_back(manifest.value());
+        }
+    }
+
+    return out;
+}
+
+// what the next build will read, with the invocation resolved again and said nothing about - and, when
+// `warm`, the libraries parsed ahead of it while nothing is changing. What is left when the invocation no
+// longer resolves is named_inputs
+static std::vector<std::filesystem::path> next_inputs(
+    const Compiler::DriverOptions &driver,
+    const AST::DiagnosticRenderer &quiet,
+    bool warm
+)
+{
+    std::vector<std::filesystem::path> inputs;
+
+    try {
+        Invocation invocation;
+
+        if (resolve_invocation(driver, quiet, invocation)) {
+            inputs = watched_inputs(invocation);
+
+            if (warm) {
+                warm_libraries(driver, quiet, invocation);
+            }
+        }
+    }
+    catch (...) {
+        s_warm_bundle = WarmBundle();
+    }
+
+    if (inputs.empty()) {
+        inputs = named_inputs(driver);
+    }
+
+    return inputs;
+}
+
+// `--watch`: `build_once`, then again every time one of the files it read changes, until Ctrl-C.
+//
+// **each build is a forked child**, for the reason `echoc serve` forks one per request: the semantic passes
+// mutate the bundle they are handed, so the libraries this process parses between builds can be reused
+// only by a process that is thrown away afterwards. What stays in this one is what the next build starts
+// from - the native target, and the libraries warm_libraries parsed while nothing was changing - and what
+// is on disk does the rest: an unchanged module's object is a cache hit, so only what the edit reached is
+// compiled again.
+//
+// **the watch is armed before each build starts**, and its inputs stamped, so a save that lands while the
+// build runs is the next build rather than lost. Re-arming afterwards diffs the watched set, keeping every
+// event already queued, and the stamps catch what no watch was on: a file only this build made an input.
+//
+// under `--explain time` each build's own report is followed by the watcher's - `rebuild` from the change
+// being noticed to the build exiting, which is the latency somebody at the editor waits through, and
+// `rearm watch` for what the watcher did before it could wait again
+//
+// the status is the last build's, for the one way out that is not Ctrl-C: nothing left that can be watched
+static int main_watch(
+    const Compiler::DriverOptions &driver,
+    const AST::DiagnosticRenderer &diagnostics,
+    const std::function<int()> &build_once
+)
+{
+    if (!Compiler::compile_server_available()) {
+        diagnostics.render_untyped("Cannot Watch",
+            "'--watch' builds each time in a process of its own, and this platform has no fork. Leave it "
+            "off to build once.");
+        return 1;
+    }
+
+    Compiler::ensure_native_target_registered();
+
+    const char *what = driver.subcommand == Compiler::Subcommand::t_test ? "test run" : "build";
+
+    std::ostream discarded(nullptr);
+    const AST::DiagnosticRenderer quiet(
+        discarded, driver.format, Compiler::TerminalCapabilities::resolve(driver.color, driver.format));
+
+    Compiler::FileWatcher watcher;
+    Compiler::PhaseTimings &timings = Compiler::PhaseTimings::instance();
+
+    // the first build's inputs, resolved before it rather than after, so it is watched like every later one
+    std::vector<std::filesystem::path> inputs = next_inputs(driver, quiet, false);
+    watcher.watch(inputs);
+
+    std::vector<std::filesystem::path> changed;
+
+    while (true) {
+        std::cout.flush();
+        std::cerr.flush();
+
+        timings.reset();
+
+        const auto started = std::chrono::steady_clock::now();
+        const Compiler::FileWatcher::Snapshot before = Compiler::FileWatcher::snapshot(inputs);
+        int status = 1;
+
+        {
+            Compiler::ScopedPhase rebuild("rebuild");
+            timings.count("changed files", changed.size());
+
+            const pid_t child = fork();
+
+            if (child < 0) {
+                diagnostics.render_untyped("Cannot Watch",
+                    fmt::format("Could not start a {}: {}.", what, std::strerror(errno)));
+                return 1;
+            }
+
+            if (child == 0) {
+                // the clock starts over with each build, so `--explain time` describes this one and not the
+                // resolution the watcher did between them
+                timings.reset();
+
+                const int built = build_once();
+
+                std::cout.flush();
+                std::cerr.flush();
+                _exit(built);
+            }
+
+            int waited = 0;
+
+            while (waitpid(child, &waited, 0) < 0 && errno == EINTR) {
+            }
+
+            status = WIFEXITED(waited) ? WEXITSTATUS(waited) : 1;
+        }
+
+        const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+
+        {
+            Compiler::ScopedPhase rearm("rearm watch");
+
+            // **resolved after the build rather than once up front** so that what is watched is what this
+            // build read: a source a manifest edit added, a header a C edit started including
+            inputs = next_inputs(driver, quiet, true);
+            watcher.watch(inputs);
+
+            changed = Compiler::FileWatcher::changed_since(before, inputs);
+        }
+
+        std::cout << timings.report();
+
+        if (!driver.silent) {
+            std::cerr << fmt::format(
+                "[watch] The {} {} in {} ms. Watching {} file{}; Ctrl-C stops it.",
+                what, status == 0 ? "succeeded" : "failed", milliseconds,
+                inputs.size(), inputs.size() == 1 ? "" : "s") << std::endl;
+        }
+
+        // a change made while the build ran is built now. Whatever the watch queued for it is the same
+        // change, and is dropped so that it does not start the build after this one too
+        if (!changed.empty()) {
+            watcher.forget_pending();
+        }
+        else {
+            changed = watcher.wait_for_change();
+        }
+
+        if (changed.empty()) {
+            diagnostics.render_untyped("Cannot Watch",
+                "Nothing this build read can be watched, so there is nothing to build again on.");
+            return status;
+        }
+
+        if (!driver.silent) {
+            const std::filesystem::path shown =
+                changed.front().lexically_proximate(std::filesystem::current_path());
+            const std::string more =
+                changed.size() > 1 ? fmt::format(" and {} more", changed.size() - 1) : "";
+
+            std::cerr << fmt::format("[watch] '{}'{} changed.", shown.string(), more) << std::endl;
+        }
+    }
+}
+
 int main(int argc, char *argv[], char *envp[])
+{
+    // **a compile is handed to a running server before anything else happens**, and only a compile: `clean`,
+    // `serve` itself and a question like `--help` gain nothing from one. Asked of the first word alone,
+    // because parsing the rest is the server's job - and a server that is not there, or is not this very
+    // executable, answers nullopt and the command runs here as it always did
+    if (argc > 1) {
+        const Compiler::SubcommandInfo *named = Compiler::subcommand_for_word(argv[1]);
+
+        // nor `--watch`, which is a loop of its own that keeps the libraries warm between builds and would
+        // only be kept from that by a server answering its first
+        const bool watching = std::any_of(argv + 1, argv + argc, [](const char *word) {
+            return std::strcmp(word, "--watch") == 0;
+        });
+
+        if (named != nullptr && (named->bit & Compiler::accepts::compiling) != 0 && !watching) {
+            if (const std::optional<int> served = Compiler::forward_to_server(argc, argv)) {
+                return served.value();
+            }
+        }
+    }
+
+    return run_command(argc, argv, envp);
+}
+
+// the whole of an invocation, whichever process runs it - this one, or a compile server's child
+static int run_command(int argc, char *argv[], char *envp[])
 {
     // **parse, then answer, then resolve.** Compiler::parse_command_line owns every rule about what the
     // words mean, including the bare `--` split, so nothing here reaches into argv - and --help and
@@ -2776,6 +4175,33 @@ int main(int argc, char *argv[], char *envp[])
     // json form wants one stream that carries diagnostics and nothing else
     const AST::DiagnosticRenderer diagnostics(std::cerr, driver.format, capabilities);
 
+    // **before the checklist is switched on**, which is process-wide: the server's children inherit its
+    // state, and each of them decides for itself whether its own terminal wants one. The clock above never
+    // is for `serve`, which takes no `--explain`
+    if (driver.subcommand == Compiler::Subcommand::t_serve) {
+        return main_serve(driver, diagnostics);
+    }
+
+    // and for the same reason: the watcher forks every build, and each build switches the checklist on in
+    // itself
+    if (driver.watch) {
+        return main_watch(driver, diagnostics, [&] {
+            return run_subcommand(driver, diagnostics, capabilities, envp);
+        });
+    }
+
+    return run_subcommand(driver, diagnostics, capabilities, envp);
+}
+
+// the subcommand itself, once the command line has been answered - in this process, or in each build
+// main_watch forks
+static int run_subcommand(
+    const Compiler::DriverOptions &driver,
+    const AST::DiagnosticRenderer &diagnostics,
+    const Compiler::TerminalCapabilities &capabilities,
+    char *envp[]
+)
+{
     // **the same stream, and the gate that keeps them from fighting over it.** The checklist is drawn only
     // when stderr is a terminal that can be redrawn, `--silent` was not given, and the format is not the
     // machine-readable one - so a pipe, a CI log and the e2e corpus write nothing and need no
@@ -2792,6 +4218,14 @@ int main(int argc, char *argv[], char *envp[])
         return main_print_manifest(driver, diagnostics);
     }
 
+    // **every subcommand below returns straight out of `main`**, so the bundle it drops is dropped on the
+    // way out of the process - and running the destructor of every node in it would be the last thing a
+    // compile spends time on, for memory the exit hands back anyway. Except `build`, which drops one
+    // bundle per target and so switches this on itself, for the last of them
+    if (driver.subcommand != Compiler::Subcommand::t_build) {
+        AST::NodeCollection::skip_teardown();
+    }
+
     switch (driver.subcommand) {
     case Compiler::Subcommand::t_run:
         return main_run(driver, diagnostics, envp);
@@ -2805,6 +4239,13 @@ int main(int argc, char *argv[], char *envp[])
     case Compiler::Subcommand::t_test:
         return main_test(driver, diagnostics, capabilities, envp);
 
+    case Compiler::Subcommand::t_cache:
+        return main_cache(driver, diagnostics);
+
+    // answered by run_command, before anything process-wide was switched on
+    case Compiler::Subcommand::t_serve:
+        break;
+
     // unreachable: the parser refuses an invocation with no command, so this is here to make the switch
     // total rather than to be taken
     case Compiler::Subcommand::t_none:
@@ -1,5 +1,9 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
 #include <AST/ASTNodeReference.h>
 #include <AST/NullNode.h>
 #include <AST/ScopeNode.h>
@@ -50,3 +54,64 @@ TEST_CASE( "Node Reference List", "[AST]" )
     REQUIRE( reflist[0].has_type<AST::NullNode>() );
     REQUIRE( !reflist[0].has_type<AST::ScopeNode>() );
 }
+
+TEST_CASE( "Nodes stay where they were made, across arena blocks, a forget and a move", "[AST]" )
+{
+    auto nodes = AST::NodeCollection();
+
+    // comfortably more than one of the arena's blocks holds
+    std::vector<AST::ScopeNode *> scopes;
+    for (int i = 0; i < 5000; i++) {
+        auto &scope = nodes.emplace_back<AST::ScopeNode>();
+        scope.children.push_back(AST::make_ref<AST::NullNode>(&nodes.emplace_back<AST::NullNode>()));
+        scopes.push_back(&scope);
+    }
+
+    REQUIRE( nodes.size() == 10000 );
+    REQUIRE( nodes.of_type<AST::ScopeNode>().size() == 5000 );
+
+    for (AST::ScopeNode *scope : scopes) {
+        REQUIRE( reinterpret_cast<uintptr_t>(scope) % alignof(AST::ScopeNode) == 0 );
+        REQUIRE( scope->children.size() == 1 );
+        REQUIRE( scope->children[0].has_type<AST::NullNode>() );
+    }
+
+    // forgotten is unlisted, not freed
+    nodes.forget({ scopes[0], scopes[1] });
+
+    REQUIRE( nodes.of_type<AST::ScopeNode>().size() == 4998 );
+    REQUIRE( nodes.size() == 10000 );
+    REQUIRE( scopes[0]->children[0].has_type<AST::NullNode>() );
+
+    auto moved = std::move(nodes);
+
+    REQUIRE( moved.size() == 10000 );
+    REQUIRE( moved.of_type<AST::ScopeNode>().front() == scopes[2] );
+    REQUIRE( scopes[4999]->children[0].has_type<AST::NullNode>() );
+}
+
+TEST_CASE( "A forget keeps the order of what is left, and leaves another collection's nodes alone", "[AST]" )
+{
+    auto nodes = AST::NodeCollection();
+    auto other = AST::NodeCollection();
+
+    std::vector<AST::NullNode *> nulls;
+    for (int i = 0; i < 6; i++) {
+        nulls.push_back(&nodes.emplace_back<AST::NullNode>());
+    }
+    auto &scope = nodes.emplace_back<AST::ScopeNode>();
+    auto &foreign = other.emplace_back<AST::NullNode>();
+
+    // one batch, handed to both the way Bundle::forget_nodes hands it to every module
+    const std::unordered_set<const AST::Node *> gone { nulls[1], nulls[4], &foreign };
+    nodes.forget(gone);
+
+    REQUIRE( nodes.of_type<AST::NullNode>() == std::vector<AST::NullNode *>{ nulls[0], nulls[2], nulls[3], nulls[5] } );
+    REQUIRE( nodes.of_type<AST::ScopeNode>().front() == &scope );
+    REQUIRE( other.of_type<AST::NullNode>().front() == &foreign );
+
+    other.forget(gone);
+
+    REQUIRE( other.of_type<AST::NullNode>().empty() );
+    REQUIRE( nodes.of_type<AST::NullNode>().size() == 4 );
+}
@@ -172,9 +172,9 @@ TEST_CASE("every spelling in the option table is unique", "[cli]")
 // **a hard list, so an eighth short option is a decision somebody makes in this file.** The spellings this
 // overhaul removed - `-ar`, `-syt`, `-pu`, `-ec` and the rest - were shorts that could never be clustered
 // and read as long flags with a dash missing
-TEST_CASE("only single-character shorthands exist, and only these seven", "[cli]")
+TEST_CASE("only single-character shorthands exist, and only these eight", "[cli]")
 {
-    const std::string allowed = "hvompgn";
+    const std::string allowed = "hvompgnj";
 
     for (const CommandLineOption &option : Compiler::command_line_options()) {
         if (option.shorthand == '\0') {
@@ -285,19 +285,22 @@ TEST_CASE("a value's code is its enumerator", "[cli]")
     REQUIRE(prints[6].code == static_cast<unsigned int>(PrintKind::t_manifest));
 
     const std::vector<Compiler::OptionValue> &explains = Compiler::option_for(Opt::t_explain).values;
-    REQUIRE(explains.size() == 4);
+    REQUIRE(explains.size() == 5);
 
     REQUIRE(explains[0].code == static_cast<unsigned int>(ExplainKind::t_cache));
     REQUIRE(explains[1].code == static_cast<unsigned int>(ExplainKind::t_prune));
     REQUIRE(explains[2].code == static_cast<unsigned int>(ExplainKind::t_memory));
     REQUIRE(explains[3].code == static_cast<unsigned int>(ExplainKind::t_time));
+    REQUIRE(explains[4].code == static_cast<unsigned int>(ExplainKind::t_tiers));
 
     const std::vector<Compiler::OptionValue> &modes = Compiler::option_for(Opt::t_optimize).values;
-    REQUIRE(modes.size() == 3);
+    REQUIRE(modes.size() == 5);
 
     REQUIRE(modes[0].code == static_cast<unsigned int>(OptimizeMode::t_none));
     REQUIRE(modes[1].code == static_cast<unsigned int>(OptimizeMode::t_module));
     REQUIRE(modes[2].code == static_cast<unsigned int>(OptimizeMode::t_whole));
+    REQUIRE(modes[3].code == static_cast<unsigned int>(OptimizeMode::t_thin));
+    REQUIRE(modes[4].code == static_cast<unsigned int>(OptimizeMode::t_tiered));
 }
 
 // a retirement sentence that shadowed a live flag would refuse the very spelling it recommends
@@ -452,7 +455,7 @@ TEST_CASE("a refusal says which mistake was made", "[cli]")
     REQUIRE(refusal({}) == "No command given.");
 
     REQUIRE(refusal({ "compile", "a.eco" })
-        == "'compile' is not an echoc command. Write 'run', 'build', 'test' or 'clean'.");
+        == "'compile' is not an echoc command. Write 'run', 'build', 'test', 'clean', 'serve' or 'cache'.");
 
     REQUIRE(refusal({ "run", "--nonsense", "a.eco" }) == "Unknown option '--nonsense'.");
 
@@ -485,6 +488,31 @@ TEST_CASE("a refusal says which mistake was made", "[cli]")
 
     REQUIRE(refusal({ "clean", "--explain", "cache" }) == "'clean' does not take '--explain'.");
 
+    REQUIRE(refusal({ "serve" }) == "<accepted>");
+    REQUIRE(refusal({ "serve", "--silent" }) == "<accepted>");
+    REQUIRE(refusal({ "serve", "app.eco" })
+        == "'serve' takes no source files. Each command it serves names its own.");
+    REQUIRE(refusal({ "serve", "-m", "lib" }) == "'serve' does not take '-m, --module'.");
+
+    // the store is the environment's to name, so `cache` takes its action and nothing that locates a build
+    REQUIRE(refusal({ "cache", "stats" }) == "<accepted>");
+    REQUIRE(refusal({ "cache", "prune", "-n" }) == "<accepted>");
+    REQUIRE(refusal({ "cache" }) == "'cache' needs one of 'stats' or 'prune'.");
+    REQUIRE(refusal({ "cache", "clear" }) == "'clear' is not something 'cache' does. Write 'stats' or 'prune'.");
+    REQUIRE(refusal({ "cache", "prune", "old" }) == "'cache prune' takes nothing after it.");
+    REQUIRE(refusal({ "cache", "stats", "-m", "lib" }) == "'cache' does not take '-m, --module'.");
+    REQUIRE(resolved({ "cache", "prune", "-n" }).cache_action == Compiler::CacheAction::t_prune);
+    REQUIRE(resolved({ "cache", "prune", "-n" }).dry_run);
+
+    // a loop around a build has a build to repeat, and `run` hands the terminal to a program that may never
+    // give it back
+    REQUIRE(refusal({ "build", "--watch", "-o", "out", "a.eco" }) == "<accepted>");
+    REQUIRE(refusal({ "test", "--watch", "a.eco" }) == "<accepted>");
+    REQUIRE(refusal({ "run", "--watch", "a.eco" }) == "'run' does not take '--watch'.");
+    REQUIRE(refusal({ "clean", "--watch" }) == "'clean' does not take '--watch'.");
+    REQUIRE(resolved({ "test", "--watch", "a.eco" }).watch);
+    REQUIRE_FALSE(resolved({ "test", "a.eco" }).watch);
+
     REQUIRE(refusal({ "build", "--timeout", "200", "-o", "out", "a.eco" })
         == "'build' does not take '--timeout'.");
 
@@ -501,7 +529,7 @@ TEST_CASE("a refusal says which mistake was made", "[cli]")
         "two answers to one question"));
 
     REQUIRE(refusal({ "run", "--optimize", "hard", "a.eco" })
-        == "Unknown '--optimize' value 'hard'. Expected one of: none|module|whole.");
+        == "Unknown '--optimize' value 'hard'. Expected one of: none|module|whole|tiered.");
 
     // the vocabulary another owner holds still reports through that owner's own table
     REQUIRE(contains(refusal({ "run", "--color", "alwyas", "a.eco" }), "Unknown '--color' value"));
@@ -553,6 +581,19 @@ TEST_CASE("debug symbols default the optimize mode but never override a written
     REQUIRE_FALSE(stated_module.options.no_optimize);
 }
 
+// **the default is settled here, never left for a reader to interpret.** Zero is both what an unwritten
+// count would naively read as and a refusal when written, so nothing downstream may ever see one
+TEST_CASE("the job count defaults to at least one and a written one wins", "[cli]")
+{
+    REQUIRE(resolved({ "build", "-o", "x", "a.eco" }).jobs >= 1);
+    REQUIRE(resolved({ "build", "-o", "x", "-j", "3", "a.eco" }).jobs == 3);
+    REQUIRE(resolved({ "run", "--jobs", "1", "a.eco" }).jobs == 1);
+
+    REQUIRE(refusal({ "build", "-o", "x", "-j", "0", "a.eco" }) != "<accepted>");
+    REQUIRE(refusal({ "build", "-o", "x", "-j", "many", "a.eco" }) != "<accepted>");
+    REQUIRE(refusal({ "clean", "-j", "2" }) != "<accepted>");
+}
+
 // **the single assertion standing between this and a silent cache-key change.** A dump changes no
 // emitted byte, so it must force the merge without ever reaching Compiler::compute_module_keys
 TEST_CASE("printing the IR merges the program but never enters the cache key", "[cli]")
@@ -567,8 +608,10 @@ TEST_CASE("printing the IR merges the program but never enters the cache key", "
     REQUIRE(optimized.whole_program);
     REQUIRE(optimized.optimize_is_whole_program());
 
-    // the JIT holds one module and emits no object, so there is never an artifact to store or reuse
-    REQUIRE(resolved({ "run", "a.eco" }).whole_program);
+    // the JIT loads per-module objects, so a plain run reuses and stores them the way a build does
+    REQUIRE_FALSE(resolved({ "run", "a.eco" }).whole_program);
+    REQUIRE_FALSE(resolved({ "test", "a.eco" }).whole_program);
+    REQUIRE(resolved({ "run", "--print", "ir", "a.eco" }).whole_program);
     REQUIRE_FALSE(resolved({ "run", "a.eco" }).optimize_is_whole_program());
 
     const DriverOptions plain = resolved({ "build", "-o", "x", "a.eco" });
@@ -577,6 +620,43 @@ TEST_CASE("printing the IR merges the program but never enters the cache key", "
     REQUIRE_FALSE(plain.optimize_is_whole_program());
 }
 
+// **thin is the one mode that changes what a unit's artifact is**, so it has a per-unit half on the options -
+// and it is the one mode a subcommand without a link cannot honour
+TEST_CASE("a thin build keeps the per-module cache and is a build's alone", "[cli]")
+{
+    const DriverOptions thin = resolved({ "build", "-o", "x", "--optimize", "thin", "a.eco" });
+
+    REQUIRE_FALSE(thin.whole_program);
+    REQUIRE_FALSE(thin.optimize_is_whole_program());
+    REQUIRE(thin.options.thin_lto);
+    REQUIRE_FALSE(thin.options.no_optimize);
+
+    REQUIRE_FALSE(resolved({ "build", "-o", "x", "a.eco" }).options.thin_lto);
+
+    // a dump merges the program, and a merged program has no units left to summarize
+    REQUIRE_FALSE(resolved({ "build", "-o", "x", "--optimize", "thin", "--print", "ir", "a.eco" }).options.thin_lto);
+
+    REQUIRE(contains(refusal({ "run", "--optimize", "thin", "a.eco" }), "is not something 'run' can answer"));
+    REQUIRE(contains(refusal({ "test", "--optimize", "thin", "a.eco" }), "is not something 'test' can answer"));
+}
+
+// **tiered changes how the JIT runs a module and nothing about the module**, so it leaves every per-unit
+// answer where `module` puts it - the objects a tiered run stores are the ones a plain run would
+TEST_CASE("a tiered run keeps module's units and is a run's alone", "[cli]")
+{
+    const DriverOptions tiered = resolved({ "run", "--optimize", "tiered", "a.eco" });
+    const DriverOptions plain = resolved({ "run", "a.eco" });
+
+    REQUIRE(tiered.optimize == OptimizeMode::t_tiered);
+    REQUIRE_FALSE(tiered.whole_program);
+    REQUIRE_FALSE(tiered.options.thin_lto);
+    REQUIRE(tiered.options.no_optimize == plain.options.no_optimize);
+
+    REQUIRE(contains(refusal({ "build", "-o", "x", "--optimize", "tiered", "a.eco" }), "is not something 'build' can answer"));
+    REQUIRE(contains(refusal({ "test", "--optimize", "tiered", "a.eco" }), "is not something 'test' can answer"));
+    REQUIRE(contains(refusal({ "test", "--explain", "tiers", "a.eco" }), "is not something 'test' can answer"));
+}
+
 TEST_CASE("explaining memory implies tracking allocations", "[cli]")
 {
     const DriverOptions driver = resolved({ "run", "--explain", "memory", "a.eco" });
@@ -804,7 +884,9 @@ TEST_CASE("the usage line is built from the table", "[cli]")
         "  echoc run [options] <sources...> [-- <program arguments>]\n"
         "  echoc build [options] <sources...>\n"
         "  echoc test [options] <sources...>\n"
-        "  echoc clean [options]\n");
+        "  echoc clean [options]\n"
+        "  echoc serve [options]\n"
+        "  echoc cache [options] <stats|prune>\n");
 }
 
 TEST_CASE("a refusal is the sentence, the usage and where to read more", "[cli]")
@@ -863,7 +945,7 @@ TEST_CASE("one option's page is that option and nothing else", "[cli]")
     // the full prose, which the compact page deliberately does not carry. Asserted on a phrase rather
     // than the whole string, because the renderer wraps it - a byte comparison would be a golden of the
     // wording, which is the thing this suite deliberately does not pin
-    REQUIRE(contains(text, "one option with three values now"));
+    REQUIRE(contains(text, "one option with four values now"));
     REQUIRE_FALSE(contains(text, Compiler::option_for(Opt::t_optimize).summary));
 
     // every value, with its own description rather than the page's one-liner - the first words of each,
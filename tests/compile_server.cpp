@@ -0,0 +1,223 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Compiler/CompileServer.h>
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Compiler::serve_requests and Compiler::forward_to_server, end to end but without a compiler behind them:
+// what a server is asked to serve here writes down what it was handed. **The contract is that a served
+// command is the process the client would have been** - its directory, its environment, its exit status -
+// so that is what each case reads back
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+std::string read_back(const fs::path &path)
+{
+    std::ifstream in(path);
+    std::stringstream content;
+    content << in.rdbuf();
+
+    return content.str();
+}
+
+// waits for `path` to appear, for a server that is still starting or an `after` that is still running
+bool appears(const fs::path &path)
+{
+    for (int attempt = 0; attempt < 500; attempt++) {
+        std::error_code ec;
+
+        if (fs::exists(path, ec)) {
+            return true;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    return false;
+}
+
+// a server in a forked child, on a socket of its own, stopped the way a person stops one when the case
+// leaves
+class ScopedServer
+{
+public:
+    explicit ScopedServer(const std::string &name) :
+        _root(fs::temp_directory_path() / scratch_name(name)),
+        _socket(_root / "sock" / "serve.sock")
+    {
+        std::error_code ec;
+        fs::remove_all(_root, ec);
+        fs::create_directories(_root / "work", ec);
+
+        setenv("ECHOC_SERVER_SOCKET", _socket.c_str(), 1);
+        unsetenv("ECHOC_NO_SERVER");
+
+        _server = fork();
+
+        if (_server == 0) {
+            const auto serve = [](const Compiler::ServedRequest &request) {
+                std::ofstream out("served.txt");
+
+                for (const std::string &word : request.arguments) {
+                    out << word << " ";
+                }
+
+                const char *probe = std::getenv("ECHOC_SERVE_PROBE");
+                out << (probe != nullptr ? probe : "<unset>");
+
+                return 3;
+            };
+
+            const auto after = [](const Compiler::ServedRequest &) {
+                std::ofstream("warmed.txt") << "warm";
+            };
+
+            std::string error;
+            _exit(Compiler::serve_requests(_socket, serve, after, error));
+        }
+    }
+
+    ~ScopedServer()
+    {
+        if (_server > 0) {
+            kill(_server, SIGTERM);
+
+            int status = 0;
+            waitpid(_server, &status, 0);
+        }
+
+        unsetenv("ECHOC_SERVER_SOCKET");
+
+        std::error_code ec;
+        fs::remove_all(_root, ec);
+    }
+
+    ScopedServer(const ScopedServer &) = delete;
+    ScopedServer &operator=(const ScopedServer &) = delete;
+
+    const fs::path &socket() const { return _socket; }
+    fs::path work() const { return _root / "work"; }
+
+    // stops it now, and says how it ended
+    int stop()
+    {
+        kill(_server, SIGTERM);
+
+        int status = 0;
+        waitpid(_server, &status, 0);
+        _server = -1;
+
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+
+private:
+    static std::string scratch_name(const std::string &name)
+    {
+        return "echoc-serve-" + name + "-" + std::to_string(getpid());
+    }
+
+    fs::path _root;
+    fs::path _socket;
+    pid_t _server = -1;
+};
+
+// forward_to_server from inside `directory`, as a client typed there would
+std::optional<int> forward_from(const fs::path &directory, std::vector<std::string> words)
+{
+    const fs::path before = fs::current_path();
+    fs::current_path(directory);
+
+    std::vector<char *> argv;
+
+    for (std::string &word : words) {
+        argv.push_back(word.data());
+    }
+
+    const std::optional<int> status = Compiler::forward_to_server(static_cast<int>(argv.size()), argv.data());
+
+    fs::current_path(before);
+
+    return status;
+}
+
+};
+
+TEST_CASE("a served command is the process its client would have been", "[server]")
+{
+    ScopedServer server("served");
+    REQUIRE(appears(server.socket()));
+
+    setenv("ECHOC_SERVE_PROBE", "from the client", 1);
+    const std::optional<int> status = forward_from(server.work(), { "echoc", "run", "app.eco" });
+    unsetenv("ECHOC_SERVE_PROBE");
+
+    // the child's status, not the server's and not a transport's
+    REQUIRE(status.has_value());
+    REQUIRE(status.value() == 3);
+
+    // in the client's directory, with the client's argv and the client's environment
+    REQUIRE(read_back(server.work() / "served.txt") == "echoc run app.eco from the client");
+
+    // and the server's own turn afterwards, in the same directory
+    REQUIRE(appears(server.work() / "warmed.txt"));
+
+    // a stop request is a clean exit that takes the socket with it, so the next client compiles in-process
+    // rather than connecting to nothing
+    REQUIRE(server.stop() == 0);
+    REQUIRE_FALSE(fs::exists(server.socket()));
+    REQUIRE_FALSE(forward_from(server.work(), { "echoc", "run", "app.eco" }).has_value());
+}
+
+TEST_CASE("with nobody to ask, a command is compiled where it was typed", "[server]")
+{
+    SECTION("no server at all")
+    {
+        setenv("ECHOC_SERVER_SOCKET", "/nonexistent/echoc/serve.sock", 1);
+        REQUIRE_FALSE(forward_from(fs::current_path(), { "echoc", "run", "app.eco" }).has_value());
+        unsetenv("ECHOC_SERVER_SOCKET");
+    }
+
+    SECTION("a server, and the opt-out")
+    {
+        ScopedServer server("opted_out");
+        REQUIRE(appears(server.socket()));
+
+        setenv("ECHOC_NO_SERVER", "1", 1);
+        const std::optional<int> status = forward_from(server.work(), { "echoc", "run", "app.eco" });
+        unsetenv("ECHOC_NO_SERVER");
+
+        REQUIRE_FALSE(status.has_value());
+        REQUIRE_FALSE(fs::exists(server.work() / "served.txt"));
+    }
+}
+
+TEST_CASE("a second server refuses the socket a live one holds", "[server]")
+{
+    ScopedServer server("second");
+    REQUIRE(appears(server.socket()));
+
+    std::string error;
+    const int status = Compiler::serve_requests(
+        server.socket(),
+        [](const Compiler::ServedRequest &) { return 0; },
+        [](const Compiler::ServedRequest &) {},
+        error);
+
+    REQUIRE(status == 1);
+    REQUIRE(error.find("already listening") != std::string::npos);
+}
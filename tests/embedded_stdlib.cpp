@@ -0,0 +1,65 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <Lexer.h>
+#include <AST/ASTModule.h>
+#include <AST/ASTModuleEmbedder.h>
+
+#include "stdlib_embedded.h"
+
+// the committed header, read the way a released binary reads it. Nothing here compares it against the stdlib
+// sources - CI regenerates it and diffs for that - but a lexer change that forgot to bump
+// ECO_MODULE_TOKENS_VERSION is caught only here: the blob still loads, and it loads the old lexer's tokens
+
+TEST_CASE( "the embedded stdlib holds what the lexer makes of its own sources", "[embedded]" )
+{
+    AST::Module module("stdlib", 0);
+    auto files = AST::load_embedded_module(module, EmbeddedModule::stdlib_module_blob(), nullptr);
+
+    REQUIRE( files.size() > 0 );
+
+    Lexer lexer;
+
+    for (const auto &[file, tfile] : files) {
+        INFO( file->get_path().string() );
+        REQUIRE( file->content.has_value() );
+
+        TokenCollection lexed;
+        lexer.tokenize(lexed, file->content.value());
+
+        const size_t start = tfile.token_slice.start_index;
+        REQUIRE( tfile.token_slice.end_index - start == lexed.size() );
+
+        for (size_t i = 0; i < lexed.size(); i++) {
+            const Token &stored = module.tokens.tokens[start + i];
+
+            REQUIRE( stored.type == lexed.tokens[i].type );
+            REQUIRE( stored.line == lexed.tokens[i].line );
+            REQUIRE( stored.char_offset == lexed.tokens[i].char_offset );
+            REQUIRE( module.tokens.value_of(start + i) == lexed.value_of(i) );
+            REQUIRE( stored.file == file );
+            REQUIRE( !stored.minted );
+        }
+    }
+}
+
+TEST_CASE( "an embedded stdlib that does not decode is refused", "[embedded]" )
+{
+    const std::string_view blob = EmbeddedModule::stdlib_module_blob();
+
+    SECTION( "cut short" ) {
+        AST::Module module("stdlib", 0);
+        REQUIRE_THROWS_AS( AST::load_embedded_module(module, blob.substr(0, blob.size() / 2), nullptr), std::runtime_error );
+    }
+
+    SECTION( "from another format" ) {
+        std::string other(blob);
+        other[8] = static_cast<char>(other[8] + 1);
+
+        AST::Module module("stdlib", 0);
+        REQUIRE_THROWS_AS( AST::load_embedded_module(module, other, nullptr), std::runtime_error );
+    }
+}
@@ -0,0 +1,113 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Compiler/FileDigests.h>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#include "subprocess.h"
+
+// Compiler::FileDigests against real files. **A remembered digest is a promise about content**, so every case
+// here is one of the two ways that promise could be broken - a digest recalled for bytes that changed, or one
+// that disagrees with hashing the file afresh - and the one way it pays: an untouched file is not read again
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+using EchoTests::write_file;
+
+// settles at once, so a case does not have to wait out the timestamp granularity the real one allows for
+constexpr std::chrono::nanoseconds k_settled_now{ -1 };
+
+};
+
+TEST_CASE("a file's digest is its content's, remembered or not", "[cache][digests]")
+{
+    EchoTests::ScopedProject scratch("file_digests", "content");
+    const fs::path source = scratch.root() / "main.eco";
+    write_file(source, "fn main() {}\n");
+
+    Compiler::FileDigests digests(k_settled_now);
+
+    REQUIRE(digests.digest_of(source) == Compiler::content_digest("fn main() {}\n"));
+    REQUIRE(digests.hashed() == 1);
+
+    REQUIRE(digests.digest_of(source) == Compiler::content_digest("fn main() {}\n"));
+    REQUIRE(digests.recalled() == 1);
+
+    // a file that is not there has no digest, rather than the digest of nothing
+    REQUIRE_FALSE(digests.digest_of(scratch.root() / "missing.eco").has_value());
+}
+
+TEST_CASE("an edit that keeps the size and the mtime is still read again", "[cache][digests]")
+{
+    EchoTests::ScopedProject scratch("file_digests", "edit");
+    const fs::path source = scratch.root() / "main.eco";
+    write_file(source, "fn main() { a }\n");
+
+    const fs::file_time_type written = fs::last_write_time(source);
+
+    Compiler::FileDigests digests(k_settled_now);
+    REQUIRE(digests.digest_of(source) == Compiler::content_digest("fn main() { a }\n"));
+
+    // the same length and the mtime put back, which is what a tool restoring timestamps leaves. The ctime is
+    // the kernel's, and it moved
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    write_file(source, "fn main() { b }\n");
+    fs::last_write_time(source, written);
+
+    REQUIRE(digests.digest_of(source) == Compiler::content_digest("fn main() { b }\n"));
+    REQUIRE(digests.recalled() == 0);
+}
+
+TEST_CASE("a change too recent to have settled is never recalled", "[cache][digests]")
+{
+    EchoTests::ScopedProject scratch("file_digests", "racy");
+    const fs::path source = scratch.root() / "main.eco";
+    write_file(source, "fn main() {}\n");
+
+    // the real window: a file written a moment ago could be written again inside the same tick
+    Compiler::FileDigests digests;
+
+    REQUIRE(digests.digest_of(source).has_value());
+    REQUIRE(digests.digest_of(source).has_value());
+
+    REQUIRE(digests.recalled() == 0);
+    REQUIRE(digests.hashed() == 2);
+}
+
+TEST_CASE("the memo outlives the process that wrote it", "[cache][digests]")
+{
+    EchoTests::ScopedProject scratch("file_digests", "memo");
+    const fs::path source = scratch.root() / "main.eco";
+    const fs::path memo = scratch.root() / "digests";
+    write_file(source, "fn main() {}\n");
+
+    {
+        Compiler::FileDigests first(k_settled_now);
+        first.attach(memo);
+        REQUIRE(first.digest_of(source).has_value());
+        first.save();
+    }
+
+    REQUIRE(fs::exists(memo));
+
+    Compiler::FileDigests second(k_settled_now);
+    second.attach(memo);
+
+    REQUIRE(second.digest_of(source) == Compiler::content_digest("fn main() {}\n"));
+    REQUIRE(second.recalled() == 1);
+    REQUIRE(second.hashed() == 0);
+
+    // and a memo in a directory that is not there is simply not written
+    Compiler::FileDigests nowhere(k_settled_now);
+    nowhere.attach(scratch.root() / "absent" / "digests");
+    REQUIRE(nowhere.digest_of(source).has_value());
+    nowhere.save();
+
+    REQUIRE_FALSE(fs::exists(scratch.root() / "absent"));
+}
@@ -0,0 +1,151 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Compiler/FileWatcher.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "subprocess.h"
+
+// Compiler::FileWatcher against a real directory. **What `--watch` needs from it is two answers**: an edit to
+// a file the build read wakes it, and a file the build itself writes beside them does not - a watcher that
+// got the second wrong would rebuild forever on its own output
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+using EchoTests::write_file;
+
+// `change` after the watcher is already waiting, from another thread, as an editor would
+std::vector<fs::path> wait_while(Compiler::FileWatcher &watcher, const std::function<void()> &change)
+{
+    std::thread editor([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        change();
+    });
+
+    std::vector<fs::path> changed = watcher.wait_for_change();
+    editor.join();
+
+    return changed;
+}
+
+bool names(const std::vector<fs::path> &changed, const std::string &name)
+{
+    return std::any_of(changed.begin(), changed.end(), [&](const fs::path &path) {
+        return path.filename() == name;
+    });
+}
+
+};
+
+TEST_CASE("an edit to a watched file wakes the watcher, and the build's own output does not", "[watch]")
+{
+    EchoTests::ScopedProject scratch("file_watcher", "edit");
+    fs::create_directories(scratch.build_dir());
+
+    write_file(scratch.root() / "module.eco", "#[name: app]\n");
+    write_file(scratch.root() / "main.eco", "fn main() {}\n");
+    write_file(scratch.root() / "notes.txt", "");
+
+    Compiler::FileWatcher watcher;
+    watcher.watch({ scratch.root() / "module.eco", scratch.root() / "main.eco" });
+
+    const std::vector<fs::path> changed = wait_while(watcher, [&] {
+        // first what a build writes, in the watched directory and under it, and only then the edit - so
+        // that if either of those had counted, the answer would name it
+        write_file(scratch.root() / "notes.txt", "scribbled");
+        write_file(scratch.build_dir() / "main.o", "object");
+        write_file(scratch.root() / "main.eco", "fn main() { }\n");
+    });
+
+    REQUIRE(names(changed, "main.eco"));
+    REQUIRE_FALSE(names(changed, "notes.txt"));
+    REQUIRE_FALSE(names(changed, "main.o"));
+}
+
+TEST_CASE("a new source beside the watched ones counts, since a glob may match it", "[watch]")
+{
+    EchoTests::ScopedProject scratch("file_watcher", "new");
+
+    write_file(scratch.root() / "module.eco", "#[name: app]\n#[sources: \"*.eco\"]\n");
+
+    Compiler::FileWatcher watcher;
+    watcher.watch({ scratch.root() / "module.eco" });
+
+    const std::vector<fs::path> changed = wait_while(watcher, [&] {
+        write_file(scratch.root() / "added.eco", "fn helper() {}\n");
+    });
+
+    REQUIRE(names(changed, "added.eco"));
+}
+
+// `--watch` re-arms after every build, and a save made while the build ran is waiting in the queue by then.
+// Re-arming must not throw it away - the unrelated edit afterwards is only there so a watcher that did
+// answers rather than waiting forever
+TEST_CASE("an edit queued before the watch is re-armed is still reported", "[watch]")
+{
+    EchoTests::ScopedProject scratch("file_watcher", "rearm");
+    fs::create_directories(scratch.root() / "lib");
+
+    write_file(scratch.root() / "main.eco", "fn main() {}\n");
+    write_file(scratch.root() / "lib" / "lib.eco", "fn helper() {}\n");
+
+    Compiler::FileWatcher watcher;
+    watcher.watch({ scratch.root() / "main.eco" });
+
+    write_file(scratch.root() / "main.eco", "fn main() { }\n");
+
+    watcher.watch({ scratch.root() / "main.eco", scratch.root() / "lib" / "lib.eco" });
+
+    const std::vector<fs::path> changed = wait_while(watcher, [&] {
+        write_file(scratch.root() / "lib" / "lib.eco", "fn helper() { }\n");
+    });
+
+    REQUIRE(names(changed, "main.eco"));
+}
+
+// the window no watch covers: a file that was not an input when the build started. Only its time says it
+// was written during the build, and a file the snapshot did cover is judged by its stamp alone
+TEST_CASE("a snapshot names what moved since, including a file it did not cover", "[watch]")
+{
+    EchoTests::ScopedProject scratch("file_watcher", "snapshot");
+
+    write_file(scratch.root() / "main.eco", "fn main() {}\n");
+    write_file(scratch.root() / "untouched.eco", "fn same() {}\n");
+    write_file(scratch.root() / "older.h", "int older;\n");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const std::vector<fs::path> before_build = { scratch.root() / "main.eco", scratch.root() / "untouched.eco" };
+    const Compiler::FileWatcher::Snapshot before = Compiler::FileWatcher::snapshot(before_build);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    write_file(scratch.root() / "main.eco", "fn main() { return; }\n");
+    write_file(scratch.root() / "newer.h", "int newer;\n");
+
+    const std::vector<fs::path> changed = Compiler::FileWatcher::changed_since(before, {
+        scratch.root() / "main.eco", scratch.root() / "untouched.eco",
+        scratch.root() / "older.h", scratch.root() / "newer.h" });
+
+    REQUIRE(names(changed, "main.eco"));
+    REQUIRE(names(changed, "newer.h"));
+    REQUIRE_FALSE(names(changed, "untouched.eco"));
+    REQUIRE_FALSE(names(changed, "older.h"));
+}
+
+TEST_CASE("nothing to watch is an empty answer rather than a wait", "[watch]")
+{
+    Compiler::FileWatcher watcher;
+    watcher.watch({});
+
+    REQUIRE(watcher.wait_for_change().empty());
+}
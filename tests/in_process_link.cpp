@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Compiler/InProcessLink.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "subprocess.h"
+
+// Compiler::last_driver_command, which is the whole of what an in-process link knows about the toolchain: the
+// linker line is read out of `clang -###`, and a word misread there is a link that fails on every build - or
+// worse, one that succeeds against the wrong crt file
+
+TEST_CASE("the linker line is the last command the driver printed", "[in process link]")
+{
+    const std::string output =
+        "clang version 17.0.6\n"
+        "Target: x86_64-pc-linux-gnu\n"
+        "Thread model: posix\n"
+        "InstalledDir: /usr/bin\n"
+        " \"/usr/bin/clang-17\" \"-cc1\" \"-emit-obj\" \"-o\" \"/tmp/a.o\" \"a.c\"\n"
+        " \"/usr/bin/ld.lld\" \"-pie\" \"-o\" \"out\" \"/usr/lib/Scrt1.o\" \"a.o\" \"-lc\"\n";
+
+    const auto command = Compiler::last_driver_command(output);
+
+    REQUIRE(command.has_value());
+    CHECK(command.value() == std::vector<std::string>{
+        "/usr/bin/ld.lld", "-pie", "-o", "out", "/usr/lib/Scrt1.o", "a.o", "-lc" });
+}
+
+TEST_CASE("a quoted word keeps its spaces and loses the driver's escapes", "[in process link]")
+{
+    const std::string output =
+        " \"/usr/bin/ld\" \"-o\" \"/home/some one/out\" \"-rpath=\\$ORIGIN\" \"say \\\"hi\\\"\" \"back\\\\slash\"\n";
+
+    const auto command = Compiler::last_driver_command(output);
+
+    REQUIRE(command.has_value());
+    CHECK(command.value() == std::vector<std::string>{
+        "/usr/bin/ld", "-o", "/home/some one/out", "-rpath=$ORIGIN", "say \"hi\"", "back\\slash" });
+}
+
+TEST_CASE("output with no command in it is no line at all", "[in process link]")
+{
+    CHECK_FALSE(Compiler::last_driver_command("").has_value());
+    CHECK_FALSE(Compiler::last_driver_command(
+        "clang version 17.0.6\n"
+        "clang: error: invalid linker name in argument '-fuse-ld=lld'\n").has_value());
+}
+
+#if defined(ECO_HAVE_LLD) && !defined(__APPLE__)
+TEST_CASE("a rebuild links without starting the clang driver", "[in process link][link]")
+{
+    EchoTests::ScopedProject project("in_process_link", "no_driver_on_rebuild");
+
+    const EchoTests::ProcessResult found = EchoTests::run_capturing("command -v clang");
+    std::string clang = found.output.substr(0, found.output.find('\n'));
+
+    if (found.exit_code != 0 || clang.empty()) {
+        SKIP("no clang on PATH to ask for the link line");
+    }
+
+    // a `clang` ahead of the real one on PATH, which notes every time it is started and then is the real one
+    const std::filesystem::path log = project.root() / "clang.log";
+    const std::filesystem::path shim = project.root() / "bin" / "clang";
+
+    EchoTests::write_file(shim,
+        "#!/bin/sh\n"
+        "echo \"$*\" >> " + EchoTests::quoted(log) + "\n"
+        "exec " + EchoTests::quoted(clang) + " \"$@\"\n");
+    std::filesystem::permissions(shim, std::filesystem::perms::owner_all, std::filesystem::perm_options::add);
+
+    EchoTests::write_file(project.root() / "module.eco",
+        "#[module: \"hello\"]\n"
+        "#[sources: \"*.eco\"]\n"
+        "#[target: exe { name: \"hello\", entry: \"main.eco\" }]\n");
+    EchoTests::write_file(project.root() / "main.eco", "echo(\"first\");\n");
+
+    // the user cache too, so the link line and the standard library are this case's and not the machine's
+    const auto build = [&] {
+        return EchoTests::run_capturing(
+            "cd " + EchoTests::quoted(project.root())
+            + " && PATH=" + EchoTests::quoted(shim.parent_path()) + ":\"$PATH\""
+            + " XDG_CACHE_HOME=" + EchoTests::quoted(project.root() / "cache")
+            + " " + EchoTests::quoted(ECHOC_BINARY) + " build 2>&1");
+    };
+
+    const auto run = [&] {
+        return EchoTests::run_capturing(EchoTests::quoted(project.root() / "ecobuild" / "hello") + " 2>&1");
+    };
+
+    const EchoTests::ProcessResult first = build();
+    INFO(first.output);
+    REQUIRE(first.exit_code == 0);
+    REQUIRE(run().output.find("first") != std::string::npos);
+
+    // an edit to the entry, so the second build has a link to make and everything else comes from the cache
+    std::error_code ec;
+    const auto before = std::filesystem::exists(log, ec) ? std::filesystem::file_size(log, ec) : 0;
+
+    EchoTests::write_file(project.root() / "main.eco", "echo(\"second\");\n");
+
+    const EchoTests::ProcessResult second = build();
+    INFO(second.output);
+    REQUIRE(second.exit_code == 0);
+    REQUIRE(run().output.find("second") != std::string::npos);
+
+    const auto after = std::filesystem::exists(log, ec) ? std::filesystem::file_size(log, ec) : 0;
+    REQUIRE(after == before);
+}
+#endif
@@ -1,8 +1,14 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <AST/ASTConstantExpander.h>
+#include <AST/ASTMonomorphizer.h>
 #include <AST/FunctionDeclNode.h>
 #include <AST/ExprNode.h>
 #include <AST/TypeDeclNode.h>
+#include <Compiler/TargetFacts.h>
+#include <Parser/ModuleParser.h>
+
+#include <string>
 
 #include "helpers.h"
 
@@ -359,3 +365,37 @@ TEST_CASE("One instantiation has one layout, whichever site names it", "[generic
     REQUIRE(written.get_complex_type() == inferred.get_complex_type());
     REQUIRE(written.get_mangled_name() == inferred.get_mangled_name());
 }
+
+TEST_CASE("a generic reached through another is instantiated a round later, and the rounds are reported", "[generics]")
+{
+    // not tests_make_parsed_bundle: that runs the passes with a Monomorphizer of its own, and the
+    // rounds are only on the one that ran
+    Bundle bundle;
+    auto &module = bundle.modules.get_module(bundle.modules.add_module("test"));
+
+    Parser::ModuleParser(Compiler::TargetFacts::host()).parse_input(Parser::ModuleParser::InputPayload {
+        .files = { Parser::ModuleParser::InputFile("/tmp/testfile.eco",
+            "function inner<T>(T $x): T { return $x; }\n"
+            "function middle<T>(T $x): T { return inner($x); }\n"
+            "function outer<T>(T $x): T { return middle($x); }\n"
+            "echo outer(5);\n") },
+        .module = module,
+        .collector = bundle.collector
+    });
+
+    ConstantExpander(bundle).run();
+
+    Monomorphizer monomorphizer(bundle);
+    monomorphizer.run();
+
+    REQUIRE_FALSE(bundle.collector.has_critical_issues());
+
+    // one round per level of the chain - each instance's body is what exposes the next call - and one
+    // more that finds nothing left to do
+    const std::string dump = monomorphizer.debug_dump_instances();
+    REQUIRE(dump.find("Fixpoint: 4 rounds") != std::string::npos);
+
+    // the last round made nothing and so admitted nothing: what it visited is only what stayed open,
+    // the calls in the three templates' own bodies
+    REQUIRE(dump.find("- round 4: 0 new calls") != std::string::npos);
+}
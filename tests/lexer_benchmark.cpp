@@ -0,0 +1,101 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <Lexer.h>
+#include <LexerScan.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// how fast the lexer reads the standard library, at every scan level this CPU runs.
+//
+// **hidden, so a plain `tests` run never pays for it**: it lexes the whole stdlib hundreds of times, and a
+// number is only worth reading on a quiet machine somebody chose to measure on. Ask for it by tag:
+//   ./build/tests "[benchmark]"
+//
+// the levels run in one process over the same bytes, so the MB/s lines are the gain the vectorised scans
+// buy and nothing else - what a comparison across two builds could never promise
+
+namespace
+{
+    std::vector<std::string> stdlib_sources()
+    {
+        std::vector<std::string> sources;
+
+        for (const auto &entry : std::filesystem::recursive_directory_iterator(STDLIB_SOURCE_DIR)) {
+            if (!entry.is_regular_file() || entry.path().extension() != ".eco") {
+                continue;
+            }
+
+            std::ifstream in(entry.path());
+            std::stringstream content;
+            content << in.rdbuf();
+            sources.push_back(content.str());
+        }
+
+        return sources;
+    }
+
+    size_t lex_all(const std::vector<std::string> &sources)
+    {
+        Lexer lexer;
+        size_t tokens = 0;
+
+        for (const std::string &source : sources) {
+            TokenCollection collection;
+            lexer.tokenize(collection, source);
+            tokens += collection.size();
+        }
+
+        return tokens;
+    }
+};
+
+TEST_CASE("lexing the standard library", "[.][benchmark][lexer]")
+{
+    const std::vector<std::string> sources = stdlib_sources();
+
+    size_t bytes = 0;
+    for (const std::string &source : sources) {
+        bytes += source.size();
+    }
+
+    REQUIRE(bytes > 0);
+
+    const LexerScan::Level restore = LexerScan::active_level();
+
+    for (LexerScan::Level level : {
+            LexerScan::Level::t_portable, LexerScan::Level::t_sse2, LexerScan::Level::t_avx2 }) {
+        if (level > LexerScan::detected_level()) {
+            continue;
+        }
+
+        LexerScan::use_level(level);
+
+        // a plain timed loop as well as Catch's own statistics, because the number anybody asks for is
+        // throughput and a mean per iteration leaves the division to them
+        constexpr int rounds = 20;
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < rounds; i++) {
+            REQUIRE(lex_all(sources) > 0);
+        }
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        const double megabytes = static_cast<double>(bytes) * rounds / (1024.0 * 1024.0);
+
+        std::cout << "[lexer] " << LexerScan::level_name(level) << ": "
+                  << megabytes / elapsed.count() << " MB/s over " << bytes << " bytes" << std::endl;
+
+        BENCHMARK(std::string("lex stdlib, ") + LexerScan::level_name(level)) {
+            return lex_all(sources);
+        };
+    }
+
+    LexerScan::use_level(restore);
+}
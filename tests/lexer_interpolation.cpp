@@ -36,8 +36,8 @@ TEST_CASE("A string with no hole is one token, whichever quote it used", "[lexer
 
     // verbatim, quotes included: decoding is AST::decode_string_literal's, so a code excerpt can
     // still show what was written
-    REQUIRE( tokens.token_values[0] == "\"plain\"" );
-    REQUIRE( tokens.token_values[2] == "\"a { brace\"" );
+    REQUIRE( tokens.value_of(0) == "\"plain\"" );
+    REQUIRE( tokens.value_of(2) == "\"a { brace\"" );
 }
 
 // a `'` string never interpolates, whatever is in it. that is the escape hatch, and the only place in
@@ -51,7 +51,7 @@ TEST_CASE("A single quoted string never interpolates", "[lexer]")
 
     REQUIRE( tokens.tokens.size() == 1 );
     REQUIRE( tokens.tokens[0].type == Token::Type::t_string_literal );
-    REQUIRE( tokens.token_values[0] == "'{$name} stays'" );
+    REQUIRE( tokens.value_of(0) == "'{$name} stays'" );
 }
 
 TEST_CASE("An interpolated literal lexes to a run of tokens", "[lexer]")
@@ -70,10 +70,10 @@ TEST_CASE("An interpolated literal lexes to a run of tokens", "[lexer]")
     } );
 
     // the chunks are the raw text *between* the holes, unquoted - there is nothing to strip
-    REQUIRE( tokens.token_values[0] == "a" );
-    REQUIRE( tokens.token_values[1] == "$x" );
-    REQUIRE( tokens.token_values[2] == "b" );
-    REQUIRE( tokens.token_values[4] == "c" );
+    REQUIRE( tokens.value_of(0) == "a" );
+    REQUIRE( tokens.value_of(1) == "$x" );
+    REQUIRE( tokens.value_of(2) == "b" );
+    REQUIRE( tokens.value_of(4) == "c" );
 
     // and an empty chunk is a real chunk, which is what keeps chunks == holes + 1 true by
     // construction rather than by a check afterwards
@@ -88,9 +88,9 @@ TEST_CASE("An interpolated literal lexes to a run of tokens", "[lexer]")
         Token::Type::t_string_interp_end,
     } );
 
-    REQUIRE( tokens.token_values[0].empty() );
-    REQUIRE( tokens.token_values[2].empty() );
-    REQUIRE( tokens.token_values[4].empty() );
+    REQUIRE( tokens.value_of(0).empty() );
+    REQUIRE( tokens.value_of(2).empty() );
+    REQUIRE( tokens.value_of(4).empty() );
 }
 
 // a hole is lexed by the same engine the top level uses, which is the whole reason LexerEngine exists
@@ -128,7 +128,7 @@ TEST_CASE("A hole holds ordinary Echo", "[lexer]")
         Token::Type::t_string_interp_end,
     } );
 
-    REQUIRE( tokens.token_values[7] == "!" );
+    REQUIRE( tokens.value_of(7) == "!" );
 }
 
 // **the spec split is decided on the token stream, not on the characters**, which is what separates
@@ -149,7 +149,7 @@ TEST_CASE("A format spec is the text after a top level colon", "[lexer]")
     } );
 
     // raw, and deliberately never lexed: `.2f` is not Echo and must not be read as any
-    REQUIRE( tokens.token_values[2] == ".2f" );
+    REQUIRE( tokens.value_of(2) == ".2f" );
 
     tokens.clear();
     lexer.tokenize(tokens, "\"{$std::io::stdout->fd}\"");
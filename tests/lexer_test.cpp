@@ -1,8 +1,11 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <cstdint>
+#include <memory>
+#include <string>
 
 #include <Lexer.h>
+#include <LexerScan.h>
 
 
 TEST_CASE( "Token References", "[lexer]" ) {
@@ -22,6 +25,49 @@ TEST_CASE( "Token References", "[lexer]" ) {
     REQUIRE( bar.type() == Token::Type::t_identifier );
 }
 
+TEST_CASE( "A spelling is stored once per collection", "[lexer]" )
+{
+    Lexer lexer;
+    TokenCollection tokens;
+
+    lexer.tokenize(tokens, "$a = $a + $b; $b = $a;");
+
+    REQUIRE( tokens.size() == 10 );
+
+    // `$a` `=` `+` `$b` `;`
+    REQUIRE( tokens.values.size() == 5 );
+
+    REQUIRE( tokens[0].same_spelling(tokens[2]) );
+    REQUIRE( tokens[0].value_id() == tokens[8].value_id() );
+    REQUIRE_FALSE( tokens[0].same_spelling(tokens[4]) );
+
+    // a reference handed out before more tokens arrive stays the spelling it was
+    const std::string &first = tokens[0].value();
+
+    for (int i = 0; i < 1000; i++) {
+        tokens.push("$x" + std::to_string(i), Token::Type::t_varname, 0, 0);
+    }
+
+    REQUIRE( first == "$a" );
+}
+
+TEST_CASE( "A copied collection spells its tokens without the original", "[lexer]" )
+{
+    Lexer lexer;
+    auto original = std::make_unique<TokenCollection>();
+
+    lexer.tokenize(*original, "foo bar foo");
+
+    TokenCollection copy = *original;
+    original.reset();
+
+    copy.push("bar", Token::Type::t_identifier, 0, 0);
+
+    REQUIRE( copy.value_of(0) == "foo" );
+    REQUIRE( copy.values.size() == 2 );
+    REQUIRE( copy[3].same_spelling(copy[1]) );
+}
+
 TEST_CASE( "Numeric Literals", "[lexer]" )
 {
     Lexer lexer;
@@ -107,11 +153,11 @@ TEST_CASE( "A range's dots are not a decimal point", "[lexer]" )
 
     REQUIRE( tokens.tokens.size() == 4 );
     REQUIRE( tokens.tokens[0].type == Token::Type::t_integer_literal );
-    REQUIRE( tokens.token_values[0] == "0" );
+    REQUIRE( tokens.value_of(0) == "0" );
     REQUIRE( tokens.tokens[1].type == Token::Type::t_dot );
     REQUIRE( tokens.tokens[2].type == Token::Type::t_dot );
     REQUIRE( tokens.tokens[3].type == Token::Type::t_integer_literal );
-    REQUIRE( tokens.token_values[3] == "10" );
+    REQUIRE( tokens.value_of(3) == "10" );
 
     // the inclusive form is the same three tokens plus the `=`, which is why `..=` needs no token type
     // of its own - the operator registry reassembles it out of what is already here
@@ -132,11 +178,11 @@ TEST_CASE( "A range's dots are not a decimal point", "[lexer]" )
 
     REQUIRE( tokens.tokens.size() == 4 );
     REQUIRE( tokens.tokens[0].type == Token::Type::t_floating_literal );
-    REQUIRE( tokens.token_values[0] == "1.0" );
+    REQUIRE( tokens.value_of(0) == "1.0" );
     REQUIRE( tokens.tokens[1].type == Token::Type::t_dot );
     REQUIRE( tokens.tokens[2].type == Token::Type::t_dot );
     REQUIRE( tokens.tokens[3].type == Token::Type::t_floating_literal );
-    REQUIRE( tokens.token_values[3] == "2.5" );
+    REQUIRE( tokens.value_of(3) == "2.5" );
 
     // `1.` keeps its implicit zero - the one shape where the guard could have eaten a real decimal point
     tokens.clear();
@@ -144,7 +190,7 @@ TEST_CASE( "A range's dots are not a decimal point", "[lexer]" )
 
     REQUIRE( tokens.tokens.size() == 1 );
     REQUIRE( tokens.tokens[0].type == Token::Type::t_floating_literal );
-    REQUIRE( tokens.token_values[0] == "1.0" );
+    REQUIRE( tokens.value_of(0) == "1.0" );
 }
 
 TEST_CASE( "Strings", "[lexer]" ) {
@@ -159,7 +205,7 @@ TEST_CASE( "Strings", "[lexer]" ) {
     REQUIRE( tokens.tokens[2].type == Token::Type::t_string_literal );
 
     // check the values
-    REQUIRE( tokens.token_values[0] == "'foo'" );
+    REQUIRE( tokens.value_of(0) == "'foo'" );
 
     tokens.clear();
 
@@ -171,35 +217,35 @@ TEST_CASE( "Strings", "[lexer]" ) {
     REQUIRE( tokens.tokens[2].type == Token::Type::t_string_literal );
 
     // check the values
-    REQUIRE( tokens.token_values[0] == "\"foo\"" );
+    REQUIRE( tokens.value_of(0) == "\"foo\"" );
 
     // test empty string
     tokens.clear();
     lexer.tokenize(tokens, "''");
 
     REQUIRE( tokens.tokens[0].type == Token::Type::t_string_literal );
-    REQUIRE( tokens.token_values[0] == "''" );
+    REQUIRE( tokens.value_of(0) == "''" );
 
     // test string with escaped quotes
     tokens.clear();
     lexer.tokenize(tokens, "'\\'foo\\''");
 
     REQUIRE( tokens.tokens[0].type == Token::Type::t_string_literal );
-    REQUIRE( tokens.token_values[0] == "'\\'foo\\''" );
+    REQUIRE( tokens.value_of(0) == "'\\'foo\\''" );
 
     // test line breaks
     tokens.clear();
     lexer.tokenize(tokens, "'foo\nbar'");
 
     REQUIRE( tokens.tokens[0].type == Token::Type::t_string_literal );
-    REQUIRE( tokens.token_values[0] == "'foo\nbar'" );
+    REQUIRE( tokens.value_of(0) == "'foo\nbar'" );
 
     // test utf-8
     tokens.clear();
     lexer.tokenize(tokens, "'🍕'");
 
     REQUIRE( tokens.tokens[0].type == Token::Type::t_string_literal );
-    REQUIRE( tokens.token_values[0] == "'🍕'" );
+    REQUIRE( tokens.value_of(0) == "'🍕'" );
 }
 
 TEST_CASE( "Unterminated String", "[lexer]" ) {
@@ -221,8 +267,8 @@ TEST_CASE( "Variable Names", "[lexer]" )
     REQUIRE( tokens.tokens[2].type == Token::Type::t_varname );
 
     // check the values
-    REQUIRE( tokens.token_values[0] == "$foo" );
-    REQUIRE( tokens.token_values[2] == "$bar" );
+    REQUIRE( tokens.value_of(0) == "$foo" );
+    REQUIRE( tokens.value_of(2) == "$bar" );
 }
 
 TEST_CASE( "Variable Names Incomplete", "[lexer]" )
@@ -236,8 +282,8 @@ TEST_CASE( "Variable Names Incomplete", "[lexer]" )
     REQUIRE( tokens.tokens[1].type == Token::Type::t_varname );
 
     // check the values
-    REQUIRE( tokens.token_values[0] == "$" );
-    REQUIRE( tokens.token_values[1] == "$bar" );
+    REQUIRE( tokens.value_of(0) == "$" );
+    REQUIRE( tokens.value_of(1) == "$bar" );
 }
 
 
@@ -253,20 +299,20 @@ TEST_CASE( "HexLiterals", "[lexer]" ) {
     REQUIRE( tokens.tokens[2].type == Token::Type::t_hex_literal );
 
     // check the values
-    REQUIRE( tokens.token_values[0] == "0x0" );
-    REQUIRE( tokens.token_values[2] == "0x1" );
+    REQUIRE( tokens.value_of(0) == "0x0" );
+    REQUIRE( tokens.value_of(2) == "0x1" );
 
     // check long hex literals
     tokens.clear();
     lexer.tokenize(tokens, "0x1234567890abcdef");
     REQUIRE( tokens.tokens[0].type == Token::Type::t_hex_literal );
-    REQUIRE( tokens.token_values[0] == "0x1234567890abcdef" );
+    REQUIRE( tokens.value_of(0) == "0x1234567890abcdef" );
 
     // check uppercase hex literals
     tokens.clear();
     lexer.tokenize(tokens, "0x1234567890ABCDEF");
     REQUIRE( tokens.tokens[0].type == Token::Type::t_hex_literal );
-    REQUIRE( tokens.token_values[0] == "0x1234567890ABCDEF" );
+    REQUIRE( tokens.value_of(0) == "0x1234567890ABCDEF" );
 }
 
 TEST_CASE( "Single Line Comments", "[lexer]" ) {
@@ -279,7 +325,7 @@ TEST_CASE( "Single Line Comments", "[lexer]" ) {
     REQUIRE( tokens.tokens[0].type == Token::Type::t_identifier );
 
     // check the values
-    REQUIRE( tokens.token_values[0] == "foo" );
+    REQUIRE( tokens.value_of(0) == "foo" );
 }
 
 TEST_CASE("Multi Line Comments", "[lexer]") {
@@ -293,8 +339,8 @@ TEST_CASE("Multi Line Comments", "[lexer]") {
     REQUIRE( tokens.tokens[1].type == Token::Type::t_identifier );
 
     // check the values
-    REQUIRE( tokens.token_values[0] == "hey" );
-    REQUIRE( tokens.token_values[1] == "ronon" );
+    REQUIRE( tokens.value_of(0) == "hey" );
+    REQUIRE( tokens.value_of(1) == "ronon" );
 }
 
 TEST_CASE("Multi Line Comments Unterminated", "[lexer]") {
@@ -601,3 +647,56 @@ TEST_CASE( "foreach and the double arrow", "[lexer]" )
     REQUIRE( tokens[8].type() == Token::Type::t_logical_geq );
     REQUIRE( tokens[11].type() == Token::Type::t_assign );
 }
+
+// **the bookkeeping is the point, not the tokens.** A scan level that found the same tokens and put one of
+// them a column off would pass every other test in this file on the machine it was written on - so every
+// level the CPU runs lexes the same text, and the positions are compared as well as the spellings.
+//
+// the input is built to cross vector widths on purpose: whitespace runs longer than 32 bytes with newlines
+// at both ends of them, a literal whose escape sits on a 16-byte boundary, comments spanning lines
+TEST_CASE( "every scan level lexes exactly what the portable one does", "[lexer]" )
+{
+    std::string input;
+
+    for (int i = 0; i < 40; i++) {
+        input += "$a" + std::to_string(i) + std::string(static_cast<size_t>(i), ' ') + "=\t\t" + std::string(static_cast<size_t>(i % 5), '\n');
+        input += "'" + std::string(static_cast<size_t>(i), 'x') + "\\'" + std::string(static_cast<size_t>(40 - i), 'y') + "\n';";
+        input += "/* " + std::string(static_cast<size_t>(i * 2), '-') + "\n * \n*/";
+        input += "\"pre " + std::string(static_cast<size_t>(i), 'z') + " {$b} post\\n\";";
+        input += "// " + std::string(static_cast<size_t>(i * 3), '#') + "\n";
+    }
+
+    const LexerScan::Level restore = LexerScan::active_level();
+
+    LexerScan::use_level(LexerScan::Level::t_portable);
+
+    Lexer lexer;
+    TokenCollection reference;
+    lexer.tokenize(reference, input);
+
+    for (LexerScan::Level level : { LexerScan::Level::t_sse2, LexerScan::Level::t_avx2 }) {
+        if (level > LexerScan::detected_level()) {
+            continue;
+        }
+
+        INFO( LexerScan::level_name(level) );
+
+        LexerScan::use_level(level);
+
+        TokenCollection tokens;
+        lexer.tokenize(tokens, input);
+
+        REQUIRE( tokens.size() == reference.size() );
+
+        for (size_t i = 0; i < tokens.size(); i++) {
+            INFO( "token " << i << " '" << reference[i].value() << "'" );
+
+            REQUIRE( tokens[i].type() == reference[i].type() );
+            REQUIRE( tokens[i].line() == reference[i].line() );
+            REQUIRE( tokens[i].column() == reference[i].column() );
+            REQUIRE( tokens[i].value() == reference[i].value() );
+        }
+    }
+
+    LexerScan::use_level(restore);
+}
@@ -506,7 +506,7 @@ TEST_CASE("an object refuses the JIT with a sentence rather than a silence", "[l
     std::string refusal;
     const auto resolved = Compiler::runtime_library_of(requirements.front(), requirements, refusal);
 
-    // three answers and not two: dropping this one leaves MCJIT naming an unresolved symbol, which says
+    // three answers and not two: dropping this one leaves the JIT naming an unresolved symbol, which says
     // nothing about the declaration that could never have been applied
     REQUIRE_FALSE(resolved.has_value());
     REQUIRE(refusal.find("echoc build") != std::string::npos);
@@ -565,6 +565,34 @@ TEST_CASE("pthread does not refuse a run when the file is a linker name", "[link
     REQUIRE(result.output.find("Cannot Run This Program") == std::string::npos);
 }
 
+TEST_CASE("a run resolves an external only when something calls it", "[link][jit]")
+{
+    // **the lazy JIT's promise, pinned**: a body is compiled on its first call and its externals are looked
+    // up then, so a helper naming a symbol no library defines costs a run nothing until the helper runs.
+    // the eager JIT resolved every module up front and would refuse this program before its first line
+    ScopedProject project("lazy_external");
+
+    write_file(project.root() / "module.eco",
+        "#[module: \"lazy_external\"]\n"
+        "#[sources: \"src/*.eco\"]\n");
+
+    write_file(project.root() / "src" / "main.eco",
+        "extern {\n"
+        "    function eco_no_such_symbol_anywhere() : int32;\n"
+        "}\n"
+        "\n"
+        "function never_called() : int32 {\n"
+        "    return eco_no_such_symbol_anywhere();\n"
+        "}\n"
+        "\n"
+        "echo 1;\n");
+
+    const EchoTests::ProcessResult result = project.echoc("run");
+
+    REQUIRE(result.exit_code == 0);
+    REQUIRE(result.output.find("1\n") != std::string::npos);
+}
+
 TEST_CASE("a search path is nothing for the JIT to open", "[link][jit]")
 {
     ScopedProject project("runtime_search_alone");
@@ -0,0 +1,251 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Compiler/TargetFacts.h>
+#include <Parser/ManifestMemo.h>
+#include <Parser/ManifestParser.h>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "subprocess.h"
+
+// Parser::recall_manifest_graph against real projects. **A recalled graph is a promise that a resolve would
+// have produced it**, so every case here is one of the ways that promise could be broken - a manifest edited,
+// a file added under a pattern, a different context - and the one way it pays: nothing moved, and the graph
+// comes back whole without a manifest being parsed
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+using EchoTests::write_file;
+
+// an application depending on a library, with a recursive pattern, a target carrying a scope and a link
+// requirement - one of each shape the memo has a record for
+void write_project(const fs::path &root)
+{
+    write_file(root / "lib" / "module.eco",
+        "#[module: \"geom\"]\n"
+        "#[sources: \"*.eco\"]\n");
+    write_file(root / "lib" / "point.eco", "function origin() : int32 { return 0; }\n");
+
+    write_file(root / "app" / "module.eco",
+        "#[module: \"app\"]\n"
+        "#[version: \"0.2.0\"]\n"
+        "#[sources: \"src/**/*.eco\"]\n"
+        "#[depends: \"../lib\"]\n"
+        "#[link: lib \"m\"]\n"
+        "#[target: exe { name: \"clock\", entry: \"src/main.eco\" }]\n"
+        "#[target: test] {\n"
+        "    #[sources: \"tests/*.eco\"]\n"
+        "}\n");
+    write_file(root / "app" / "src" / "main.eco", "echo(\"tick\");\n");
+    write_file(root / "app" / "src" / "time" / "clock.eco", "function now() : int32 { return 1; }\n");
+    write_file(root / "app" / "tests" / "clock_test.eco", "test ticks { assert(now() == 1); }\n");
+
+    fs::create_directories(root / "app" / "ecobuild");
+}
+
+// every directory under `root` an hour old, so the edits a case makes afterwards are certain to move an mtime
+// and the stamps the resolve takes have settled
+void backdate(const fs::path &root)
+{
+    const fs::file_time_type past = fs::file_time_type::clock::now() - std::chrono::hours(1);
+
+    for (const fs::directory_entry &entry : fs::recursive_directory_iterator(root)) {
+        if (entry.is_directory()) {
+            fs::last_write_time(entry.path(), past);
+        }
+    }
+
+    fs::last_write_time(root, past);
+}
+
+struct Resolved
+{
+    std::vector<Parser::ModuleManifest> graph;
+    uint64_t context = 0;
+};
+
+// a full resolve of `app`, kept at `memo`
+Resolved resolve_and_remember(const fs::path &root, const fs::path &memo, const Compiler::TargetFacts &facts)
+{
+    Parser::ManifestScratch scratch(facts);
+    const std::vector<fs::path> roots = { root / "app" };
+
+    Resolved resolved;
+    REQUIRE(Parser::resolve_module_graph(roots, scratch, resolved.graph));
+
+    resolved.context = Parser::manifest_graph_context(roots, facts, scratch.package_dir);
+    Parser::remember_manifest_graph(memo, resolved.context, resolved.graph, scratch.witness);
+
+    return resolved;
+}
+
+};
+
+TEST_CASE("a remembered graph comes back as it was resolved", "[cache][manifests]")
+{
+    EchoTests::ScopedProject scratch("manifest_memo", "roundtrip");
+    write_project(scratch.root());
+    backdate(scratch.root());
+
+    const fs::path memo = scratch.root() / "app" / "ecobuild" / "manifests";
+    const Resolved resolved = resolve_and_remember(scratch.root(), memo, Compiler::TargetFacts::host());
+
+    REQUIRE(fs::exists(memo));
+
+    std::vector<Parser::ModuleManifest> recalled;
+    REQUIRE(Parser::recall_manifest_graph(memo, resolved.context, recalled));
+    REQUIRE(recalled.size() == 2);
+
+    for (size_t i = 0; i < recalled.size(); i++) {
+        const Parser::ModuleManifest &was = resolved.graph[i];
+        const Parser::ModuleManifest &is = recalled[i];
+
+        REQUIRE(is.path == was.path);
+        REQUIRE(is.directory == was.directory);
+        REQUIRE(is.name == was.name);
+        REQUIRE(is.version == was.version);
+        REQUIRE(is.sources == was.sources);
+        REQUIRE(is.depends == was.depends);
+        REQUIRE(is.sources_as_written == was.sources_as_written);
+        REQUIRE(is.link == was.link);
+        REQUIRE(is.targets.size() == was.targets.size());
+
+        for (size_t t = 0; t < is.targets.size(); t++) {
+            REQUIRE(is.targets[t].name == was.targets[t].name);
+            REQUIRE(is.targets[t].kind == was.targets[t].kind);
+            REQUIRE(is.targets[t].entry == was.targets[t].entry);
+            REQUIRE(is.targets[t].has_scope == was.targets[t].has_scope);
+            REQUIRE(is.targets[t].sources == was.targets[t].sources);
+        }
+    }
+
+    // the dependency first, because that is the order the graph has to be parsed in
+    REQUIRE(recalled.front().name == "geom");
+    REQUIRE(recalled.back().sources.size() == 2);
+    REQUIRE(recalled.back().link.front().declared_by == "app");
+}
+
+TEST_CASE("a graph declaring a tool attribute is never recalled without it", "[cache][manifests]")
+{
+    EchoTests::ScopedProject scratch("manifest_memo", "tools");
+    write_project(scratch.root());
+
+    write_file(scratch.root() / "lib" / "module.eco",
+        "#[module: \"geom\"]\n"
+        "#[sources: \"*.eco\"]\n"
+        "#[epm::license: \"MIT\"]\n");
+
+    backdate(scratch.root());
+
+    const fs::path memo = scratch.root() / "app" / "ecobuild" / "manifests";
+    const Resolved resolved = resolve_and_remember(scratch.root(), memo, Compiler::TargetFacts::host());
+
+    REQUIRE(resolved.graph.front().tools.size() == 1);
+
+    // nothing kept, so the next invocation resolves again and reads the attribute off the manifest itself
+    std::vector<Parser::ModuleManifest> recalled;
+    REQUIRE_FALSE(fs::exists(memo));
+    REQUIRE_FALSE(Parser::recall_manifest_graph(memo, resolved.context, recalled));
+
+    // and dropping it is a graph that round-trips again
+    write_file(scratch.root() / "lib" / "module.eco",
+        "#[module: \"geom\"]\n"
+        "#[sources: \"*.eco\"]\n");
+    backdate(scratch.root());
+
+    const Resolved again = resolve_and_remember(scratch.root(), memo, Compiler::TargetFacts::host());
+    REQUIRE(Parser::recall_manifest_graph(memo, again.context, recalled));
+    REQUIRE(recalled.front().tools.empty());
+}
+
+TEST_CASE("a name added or removed under a pattern is a full resolve", "[cache][manifests]")
+{
+    EchoTests::ScopedProject scratch("manifest_memo", "directories");
+    write_project(scratch.root());
+    backdate(scratch.root());
+
+    const fs::path memo = scratch.root() / "app" / "ecobuild" / "manifests";
+    const Resolved resolved = resolve_and_remember(scratch.root(), memo, Compiler::TargetFacts::host());
+
+    std::vector<Parser::ModuleManifest> recalled;
+
+    // an edit inside a source is no name coming or going, and the graph is exactly what it was
+    write_file(scratch.root() / "app" / "src" / "main.eco", "echo(\"tock\");\n");
+    REQUIRE(Parser::recall_manifest_graph(memo, resolved.context, recalled));
+
+    // a file two directories below the pattern's root is still one `**` names
+    write_file(scratch.root() / "app" / "src" / "time" / "zone.eco", "function zone() : int32 { return 0; }\n");
+    recalled.clear();
+    REQUIRE_FALSE(Parser::recall_manifest_graph(memo, resolved.context, recalled));
+    REQUIRE(recalled.empty());
+
+    // and a removal is the same question from the other side
+    backdate(scratch.root());
+    const Resolved again = resolve_and_remember(scratch.root(), memo, Compiler::TargetFacts::host());
+    REQUIRE(Parser::recall_manifest_graph(memo, again.context, recalled));
+
+    fs::remove(scratch.root() / "lib" / "point.eco");
+    REQUIRE_FALSE(Parser::recall_manifest_graph(memo, again.context, recalled));
+}
+
+TEST_CASE("an edited manifest or another context is a full resolve", "[cache][manifests]")
+{
+    EchoTests::ScopedProject scratch("manifest_memo", "manifests");
+    write_project(scratch.root());
+    backdate(scratch.root());
+
+    const fs::path memo = scratch.root() / "app" / "ecobuild" / "manifests";
+    const Resolved resolved = resolve_and_remember(scratch.root(), memo, Compiler::TargetFacts::host());
+
+    std::vector<Parser::ModuleManifest> recalled;
+
+    // a manifest's facts are what an `#[if:]` in it reads, so a graph is recalled only under the ones it was
+    // resolved under
+    Compiler::TargetFacts defined = Compiler::TargetFacts::host();
+    defined.defines.insert("feature_x");
+
+    const uint64_t other = Parser::manifest_graph_context({ scratch.root() / "app" }, defined, {});
+
+    REQUIRE(other != resolved.context);
+    REQUIRE_FALSE(Parser::recall_manifest_graph(memo, other, recalled));
+
+    // the dependency's manifest, which no pattern names and no directory stamp would notice
+    write_file(scratch.root() / "lib" / "module.eco",
+        "#[module: \"geometry\"]\n"
+        "#[sources: \"*.eco\"]\n");
+
+    REQUIRE_FALSE(Parser::recall_manifest_graph(memo, resolved.context, recalled));
+}
+
+TEST_CASE("a graph a stamp cannot vouch for is never kept", "[cache][manifests]")
+{
+    EchoTests::ScopedProject scratch("manifest_memo", "unkept");
+    write_project(scratch.root());
+
+    // a pattern outside the two shapes the directory walk answers, which goes to the vendored glob
+    write_file(scratch.root() / "lib" / "module.eco",
+        "#[module: \"geom\"]\n"
+        "#[sources: \"p?int.eco\"]\n");
+
+    backdate(scratch.root());
+
+    const fs::path memo = scratch.root() / "app" / "ecobuild" / "manifests";
+    resolve_and_remember(scratch.root(), memo, Compiler::TargetFacts::host());
+
+    REQUIRE_FALSE(fs::exists(memo));
+
+    // and a directory changed a moment before it was walked is one the next invocation reads again
+    EchoTests::ScopedProject fresh("manifest_memo", "unsettled");
+    write_project(fresh.root());
+
+    const fs::path fresh_memo = fresh.root() / "app" / "ecobuild" / "manifests";
+    resolve_and_remember(fresh.root(), fresh_memo, Compiler::TargetFacts::host());
+
+    REQUIRE_FALSE(fs::exists(fresh_memo));
+}
@@ -169,27 +169,82 @@ TEST_CASE("a cache key is stable, and moves only for what changed", "[cache]")
         REQUIRE(line_starting_with(second.output, "stdlib") == stdlib_before);
     }
 
-    SECTION("editing the library moves its key and its dependent's, but not the stdlib's")
+    SECTION("editing a library body moves its key, but not its dependent's or the stdlib's")
     {
         write_file(project.root() / "lib" / "src" / "lib.eco",
             "namespace cachelib;\n"
             "\n"
             "public function twice(int32 $n) : int32\n"
             "{\n"
-            "    return $n + $n;\n"
+            "    // the same answer, spelled over more lines\n"
+            "    int32 $twice = $n + $n;\n"
+            "\n"
+            "    return $twice;\n"
             "}\n");
 
         const ProcessResult after = project.echoc(args, app_dir);
 
         REQUIRE(line_starting_with(after.output, "cachelib") != lib_before);
 
-        // transitively, without a second graph walk: a dependency contributes its whole key
-        REQUIRE(line_starting_with(after.output, "app") != app_before);
+        // an ordinary body is compiled into its own module's object alone, so the application's object
+        // is keyed on what the library *declares* - and that did not change
+        REQUIRE(line_starting_with(after.output, "app") == app_before);
 
         // and nothing below it in the order is disturbed
         REQUIRE(line_starting_with(after.output, "stdlib") == stdlib_before);
     }
 
+    SECTION("editing a library signature moves its key and its dependent's")
+    {
+        write_file(project.root() / "lib" / "src" / "lib.eco",
+            "namespace cachelib;\n"
+            "\n"
+            "public function twice(int32 $n) : int64\n"
+            "{\n"
+            "    return $n * 2;\n"
+            "}\n");
+
+        const ProcessResult after = project.echoc(args, app_dir);
+
+        REQUIRE(line_starting_with(after.output, "cachelib") != lib_before);
+
+        // transitively, without a second graph walk: every earlier module's interface is in the key
+        REQUIRE(line_starting_with(after.output, "app") != app_before);
+    }
+
+    SECTION("editing an inline body moves its dependent's key too")
+    {
+        // `#[inline]` copies the body into every unit that calls it, so it is part of the interface
+        // however ordinary the edit
+        write_file(project.root() / "lib" / "src" / "lib.eco",
+            "namespace cachelib;\n"
+            "\n"
+            "#[inline]\n"
+            "public function twice(int32 $n) : int32\n"
+            "{\n"
+            "    return $n * 2;\n"
+            "}\n");
+
+        const ProcessResult inlined = project.echoc(args, app_dir);
+        const std::string app_inlined = line_starting_with(inlined.output, "app");
+
+        REQUIRE(app_inlined != app_before);
+
+        write_file(project.root() / "lib" / "src" / "lib.eco",
+            "namespace cachelib;\n"
+            "\n"
+            "#[inline]\n"
+            "public function twice(int32 $n) : int32\n"
+            "{\n"
+            "    return $n + $n;\n"
+            "}\n");
+
+        const ProcessResult edited = project.echoc(args, app_dir);
+
+        REQUIRE(edited.output.find("42") != std::string::npos);
+        REQUIRE(line_starting_with(edited.output, "app") != app_inlined);
+    }
+
     SECTION("editing the application does not move the library's key")
     {
         write_file(project.root() / "app" / "app.eco", "echo cachelib::twice(50);\n");
@@ -429,6 +484,156 @@ TEST_CASE("a library's object does not depend on its consumer with the pipeline
     check_consumer_independence("consumer_independence_noopt", "--optimize none");
 }
 
+// `-j` moves object emission onto workers, each with a context and a TargetMachine of its own. The key cannot
+// see that - it is computed from source - so only the objects can say whether a worker wrote what the calling
+// thread would have
+TEST_CASE("objects emitted on several threads are the objects emitted on one", "[cache][jobs]")
+{
+    ScopedProject project("parallel_emission");
+
+    write_library(project.root() / "lib", "parlib");
+    write_file(project.root() / "app" / "app.eco",
+        "array<int32> $xs = [1, 2, 3];\n"
+        "echo parlib::twice($xs[2]);\n");
+
+    const fs::path serial = project.root() / "serial";
+    const fs::path parallel = project.root() / "parallel";
+
+    const auto build = [&](const fs::path &cache, const std::string &jobs) {
+        return project.echoc(
+            "build -j " + jobs + " -o out -m " + quoted(project.root() / "lib") + " --build-dir "
+                + quoted(cache) + " app.eco",
+            project.root() / "app");
+    };
+
+    REQUIRE(build(serial, "1").exit_code == 0);
+    REQUIRE(build(parallel, "4").exit_code == 0);
+
+    const ProcessResult ran = run_capturing(quoted(project.root() / "app" / "out") + " 2>&1");
+    REQUIRE(ran.exit_code == 0);
+    REQUIRE(ran.output.find("6") != std::string::npos);
+
+    std::vector<fs::path> objects;
+    for (const auto &entry : fs::recursive_directory_iterator(serial)) {
+        if (entry.path().extension() == ".o") {
+            objects.push_back(entry.path());
+        }
+    }
+
+    // the library, the stdlib's modules and the program itself - more than one, or nothing ran in parallel
+    REQUIRE(objects.size() > 1);
+
+    for (const fs::path &object : objects) {
+        INFO("object: " << fs::relative(object, serial).string());
+        REQUIRE(files_are_identical(object, parallel / fs::relative(object, serial)));
+    }
+}
+
+// `-j` also reads and lexes the manifest modules on a pool, one module per task, and only the parse stays on
+// the calling thread. Several modules with several sources each, so tasks really do finish out of order - and
+// the bundle must still come out in dependency order, which is what `--print ast` and the objects both show
+TEST_CASE("modules lexed on several threads parse into the bundle one thread reads", "[cache][jobs]")
+{
+    ScopedProject project("parallel_lexing");
+
+    const std::vector<std::string> libraries = { "lexa", "lexb", "lexc" };
+    std::string module_flags;
+
+    for (const std::string &name : libraries) {
+        write_library(project.root() / name, name);
+        write_file(project.root() / name / "src" / "more.eco",
+            "namespace " + name + ";\n"
+            "\n"
+            "public function thrice(int32 $n) : int32\n"
+            "{\n"
+            "    return $n * 3;\n"
+            "}\n");
+        module_flags += " -m " + quoted(project.root() / name);
+    }
+
+    write_file(project.root() / "app" / "app.eco",
+        "echo lexa::twice(1) + lexb::thrice(2) + lexc::twice(3);\n");
+
+    const fs::path serial = project.root() / "serial";
+    const fs::path parallel = project.root() / "parallel";
+
+    const auto build = [&](const fs::path &cache, const std::string &jobs) {
+        return project.echoc(
+            "build -j " + jobs + " --print ast -o out" + module_flags + " --build-dir " + quoted(cache)
+                + " app.eco",
+            project.root() / "app");
+    };
+
+    const ProcessResult one = build(serial, "1");
+    const ProcessResult four = build(parallel, "4");
+    REQUIRE(one.exit_code == 0);
+    REQUIRE(four.exit_code == 0);
+
+    // every library made it into the dump, so the comparison below is over more than the program
+    for (const std::string &name : libraries) {
+        REQUIRE(one.output.find(name) != std::string::npos);
+    }
+    REQUIRE(one.output == four.output);
+
+    const ProcessResult ran = run_capturing(quoted(project.root() / "app" / "out") + " 2>&1");
+    REQUIRE(ran.exit_code == 0);
+    REQUIRE(ran.output.find("14") != std::string::npos);
+
+    std::vector<fs::path> objects;
+    for (const auto &entry : fs::recursive_directory_iterator(serial)) {
+        if (entry.path().extension() == ".o") {
+            objects.push_back(entry.path());
+        }
+    }
+    REQUIRE(objects.size() > libraries.size());
+
+    for (const fs::path &object : objects) {
+        INFO("object: " << fs::relative(object, serial).string());
+        REQUIRE(files_are_identical(object, parallel / fs::relative(object, serial)));
+    }
+}
+
+TEST_CASE("units lowered on several threads run the program one thread would", "[cache][jobs]")
+{
+    ScopedProject project("parallel_lowering");
+
+    // a body both units define - `array<int32>`'s indexing - so the ODR check compares two copies that were
+    // built in two different contexts, which is the one comparison lanes added
+    write_file(project.root() / "lib" / "module.eco",
+        "#[module: \"lanelib\"]\n"
+        "#[version: \"0.1.0\"]\n"
+        "#[sources: \"src/*.eco\"]\n");
+    write_file(project.root() / "lib" / "src" / "lib.eco",
+        "namespace lanelib;\n"
+        "\n"
+        "public function first(array<int32>& $xs) : int32\n"
+        "{\n"
+        "    return $xs[0] * 2;\n"
+        "}\n");
+    write_file(project.root() / "app" / "app.eco",
+        "array<int32> $xs = [20, 1, 2];\n"
+        "echo lanelib::first(&$xs) + $xs[2];\n");
+
+    const auto run = [&](const std::string &jobs) {
+        return project.echoc(
+            "run -t -j " + jobs + " -m " + quoted(project.root() / "lib") + " --build-dir "
+                + quoted(project.root() / ("build_" + jobs)) + " app.eco",
+            project.root() / "app");
+    };
+
+    const ProcessResult serial = run("1");
+    REQUIRE(serial.exit_code == 0);
+    REQUIRE(serial.output.find("42") != std::string::npos);
+    REQUIRE(serial.output.find("codegen threads") == std::string::npos);
+
+    const ProcessResult parallel = run("4");
+    REQUIRE(parallel.exit_code == 0);
+    REQUIRE(parallel.output.find("42") != std::string::npos);
+
+    // the row that says lanes ran at all, so this is not a second serial run that happened to agree
+    REQUIRE(parallel.output.find("codegen threads") != std::string::npos);
+}
+
 TEST_CASE("a stored object is reused, and a changed source is not", "[cache][store]")
 {
     ScopedProject project("store");
@@ -594,6 +799,368 @@ TEST_CASE("a stored object is reused, and a changed source is not", "[cache][sto
     }
 }
 
+// **the JIT loads what a build links**, so the store a run writes is the store a run reads - and the same
+// one a `build` with the same flags reads too, since nothing about the key knows which subcommand asked
+TEST_CASE("a run loads stored objects rather than compiling them", "[cache][store][jit]")
+{
+    ScopedProject project("jit_store");
+
+    write_library(project.root() / "lib", "jitlib");
+    write_file(project.root() / "app" / "app.eco", "echo jitlib::twice(21);\n");
+
+    const fs::path app_dir = project.root() / "app";
+    const std::string located =
+        "-m " + quoted(project.root() / "lib") + " --build-dir " + quoted(project.build_dir());
+    const std::string flags = located + " --explain cache";
+
+    const ProcessResult cold = project.echoc("run " + flags + " app.eco", app_dir);
+    REQUIRE(cold.exit_code == 0);
+    REQUIRE(cold.output.find("42") != std::string::npos);
+    REQUIRE(line_starting_with(cold.output, "jitlib").find("miss") != std::string::npos);
+    REQUIRE(cold.output.find("bypassed") == std::string::npos);
+
+    SECTION("the next run is served the object the first one stored")
+    {
+        const ProcessResult warm = project.echoc("run " + flags + " app.eco", app_dir);
+
+        REQUIRE(warm.exit_code == 0);
+        REQUIRE(warm.output.find("42") != std::string::npos);
+        REQUIRE(line_starting_with(warm.output, "jitlib").find("hit") != std::string::npos);
+    }
+
+    SECTION("a build in the same mode links the object a run stored")
+    {
+        const ProcessResult built = project.echoc("build --debug -o out " + flags + " app.eco", app_dir);
+
+        REQUIRE(built.exit_code == 0);
+        REQUIRE(line_starting_with(built.output, "jitlib").find("hit") != std::string::npos);
+
+        const ProcessResult ran = run_capturing(quoted(app_dir / "out") + " 2>&1");
+        REQUIRE(ran.exit_code == 0);
+        REQUIRE(ran.output.find("42") != std::string::npos);
+    }
+
+    SECTION("the prune says why it did not run")
+    {
+        const ProcessResult explained = project.echoc("run --explain prune " + located + " app.eco", app_dir);
+
+        REQUIRE(explained.exit_code == 0);
+        REQUIRE(explained.output.find("not run:") != std::string::npos);
+    }
+}
+
+TEST_CASE("a run of what a build already linked starts that program", "[cache][store][program]")
+{
+    ScopedProject project("kept_program");
+
+    write_library(project.root() / "lib", "keptlib");
+    write_file(project.root() / "app" / "module.eco",
+        "#[module: \"kept\"]\n"
+        "#[depends: \"../lib\"]\n"
+        "#[sources: \"*.eco\"]\n");
+    write_file(project.root() / "app" / "app.eco", "echo keptlib::twice(21);\n");
+
+    const fs::path app_dir = project.root() / "app";
+    const std::string located = "--build-dir " + quoted(project.build_dir());
+    const std::string run = "run --explain cache " + located;
+
+    REQUIRE(project.echoc("build --debug -o out " + located, app_dir).exit_code == 0);
+
+    SECTION("the same inputs in the same mode start the kept program, and compile nothing")
+    {
+        const ProcessResult ran = project.echoc(run, app_dir);
+
+        REQUIRE(ran.exit_code == 0);
+        REQUIRE(ran.output.find("42") != std::string::npos);
+        REQUIRE(line_starting_with(ran.output, "program").find("hit") != std::string::npos);
+
+        // the module rows are the compile's, and there was none
+        REQUIRE(line_starting_with(ran.output, "keptlib").empty());
+    }
+
+    SECTION("an edited source is a miss that names it, and is compiled")
+    {
+        write_file(project.root() / "app" / "app.eco", "echo keptlib::twice(22);\n");
+
+        const ProcessResult ran = project.echoc(run, app_dir);
+        const std::string row = line_starting_with(ran.output, "program");
+
+        REQUIRE(ran.exit_code == 0);
+        REQUIRE(ran.output.find("44") != std::string::npos);
+        REQUIRE(row.find("miss") != std::string::npos);
+        REQUIRE(row.find("'app.eco' changed") != std::string::npos);
+    }
+
+    SECTION("another build mode is another program")
+    {
+        // `run` is a debug build by default and this one asked for release, so the program kept above has
+        // asserts this one must not
+        const ProcessResult ran = project.echoc(run + " --release", app_dir);
+
+        REQUIRE(ran.exit_code == 0);
+        REQUIRE(ran.output.find("42") != std::string::npos);
+        REQUIRE(line_starting_with(ran.output, "program").find("miss") != std::string::npos);
+    }
+
+    SECTION("a loose file keeps nothing, and says why")
+    {
+        const ProcessResult ran = project.echoc(
+            "run --explain cache -m " + quoted(project.root() / "lib") + " " + located + " app.eco", app_dir);
+
+        REQUIRE(ran.exit_code == 0);
+        REQUIRE(line_starting_with(ran.output, "program").find("loose file") != std::string::npos);
+    }
+}
+
+// **`--optimize thin` is the optimized build that keeps the cache**, so this is the store's contract again under
+// it: a library keeps a summary under its key, a second build reuses it, and the link that follows still
+// produces a program that runs
+TEST_CASE("a thin build keeps each library's summary and reuses it", "[cache][store][thin]")
+{
+    ScopedProject project("thin");
+
+    write_library(project.root() / "lib", "thinlib");
+    write_file(project.root() / "app" / "module.eco",
+        "#[module: \"thinapp\"]\n"
+        "#[depends: \"../lib\"]\n"
+        "#[sources: \"*.eco\"]\n");
+    write_file(project.root() / "app" / "app.eco", "echo thinlib::twice(21);\n");
+
+    const fs::path app_dir = project.root() / "app";
+    const std::string args =
+        "build --optimize thin -o out --explain cache --build-dir " + quoted(project.build_dir());
+
+    const ProcessResult cold = project.echoc(args, app_dir);
+
+    REQUIRE(cold.exit_code == 0);
+    REQUIRE(line_starting_with(cold.output, "thinlib").find("miss") != std::string::npos);
+    REQUIRE_FALSE(line_starting_with(cold.output, "units").empty());
+
+    // bitcode where an object would be, and no object beside it
+    bool summary = false;
+    bool object = false;
+
+    for (const auto &entry : fs::recursive_directory_iterator(project.build_dir())) {
+        if (entry.path().filename().string().rfind("thinlib-", 0) == 0) {
+            summary |= entry.path().extension() == ".bc";
+            object |= entry.path().extension() == ".o";
+        }
+    }
+
+    REQUIRE(summary);
+    REQUIRE_FALSE(object);
+
+    const ProcessResult warm = project.echoc(args, app_dir);
+
+    REQUIRE(warm.exit_code == 0);
+    REQUIRE(line_starting_with(warm.output, "thinlib").find("hit") != std::string::npos);
+
+    // nothing changed, so nothing the link produced had to be produced again
+    REQUIRE(line_starting_with(warm.output, "units").find("generated  0") != std::string::npos);
+
+    const ProcessResult ran = run_capturing(quoted(app_dir / "out") + " 2>&1");
+    REQUIRE(ran.exit_code == 0);
+    REQUIRE(ran.output.find("42") != std::string::npos);
+
+    SECTION("an ordinary build of the same sources is another artifact")
+    {
+        const ProcessResult plain = project.echoc(
+            "build -o out --explain cache --build-dir " + quoted(project.build_dir()), app_dir);
+
+        REQUIRE(plain.exit_code == 0);
+        REQUIRE(line_starting_with(plain.output, "thinlib").find("miss") != std::string::npos);
+        REQUIRE(line_starting_with(plain.output, "thinlib") != line_starting_with(warm.output, "thinlib"));
+    }
+}
+
+TEST_CASE("a body edit rebuilds its own module and no dependent", "[cache][store]")
+{
+    ScopedProject project("interface_keys");
+
+    write_library(project.root() / "lib", "baselib");
+
+    write_file(project.root() / "mid" / "module.eco",
+        "#[module: \"midlib\"]\n"
+        "#[depends: \"../lib\"]\n"
+        "#[sources: \"src/*.eco\"]\n");
+
+    write_file(project.root() / "mid" / "src" / "mid.eco",
+        "namespace midlib;\n"
+        "\n"
+        "public function quadruple(int32 $n) : int32\n"
+        "{\n"
+        "    return baselib::twice(baselib::twice($n));\n"
+        "}\n");
+
+    write_file(project.root() / "app" / "app.eco", "echo midlib::quadruple(10);\n");
+
+    const fs::path app_dir = project.root() / "app";
+    const std::string args =
+        "build -o out -m " + quoted(project.root() / "mid")
+        + " --build-dir " + quoted(project.build_dir()) + " --explain cache app.eco";
+
+    REQUIRE(project.echoc(args, app_dir).exit_code == 0);
+
+    SECTION("a changed body is recompiled, and the module above it is reused")
+    {
+        write_file(project.root() / "lib" / "src" / "lib.eco",
+            "namespace baselib;\n"
+            "\n"
+            "public function twice(int32 $n) : int32\n"
+            "{\n"
+            "    return $n * 3;\n"
+            "}\n");
+
+        const ProcessResult after = project.echoc(args, app_dir);
+        REQUIRE(after.exit_code == 0);
+
+        const std::string base = line_starting_with(after.output, "baselib");
+        REQUIRE(base.find("miss") != std::string::npos);
+        REQUIRE(base.find("lib.eco") != std::string::npos);
+
+        // and says why, since a hit right above a miss reads as a stale object otherwise
+        const std::string mid = line_starting_with(after.output, "midlib");
+        REQUIRE(mid.find("hit") != std::string::npos);
+        REQUIRE(mid.find("interface unchanged: 'baselib' was rebuilt") != std::string::npos);
+
+        // the reused object calls the new body, which is the only thing that makes the hit correct
+        const ProcessResult ran = run_capturing(quoted(app_dir / "out") + " 2>&1");
+        REQUIRE(ran.exit_code == 0);
+        REQUIRE(ran.output.find("90") != std::string::npos);
+    }
+
+    SECTION("a new overload is a changed interface, and the miss names the module")
+    {
+        write_file(project.root() / "lib" / "src" / "lib.eco",
+            "namespace baselib;\n"
+            "\n"
+            "public function twice(int32 $n) : int32\n"
+            "{\n"
+            "    return $n * 2;\n"
+            "}\n"
+            "\n"
+            "public function twice(int64 $n) : int64\n"
+            "{\n"
+            "    return $n * 2;\n"
+            "}\n");
+
+        const ProcessResult after = project.echoc(args, app_dir);
+        REQUIRE(after.exit_code == 0);
+
+        const std::string mid = line_starting_with(after.output, "midlib");
+        REQUIRE(mid.find("miss") != std::string::npos);
+        REQUIRE(mid.find("the interface of 'baselib' changed") != std::string::npos);
+    }
+}
+
+// the `tokens` row `--explain cache` prints under a module's own, or "" when it printed none
+std::string tokens_row_of(const std::string &output, const std::string &module_name)
+{
+    std::istringstream stream(output);
+    std::string line;
+
+    while (std::getline(stream, line)) {
+        std::istringstream fields(line);
+        std::string first;
+        fields >> first;
+
+        if (first != module_name) {
+            continue;
+        }
+
+        std::string next;
+        if (std::getline(stream, next) && next.find("tokens") != std::string::npos) {
+            return next;
+        }
+
+        return "";
+    }
+
+    return "";
+}
+
+TEST_CASE("stored tokens are reused in place of lexing, and a changed source is not", "[cache][tokens]")
+{
+    ScopedProject project("token_store");
+
+    write_library(project.root() / "lib", "facelib");
+    write_file(project.root() / "app" / "module.eco",
+        "#[module: \"app\"]\n"
+        "#[depends: \"../lib\"]\n"
+        "#[sources: \"*.eco\"]\n");
+    write_file(project.root() / "app" / "app.eco", "echo facelib::twice(21);\n");
+
+    // `run`, whose `tokens` rows are the same as a `build`'s - the store is read before either has decided
+    // anything about objects
+    const std::string args = "run --explain cache --build-dir " + quoted(project.build_dir());
+    const fs::path app_dir = project.root() / "app";
+
+    const ProcessResult cold = project.echoc(args, app_dir);
+    REQUIRE(cold.exit_code == 0);
+    REQUIRE(cold.output.find("42") != std::string::npos);
+    REQUIRE(tokens_row_of(cold.output, "facelib").find("stored for next time") != std::string::npos);
+
+    // the program is never stored, for the object store's reason
+    REQUIRE(tokens_row_of(cold.output, "app").empty());
+
+    SECTION("the next run loads it, and the program is the same program")
+    {
+        const ProcessResult warm = project.echoc(args, app_dir);
+
+        REQUIRE(warm.exit_code == 0);
+        REQUIRE(warm.output.find("42") != std::string::npos);
+        REQUIRE(tokens_row_of(warm.output, "facelib").find("reused") != std::string::npos);
+    }
+
+    SECTION("editing the library reads it from source again")
+    {
+        write_file(project.root() / "lib" / "src" / "lib.eco",
+            "namespace facelib;\n"
+            "\n"
+            "public function twice(int32 $n) : int32\n"
+            "{\n"
+            "    return $n + $n;\n"
+            "}\n");
+
+        const ProcessResult after = project.echoc(args, app_dir);
+
+        REQUIRE(after.exit_code == 0);
+        REQUIRE(after.output.find("42") != std::string::npos);
+        REQUIRE(tokens_row_of(after.output, "facelib").find("stored for next time") != std::string::npos);
+    }
+
+    SECTION("a damaged store is refused and replaced, never trusted")
+    {
+        for (const auto &entry : fs::recursive_directory_iterator(project.build_dir())) {
+            if (entry.path().extension() == ".ecot"
+                    && entry.path().filename().string().rfind("facelib", 0) == 0) {
+                std::ofstream truncate(entry.path(), std::ios::binary | std::ios::trunc);
+                truncate << "ECOTOKNS";
+            }
+        }
+
+        const ProcessResult damaged = project.echoc(args, app_dir);
+
+        REQUIRE(damaged.exit_code == 0);
+        REQUIRE(damaged.output.find("42") != std::string::npos);
+        REQUIRE(tokens_row_of(damaged.output, "facelib").find("did not read back") != std::string::npos);
+
+        const ProcessResult repaired = project.echoc(args, app_dir);
+        REQUIRE(tokens_row_of(repaired.output, "facelib").find("reused") != std::string::npos);
+    }
+
+    SECTION("the parallel lexer loads it the same way")
+    {
+        // `-j` moves reading and lexing onto workers, and the store is read there too - the one path where
+        // a module's tokens are loaded somewhere other than where it is parsed
+        const ProcessResult warm = project.echoc(args + " -j 4", app_dir);
+
+        REQUIRE(warm.exit_code == 0);
+        REQUIRE(warm.output.find("42") != std::string::npos);
+        REQUIRE(tokens_row_of(warm.output, "facelib").find("reused") != std::string::npos);
+    }
+}
+
 TEST_CASE("a vendor path change alone does not change a module's key", "[cache][packages]")
 {
     // paths are folded as basenames, so copying a vendored tree to another directory must not
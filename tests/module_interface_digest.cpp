@@ -0,0 +1,208 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "helpers.h"
+
+#include <AST/ASTModule.h>
+#include <Compiler/ModuleCache.h>
+
+#include <string>
+
+// Compiler::module_interface_digest is what a dependent's object key folds in place of the dependency's
+// sources. Wrong in one direction it is a cache that rebuilds everything, which is what it replaced; wrong in
+// the other it serves a stale object that links - so each case below is a pair, an edit that must not move
+// the digest beside the nearest edit that must.
+
+namespace
+{
+
+uint64_t digest_of(const std::string &source, bool with_positions = false)
+{
+    auto bundle = EchoTests::tests_make_parsed_bundle(source);
+
+    return Compiler::module_interface_digest(bundle->modules.find_module("test"), with_positions);
+}
+
+};
+
+TEST_CASE("an ordinary body is not part of the interface", "[cache][interface-digest]")
+{
+    const uint64_t before = digest_of(
+        "function twice(int32 $n) : int32\n"
+        "{\n"
+        "    return $n * 2;\n"
+        "}\n"
+        "\n"
+        "function after(int32 $n) : int32\n"
+        "{\n"
+        "    return $n;\n"
+        "}\n");
+
+    SECTION("so editing one moves nothing, even when it grows lines")
+    {
+        REQUIRE(digest_of(
+            "function twice(int32 $n) : int32\n"
+            "{\n"
+            "    int32 $twice = $n + $n;\n"
+            "\n"
+            "    return $twice;\n"
+            "}\n"
+            "\n"
+            "function after(int32 $n) : int32\n"
+            "{\n"
+            "    return $n;\n"
+            "}\n") == before);
+    }
+
+    SECTION("but its signature is")
+    {
+        REQUIRE(digest_of(
+            "function twice(int32 $n) : int64\n"
+            "{\n"
+            "    return $n * 2;\n"
+            "}\n"
+            "\n"
+            "function after(int32 $n) : int32\n"
+            "{\n"
+            "    return $n;\n"
+            "}\n") != before);
+    }
+
+    SECTION("and so is a declaration added beside it")
+    {
+        REQUIRE(digest_of(
+            "function twice(int32 $n) : int32\n"
+            "{\n"
+            "    return $n * 2;\n"
+            "}\n"
+            "\n"
+            "function twice(int64 $n) : int64\n"
+            "{\n"
+            "    return $n * 2;\n"
+            "}\n"
+            "\n"
+            "function after(int32 $n) : int32\n"
+            "{\n"
+            "    return $n;\n"
+            "}\n") != before);
+    }
+}
+
+TEST_CASE("a body copied into its callers is part of the interface", "[cache][interface-digest]")
+{
+    SECTION("an #[inline] one")
+    {
+        REQUIRE(digest_of(
+            "#[inline]\n"
+            "function twice(int32 $n) : int32 { return $n * 2; }\n")
+            != digest_of(
+            "#[inline]\n"
+            "function twice(int32 $n) : int32 { return $n + $n; }\n"));
+    }
+
+    SECTION("a generic one")
+    {
+        REQUIRE(digest_of(
+            "function first<T>(T $a, T $b) : T { return $a; }\n")
+            != digest_of(
+            "function first<T>(T $a, T $b) : T { return $b; }\n"));
+    }
+
+    SECTION("a method of a generic struct, and not one of a plain struct")
+    {
+        const std::string generic_before =
+            "struct Box<T>\n"
+            "{\n"
+            "    T $value;\n"
+            "\n"
+            "    function get() : T\n"
+            "    {\n"
+            "        return $this->value;\n"
+            "    }\n"
+            "}\n";
+
+        const std::string generic_after =
+            "struct Box<T>\n"
+            "{\n"
+            "    T $value;\n"
+            "\n"
+            "    function get() : T\n"
+            "    {\n"
+            "        T $v = $this->value;\n"
+            "        return $v;\n"
+            "    }\n"
+            "}\n";
+
+        REQUIRE(digest_of(generic_before) != digest_of(generic_after));
+
+        const std::string plain_before =
+            "struct Counter\n"
+            "{\n"
+            "    int32 $value;\n"
+            "\n"
+            "    function get() : int32\n"
+            "    {\n"
+            "        return $this->value;\n"
+            "    }\n"
+            "}\n";
+
+        const std::string plain_after =
+            "struct Counter\n"
+            "{\n"
+            "    int32 $value;\n"
+            "\n"
+            "    function get() : int32\n"
+            "    {\n"
+            "        int32 $v = $this->value;\n"
+            "        return $v;\n"
+            "    }\n"
+            "}\n";
+
+        REQUIRE(digest_of(plain_before) == digest_of(plain_after));
+
+        // the layout is interface however ordinary the methods are
+        REQUIRE(digest_of(plain_before) != digest_of(
+            "struct Counter\n"
+            "{\n"
+            "    int64 $value;\n"
+            "\n"
+            "    function get() : int32\n"
+            "    {\n"
+            "        return $this->value;\n"
+            "    }\n"
+            "}\n"));
+    }
+}
+
+TEST_CASE("a position is part of the interface only where an object can carry it", "[cache][interface-digest]")
+{
+    // the ordinary body above grows a line, which moves everything under it
+    const std::string before =
+        "function helper() : int32\n"
+        "{\n"
+        "    return 1;\n"
+        "}\n"
+        "\n";
+
+    const std::string after =
+        "function helper() : int32\n"
+        "{\n"
+        "    int32 $one = 1;\n"
+        "    return $one;\n"
+        "}\n"
+        "\n";
+
+    SECTION("a declaration's line does not count, unless the build carries debug info")
+    {
+        const std::string declaration = "function plain(int32 $n) : int32 { return $n; }\n";
+
+        REQUIRE(digest_of(before + declaration) == digest_of(after + declaration));
+        REQUIRE(digest_of(before + declaration, true) != digest_of(after + declaration, true));
+    }
+
+    SECTION("a generic body's line always does, since an abort in it prints the line")
+    {
+        const std::string generic = "function first<T>(T $a, T $b) : T { return $a; }\n";
+
+        REQUIRE(digest_of(before + generic) != digest_of(after + generic));
+    }
+}
@@ -365,3 +365,39 @@ TEST_CASE("a template that fits better than a concrete overload wins", "[overloa
     REQUIRE(calls[0]->decl->is_instantiated());
     REQUIRE(calls[0]->decl->args[0]->type().is_floating_type());
 }
+
+TEST_CASE("an instance asking one overload set the same question twice scores it once", "[overloads]")
+{
+    // each instance's two calls to `g` are one name, one namespace, one argument type and one argument
+    // shape - so the second is answered from the registry rather than scored against both overloads
+    // again. remembered per type, so each instance still gets its own answer
+    auto bundle = EchoTests::tests_make_parsed_bundle(
+        "function g(int32 $a) : int32 { return 1; }\n"
+        "function g(float64 $a) : int32 { return 2; }\n"
+        "function twice<T>(T $v) : int32 { return g($v) + g($v); }\n"
+        "echo twice(1);\n"
+        "echo twice(1.5);\n");
+
+    REQUIRE_FALSE(bundle->collector.has_critical_issues());
+
+    const auto counts = bundle->collector.functions.match_counts();
+    REQUIRE(counts.hits >= 2);
+    REQUIRE(counts.misses >= 2);
+
+    size_t integer = 0;
+    size_t floating = 0;
+
+    // the template's own body asks too and is answered by neither, since `T` decides nothing
+    auto &m = bundle->modules.find_module("test");
+    for (auto *call : calls_to(m, "g")) {
+        if (call->decl == nullptr) {
+            continue;
+        }
+
+        integer += call->decl->args[0]->type().is_integer_type();
+        floating += call->decl->args[0]->type().is_floating_type();
+    }
+
+    REQUIRE(integer == 2);
+    REQUIRE(floating == 2);
+}
@@ -0,0 +1,148 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "helpers.h"
+
+#include <AST/ASTBundle.h>
+#include <Compiler/TargetFacts.h>
+#include <Parser/ModuleParser.h>
+#include <eco.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef ECO_E2E_TESTS_DIR
+#define ECO_E2E_TESTS_DIR "tests_eco"
+#endif
+
+// how long the semantic passes take over real programs: every `ok` case of a few e2e directories, each
+// compiled the way `echoc run` compiles it - the standard library, then the program - and only the passes
+// timed, since parsing has a benchmark of its own in the lexer's.
+//
+// **hidden, so a plain `tests` run never pays for it**, for the lexer benchmark's reason. Ask for it by tag:
+//   ./build/tests "[benchmark]"
+//
+// the directories are the ones whose programs lean on generics, which is where the monomorphizer's
+// fixpoint - and every `of_type` sweep inside it - does the most rounds
+
+namespace
+{
+    std::string read_file(const std::filesystem::path &path)
+    {
+        std::ifstream in(path);
+        std::stringstream content;
+        content << in.rdbuf();
+        return content.str();
+    }
+
+    // the standard library's sources in a stable order. The manifest is not read: what is measured is the
+    // passes, and a parse that follows `#[sources:]` would only add a way for this file to drift from it
+    std::vector<std::filesystem::path> stdlib_sources()
+    {
+        std::vector<std::filesystem::path> sources;
+
+        for (const auto &entry : std::filesystem::recursive_directory_iterator(STDLIB_SOURCE_DIR)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".eco"
+                && entry.path().filename() != "module.eco") {
+                sources.push_back(entry.path());
+            }
+        }
+
+        std::sort(sources.begin(), sources.end());
+        return sources;
+    }
+
+    // does the case's `.test` header leave it an ordinary program: one that compiles, against the standard
+    // library and nothing else. A case expecting an error stops part way through the passes, and an average
+    // over those measures the error paths instead - see tests_eco/README.md for the header
+    bool is_plain_program(const std::filesystem::path &expectation)
+    {
+        std::istringstream header(read_file(expectation));
+        std::string line;
+
+        while (std::getline(header, line) && line.rfind("---", 0) != 0) {
+            if ((line.rfind("expect:", 0) == 0 && line != "expect: ok")
+                || line.rfind("stdlib: off", 0) == 0
+                || line.rfind("modules:", 0) == 0) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::vector<std::filesystem::path> programs()
+    {
+        std::vector<std::filesystem::path> found;
+
+        for (const char *dir : { "generics", "maps", "iteration", "classes" }) {
+            const std::filesystem::path root = std::filesystem::path(ECO_E2E_TESTS_DIR) / dir;
+
+            if (!std::filesystem::is_directory(root)) {
+                continue;
+            }
+
+            for (const auto &entry : std::filesystem::directory_iterator(root)) {
+                if (entry.path().extension() != ".eco") {
+                    continue;
+                }
+
+                std::filesystem::path expectation = entry.path();
+                expectation.replace_extension(".test");
+
+                if (is_plain_program(expectation)) {
+                    found.push_back(entry.path());
+                }
+            }
+        }
+
+        std::sort(found.begin(), found.end());
+        return found;
+    }
+};
+
+TEST_CASE("the semantic passes over the e2e programs", "[.][benchmark][semantic]")
+{
+    const std::vector<std::filesystem::path> stdlib = stdlib_sources();
+    const std::vector<std::filesystem::path> cases = programs();
+
+    REQUIRE(!stdlib.empty());
+    REQUIRE(!cases.empty());
+
+    Parser::ModuleParser parser(Compiler::TargetFacts::host());
+
+    std::chrono::duration<double, std::milli> passes{};
+    size_t nodes = 0;
+
+    for (const std::filesystem::path &program : cases) {
+        AST::Bundle bundle;
+
+        auto &library = bundle.modules.get_module(bundle.modules.add_module("stdlib"));
+        Parser::ModuleParser::InputPayload library_input { .files = {}, .module = library, .collector = bundle.collector };
+        for (const std::filesystem::path &source : stdlib) {
+            library_input.files.push_back(Parser::ModuleParser::InputFile(source));
+        }
+        parser.parse_input(library_input);
+
+        auto &main = bundle.modules.get_module(bundle.modules.add_module(ECO_MAIN_MODULE_NAME));
+        parser.parse_input(Parser::ModuleParser::InputPayload {
+            .files = { Parser::ModuleParser::InputFile(program) }, .module = main, .collector = bundle.collector });
+
+        const auto start = std::chrono::steady_clock::now();
+        EchoTests::run_test_semantic_passes(bundle, EchoTests::tests_compiler_options());
+        passes += std::chrono::steady_clock::now() - start;
+
+        for (const auto &module : bundle.modules) {
+            nodes += module->nodes.size();
+        }
+    }
+
+    std::cout << "[semantic] " << cases.size() << " programs: " << passes.count() << " ms in the passes, "
+              << passes.count() / static_cast<double>(cases.size()) << " ms each, "
+              << nodes / cases.size() << " nodes each" << std::endl;
+}
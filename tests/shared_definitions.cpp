@@ -0,0 +1,188 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Compiler/LLVM/SharedDefinitions.h>
+#include <Compiler/ModuleCache.h>
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/SourceMgr.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "subprocess.h"
+
+// the split Backend::keep_shared_definitions stores a unit's ODR-shared bodies by, asked of hand-written IR
+// for odr_compare.cpp's reason: what it has to get right is a property of any unit at all, and the units a
+// compiled program happens to produce are a handful of them.
+//
+// **the digest is the cache's whole notion of "the same instances"**, so most of what is here is the two
+// ways it can be wrong - apart for bodies that agree, which is a miss every build, or equal for bodies that
+// do not, which is an object linked in place of the code it was supposed to be
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+// a unit holding two instances, one calling the other with a literal, and a function of its own
+const char *k_unit = R"(
+%"array<int32>" = type { ptr, i64 }
+
+@.str.3 = private unnamed_addr constant [3 x i8] c"ab\00"
+
+declare void @puts(ptr)
+
+define linkonce_odr void @"array<int32>::clear"(ptr %0) {
+  %2 = getelementptr %"array<int32>", ptr %0, i32 0, i32 1
+  store i64 0, ptr %2
+  call void @"array<int32>::trace"()
+  ret void
+}
+
+define linkonce_odr void @"array<int32>::trace"() {
+  call void @puts(ptr @.str.3)
+  ret void
+}
+
+define void @main() {
+  call void @"array<int32>::clear"(ptr null)
+  ret void
+}
+)";
+
+std::unique_ptr<llvm::Module> parse(llvm::LLVMContext &context, const std::string &ir)
+{
+    llvm::SMDiagnostic error;
+    std::unique_ptr<llvm::Module> module = llvm::parseAssemblyString(ir, error, context);
+
+    REQUIRE(module != nullptr);
+    return module;
+}
+
+};
+
+TEST_CASE("a unit's shared bodies move with the literals they reach", "[cache][instances]")
+{
+    llvm::LLVMContext context;
+    std::unique_ptr<llvm::Module> unit = parse(context, k_unit);
+
+    Compiler::LLVM::SharedDefinitionSplit split = Compiler::LLVM::split_shared_definitions(*unit);
+
+    REQUIRE(split.module != nullptr);
+    REQUIRE(split.definitions == 2);
+    REQUIRE(split.kept_because.empty());
+    REQUIRE_FALSE(llvm::verifyModule(*split.module, &llvm::errs()));
+
+    // both instances, and the unit's own function only if something moved named it - nothing did
+    REQUIRE_FALSE(split.module->getFunction("array<int32>::clear")->isDeclaration());
+    REQUIRE_FALSE(split.module->getFunction("array<int32>::trace")->isDeclaration());
+    REQUIRE(split.module->getFunction("main") == nullptr);
+    REQUIRE(split.module->getFunction("puts")->isDeclaration());
+
+    // the literal went along unnamed, which is what keeps `.str.3` from being part of what is stored
+    REQUIRE(split.module->global_size() == 1);
+    REQUIRE_FALSE(split.module->globals().begin()->hasName());
+
+    // and the unit, released, names the two instances it no longer defines
+    Compiler::LLVM::release_shared_definitions(*unit, *split.module);
+
+    REQUIRE_FALSE(llvm::verifyModule(*unit, &llvm::errs()));
+    REQUIRE(unit->getFunction("array<int32>::clear")->isDeclaration());
+    REQUIRE(unit->getFunction("array<int32>::trace")->isDeclaration());
+    REQUIRE_FALSE(unit->getFunction("main")->isDeclaration());
+    REQUIRE(unit->getNamedGlobal(".str.3") == nullptr);
+}
+
+TEST_CASE("a shared body reaching its unit's own state keeps the unit whole", "[cache][instances]")
+{
+    llvm::LLVMContext context;
+    std::unique_ptr<llvm::Module> unit = parse(context, R"(
+@counter = internal global i32 0
+
+define linkonce_odr void @"bump<int32>"() {
+  %1 = load i32, ptr @counter
+  %2 = add i32 %1, 1
+  store i32 %2, ptr @counter
+  ret void
+}
+)");
+
+    Compiler::LLVM::SharedDefinitionSplit split = Compiler::LLVM::split_shared_definitions(*unit);
+
+    REQUIRE(split.module == nullptr);
+    REQUIRE(split.definitions == 1);
+    REQUIRE(split.kept_because.find("'counter'") != std::string::npos);
+}
+
+TEST_CASE("the digest is the bodies, not the names the unit gave them", "[cache][instances]")
+{
+    llvm::LLVMContext context;
+    std::unique_ptr<llvm::Module> unit = parse(context, k_unit);
+
+    // the same instances in a unit lowered second into the same context, where the struct is `.0`-suffixed
+    // and the literal was the ninth one rather than the fourth
+    std::string renamed = k_unit;
+    renamed.replace(renamed.find("@.str.3"), 7, "@.str.9");
+    renamed.replace(renamed.find("@.str.3"), 7, "@.str.9");
+
+    std::unique_ptr<llvm::Module> second = parse(context, renamed);
+    REQUIRE(llvm::StructType::getTypeByName(context, "array<int32>.0") != nullptr);
+
+    Compiler::LLVM::SharedDefinitionSplit left = Compiler::LLVM::split_shared_definitions(*unit);
+    Compiler::LLVM::SharedDefinitionSplit right = Compiler::LLVM::split_shared_definitions(*second);
+
+    REQUIRE(Compiler::LLVM::shared_definitions_digest(*left.module, 7)
+        == Compiler::LLVM::shared_definitions_digest(*right.module, 7));
+
+    // and the names are exactly what they were once the print is done
+    REQUIRE(llvm::StructType::getTypeByName(context, "array<int32>") != nullptr);
+
+    // the environment is part of the key, and so is a changed body
+    REQUIRE(Compiler::LLVM::shared_definitions_digest(*left.module, 7)
+        != Compiler::LLVM::shared_definitions_digest(*left.module, 8));
+
+    std::string edited = k_unit;
+    edited.replace(edited.find("store i64 0"), 11, "store i64 1");
+
+    std::unique_ptr<llvm::Module> third = parse(context, edited);
+    Compiler::LLVM::SharedDefinitionSplit changed = Compiler::LLVM::split_shared_definitions(*third);
+
+    REQUIRE(Compiler::LLVM::shared_definitions_digest(*left.module, 7)
+        != Compiler::LLVM::shared_definitions_digest(*changed.module, 7));
+}
+
+TEST_CASE("an object is claimed only with every instance object it leans on", "[cache][instances]")
+{
+    EchoTests::ScopedProject scratch("shared_definitions", "claim");
+
+    const fs::path instances = scratch.root() / "instances";
+    fs::create_directories(instances);
+
+    const fs::path object = scratch.root() / "geom-0123.o";
+    const fs::path instance = Compiler::instance_object_path(instances, 0xfeed);
+
+    std::ofstream(object, std::ios::binary) << "object";
+    std::ofstream(instance, std::ios::binary) << "instance";
+
+    // no record is a whole object, which is every object written before there were instance objects
+    auto claimed = Compiler::claim_instance_objects(object, instances);
+    REQUIRE(claimed.has_value());
+    REQUIRE(claimed->empty());
+
+    REQUIRE(Compiler::write_instance_record(object, { instance }));
+
+    claimed = Compiler::claim_instance_objects(object, instances);
+    REQUIRE(claimed.has_value());
+    REQUIRE(*claimed == std::vector<fs::path>{ instance });
+
+    // one pruned from under it is a miss, never an object linked without its bodies
+    fs::remove(instance);
+    REQUIRE_FALSE(Compiler::claim_instance_objects(object, instances).has_value());
+}
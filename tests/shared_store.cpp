@@ -0,0 +1,140 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <Compiler/SharedStore.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "subprocess.h"
+
+// Compiler::SharedStore against real directories. **What another project fetches has to be exactly what this
+// one published**, so these cases are about the bytes arriving whole and the store staying inside its cap -
+// oldest first - and not about what builds do with either; that is the driver's, and tests_eco's
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+using EchoTests::write_file;
+
+std::string read(const fs::path &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// publishes `name` holding `bytes`, then backdates it so the order cases below read is the one they wrote
+void publish_aged(
+    const Compiler::SharedStore &store,
+    const fs::path &scratch,
+    const std::string &name,
+    const std::string &bytes,
+    std::chrono::hours age
+)
+{
+    write_file(scratch / name, bytes);
+    REQUIRE(store.publish(name, scratch / name));
+
+    fs::last_write_time(store.root() / "objects" / name, fs::file_time_type::clock::now() - age);
+}
+
+};
+
+TEST_CASE("a size is read the way a person writes one", "[cache][store]")
+{
+    REQUIRE(Compiler::parse_byte_size("4096") == 4096u);
+    REQUIRE(Compiler::parse_byte_size("64K") == 64u * 1024);
+    REQUIRE(Compiler::parse_byte_size("512M") == 512u * 1024 * 1024);
+    REQUIRE(Compiler::parse_byte_size("10G") == 10ull * 1024 * 1024 * 1024);
+    REQUIRE(Compiler::parse_byte_size("10GiB") == 10ull * 1024 * 1024 * 1024);
+    REQUIRE(Compiler::parse_byte_size("2gb") == 2ull * 1024 * 1024 * 1024);
+
+    REQUIRE_FALSE(Compiler::parse_byte_size("").has_value());
+    REQUIRE_FALSE(Compiler::parse_byte_size("G").has_value());
+    REQUIRE_FALSE(Compiler::parse_byte_size("10X").has_value());
+    REQUIRE_FALSE(Compiler::parse_byte_size("-1G").has_value());
+    REQUIRE_FALSE(Compiler::parse_byte_size("999999999999999T").has_value());
+
+    REQUIRE(Compiler::describe_byte_size(93) == "93 bytes");
+    REQUIRE(Compiler::describe_byte_size(1536) == "1.5 KiB");
+    REQUIRE(Compiler::describe_byte_size(10ull * 1024 * 1024 * 1024) == "10 GiB");
+}
+
+TEST_CASE("what one project publishes another fetches whole", "[cache][store]")
+{
+    EchoTests::ScopedProject scratch("shared_store", "roundtrip");
+    const Compiler::SharedStore store(scratch.root() / "store", Compiler::k_default_shared_store_capacity);
+
+    fs::create_directories(scratch.root() / "first");
+    fs::create_directories(scratch.root() / "second");
+
+    const std::string name = "json-0123456789abcdef.o";
+    write_file(scratch.root() / "first" / name, "an object");
+
+    REQUIRE_FALSE(store.fetch(name, scratch.root() / "second" / name));
+    REQUIRE(store.publish(name, scratch.root() / "first" / name));
+
+    // a second publish of the same key is the same bytes, and is a touch rather than a write
+    REQUIRE(store.publish(name, scratch.root() / "first" / name));
+
+    REQUIRE(store.fetch(name, scratch.root() / "second" / name));
+    REQUIRE(read(scratch.root() / "second" / name) == "an object");
+
+    // nothing is left staged on either side
+    REQUIRE(fs::is_empty(scratch.root() / "store" / "tmp"));
+    REQUIRE(std::distance(fs::directory_iterator(scratch.root() / "second"), fs::directory_iterator()) == 1);
+
+    REQUIRE(store.usage().objects == 1);
+    REQUIRE(store.usage().bytes == std::string("an object").size());
+}
+
+TEST_CASE("a prune removes what was used longest ago", "[cache][store]")
+{
+    EchoTests::ScopedProject scratch("shared_store", "prune");
+    const Compiler::SharedStore store(scratch.root() / "store", Compiler::k_default_shared_store_capacity);
+
+    publish_aged(store, scratch.root(), "old.o", std::string(100, 'o'), std::chrono::hours(30));
+    publish_aged(store, scratch.root(), "middle.o", std::string(100, 'm'), std::chrono::hours(20));
+    publish_aged(store, scratch.root(), "new.o", std::string(100, 'n'), std::chrono::hours(10));
+
+    // a fetch is a use, so the oldest publish is no longer the least recently used
+    fs::create_directories(scratch.root() / "consumer");
+    REQUIRE(store.fetch("old.o", scratch.root() / "consumer" / "old.o"));
+
+    const Compiler::SharedStore::Pruned pruned = store.prune(200, /*dry_run=*/false);
+
+    REQUIRE(pruned.removed.objects == 1);
+    REQUIRE(pruned.removed.bytes == 100);
+    REQUIRE(pruned.kept.objects == 2);
+
+    REQUIRE(fs::exists(scratch.root() / "store" / "objects" / "old.o"));
+    REQUIRE_FALSE(fs::exists(scratch.root() / "store" / "objects" / "middle.o"));
+    REQUIRE(fs::exists(scratch.root() / "store" / "objects" / "new.o"));
+
+    // and what a build already linked out of the store is its own, whatever the store does next
+    REQUIRE(store.prune(0, /*dry_run=*/false).kept.objects == 0);
+    REQUIRE(read(scratch.root() / "consumer" / "old.o") == std::string(100, 'o'));
+}
+
+TEST_CASE("a dry run counts and removes nothing", "[cache][store]")
+{
+    EchoTests::ScopedProject scratch("shared_store", "dry");
+    const Compiler::SharedStore store(scratch.root() / "store", Compiler::k_default_shared_store_capacity);
+
+    publish_aged(store, scratch.root(), "a.o", std::string(100, 'a'), std::chrono::hours(2));
+    publish_aged(store, scratch.root(), "b.o", std::string(100, 'b'), std::chrono::hours(1));
+
+    const Compiler::SharedStore::Pruned pruned = store.prune(150, /*dry_run=*/true);
+
+    REQUIRE(pruned.removed.objects == 1);
+    REQUIRE(pruned.kept.objects == 1);
+    REQUIRE(store.usage().objects == 2);
+
+    // a store that fits is left alone, dry or not
+    REQUIRE(store.prune(1000, /*dry_run=*/false).removed.objects == 0);
+    REQUIRE(store.usage().objects == 2);
+}